@@ -17,50 +17,10 @@ This is my implimentation of loading a Tiled map into a SDL Game.
 #include <pugixml.hpp>
 #include "debug_gui.h"
 #include "utils/camera.h"
+#include "utils/map_data.h"
 
 using json = nlohmann::json;
 
-struct TSDL_Layer
-{
-    std::string name;
-    int width;
-    int height;
-    std::vector<int> data;
-};
-struct TSDL_Tileset
-{
-    int firstGid;
-    std::string source;
-};
-/**
-The TSDL_Tileset will have a source file which will be a .tsx xml file
-which we will load and parse to get the tileset information.
-    **/
-struct TSDL_TilesetSource
-{
-    std::string name;
-    int tileWidth;
-    int tileHeight;
-    int tileCount;
-    int columns;
-    std::string imagePath;
-    int imageWidth;
-    int imageHeight;
-    SDL_Texture *texture = nullptr;
-};
-struct TSDL_TileMap
-{
-    int width;
-    int height;
-    int tileWidth;
-    int tileHeight;
-    std::vector<TSDL_Layer> layers;    // Multiple layers
-    std::vector<TSDL_Tileset> tilesets; // Tilesets used
-    std::vector<TSDL_TilesetSource> tilesetSources; // Tilesets used
-    int maxTileCount = 0;
-};
-
-
 class TSDL
 {
 private:
@@ -80,15 +40,11 @@ private:
     }
 public:
     /** 
-    Load the map and store it inside the TSDL_TileMap Struct
+    Load the map and store it inside the TSDL_TileMap Struct (MapData::load) then
+    load the tileset textures for it
     **/
     static bool loadMap(SDL_Renderer* renderer, TSDL_TileMap *tileMap, const std::string& jsonPath, const std::string& tsxPath);
 
-    /**
-    Load the Tileset Source from the .tsx file
-    **/
-    static bool loadTsx(TSDL_TileMap *tileMap, const std::string &path);
-
     /** 
     The tilesetsources already contain the image path so we can load the texture from there
     **/
@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef BENCH_BENCHMARKS_H
+#define BENCH_BENCHMARKS_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class CollisionGrid;
+
+/**
+    Micro benchmarks for the engine systems
+
+    These dont need a window or a renderer, the Debug GUI has a Perf tab with a
+    button for each one that shows the results in a table
+**/
+struct BenchResult
+{
+    std::string name;
+    int count = 0;              // how many entities / queries / rays the run was over
+    double milliseconds = 0.0;  // average time of one run (one tick, one batch, ...)
+    std::string detail;         // anything else worth showing (pairs found, ns per item, ...)
+};
+
+class BenchTimer
+{
+private:
+    std::chrono::steady_clock::time_point start;
+
+public:
+    BenchTimer() : start(std::chrono::steady_clock::now()) {}
+    void reset() { start = std::chrono::steady_clock::now(); }
+    double elapsedMilliseconds() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+class Benchmarks
+{
+public:
+    // Spatial hash rebuild + pair finding at a constant density from 100 to 10k entities
+    static std::vector<BenchResult> spatialHash();
+    // AABB tree build / move / overlap / raycast / nearest against brute force at 1k, 10k and 100k proxies
+    static std::vector<BenchResult> aabbTree();
+    // Batched SIMD culling / tile collision kernels against a scalar loop
+    static std::vector<BenchResult> aabbKernels();
+    // Grid DDA raycasts per second on map.json tiled out to large maps
+    static std::vector<BenchResult> gridRaycast();
+    // Flow field full build vs the incremental goal move, agent sampling and the worker thread round trip
+    static std::vector<BenchResult> flowField();
+    // JPS queries per second against plain A*, and the cached path service
+    static std::vector<BenchResult> pathfinding();
+    // HPA* build, long queries against JPS, segment refinement and partial rebuilds
+    static std::vector<BenchResult> hierarchicalPathfinding();
+    // One tick of the SoA component store systems against virtual entity accessors, plus handle churn
+    static std::vector<BenchResult> componentStore();
+    // Job system overhead, entity systems and JPS batches split across workers, fenced chains
+    static std::vector<BenchResult> jobSystem();
+    // Pool spawn / despawn churn against new / delete, stale handle checks and a capped pool
+    static std::vector<BenchResult> pools();
+    // Crowd movement, old per entity Vec2 code vs the scalar reference (within a tolerance) vs the batched SIMD kernel (bit for bit)
+    static std::vector<BenchResult> movement();
+    // Scripted Q16.16 movement + collision ticks, world hash checked against a golden hash
+    static std::vector<BenchResult> determinism();
+    // Player / body state through the bit packed schemas against a struct dump, bytes each and encode / decode speed
+    static std::vector<BenchResult> serialization();
+    // Bandwidth a client in a simulated 64 player session, full states against deltas on acked baselines with loss
+    static std::vector<BenchResult> snapshots();
+    // Remote bodies at 144 fps from 60 Hz states, newest state against the interpolation buffer with jitter and loss
+    static std::vector<BenchResult> interpolation();
+    // Server cost a tick and bandwidth at 100 / 500 / 2000 clients with interest management, against sending everyone everything
+    static std::vector<BenchResult> interest();
+
+    // assets/map.json's Collision layer repeated to fill width x height tiles (random walls if it cant be read)
+    static bool buildMapGrid(int width, int height, CollisionGrid &grid);
+};
+
+#endif
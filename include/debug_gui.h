@@ -18,6 +18,12 @@
 
 #include "entity/entity.h"
 #include "entity/player.h"
+#include "bench/benchmarks.h"
+#include "utils/fixed_timestep.h"
+#include "utils/frame_pacer.h"
+#include "utils/input_latency.h"
+#include "utils/job_system.h"
+#include "net/interpolation.h"
 
 
 class DebugGUI {
@@ -31,6 +37,7 @@ public:
     static void renderLayerInfo();
     static void renderTexturesInfo();
     static void renderPlayerInfo(SDL_Renderer* renderer);
+    static void renderPerfInfo();
 
     static void renderEntitySpriteOptions(Entity *entity, SDL_Renderer* renderer);
     static void renderEntitySpriteCreationMenu(Entity* entity, SDL_Renderer* renderer);
@@ -72,6 +79,16 @@ public:
         // Player Info
         // =====================================================================================================================
         Player* player;
+
+        // =====================================================================================================================
+        // Perf Info
+        // =====================================================================================================================
+        std::vector<BenchResult> benchResults;
+        const FixedTimestep *timestep = nullptr;
+        FramePacer *framePacer = nullptr;
+        const InputLatency *inputLatency = nullptr;
+        const JobSystem *jobSystem = nullptr;
+        const InterpolationBuffer *remoteBodies = nullptr;
     };
 
     static void SetPlayer(Player* player);
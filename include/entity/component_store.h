@@ -0,0 +1,135 @@
+#pragma once
+
+#ifndef ENTITY_COMPONENT_STORE_H
+#define ENTITY_COMPONENT_STORE_H
+
+#include "utils/aabb.h"
+#include "utils/pool.h"
+#include <cstdint>
+#include <vector>
+
+class Sprites;
+class JobSystem;
+struct MovementParams;
+
+// Entities use the same generational handles as the pools (see PoolHandle)
+typedef PoolHandle EntityHandle;
+
+/**
+    One array per field, slot i of every array is the same entity
+**/
+struct TransformComponents
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    // Where the entity was at the start of the tick and where to draw it this frame
+    std::vector<float> previousX;
+    std::vector<float> previousY;
+    std::vector<float> renderX;
+    std::vector<float> renderY;
+    std::vector<float> width;
+    std::vector<float> height;
+};
+
+struct VelocityComponents
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> maxSpeed;
+    // Where the entity is trying to go this tick (input / steering), unit length or 0 per axis
+    std::vector<float> directionX;
+    std::vector<float> directionY;
+};
+
+// Collision box, offset from the entity position
+struct ColliderComponents
+{
+    std::vector<float> offsetX;
+    std::vector<float> offsetY;
+    std::vector<float> width;
+    std::vector<float> height;
+};
+
+struct SpriteComponents
+{
+    std::vector<Sprites *> sprites;  // not owned
+};
+
+/**
+    Every entity's data, one array per field (structure of arrays)
+
+    Entities are packed at the front of the arrays with no holes, destroying one moves
+    the last entity into its slot. Systems (storePreviousPositions, interpolate,
+    gatherColliderBounds, ...) just run down the arrays they need, a pass over positions
+    doesnt drag velocities, sizes and sprite pointers through the cache with it.
+
+    Handles go through a sparse table to find the packed slot, so slots can move around
+    without anyone holding a handle noticing. Slots are only stable until the next
+    destroy, dont keep them across frames.
+
+    Every entity has every component for now, theres only one kind of entity.
+**/
+class ComponentStore
+{
+private:
+    // Sparse, by handle index
+    HandleTable handles;
+    std::vector<uint32_t> sparse;       // handle index -> packed slot
+
+    // Packed, by slot
+    std::vector<uint32_t> slotToIndex;
+    TransformComponents transforms;
+    VelocityComponents velocities;
+    ColliderComponents colliders;
+    SpriteComponents sprites;
+
+    void removeSlot(uint32_t slot);
+
+public:
+    ComponentStore() = default;
+
+    EntityHandle create(float x = 0.0f, float y = 0.0f);
+    // Returns false if the entity was already gone
+    bool destroy(EntityHandle handle);
+    void clear();
+    void reserve(int count);
+
+    // Getters
+    bool isAlive(EntityHandle handle) const
+    {
+        return this->handles.isAlive(handle);
+    }
+    // Packed slot of the entity, -1 if it is dead
+    int slotOf(EntityHandle handle) const
+    {
+        return this->isAlive(handle) ? (int)this->sparse[handle.index] : -1;
+    }
+    EntityHandle handleAt(int slot) const;
+    int size() const { return (int)this->slotToIndex.size(); }
+
+    TransformComponents &getTransforms() { return transforms; }
+    VelocityComponents &getVelocities() { return velocities; }
+    ColliderComponents &getColliders() { return colliders; }
+    SpriteComponents &getSprites() { return sprites; }
+    const TransformComponents &getTransforms() const { return transforms; }
+    const VelocityComponents &getVelocities() const { return velocities; }
+    const ColliderComponents &getColliders() const { return colliders; }
+    const SpriteComponents &getSprites() const { return sprites; }
+
+    // =====================================================================================================================
+    // Systems, pass a JobSystem to split them across cores (slots are independent)
+    // =====================================================================================================================
+    // Start of a tick, remember where everything was for interpolation
+    void storePreviousPositions(JobSystem *jobs = nullptr);
+    // Plain velocity integration for entities that dont do their own movement
+    void integrate(float dt, JobSystem *jobs = nullptr);
+    // Accelerate along direction, clamp, friction, move (see MovementKernels), batched SIMD. No tile
+    // collision, so nothing in the game or server ticks with it yet (see MovementKernels for why)
+    void integrateMovement(const MovementParams &params, JobSystem *jobs = nullptr);
+    // renderX / Y = lerp(previous, position, alpha)
+    void interpolate(float alpha, JobSystem *jobs = nullptr);
+    // World space collider box of every entity, bounds[slot]
+    void gatherColliderBounds(std::vector<AABB> &bounds, JobSystem *jobs = nullptr) const;
+};
+
+#endif
@@ -3,40 +3,71 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
+#include "entity/component_store.h"
 #include "utils/sprite.h"
 #include "Vec2.h"
 #include <SDL2/SDL.h>
-#include <string>
 
+/**
+    A view of one entity in the ComponentStore
+
+    Entity doesnt hold any of the data itself, every getter / setter looks the handle up
+    and reads the packed arrays. None of them are virtual so they inline into a couple
+    of loads. Systems that touch lots of entities should go straight to the store arrays
+    instead of going through these.
+
+    Creating an Entity creates its entry in the store, destroying it removes it.
+**/
 class Entity {
 protected:
-    float width;
-    float height;
-    std::string     name;
-    Vec2            position;
-    float           maxSpeed;
-    Sprites         *sprite;
-    SDL_Renderer    *renderer;
+    ComponentStore  *store;
+    EntityHandle    handle;
+
+    int slot() const { return store->slotOf(handle); }
 
 public:
-    virtual ~Entity() = default;
+    Entity(ComponentStore *store, float x = 0.0f, float y = 0.0f) : store(store), handle(store->create(x, y)) {}
+    virtual ~Entity() { store->destroy(handle); }
+    Entity(const Entity &) = delete;
+    Entity &operator=(const Entity &) = delete;
 
     // Common Getters
-    virtual float getX() { return position.x; }
-    virtual float getY() { return position.y; }
-    virtual float getWidth() { return width; }
-    virtual float getHeight() { return height; }
-
-    virtual Vec2 getPosition() { return position; }
-    virtual float getMaxSpeed() { return maxSpeed; }
-    virtual Sprites* getSprite() { return sprite; }
-    virtual std::string getName() { return name; }
+    ComponentStore *getStore() const { return store; }
+    EntityHandle getHandle() const { return handle; }
+    float getX() const { return store->getTransforms().x[slot()]; }
+    float getY() const { return store->getTransforms().y[slot()]; }
+    Vec2 getPosition() const { int i = slot(); return Vec2(store->getTransforms().x[i], store->getTransforms().y[i]); }
+    float getWidth() const { return store->getTransforms().width[slot()]; }
+    float getHeight() const { return store->getTransforms().height[slot()]; }
+    // Where to draw it this frame (see ComponentStore::interpolate)
+    float getRenderX() const { return store->getTransforms().renderX[slot()]; }
+    float getRenderY() const { return store->getTransforms().renderY[slot()]; }
+    float getVelocityX() const { return store->getVelocities().x[slot()]; }
+    float getVelocityY() const { return store->getVelocities().y[slot()]; }
+    float getMaxSpeed() const { return store->getVelocities().maxSpeed[slot()]; }
+    Sprites *getSprite() const { return store->getSprites().sprites[slot()]; }
 
     // Common Setters
-    virtual void setPosition(float x, float y) { position.x = x; position.y = y; }
-    virtual void setMaxSpeed(float spd) { maxSpeed = spd; }
-    virtual void setSprite(Sprites *spr) { sprite = spr; }
-    virtual void setRenderer(SDL_Renderer *rend) { renderer = rend; }
+    // Teleports, the previous position moves too so we dont lerp across the map to get there
+    void setPosition(float x, float y)
+    {
+        TransformComponents &transforms = store->getTransforms();
+        int i = slot();
+        transforms.x[i] = transforms.previousX[i] = transforms.renderX[i] = x;
+        transforms.y[i] = transforms.previousY[i] = transforms.renderY[i] = y;
+    }
+    void setX(float x) { setPosition(x, getY()); }
+    void setY(float y) { setPosition(getX(), y); }
+    void setSize(float width, float height)
+    {
+        int i = slot();
+        store->getTransforms().width[i] = width;
+        store->getTransforms().height[i] = height;
+    }
+    void setVelocityX(float velocityX) { store->getVelocities().x[slot()] = velocityX; }
+    void setVelocityY(float velocityY) { store->getVelocities().y[slot()] = velocityY; }
+    void setMaxSpeed(float speed) { store->getVelocities().maxSpeed[slot()] = speed; }
+    void setSprite(Sprites *sprite) { store->getSprites().sprites[slot()] = sprite; }
 
     // Core Methods
     virtual void update(float dt) = 0; // Must be implemented by derived classes
@@ -0,0 +1,23 @@
+#pragma once
+
+#ifndef ENTITY_POOLS_H
+#define ENTITY_POOLS_H
+
+#include "utils/pool.h"
+#include "utils/camera.h"
+#include "utils/collision.h"
+#include "utils/sprite.h"
+
+/**
+    Pools for the parts of an entity that are whole objects rather than plain data in
+    the ComponentStore. An entity takes what it needs out of these when it spawns and
+    hands it back when it goes, so spawning / despawning doesnt go through new / delete.
+**/
+struct EntityPools
+{
+    Pool<Collision> collisions;
+    Pool<Camera> cameras;
+    Pool<Sprites> sprites;
+};
+
+#endif
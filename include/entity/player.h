@@ -11,9 +11,13 @@
 #include <SDL_image.h>
 #include <iostream>
 #include "Vec2.h"
+#include "utils/fixed.h"
+#include "net/client_prediction.h"
 #include "comfy_lib.h"
 #include "debug_gui.h"
 
+struct EntityPools;
+
 class Player : public Entity
 {
 public:
@@ -31,32 +35,47 @@ private:
     int             maxHealth;
     PlayerState     state;
 
-    float           width;
-    float           height;
-    Vec2            position;
-    Vec2            velocity;
+    // Position, size, velocity, max speed and sprite are in the ComponentStore (see Entity)
+    float           stepSeconds;
+    // Draw (and follow with the camera) where the freshest input would put us instead
+    bool            predictRender;
     float           acceleration;
-    float           maxSpeed;
     float           friction;
     bool            keysPressed[4]; // Track W,A,S,D states
     float           playerScale;
+#if defined(COMFY_DETERMINISTIC)
+    // The real position / velocity, the store has float copies (see moveFixed)
+    FixedVec2       simPosition;
+    FixedVec2       simVelocity;
+    float           syncedX;
+    float           syncedY;
+    bool moveFixed();
+#else
+    bool moveFloat(float dt);
+#endif
+    // Connected to a server, we move with its BodyMovement and it corrects us (see reconcile)
+    bool            networked;
+    ClientPrediction prediction;
+    bool movePredicted();
+    // The predicted body into the store
+    void writePredicted();
 
-    // Tools The Player Needs
+    // Tools The Player Needs, collision / camera / sprites come out of the EntityPools
     TSDL_TileMap    *tileMap;
+    EntityPools     *pools;
+    PoolHandle      collisionHandle;
+    PoolHandle      cameraHandle;
+    PoolHandle      spritesHandle;
     Collision       *collision;
     Camera          *camera;
-    Sprites         *sprite;
 
     SDL_Renderer    *renderer;
 
 public:
-    Player();
+    Player(ComponentStore *store, EntityPools *pools);
+    ~Player() override;
 
     // Getters
-    float getX() override;
-    float getY() override;
-    float getWidth() override;
-    float getHeight() override;
     int getHealth();
     int getDamage();
     int getLevel();
@@ -64,45 +83,49 @@ public:
     int getMaxHealth();
     SDL_Renderer *getRenderer();
     float getAcceleration();
-    float getMaxSpeed() override;
     float getFriction();
-    float getVelocityX();
-    float getVelocityY();
     Collision *getCollision();
     Camera *getCamera();
-    Sprites *getSprite() override;
     TSDL_TileMap *getTileMap();
     PlayerState getState();
     float getPlayerScale();
+    bool getPredictRender();
+    bool getNetworked();
+    const ClientPrediction &getPrediction();
+    // SERVER_KEY_* bits for the keys held
+    uint8_t getNetKeys();
+    // Our tuning, collider and map as the server's movement, what prediction runs
+    BodyMovement getBodyMovement();
 
     // Setters
-    void setX(float x);
-    void setY(float y);
     void setHealth(int health);
     void setDamage(int damage);
     void setLevel(int level);
     void setExperience(int experience);
     void setMaxHealth(int maxHealth);
-    void setRenderer(SDL_Renderer *renderer) override;
-    void setSpeed(int speed);
+    void setRenderer(SDL_Renderer *renderer);
     void setAcceleration(float acceleration);
-    void setMaxSpeed(float maxSpeed) override;
     void setFriction(float friction);
-    void setVelocityX(float velocityX);
-    void setVelocityY(float velocityY);
-    void setCollision(Collision *collision);
-    void setCamera(Camera *camera);
     void setTileMap(TSDL_TileMap *tileMap);
     void setState(PlayerState state);
     void setPlayerScale(float scale);
-    void setSprite(Sprites *sprite) override;
+    void setPredictRender(bool predict);
+    // Starts (or stops) predicting, every update is then one input to send (getPrediction().makeInput())
+    void setNetworked(bool networked);
     // Methods
     void loadPlayer();
     void draw(float dt, float scale) override;
+    // 0 -> 1 between the last two ticks, see FixedTimestep::getAlpha
+    void updateRenderPosition(float alpha);
+    // Our body from a server state that included input acknowledgedSequence, see ClientPrediction::reconcile
+    void reconcile(uint32_t acknowledgedSequence, const BodyState &server);
 
     void handleInput(SDL_Event &event, float dt);
     void update(float dt) override;
-    bool isMoving();
+    Vec2 getInputDirection();
+#if defined(COMFY_DETERMINISTIC)
+    FixedVec2 getInputDirectionFixed();
+#endif
 };
 
 #endif
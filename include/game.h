@@ -20,6 +20,16 @@ This File is a protype for my library for loading a tiled map
 
 #include "TSDL.h"
 #include "entity/player.h"
+#include "entity/entity_pools.h"
+#include "utils/spatial_hash.h"
+#include "utils/aabb_simd.h"
+#include "utils/fixed_timestep.h"
+#include "utils/frame_pacer.h"
+#include "utils/input_latency.h"
+#include "utils/job_system.h"
+#include "net/net_transport.h"
+#include "net/snapshot.h"
+#include "net/interpolation.h"
 
 
 class Game 
@@ -40,11 +50,56 @@ private:
     std::vector<SDL_Texture*>   fontNumbers;
 
     /** 
-        Game Entities
+        Worker threads, the entity systems split their loops across these
     **/
+    JobSystem       jobs;
+
+    /** 
+        Game Entities (all their data lives in the component store, their objects in
+        the pools). Players are declared last so they go before what they point into
+    **/
+    ComponentStore  components;
+    EntityPools     pools;
+    Pool<Player>    players;
+    PoolHandle      playerHandle;
     Player          *player;
     TSDL_TileMap    *map;
 
+    /** 
+        Entity vs Entity Broadphase (rebuilt every tick)
+    **/
+    SpatialHash                 broadphase;
+    std::vector<AABB>           entityBounds;
+    std::vector<BroadphasePair> entityPairs;
+
+    /** 
+        Entity Culling (bit i set = entityBounds[i] / store slot i is on screen)
+    **/
+    AABBArray                   entityBoxes;
+    std::vector<uint32_t>       visibleEntities;
+
+    /** 
+        Simulation runs in fixed ticks, rendering interpolates between the last two
+    **/
+    FixedTimestep               timestep;
+    FramePacer                  framePacer;
+    InputLatency                inputLatency;
+
+    /** 
+        Server connection (connect), the player predicts its own body and the states
+        coming back correct it. Everyone else is drawn a little in the past between
+        the states either side (remoteBodies). Not connected is single player like before
+    **/
+    NetClient                   net;
+    SnapshotRing                receivedStates;
+    Snapshot                    stateScratch;
+    StateMessage                state;
+    uint32_t                    lastStateTick;
+    bool                        hasState;
+    InterpolationBuffer         remoteBodies;
+    // Last view size the server was told, it only sends us the bodies around that
+    ViewMessage                 sentView;
+
     float   gameScale;
 
     void initWindow();
@@ -55,6 +110,13 @@ private:
     void loadFontNumbers();
     void renderGui();
     void drawMap();
+    void drawRemoteBodies();
+    void updateBroadphase();
+    void pollInput(float dt);
+    void simulate(float dt);
+    void pollNetwork();
+    void sendInput();
+    void cullEntities();
 
     void initGui();
 
@@ -65,6 +127,8 @@ private:
     int viewportHeight = 500;
 public:
     Game();
+    // host:port of a ComfyServer to play on, before start_game
+    bool connect(const std::string &address);
     void start_game();
 };
 
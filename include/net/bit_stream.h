@@ -0,0 +1,164 @@
+#pragma once
+
+#ifndef NET_BIT_STREAM_H
+#define NET_BIT_STREAM_H
+
+#include <cstdint>
+#include "utils/fixed.h"
+
+// Bits needed to hold every value in [0, range]
+constexpr int bitsRequired(uint32_t range)
+{
+    int bits = 0;
+    while (bits < 32 && (range >> bits) != 0) bits++;
+    return bits;
+}
+
+/**
+    Value -> steps on the wire, shared by BitWriter and the codecs in net_schema.h so a
+    codec with its range baked in sends exactly what the runtime version would
+**/
+inline uint32_t clampSteps(int64_t steps, uint32_t limit)
+{
+    if (steps < 0) return 0;
+    return steps > (int64_t)limit ? limit : (uint32_t)steps;
+}
+
+// Nearest 1 / stepsPerUnit above min, NaN goes to min
+inline uint32_t floatToSteps(float value, float min, int stepsPerUnit, uint32_t limit)
+{
+    float scaled = (value - min) * (float)stepsPerUnit + 0.5f;
+    if (!(scaled >= 0.0f)) return 0;
+    return scaled >= (float)limit ? limit : (uint32_t)scaled;
+}
+
+// Nearest 2^-fractionBits above min (whole units), >> floors so half a step goes on first
+inline uint32_t fixedToSteps(Fixed value, int32_t min, int fractionBits, uint32_t limit)
+{
+    const int shift = FIXED_FRACTION_BITS - fractionBits;
+    int64_t offset = (int64_t)value.raw - (int64_t)min * FIXED_ONE;
+    int64_t steps = shift > 0 ? (offset + ((int64_t)1 << (shift - 1))) >> shift : offset;
+    return clampSteps(steps, limit);
+}
+
+inline Fixed stepsToFixed(uint32_t steps, int32_t min, int fractionBits)
+{
+    return Fixed::fromRaw((int32_t)((int64_t)min * FIXED_ONE + ((int64_t)steps << (FIXED_FRACTION_BITS - fractionBits))));
+}
+
+/**
+    Writes values with exactly as many bits as they need into a byte buffer, least
+    significant bit first, so the first 8 bits written end up in byte 0
+
+    Bits collect in a 64 bit scratch and go out 32 at a time. Running past capacity
+    sets overflow and stops writing, check it once at the end like ByteWriter. Call
+    flush before sending, getBytes is the size to send after that
+**/
+class BitWriter
+{
+private:
+    uint8_t *data;
+    int capacity;
+    uint64_t scratch = 0;
+    int scratchBits = 0;
+    int bytesFlushed = 0;
+    int bitsWritten = 0;
+    bool overflow = false;
+
+    void flushWord();
+
+public:
+    BitWriter(uint8_t *data, int capacity) : data(data), capacity(capacity) {}
+
+    // 0 - 32 bits of value, anything above them has to be 0
+    void writeBits(uint32_t value, int bits)
+    {
+        if (bits <= 0) return;
+        if (overflow || bitsWritten + bits > capacity * 8)
+        {
+            overflow = true;
+            return;
+        }
+        scratch |= (uint64_t)value << scratchBits;
+        scratchBits += bits;
+        bitsWritten += bits;
+        if (scratchBits >= 32) flushWord();
+    }
+    void writeBool(bool value) { writeBits(value ? 1 : 0, 1); }
+    // Clamps into [min, max] first
+    void writeRangedInt(int32_t value, int32_t min, int32_t max);
+    // 7 bits at a time with a continue bit, small numbers stay small (0 - 127 is 8 bits)
+    void writeVarint(uint32_t value);
+    // Zigzag so small negatives stay small too
+    void writeSignedVarint(int32_t value);
+    // Rounded to the nearest step of 2^-fractionBits in [min, max] (whole units)
+    void writeFixed(Fixed value, int32_t min, int32_t max, int fractionBits);
+    // Rounded to the nearest 1 / stepsPerUnit in [min, max]
+    void writeQuantizedFloat(float value, float min, float max, int stepsPerUnit);
+    // Whatever is left in the scratch out to the buffer (padded to a byte)
+    void flush();
+
+    // Getters
+    int getBitsWritten() const { return bitsWritten; }
+    int getBitsRemaining() const { return capacity * 8 - bitsWritten; }
+    // Whole bytes the written bits take, valid after flush
+    int getBytes() const { return (bitsWritten + 7) / 8; }
+    bool hasOverflowed() const { return overflow; }
+    const uint8_t *getData() const { return data; }
+};
+
+/**
+    Reads what BitWriter wrote, with the same ranges / bit counts. Reading past the end
+    sets overflow and hands back 0s so a short packet can be read through and dropped
+**/
+class BitReader
+{
+private:
+    const uint8_t *data;
+    int size;
+    uint64_t scratch = 0;
+    int scratchBits = 0;
+    int bytesRead = 0;
+    int bitsRead = 0;
+    bool overflow = false;
+
+    void refill(int bits);
+
+public:
+    BitReader(const uint8_t *data, int size) : data(data), size(size) {}
+
+    uint32_t readBits(int bits)
+    {
+        if (bits <= 0) return 0;
+        if (overflow || bitsRead + bits > size * 8)
+        {
+            overflow = true;
+            return 0;
+        }
+        if (scratchBits < bits) refill(bits);
+        uint32_t value = (uint32_t)(scratch & ((1ull << bits) - 1));
+        scratch >>= bits;
+        scratchBits -= bits;
+        bitsRead += bits;
+        return value;
+    }
+    bool readBool() { return readBits(1) != 0; }
+    int32_t readRangedInt(int32_t min, int32_t max);
+    uint32_t readVarint();
+    int32_t readSignedVarint();
+    Fixed readFixed(int32_t min, int32_t max, int fractionBits);
+    float readQuantizedFloat(float min, float max, int stepsPerUnit);
+
+    // Getters
+    int getBitsRead() const { return bitsRead; }
+    int getBitsRemaining() const { return size * 8 - bitsRead; }
+    bool hasOverflowed() const { return overflow; }
+};
+
+/**
+    Fixed values snapped onto the grid writeFixed sends, so whoever sends can keep
+    exactly what the other end will read
+**/
+Fixed quantizeFixed(Fixed value, int32_t min, int32_t max, int fractionBits);
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef NET_BODY_MOVEMENT_H
+#define NET_BODY_MOVEMENT_H
+
+#include <cstdint>
+#include "net/net_messages.h"
+#include "utils/collision_grid.h"
+#include "utils/fixed.h"
+#include "utils/movement_simd.h"
+
+// Same as the player's MAX_SLIDE_ITERATIONS
+#define BODY_SLIDE_ITERATIONS 3
+
+/**
+    One tick of a player body the way the server moves it: keys to a direction,
+    MovementKernels::stepVelocityFixed, FixedCollision::moveAndSlide and then the snap
+    onto the 1/256 grid StateMessage sends. The server steps every body with this and a
+    client predicting its own body runs the exact same thing, so with the same keys
+    and tuning both ends land on the same bits
+**/
+struct BodyMovement
+{
+    FixedMovementParams params;
+    Fixed maxSpeed = Fixed::fromInt(400);
+    // Collision box relative to the body position
+    FixedAABB collider;
+    // nullptr, everything is walkable
+    const CollisionGrid *grid = nullptr;
+
+    static BodyMovement make(Fixed acceleration, Fixed friction, Fixed maxSpeed, const FixedAABB &collider,
+                             const CollisionGrid *grid);
+
+    // Moves position / velocity on a tick holding keys, returns true if it hit something
+    bool step(uint8_t keys, FixedVec2 &position, FixedVec2 &velocity) const;
+
+    // Unit direction the keys ask for, diagonals normalised like the player's input
+    static FixedVec2 directionFromKeys(uint8_t keys);
+    /**
+        What the wire can carry, velocity rounds towards 0 first or friction could never
+        take the last step off it
+    **/
+    static void snapToWire(FixedVec2 &position, FixedVec2 &velocity);
+};
+
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+#ifndef NET_CLIENT_PREDICTION_H
+#define NET_CLIENT_PREDICTION_H
+
+#include <cstdint>
+#include "net/body_movement.h"
+#include "net/net_messages.h"
+
+// About 2 s of inputs at SIM_TICK_RATE, more than that unacked and the oldest ones just dont get replayed
+#define PREDICTION_HISTORY 128
+
+/**
+    One of our inputs and where predicting it left our body
+**/
+struct PredictedInput
+{
+    uint32_t sequence = 0;
+    uint8_t keys = 0;
+    FixedVec2 position;
+    FixedVec2 velocity;
+};
+
+/**
+    Client side prediction of the body we control
+
+    Every tick we move our own body straight away with the keys we are sending
+    (predict) instead of waiting a round trip for the server to, and keep the input and
+    the result. States from the server say which input they include (lastInputSequence),
+    reconcile compares where we had ourselves after that input with where the server
+    has us. Same means everything after it still holds, different (a lost input, a tick
+    the server ran without one, something we didnt know about) and we take the
+    server's body and replay every input it hasnt seen yet on top of it.
+
+    The movement is BodyMovement on both ends so without anything going wrong a
+    prediction is bit for bit what the server ends up with and corrections stay at 0.
+    No SDL in here, the game's Player and the headless BotClient both use it
+**/
+class ClientPrediction
+{
+private:
+    PredictedInput inputs[PREDICTION_HISTORY];
+    // Newest input we predicted, 0 before the first
+    uint32_t newestSequence = 0;
+    // Newest input the server told us it applied
+    uint32_t acknowledgedSequence = 0;
+    // Position / velocity only mean something once the first state came in
+    bool hasState = false;
+    FixedVec2 position;
+    FixedVec2 velocity;
+
+    // Stats
+    uint64_t statesChecked = 0;
+    uint64_t corrections = 0;
+    uint64_t inputsReplayed = 0;
+    double totalCorrection = 0.0;
+    float lastCorrection = 0.0f;
+    float maxCorrection = 0.0f;
+
+    void replayFrom(const BodyMovement &movement, uint32_t firstSequence);
+
+public:
+    void reset();
+
+    /**
+        Runs input sequence (one more than the last) from the predicted body and keeps it.
+        Before the first state only the keys get kept, reconcile replays them once we
+        know where we are. Returns true if the move hit something
+    **/
+    bool predict(const BodyMovement &movement, uint32_t sequence, uint8_t keys);
+    /**
+        The server's body for us after it applied acknowledgedSequence. Returns true if
+        the prediction was off and got rewound and replayed (position / velocity moved)
+    **/
+    bool reconcile(const BodyMovement &movement, uint32_t acknowledgedSequence, const BodyState &server);
+
+    // Keys we predicted sequence with, 0 if it fell out of the history
+    uint8_t getKeys(uint32_t sequence) const;
+    // The newest input and the ones before it, what goes out to the server
+    InputMessage makeInput() const;
+
+    // Getters
+    bool getHasState() const { return hasState; }
+    const FixedVec2 &getPosition() const { return position; }
+    const FixedVec2 &getVelocity() const { return velocity; }
+    uint32_t getNewestSequence() const { return newestSequence; }
+    uint32_t getAcknowledgedSequence() const { return acknowledgedSequence; }
+    // Inputs sent the server hasnt applied yet (about a round trip of them)
+    uint32_t getPendingCount() const { return newestSequence - acknowledgedSequence; }
+    uint64_t getStatesChecked() const { return statesChecked; }
+    uint64_t getCorrections() const { return corrections; }
+    uint64_t getInputsReplayed() const { return inputsReplayed; }
+    // How far a correction moved us in px, the newest, the biggest and the average
+    float getLastCorrection() const { return lastCorrection; }
+    float getMaxCorrection() const { return maxCorrection; }
+    float getAverageCorrection() const { return corrections > 0 ? (float)(totalCorrection / corrections) : 0.0f; }
+};
+
+#endif
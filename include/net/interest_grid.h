@@ -0,0 +1,109 @@
+#pragma once
+
+#ifndef NET_INTEREST_GRID_H
+#define NET_INTEREST_GRID_H
+
+#include <cstdint>
+#include <vector>
+#include "net/net_messages.h"
+
+// A cell is this many map tiles each way (128 px on 16 px tiles), about a quarter of a view
+#define INTEREST_CELL_TILES 8
+// Cells per axis never go over this, a huge spread of bodies gets bigger cells instead
+#define INTEREST_MAX_CELLS_PER_AXIS 1024
+
+// World px, max is exclusive
+struct InterestRect
+{
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+
+    bool contains(float x, float y) const { return x >= minX && x < maxX && y >= minY && y < maxY; }
+    InterestRect grow(float amount) const { return {minX - amount, minY - amount, maxX + amount, maxY + amount}; }
+};
+
+/**
+    Body ids bucketed by where they are, for the server to work out which bodies each
+    client can see. Cells line up with the map's tiles (INTEREST_CELL_TILES of them),
+    the grid covers exactly the bodies it was built from.
+
+    rebuild is a counting sort, two passes over the bodies and no allocation once the
+    vectors have grown, so rebuilding it every tick is cheaper than keeping it up to
+    date as bodies move. A query walks the cells under a rect and tests the bodies in
+    them, cost is the bodies near the rect and not all of them
+**/
+class InterestGrid
+{
+private:
+    struct Entry
+    {
+        uint16_t id;
+        float x, y;
+    };
+
+    float tileWidth = 16.0f;
+    float tileHeight = 16.0f;
+    float cellWidth = 16.0f * INTEREST_CELL_TILES;
+    float cellHeight = 16.0f * INTEREST_CELL_TILES;
+    float originX = 0.0f;
+    float originY = 0.0f;
+    int columns = 0;
+    int rows = 0;
+    // Entries of cell c are entries[cellStart[c]] up to entries[cellStart[c + 1]]
+    std::vector<int> cellStart;
+    std::vector<Entry> entries;
+    std::vector<int> cellOf;
+
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+public:
+    // The map's tile size, cells are INTEREST_CELL_TILES of these
+    void setTileSize(int tileWidth, int tileHeight);
+    void rebuild(const std::vector<BodyState> &bodies);
+    // Appends the bodies whose position is inside rect (and where they are), in no particular order
+    void query(const InterestRect &rect, std::vector<uint16_t> &ids, std::vector<float> &xs, std::vector<float> &ys) const;
+
+    // Getters
+    int getColumns() const { return columns; }
+    int getRows() const { return rows; }
+    float getCellWidth() const { return cellWidth; }
+    float getCellHeight() const { return cellHeight; }
+};
+
+/**
+    What one client gets told about, the bodies in its view plus a margin, and what
+    changed since last time as enter / leave events
+
+    A body comes in once its inside the view grown by the margin and only goes again
+    once its outside that grown by hysteresis too, so something walking along the
+    edge doesnt flicker in and out (every time it comes back in it goes out in full).
+    Their own body is always in
+**/
+class InterestSet
+{
+private:
+    std::vector<uint16_t> visible;
+    std::vector<uint16_t> entered;
+    std::vector<uint16_t> left;
+    std::vector<uint16_t> candidates;
+    std::vector<float> candidateX;
+    std::vector<float> candidateY;
+    std::vector<uint16_t> next;
+
+public:
+    void clear();
+    // inner is the view plus margin, outer that plus the hysteresis. self gets in wherever it is (0xFFFF for none)
+    void update(const InterestGrid &grid, const InterestRect &inner, const InterestRect &outer, uint16_t self);
+
+    // Getters
+    // Sorted by id, what the next state should have
+    const std::vector<uint16_t> &getVisible() const { return visible; }
+    // Since the update before, both sorted
+    const std::vector<uint16_t> &getEntered() const { return entered; }
+    const std::vector<uint16_t> &getLeft() const { return left; }
+};
+
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+
+#ifndef NET_INTERPOLATION_H
+#define NET_INTERPOLATION_H
+
+#include <cstdint>
+#include <vector>
+#include "net/net_messages.h"
+
+// States kept per entity, a quarter second at SIM_TICK_RATE which is more than the delay ever gets
+#define INTERPOLATION_HISTORY 16
+// How far past the newest state we keep going on its velocity before holding still (about 100 ms)
+#define INTERPOLATION_MAX_EXTRAPOLATION_TICKS 6.0
+// The delay never goes under one tick (we need a state on each side) or over this many
+#define INTERPOLATION_MIN_DELAY_TICKS 1.0
+#define INTERPOLATION_MAX_DELAY_TICKS 8.0
+// Delay is this many times the measured jitter on top of the minimum
+#define INTERPOLATION_JITTER_SCALE 3.0
+// How quickly the delay follows a new target, in delay ticks per tick of wall clock (10% slower / faster)
+#define INTERPOLATION_DELAY_SLEW 0.1
+
+/**
+    Where a remote entity should be drawn this frame
+**/
+struct InterpolatedBody
+{
+    float x = 0.0f;
+    float y = 0.0f;
+    float velocityX = 0.0f;
+    float velocityY = 0.0f;
+    // Past the newest state we have, going on its velocity (or holding after INTERPOLATION_MAX_EXTRAPOLATION_TICKS)
+    bool extrapolating = false;
+};
+
+/**
+    The render clock for everything remote, server ticks as a double
+
+    States leave the server once a tick but arrive whenever the network gets them
+    there. Each arrival is compared with when its tick would have arrived on a perfect
+    link: the earliest one seen is the baseline (it creeps back up slowly so a route
+    getting slower doesnt leave us stuck), how late the rest are on average is the
+    jitter. We draw delay ticks behind the baseline where delay is enough to cover
+    that jitter, so there is nearly always a state on both sides of what we draw.
+    The delay slides towards its target instead of jumping so nothing visibly speeds
+    up or slows down, and the render tick never goes backwards
+**/
+class InterpolationClock
+{
+private:
+    bool hasBaseline = false;
+    // Arrival seconds - tick seconds of the earliest state
+    double baseline = 0.0;
+    // Average seconds past the baseline states arrive
+    double jitter = 0.0;
+    double delayTicks = INTERPOLATION_MIN_DELAY_TICKS + 1.0;
+    double lastNow = 0.0;
+    double renderTick = 0.0;
+
+public:
+    void reset();
+    // A state for tick arrived at now (seconds)
+    void addState(uint32_t tick, double now);
+    // Moves the render tick on to now, call once a frame before sampling
+    double update(double now);
+
+    // Getters
+    bool getHasBaseline() const { return hasBaseline; }
+    double getRenderTick() const { return renderTick; }
+    double getDelayTicks() const { return delayTicks; }
+    double getTargetDelayTicks() const;
+    double getJitterMilliseconds() const { return jitter * 1000.0; }
+};
+
+/**
+    The last INTERPOLATION_HISTORY states of one remote entity, oldest overwritten.
+    sample walks a cursor forward as the render tick moves, so its a step or two at
+    most a frame instead of a search
+**/
+class EntityInterpolator
+{
+private:
+    struct Sample
+    {
+        uint32_t tick;
+        float x, y;
+        float velocityX, velocityY;
+    };
+    Sample samples[INTERPOLATION_HISTORY];
+    // Index of the newest sample, count of valid ones
+    int newest = -1;
+    int count = 0;
+    // Newer sample of the pair we last drew between, as an age (0 = newest)
+    int cursor = 0;
+
+    const Sample &at(int age) const { return samples[(newest - age + INTERPOLATION_HISTORY) % INTERPOLATION_HISTORY]; }
+
+public:
+    void clear();
+    // Older or same tick as the newest gets ignored
+    void push(uint32_t tick, const BodyState &body);
+    // Where to draw at renderTick, false if there is nothing to draw yet
+    bool sample(double renderTick, InterpolatedBody &out);
+
+    // Getters
+    bool isEmpty() const { return count == 0; }
+    uint32_t getNewestTick() const { return count > 0 ? at(0).tick : 0; }
+};
+
+/**
+    Every remote body from the server's states, one EntityInterpolator each by body id
+    with one InterpolationClock for all of them (they come in the same packets so they
+    have the same jitter). Bodies that stop showing up in states get dropped, a new
+    generation on an id starts that id over so a respawn doesnt slide across the map
+**/
+class InterpolationBuffer
+{
+private:
+    InterpolationClock clock;
+    std::vector<EntityInterpolator> entities;
+    std::vector<uint8_t> generations;
+    // Ids with a body right now, sorted
+    std::vector<uint16_t> active;
+    std::vector<uint16_t> scratch;
+    uint32_t newestTick = 0;
+    bool hasState = false;
+
+    // Stats
+    int extrapolatingCount = 0;
+    uint64_t samplesDrawn = 0;
+    uint64_t samplesExtrapolated = 0;
+
+public:
+    void clear();
+    // A state that arrived at now (seconds), skipId is the body we predict ourselves. Out of order ones are ignored
+    void addState(const StateMessage &state, double now, uint16_t skipId);
+    // Moves the clock, once a frame before sample
+    void update(double now);
+    // Where body id goes this frame
+    bool sample(uint16_t id, InterpolatedBody &out);
+
+    // Getters
+    const std::vector<uint16_t> &getActive() const { return active; }
+    const InterpolationClock &getClock() const { return clock; }
+    // Bodies sampled past their newest state since the last update
+    int getExtrapolatingCount() const { return extrapolatingCount; }
+    uint64_t getSamplesDrawn() const { return samplesDrawn; }
+    uint64_t getSamplesExtrapolated() const { return samplesExtrapolated; }
+};
+
+#endif
@@ -0,0 +1,185 @@
+#pragma once
+
+#ifndef NET_NET_CONNECTION_H
+#define NET_NET_CONNECTION_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "net/udp_socket.h"
+
+// First 4 bytes of every packet, anything else on the port gets ignored
+#define NET_PROTOCOL_ID 0x434D4659u  // "CMFY"
+// Biggest packet we build, stays under a typical MTU so nothing fragments
+#define NET_MAX_PACKET_BYTES 1200
+// protocol id + type (top bit says the ack is valid) + sequence + ack + ack bits
+#define NET_HEADER_BYTES 13
+// Set on the type byte when ack / ackBits mean something, no room for a type that big anyway
+#define NET_HEADER_HAS_ACK 0x80
+#define NET_MAX_PAYLOAD_BYTES (NET_MAX_PACKET_BYTES - NET_HEADER_BYTES)
+// Sent packets we remember for acks / rtt, has to be more than 32 (the ack bits)
+#define NET_SENT_HISTORY 256
+
+#define NET_TIMEOUT_SECONDS 5.0
+#define NET_KEEPALIVE_SECONDS 0.25
+#define NET_CONNECT_RETRY_SECONDS 0.1
+
+enum class PacketType : uint8_t
+{
+    CONNECT_REQUEST,    // client -> server, u64 salt
+    CONNECT_ACCEPT,     // server -> client, u64 salt, u16 client index
+    CONNECT_DENIED,     // server -> client, u64 salt (server full)
+    DISCONNECT,
+    KEEPALIVE,
+    PAYLOAD,            // game messages (see net_messages.h)
+    COUNT
+};
+
+// ==========================================================================================
+// Byte Streams, little endian whatever the machine is
+// ==========================================================================================
+/**
+    Writes into a fixed buffer, running past the end sets overflow and stops writing
+    instead of asserting, the caller checks it once at the end
+**/
+struct ByteWriter
+{
+    uint8_t *data;
+    int capacity;
+    int size = 0;
+    bool overflow = false;
+
+    ByteWriter(uint8_t *data, int capacity) : data(data), capacity(capacity) {}
+
+    void writeBytes(const void *bytes, int count)
+    {
+        if (overflow || size + count > capacity) { overflow = true; return; }
+        std::memcpy(data + size, bytes, (size_t)count);
+        size += count;
+    }
+    void writeU8(uint8_t value) { writeBytes(&value, 1); }
+    void writeU16(uint16_t value) { uint8_t b[2] = {(uint8_t)value, (uint8_t)(value >> 8)}; writeBytes(b, 2); }
+    void writeU32(uint32_t value) { writeU16((uint16_t)value); writeU16((uint16_t)(value >> 16)); }
+    void writeU64(uint64_t value) { writeU32((uint32_t)value); writeU32((uint32_t)(value >> 32)); }
+    void writeI32(int32_t value) { writeU32((uint32_t)value); }
+    int getRemaining() const { return capacity - size; }
+};
+
+/**
+    Reads out of a packet, reading past the end sets overflow and hands back 0s, so a
+    short / garbage packet can be read all the way through and thrown away at the end
+**/
+struct ByteReader
+{
+    const uint8_t *data;
+    int size;
+    int position = 0;
+    bool overflow = false;
+
+    ByteReader(const uint8_t *data, int size) : data(data), size(size) {}
+
+    bool readBytes(void *bytes, int count)
+    {
+        if (overflow || position + count > size) { overflow = true; std::memset(bytes, 0, (size_t)count); return false; }
+        std::memcpy(bytes, data + position, (size_t)count);
+        position += count;
+        return true;
+    }
+    uint8_t readU8() { uint8_t b = 0; readBytes(&b, 1); return b; }
+    uint16_t readU16() { uint8_t b[2]; readBytes(b, 2); return (uint16_t)(b[0] | (b[1] << 8)); }
+    uint32_t readU32() { uint32_t low = readU16(); return low | ((uint32_t)readU16() << 16); }
+    uint64_t readU64() { uint64_t low = readU32(); return low | ((uint64_t)readU32() << 32); }
+    int32_t readI32() { return (int32_t)readU32(); }
+    int getRemaining() const { return size - position; }
+};
+
+// ==========================================================================================
+// Sequence numbers, 16 bit and wrapping
+// ==========================================================================================
+// a is newer than b, works across the wrap as long as they are less than half the range apart
+inline bool sequenceGreaterThan(uint16_t a, uint16_t b)
+{
+    return ((a > b) && (a - b <= 32768)) || ((a < b) && (b - a > 32768));
+}
+
+struct PacketHeader
+{
+    PacketType type = PacketType::PAYLOAD;
+    uint16_t sequence = 0;
+    // Newest sequence we got from the other side, bit n of ackBits is ack - 1 - n
+    uint16_t ack = 0;
+    uint32_t ackBits = 0;
+    // False until we got anything from them, ack is just 0 then and acks nothing
+    bool hasAck = false;
+
+    void write(ByteWriter &writer) const;
+    // False if it isnt one of ours
+    bool read(ByteReader &reader);
+};
+
+/**
+    One end of a connection: sequence numbers going out, what came in, and which of
+    our packets the other side has acked
+
+    Every packet carries ack + 32 ack bits, so each ack is repeated in the next 32
+    packets and losing a few doesnt lose the ack. Nothing gets resent, whoever sends
+    uses the acks to pick what to send next (delta baselines, resending inputs, ...)
+**/
+class NetConnection
+{
+private:
+    struct SentPacket
+    {
+        uint16_t sequence = 0;
+        bool valid = false;
+        bool acked = false;
+        double sendTime = 0.0;
+    };
+
+    NetAddress address;
+    uint16_t localSequence = 0;
+    uint16_t remoteSequence = 0;
+    uint32_t receivedBits = 0;
+    bool receivedAny = false;
+    SentPacket sent[NET_SENT_HISTORY];
+    std::vector<uint16_t> newAcks;
+
+    double lastSendTime = 0.0;
+    double lastReceiveTime = 0.0;
+
+    // Stats
+    float roundTripMilliseconds = 0.0f;
+    uint64_t packetsSent = 0;
+    uint64_t packetsReceived = 0;
+    uint64_t packetsAcked = 0;
+    uint64_t packetsLost = 0;
+
+    void ackSequence(uint16_t sequence, double now);
+
+public:
+    NetConnection() = default;
+    void reset(const NetAddress &address, double now);
+
+    // Fills in sequence / ack / ackBits for the next packet, call right before sending it
+    PacketHeader nextHeader(PacketType type, double now);
+    // False for duplicates and anything too old, the packet should be dropped then
+    bool processHeader(const PacketHeader &header, double now);
+    // Sequences the other side acked since last time, moves them into out
+    void takeAcks(std::vector<uint16_t> &out);
+
+    bool hasTimedOut(double now, double timeout) const { return now - lastReceiveTime > timeout; }
+    bool needsKeepalive(double now) const { return now - lastSendTime > NET_KEEPALIVE_SECONDS; }
+
+    // Getters
+    const NetAddress &getAddress() const { return address; }
+    uint16_t getLocalSequence() const { return localSequence; }
+    uint16_t getRemoteSequence() const { return remoteSequence; }
+    float getRoundTripMilliseconds() const { return roundTripMilliseconds; }
+    uint64_t getPacketsSent() const { return packetsSent; }
+    uint64_t getPacketsReceived() const { return packetsReceived; }
+    uint64_t getPacketsAcked() const { return packetsAcked; }
+    // Fell out of the ack window without being acked
+    uint64_t getPacketsLost() const { return packetsLost; }
+};
+
+#endif
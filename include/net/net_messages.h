@@ -0,0 +1,143 @@
+#pragma once
+
+#ifndef NET_NET_MESSAGES_H
+#define NET_NET_MESSAGES_H
+
+#include <cstdint>
+#include <vector>
+#include "net/net_connection.h"
+#include "net/net_schema.h"
+#include "utils/fixed.h"
+
+// Every payload starts with one of these
+enum class MessageType : uint8_t
+{
+    INPUT,  // client -> server, keys held this tick
+    STATE,  // server -> client, the world after a tick
+    VIEW,   // client -> server, how much of the world it shows
+    COUNT
+};
+
+// Held keys, one bit each (what a client sends every tick)
+#define SERVER_KEY_UP       1
+#define SERVER_KEY_DOWN     2
+#define SERVER_KEY_LEFT     4
+#define SERVER_KEY_RIGHT    8
+#define SERVER_KEY_ALL      (SERVER_KEY_UP | SERVER_KEY_DOWN | SERVER_KEY_LEFT | SERVER_KEY_RIGHT)
+
+// Earlier ticks' keys every input repeats, a lost packet's keys still show up in the next one
+#define INPUT_MESSAGE_REDUNDANCY 3
+
+/**
+    Keys a client held for one of its ticks (SERVER_KEY_* bits). sequence goes up by
+    one every tick so the server can ignore late ones and tell the client which input
+    the state it sends back already includes. previousKeys are sequence - 1, - 2, ...
+    (4 bits each, cheaper than a resend)
+**/
+struct InputMessage
+{
+    uint32_t sequence = 0;
+    uint8_t keys = 0;
+    uint8_t previousKeys[INPUT_MESSAGE_REDUNDANCY] = {};
+
+    void write(BitWriter &writer) const;
+    bool read(BitReader &reader);
+};
+
+/**
+    How big a client's view of the world is in world px (the viewport over the zoom),
+    the server sends it the bodies in that much around its own body. Sent now and
+    again rather than every tick, a lost one just means the old size a bit longer
+**/
+struct ViewMessage
+{
+    uint16_t width = 0;
+    uint16_t height = 0;
+
+    void write(BitWriter &writer) const;
+    bool read(BitReader &reader);
+};
+
+/**
+    One body in a state message, id is its index in the server's body pool, generation
+    the low bits of its handle generation so a reused index reads as a new body
+**/
+struct BodyState
+{
+    uint16_t id = 0;
+    uint8_t generation = 0;
+    FixedVec2 position;
+    FixedVec2 velocity;
+};
+
+// 1/256 px in a 32768 px world (23 bits), 1/256 px/s up to 1024 px/s (19 bits)
+using BodyPositionCodec = FixedVec2Codec<FixedCodec<-8192, 24575, 8>>;
+using BodyVelocityCodec = FixedVec2Codec<FixedCodec<-1024, 1023, 8>>;
+
+// 108 bits a body against 20 bytes as raw Fixed
+using BodyStateSchema = NetSchema<BodyState,
+                                  NetField<&BodyState::id, RangedIntCodec<0, 0xFFFF>>,
+                                  NetField<&BodyState::generation, BitsCodec<8>>,
+                                  NetField<&BodyState::position, BodyPositionCodec>,
+                                  NetField<&BodyState::velocity, BodyVelocityCodec>>;
+
+struct Snapshot;
+class SnapshotRing;
+
+// type + tick + last input + your id + your generation + baseline flag and sequence + removed count
+#define STATE_MESSAGE_HEADER_BITS (8 + 32 + 32 + 16 + 8 + 1 + 16 + 40)
+// Most removed ids in one state, the rest go next time
+#define STATE_MAX_REMOVED 32
+// Worst case for one body: id delta + new flag + the larger of a new body and 4 changed fields
+#define STATE_NEW_BODY_MAX_BITS (40 + 1 + 8 + BodyPositionCodec::maxBits + BodyVelocityCodec::maxBits)
+#define STATE_CHANGED_BODY_MAX_BITS (40 + 1 + 4 + 4 * 40)
+#define STATE_BODY_MAX_BITS (STATE_NEW_BODY_MAX_BITS > STATE_CHANGED_BODY_MAX_BITS ? STATE_NEW_BODY_MAX_BITS : STATE_CHANGED_BODY_MAX_BITS)
+
+/**
+    The world as the server has it after tick, as a delta against a snapshot the client
+    already has (the newest one it acked, see SnapshotRing) or against nothing
+
+    - ids the baseline has that are gone now
+    - then each body that is new (or has a new generation) in full, or that changed
+      with a mask of which of position x / y, velocity x / y did, each as a varint of
+      wire steps. Positions are against where the baseline's velocity would have put
+      them, so a body that stopped or kept going in a straight line costs nothing
+    - a 0 bit after the last one
+
+    No baseline makes every body new, thats the full state (first packet, or nothing
+    acked for a whole ring after loss). Bodies that dont fit stay as they were in the
+    baseline and go out in a later state.
+
+    Positions and velocities go out at 1/256, the server snaps its bodies onto that grid
+    every tick (ComfyServer::stepBody) so the client still ends up exactly where the
+    server is
+**/
+struct StateMessage
+{
+    uint32_t tick = 0;
+    // Newest InputMessage::sequence from this client the server had applied
+    uint32_t lastInputSequence = 0;
+    // The body this client controls
+    uint16_t yourId = 0xFFFF;
+    uint8_t yourGeneration = 0;
+    // Every body the client should have, sorted by id
+    std::vector<BodyState> bodies;
+    // Read came in as a delta (stats)
+    bool wasDelta = false;
+
+    /**
+        What changed since baseline (nullptr for a full state). Our own body goes first,
+        then the rest from bodies[start] round, so with more changes than fit everyone
+        gets a turn. written gets exactly what the client will have after reading it
+    **/
+    void write(BitWriter &writer, const Snapshot *baseline, int start, Snapshot &written) const;
+    // Rebuilds bodies on top of the baseline from received, false if we dont have it (or the packet is bad)
+    bool read(BitReader &reader, const SnapshotRing &received);
+    // Bodies a full state has room for
+    static int maxBodiesPerPacket() { return (NET_MAX_PAYLOAD_BYTES * 8 - STATE_MESSAGE_HEADER_BITS - 1) / (STATE_NEW_BODY_MAX_BITS + 1); }
+};
+
+// MessageType of a payload without reading the rest, COUNT if it is empty / unknown
+MessageType peekMessageType(const uint8_t *payload, int size);
+
+#endif
@@ -0,0 +1,213 @@
+#pragma once
+
+#ifndef NET_NET_SCHEMA_H
+#define NET_NET_SCHEMA_H
+
+#include <cstdint>
+#include "net/bit_stream.h"
+
+/**
+    Compile time field schemas on top of BitWriter / BitReader
+
+    A codec says how one value goes on the wire, the most bits it can take and whether
+    two values come out the same on the wire (same, what deltas go by), a Field
+    ties a codec to a struct member and a Schema is the list of them in wire order:
+
+        using Schema = NetSchema<Thing,
+                                 NetField<&Thing::health, RangedIntCodec<0, 1023>>,
+                                 NetField<&Thing::state, EnumCodec<Thing::State, Thing::State::COUNT>>>;
+        Schema::write(writer, thing);
+
+    Everything is resolved at compile time so writing a struct is the same straight line
+    of writeBits calls as doing it by hand, and Schema::maxBits is a constant to size
+    packets with. Ranges are template arguments so both ends agree by construction
+
+    writeDelta / readDelta send the same thing against a baseline the other end already
+    has, one bit a field and the value only when it changed, so something standing
+    still costs a bit a field
+**/
+
+// ==========================================================================================
+// Codecs
+// ==========================================================================================
+struct BoolCodec
+{
+    static constexpr int maxBits = 1;
+    static void write(BitWriter &writer, bool value) { writer.writeBool(value); }
+    static void read(BitReader &reader, bool &value) { value = reader.readBool(); }
+    static bool same(bool a, bool b) { return a == b; }
+};
+
+template <int32_t Min, int32_t Max>
+struct RangedIntCodec
+{
+    static_assert(Min < Max, "empty range");
+    static constexpr uint32_t limit = (uint32_t)((int64_t)Max - Min);
+    static constexpr int maxBits = bitsRequired(limit);
+
+    template <typename V>
+    static void write(BitWriter &writer, V value) { writer.writeBits(clampSteps((int64_t)value - Min, limit), maxBits); }
+    template <typename V>
+    static void read(BitReader &reader, V &value) { value = (V)((int64_t)Min + clampSteps(reader.readBits(maxBits), limit)); }
+    template <typename V>
+    static bool same(V a, V b) { return clampSteps((int64_t)a - Min, limit) == clampSteps((int64_t)b - Min, limit); }
+};
+
+// The low Bits bits, anything above wraps off (generations, sequence numbers)
+template <int Bits>
+struct BitsCodec
+{
+    static_assert(Bits > 0 && Bits <= 32, "1 - 32 bits");
+    static constexpr int maxBits = Bits;
+
+    template <typename V>
+    static void write(BitWriter &writer, V value) { writer.writeBits((uint32_t)value & (uint32_t)((1ull << Bits) - 1), Bits); }
+    template <typename V>
+    static void read(BitReader &reader, V &value) { value = (V)reader.readBits(Bits); }
+    template <typename V>
+    static bool same(V a, V b) { return (((uint32_t)a ^ (uint32_t)b) & (uint32_t)((1ull << Bits) - 1)) == 0; }
+};
+
+// Unsigned, 8 bits up to 127 then 8 more per 7 bits
+struct VarintCodec
+{
+    static constexpr int maxBits = 40;
+
+    template <typename V>
+    static void write(BitWriter &writer, V value) { writer.writeVarint((uint32_t)value); }
+    template <typename V>
+    static void read(BitReader &reader, V &value) { value = (V)reader.readVarint(); }
+    template <typename V>
+    static bool same(V a, V b) { return (uint32_t)a == (uint32_t)b; }
+};
+
+struct SignedVarintCodec
+{
+    static constexpr int maxBits = 40;
+
+    template <typename V>
+    static void write(BitWriter &writer, V value) { writer.writeSignedVarint((int32_t)value); }
+    template <typename V>
+    static void read(BitReader &reader, V &value) { value = (V)reader.readSignedVarint(); }
+    template <typename V>
+    static bool same(V a, V b) { return (int32_t)a == (int32_t)b; }
+};
+
+// Enums numbered 0 to Count - 1, Count itself never goes out (4 values is 2 bits)
+template <typename E, E Count>
+struct EnumCodec
+{
+    static_assert((int64_t)Count > 1, "an enum with one value doesnt need sending");
+    static constexpr uint32_t limit = (uint32_t)Count - 1;
+    static constexpr int maxBits = bitsRequired(limit);
+
+    static void write(BitWriter &writer, E value) { writer.writeBits(clampSteps((int64_t)value, limit), maxBits); }
+    static void read(BitReader &reader, E &value) { value = (E)clampSteps(reader.readBits(maxBits), limit); }
+    static bool same(E a, E b) { return clampSteps((int64_t)a, limit) == clampSteps((int64_t)b, limit); }
+};
+
+// Floats in [Min, Max] rounded to 1 / StepsPerUnit
+template <int32_t Min, int32_t Max, int StepsPerUnit>
+struct QuantizedFloatCodec
+{
+    static_assert(Min < Max && StepsPerUnit > 0, "empty range");
+    static_assert((int64_t)(Max - Min) * StepsPerUnit <= UINT32_MAX, "more than 32 bits");
+    static constexpr uint32_t limit = (uint32_t)((int64_t)(Max - Min) * StepsPerUnit);
+    static constexpr int maxBits = bitsRequired(limit);
+
+    static void write(BitWriter &writer, float value) { writer.writeBits(floatToSteps(value, (float)Min, StepsPerUnit, limit), maxBits); }
+    static void read(BitReader &reader, float &value)
+    {
+        value = (float)Min + (float)clampSteps(reader.readBits(maxBits), limit) * (1.0f / StepsPerUnit);
+    }
+    // A value and what the other end read back for it are the same step
+    static bool same(float a, float b) { return floatToSteps(a, (float)Min, StepsPerUnit, limit) == floatToSteps(b, (float)Min, StepsPerUnit, limit); }
+};
+
+// Fixed in [Min, Max] rounded to 2^-FractionBits
+template <int32_t Min, int32_t Max, int FractionBits>
+struct FixedCodec
+{
+    static_assert(Min < Max && FractionBits >= 0 && FractionBits <= FIXED_FRACTION_BITS, "bad range");
+    static_assert(((int64_t)(Max - Min) << FractionBits) <= UINT32_MAX, "more than 32 bits");
+    static constexpr uint32_t limit = (uint32_t)((int64_t)(Max - Min) << FractionBits);
+    static constexpr int maxBits = bitsRequired(limit);
+    // One step in Fixed::raw units
+    static constexpr int32_t stepRaw = 1 << (FIXED_FRACTION_BITS - FractionBits);
+
+    static void write(BitWriter &writer, Fixed value) { writer.writeBits(fixedToSteps(value, Min, FractionBits, limit), maxBits); }
+    static void read(BitReader &reader, Fixed &value) { value = stepsToFixed(clampSteps(reader.readBits(maxBits), limit), Min, FractionBits); }
+    // What the other end reads back for value
+    static Fixed quantize(Fixed value) { return stepsToFixed(fixedToSteps(value, Min, FractionBits, limit), Min, FractionBits); }
+    // Where value is on the wire grid, for deltas between two values
+    static uint32_t toSteps(Fixed value) { return fixedToSteps(value, Min, FractionBits, limit); }
+    static Fixed fromSteps(int64_t steps) { return stepsToFixed(clampSteps(steps, limit), Min, FractionBits); }
+    static bool same(Fixed a, Fixed b) { return toSteps(a) == toSteps(b); }
+};
+
+// Both halves of a FixedVec2 through the same codec
+template <typename Codec>
+struct FixedVec2Codec
+{
+    using Axis = Codec;
+    static constexpr int maxBits = Codec::maxBits * 2;
+
+    static void write(BitWriter &writer, const FixedVec2 &value)
+    {
+        Codec::write(writer, value.x);
+        Codec::write(writer, value.y);
+    }
+    static void read(BitReader &reader, FixedVec2 &value)
+    {
+        Codec::read(reader, value.x);
+        Codec::read(reader, value.y);
+    }
+    static FixedVec2 quantize(const FixedVec2 &value) { return FixedVec2(Codec::quantize(value.x), Codec::quantize(value.y)); }
+    static bool same(const FixedVec2 &a, const FixedVec2 &b) { return Codec::same(a.x, b.x) && Codec::same(a.y, b.y); }
+};
+
+// ==========================================================================================
+// Schemas
+// ==========================================================================================
+template <auto Member, typename Codec>
+struct NetField
+{
+    static constexpr int maxBits = Codec::maxBits;
+
+    template <typename T>
+    static void write(BitWriter &writer, const T &object) { Codec::write(writer, object.*Member); }
+    template <typename T>
+    static void read(BitReader &reader, T &object) { Codec::read(reader, object.*Member); }
+
+    template <typename T>
+    static void writeDelta(BitWriter &writer, const T &object, const T &baseline)
+    {
+        // By wire steps, the baseline the reader has is quantised and ours usually isnt
+        bool changed = !Codec::same(object.*Member, baseline.*Member);
+        writer.writeBool(changed);
+        if (changed) Codec::write(writer, object.*Member);
+    }
+    template <typename T>
+    static void readDelta(BitReader &reader, T &object, const T &baseline)
+    {
+        if (reader.readBool()) Codec::read(reader, object.*Member);
+        else object.*Member = baseline.*Member;
+    }
+};
+
+template <typename T, typename... Fields>
+struct NetSchema
+{
+    static constexpr int maxBits = (0 + ... + Fields::maxBits);
+    static constexpr int maxBytes = (maxBits + 7) / 8;
+    // Every field changed, the changed bits on top
+    static constexpr int maxDeltaBits = maxBits + (int)sizeof...(Fields);
+
+    static void write(BitWriter &writer, const T &object) { (Fields::write(writer, object), ...); }
+    static void read(BitReader &reader, T &object) { (Fields::read(reader, object), ...); }
+    // baseline is what the other end has (what it read last time), not what we had
+    static void writeDelta(BitWriter &writer, const T &object, const T &baseline) { (Fields::writeDelta(writer, object, baseline), ...); }
+    static void readDelta(BitReader &reader, T &object, const T &baseline) { (Fields::readDelta(reader, object, baseline), ...); }
+};
+
+#endif
@@ -0,0 +1,160 @@
+#pragma once
+
+#ifndef NET_NET_TRANSPORT_H
+#define NET_NET_TRANSPORT_H
+
+#include <cstdint>
+#include <vector>
+#include "net/net_connection.h"
+#include "net/udp_socket.h"
+
+enum class NetEventType
+{
+    CONNECTED,
+    DISCONNECTED,   // asked to, or timed out
+    PAYLOAD
+};
+
+/**
+    Something that happened during the last update. Payload bytes live in the
+    transport's event buffer (getEventData) until the next update
+**/
+struct NetEvent
+{
+    NetEventType type;
+    int client = 0;
+    uint16_t sequence = 0;
+    int offset = 0;
+    int size = 0;
+};
+
+/**
+    Server end of the transport, one socket and up to maxClients connections
+
+    Handshake is a CONNECT_REQUEST with a random salt from the client, answered with
+    CONNECT_ACCEPT (salt + client index) or CONNECT_DENIED when full. The salt tells a
+    client restarting on the same port apart from a resent request. No challenge or
+    encryption, this is for trusted networks and testing.
+
+    Everything is driven by update(now), the caller owns the clock (seconds, any
+    epoch) so tests can run it as fast as they like
+**/
+class NetServer
+{
+private:
+    struct Client
+    {
+        bool connected = false;
+        uint64_t salt = 0;
+        NetConnection connection;
+    };
+
+    UdpSocket socket;
+    std::vector<Client> clients;
+    double timeout = NET_TIMEOUT_SECONDS;
+
+    std::vector<NetEvent> events;
+    std::vector<uint8_t> eventData;
+    uint8_t packet[NET_MAX_PACKET_BYTES];
+
+    // Stats
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+
+    int findClient(const NetAddress &address) const;
+    void sendHandshake(const NetAddress &to, PacketType type, uint64_t salt, uint16_t clientIndex);
+    uint16_t sendPacket(int client, PacketType type, const uint8_t *payload, int size, double now);
+    void handleConnectRequest(const NetAddress &from, ByteReader &reader, double now);
+    void dropClient(int client);
+
+public:
+    NetServer() = default;
+
+    // port 0 picks a free one (getPort)
+    bool start(uint16_t port, int maxClients);
+    // Tells every client and closes the socket
+    void stop(double now);
+
+    // Drains the socket, handshakes, times clients out, sends keepalives
+    void update(double now);
+    // Returns the sequence the packet went out with (for matching acks up later)
+    uint16_t send(int client, const uint8_t *payload, int size, double now);
+    void disconnect(int client, double now);
+
+    void setTimeout(double seconds) { timeout = seconds; }
+
+    // Getters
+    const std::vector<NetEvent> &getEvents() const { return events; }
+    const uint8_t *getEventData(const NetEvent &event) const { return eventData.data() + event.offset; }
+    bool isRunning() const { return socket.isOpen(); }
+    bool isConnected(int client) const { return client >= 0 && client < (int)clients.size() && clients[client].connected; }
+    int getMaxClients() const { return (int)clients.size(); }
+    int getConnectedCount() const;
+    NetConnection *getConnection(int client) { return isConnected(client) ? &clients[client].connection : nullptr; }
+    uint16_t getPort() const { return socket.getPort(); }
+    uint64_t getBytesSent() const { return bytesSent; }
+    uint64_t getBytesReceived() const { return bytesReceived; }
+};
+
+enum class NetClientState
+{
+    DISCONNECTED,
+    CONNECTING,
+    CONNECTED,
+    DENIED,
+    TIMED_OUT
+};
+
+/**
+    Client end of the transport, see NetServer for the handshake. Only PAYLOAD events
+    come out of here, connecting / dropping shows up in getState
+**/
+class NetClient
+{
+private:
+    UdpSocket socket;
+    NetAddress server;
+    NetConnection connection;
+    NetClientState state = NetClientState::DISCONNECTED;
+    uint64_t salt = 0;
+    int clientIndex = -1;
+    double connectStartTime = 0.0;
+    double lastRequestTime = 0.0;
+    double timeout = NET_TIMEOUT_SECONDS;
+
+    std::vector<NetEvent> events;
+    std::vector<uint8_t> eventData;
+    uint8_t packet[NET_MAX_PACKET_BYTES];
+
+    // Stats
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+
+    uint16_t sendPacket(PacketType type, const uint8_t *payload, int size, double now);
+    void sendConnectRequest(double now);
+
+public:
+    NetClient() = default;
+
+    // Opens a socket on any port and starts the handshake
+    bool connect(const NetAddress &server, double now);
+    void disconnect(double now);
+
+    void update(double now);
+    // Only once CONNECTED, returns the sequence the packet went out with
+    uint16_t send(const uint8_t *payload, int size, double now);
+
+    void setTimeout(double seconds) { timeout = seconds; }
+
+    // Getters
+    const std::vector<NetEvent> &getEvents() const { return events; }
+    const uint8_t *getEventData(const NetEvent &event) const { return eventData.data() + event.offset; }
+    NetClientState getState() const { return state; }
+    bool isConnected() const { return state == NetClientState::CONNECTED; }
+    int getClientIndex() const { return clientIndex; }
+    NetConnection &getConnection() { return connection; }
+    uint64_t getBytesSent() const { return bytesSent; }
+    uint64_t getBytesReceived() const { return bytesReceived; }
+};
+
+#endif
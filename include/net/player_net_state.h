@@ -0,0 +1,57 @@
+#pragma once
+
+#ifndef NET_PLAYER_NET_STATE_H
+#define NET_PLAYER_NET_STATE_H
+
+#include <cstdint>
+#include "net/net_schema.h"
+
+// Player::PlayerState without pulling SDL into the net code, same order
+enum class NetPlayerState : uint8_t
+{
+    IDLE,
+    WALKING,
+    ATTACK,
+    COLLIDING,
+    COUNT
+};
+
+/**
+    What a Player looks like to everyone else, the schema for it. Nothing sends this
+    yet (the server only has bodies, see BodyState), its here for when health / level
+    live on the server and the serialization bench keeps it honest
+
+    As a struct dump (4 floats, 3 ints, the enum) this is 32 bytes. A full state
+    through PlayerNetSchema is still 13 - 15 (the ranges are wide, 18 bit positions),
+    its writeDelta against what the other end read last time that gets small: 2 for
+    an idle player, about 4 on average when two thirds of them moved
+**/
+struct PlayerNetState
+{
+    uint16_t id = 0;
+    float x = 0.0f;
+    float y = 0.0f;
+    float velocityX = 0.0f;
+    float velocityY = 0.0f;
+    int health = 0;
+    int level = 1;
+    int experience = 0;
+    NetPlayerState state = NetPlayerState::IDLE;
+};
+
+// 1/8 px in a 32768 px world (18 bits), 1/16 px/s up to 1024 px/s (15 bits)
+using NetPositionCodec = QuantizedFloatCodec<-8192, 24575, 8>;
+using NetVelocityCodec = QuantizedFloatCodec<-1024, 1023, 16>;
+
+using PlayerNetSchema = NetSchema<PlayerNetState,
+                                  NetField<&PlayerNetState::id, VarintCodec>,
+                                  NetField<&PlayerNetState::x, NetPositionCodec>,
+                                  NetField<&PlayerNetState::y, NetPositionCodec>,
+                                  NetField<&PlayerNetState::velocityX, NetVelocityCodec>,
+                                  NetField<&PlayerNetState::velocityY, NetVelocityCodec>,
+                                  NetField<&PlayerNetState::health, RangedIntCodec<0, 1023>>,
+                                  NetField<&PlayerNetState::level, RangedIntCodec<1, 128>>,
+                                  NetField<&PlayerNetState::experience, VarintCodec>,
+                                  NetField<&PlayerNetState::state, EnumCodec<NetPlayerState, NetPlayerState::COUNT>>>;
+
+#endif
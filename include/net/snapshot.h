@@ -0,0 +1,56 @@
+#pragma once
+
+#ifndef NET_SNAPSHOT_H
+#define NET_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "net/net_messages.h"
+
+// About a second of states at SIM_TICK_RATE, an acked baseline older than that means full states again
+#define SNAPSHOT_RING_SIZE 64
+
+/**
+    The bodies one client has after reading a state, sorted by id
+
+    The server keeps what it sent each client so it can write the next state as a delta
+    against one the client acked, the client keeps what it read so it has that baseline
+    to apply the delta to. Both key them by the packet sequence the state went out in
+**/
+struct Snapshot
+{
+    uint32_t tick = 0;
+    uint16_t sequence = 0;
+    bool valid = false;
+    bool acked = false;
+    std::vector<BodyState> bodies;
+
+    // Binary search, nullptr if it isnt in here
+    const BodyState *find(uint16_t id) const;
+};
+
+/**
+    The last SNAPSHOT_RING_SIZE snapshots, oldest gets overwritten. Vectors are swapped
+    in and out so after the first lap nothing allocates
+**/
+class SnapshotRing
+{
+private:
+    Snapshot entries[SNAPSHOT_RING_SIZE];
+    int next = 0;
+    // Newest acked entry, -1 when there is none in the ring
+    int newestAcked = -1;
+
+public:
+    void clear();
+    // Takes snapshot's bodies (it gets the overwritten entry's back to reuse)
+    void insert(Snapshot &snapshot, uint16_t sequence);
+    // The other end has this one now, it can be a baseline
+    void ack(uint16_t sequence);
+
+    const Snapshot *findSequence(uint16_t sequence) const;
+    // Baseline for the next delta, nullptr means send everything
+    const Snapshot *getNewestAcked() const { return newestAcked >= 0 ? &entries[newestAcked] : nullptr; }
+};
+
+#endif
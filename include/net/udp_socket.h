@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef NET_UDP_SOCKET_H
+#define NET_UDP_SOCKET_H
+
+#include <cstdint>
+#include <string>
+
+/**
+    IPv4 address + port, both in host byte order
+**/
+struct NetAddress
+{
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    // "127.0.0.1:40000" (or just the ip with defaultPort), false if it doesnt parse
+    static bool fromString(const std::string &text, NetAddress &out, uint16_t defaultPort = 0);
+    static NetAddress loopback(uint16_t port) { return NetAddress{0x7F000001u, port}; }
+    std::string toString() const;
+
+    bool isValid() const { return ip != 0 && port != 0; }
+    bool operator==(const NetAddress &other) const { return ip == other.ip && port == other.port; }
+    bool operator!=(const NetAddress &other) const { return !(*this == other); }
+};
+
+/**
+    Non blocking UDP socket (POSIX)
+
+    Nothing in here ever waits, receive hands back 0 when nothing is queued so the
+    server / client can drain it once a tick and get on with the simulation
+**/
+class UdpSocket
+{
+private:
+    int handle = -1;
+    uint16_t port = 0;
+
+public:
+    UdpSocket() = default;
+    ~UdpSocket();
+    UdpSocket(const UdpSocket &) = delete;
+    UdpSocket &operator=(const UdpSocket &) = delete;
+
+    // port 0 lets the OS pick one (see getPort)
+    bool open(uint16_t port = 0);
+    void close();
+
+    bool send(const NetAddress &to, const uint8_t *data, int size);
+    // Bytes received, 0 if nothing is waiting, -1 on error
+    int receive(NetAddress &from, uint8_t *buffer, int capacity);
+
+    // Getters
+    bool isOpen() const { return handle >= 0; }
+    uint16_t getPort() const { return port; }
+};
+
+#endif
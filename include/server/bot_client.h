@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef SERVER_BOT_CLIENT_H
+#define SERVER_BOT_CLIENT_H
+
+#include <cstdint>
+#include "net/client_prediction.h"
+#include "net/net_messages.h"
+#include "net/snapshot.h"
+#include "net/net_transport.h"
+
+/**
+    Headless client that plays like the server's bots (new keys every 20 ticks from a
+    seed) over a real connection. For load testing a server from another process and
+    for the loopback self test, no SDL in here
+
+    Predicts its own body like the game does (ClientPrediction), the movement has to
+    be the server's tuning and map for that to line up (setMovement, defaults to
+    ServerTuning with no map). Tells the server its view size once a second like the
+    game does, the server's default view until setView
+**/
+class BotClient
+{
+private:
+    NetClient net;
+    uint32_t seed;
+    uint8_t keys = 0;
+    bool scripted = true;
+    uint16_t viewWidth;
+    uint16_t viewHeight;
+
+    // Every state we read by packet sequence, the server deltas against these
+    SnapshotRing received;
+    Snapshot scratch;
+    StateMessage readState;
+    StateMessage lastState;
+    bool hasState = false;
+    uint64_t statesReceived = 0;
+    uint64_t deltasReceived = 0;
+    uint64_t statesDropped = 0;
+
+    BodyMovement movement;
+    ClientPrediction prediction;
+
+public:
+    explicit BotClient(uint32_t seed);
+
+    bool connect(const NetAddress &server, double now);
+    void disconnect(double now);
+
+    // Reads whatever state came in, then sends this tick's keys (once connected)
+    void update(double now);
+    // Stops the scripted keys and holds these instead (SERVER_KEY_* bits)
+    void setKeys(uint8_t keys) { this->keys = keys; this->scripted = false; }
+    // What we predict our body with, the server's getMovement()
+    void setMovement(const BodyMovement &movement) { this->movement = movement; }
+    // World px the server sends us the bodies in, goes out with the next ViewMessage
+    void setView(uint16_t width, uint16_t height) { this->viewWidth = width; this->viewHeight = height; }
+
+    // Getters
+    NetClient &getNet() { return net; }
+    const StateMessage &getLastState() const { return lastState; }
+    bool getHasState() const { return hasState; }
+    uint64_t getStatesReceived() const { return statesReceived; }
+    // Of those, how many came as a delta
+    uint64_t getDeltasReceived() const { return deltasReceived; }
+    // States we couldnt read, a delta against something we dont have (should stay 0)
+    uint64_t getStatesDropped() const { return statesDropped; }
+    uint32_t getInputSequence() const { return prediction.getNewestSequence(); }
+    const ClientPrediction &getPrediction() const { return prediction; }
+    uint8_t getKeys() const { return keys; }
+    // Our body in the last state, nullptr before the first one
+    const BodyState *getOwnBody() const;
+};
+
+#endif
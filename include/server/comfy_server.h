@@ -0,0 +1,225 @@
+#pragma once
+
+#ifndef SERVER_COMFY_SERVER_H
+#define SERVER_COMFY_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "entity/component_store.h"
+#include "net/body_movement.h"
+#include "net/interest_grid.h"
+#include "net/net_messages.h"
+#include "net/snapshot.h"
+#include "net/net_transport.h"
+#include "utils/fixed.h"
+#include "utils/fixed_timestep.h"
+#include "utils/map_data.h"
+#include "utils/movement_simd.h"
+#include "utils/pool.h"
+
+// Inputs a client can have waiting, past that the oldest get dropped
+#define SERVER_INPUT_QUEUE 8
+// Most inputs one client body runs in a tick, 2 lets a client that fell behind catch up
+#define SERVER_MAX_INPUTS_PER_TICK 2
+// A client's view before it sends a ViewMessage, the game's 600x500 viewport at its 2x scale
+#define SERVER_DEFAULT_VIEW_WIDTH 300
+#define SERVER_DEFAULT_VIEW_HEIGHT 250
+// Biggest view a client can ask for either way, world px
+#define SERVER_MAX_VIEW_SIZE 2048
+// Bodies this far past the view still get sent, they are there before they walk on screen
+#define SERVER_INTEREST_MARGIN 64.0f
+// and only stop getting sent this much further out again
+#define SERVER_INTEREST_HYSTERESIS 32.0f
+// How often the run loop logs a status line
+#define SERVER_STATUS_SECONDS 10
+// Default UDP port and how many players fit
+#define SERVER_DEFAULT_PORT 40000
+#define SERVER_DEFAULT_MAX_CLIENTS 64
+
+/**
+    Player tuning the server simulates with, from the same Data ini files the client
+    reads (player_data.ini, collision_data.ini). Defaults are the values those ship with
+**/
+struct ServerTuning
+{
+    Fixed acceleration = Fixed::fromInt(2000);
+    Fixed friction = Fixed::fromFloat(0.85f);
+    Fixed maxSpeed = Fixed::fromInt(400);
+    // Collision box relative to the body position
+    FixedAABB collider = FixedAABB::fromRect(Fixed(), Fixed::fromFloat(5.866f), Fixed::fromFloat(13.934f), Fixed::fromFloat(8.016f));
+};
+
+/**
+    Something the server moves, a connected player or a bot. The Fixed position /
+    velocity are the real ones, the ComponentStore entity gets float copies every tick
+    for whatever reads the store (broadphase, snapshots, ...)
+**/
+struct ServerBody
+{
+    EntityHandle entity;
+    FixedVec2 position;
+    FixedVec2 velocity;
+    uint8_t keys = 0;
+    // A connected player's, steps once for each of its inputs instead of once a tick
+    bool stepsOnInput = false;
+    // Bots pick their own keys from this every 20 ticks
+    bool isBot = false;
+    uint32_t botSeed = 0;
+};
+
+// One tick of keys from a client, waiting for the tick that runs it
+struct QueuedInput
+{
+    uint32_t sequence = 0;
+    uint8_t keys = 0;
+};
+
+/**
+    A connected player, by NetServer client index
+**/
+struct ServerClient
+{
+    PoolHandle body;
+    // Newest InputMessage applied, echoed back in every state
+    uint32_t lastInputSequence = 0;
+    bool hasInput = false;
+    // Inputs that came in and havent run yet, sorted by sequence
+    std::vector<QueuedInput> pendingInputs;
+    // What we sent them by packet sequence, the newest acked one is the next delta's baseline
+    SnapshotRing snapshots;
+    // World px around their body they get told about (ViewMessage)
+    int viewWidth = SERVER_DEFAULT_VIEW_WIDTH;
+    int viewHeight = SERVER_DEFAULT_VIEW_HEIGHT;
+    // Which bodies they get, what came in / went last tick
+    InterestSet interest;
+};
+
+/**
+    Dedicated server, the simulation without a window
+
+    Loads the map through MapData (layers, tile shapes and the collision grid, never a
+    texture) and runs bodies at SIM_TICK_RATE with the deterministic movement
+    (MovementKernels::stepVelocityFixed + FixedCollision::moveAndSlide), so what it
+    works out is bit for bit what a COMFY_DETERMINISTIC client works out.
+
+    Nothing in here (or anything it includes) touches SDL, ImGui or the zig library,
+    it builds on its own with -DCOMFY_HEADLESS=ON. Pacing is std::chrono + sleeps,
+    FramePacer / InputLatency are about presenting frames and stay on the client.
+
+    It is the authority: clients only ever send the keys they hold (InputMessage), the
+    server moves their body and sends everyone the world after every tick
+    (StateMessage). Anything a client says about where it is gets ignored.
+
+    Everyone only gets the part of the world around them: their view (ViewMessage)
+    plus SERVER_INTEREST_MARGIN, found through an InterestGrid rebuilt once a tick.
+    A body coming into that is a new body in their delta and one going out is a
+    removed id, so enter / leave costs nothing extra on the wire.
+
+    A player's body moves one BodyMovement step per input, not per tick. The inputs
+    queue up and each tick runs the next one (two if they are piling up), a tick
+    without one leaves the body where it is. That way a client predicting its own body
+    (ClientPrediction) does the same steps for the same inputs whatever the network did
+    to their timing, and only gets corrected when an input never made it at all.
+**/
+class ComfyServer
+{
+private:
+    TSDL_TileMap map;
+    bool hasMap = false;
+    ServerTuning tuning;
+    BodyMovement movement;
+
+    ComponentStore components;
+    Pool<ServerBody> bodies;
+
+    FixedTimestep timestep;
+    uint64_t tick = 0;
+    std::atomic<bool> running{false};
+
+    NetServer net;
+    std::vector<ServerClient> clients;
+    // Every body this tick sorted by id, and where each id is in it (-1 for none)
+    std::vector<BodyState> world;
+    std::vector<int> worldIndex;
+    InterestGrid interest;
+    StateMessage state;
+    Snapshot written;
+    std::vector<uint16_t> acks;
+    uint8_t payload[NET_MAX_PAYLOAD_BYTES];
+
+    // Stats
+    double lastTickMilliseconds = 0.0;
+    double maxTickMilliseconds = 0.0;
+    double totalTickMilliseconds = 0.0;
+    uint64_t interestEntered = 0;
+    uint64_t interestLeft = 0;
+    uint64_t interestVisible = 0;
+    uint64_t interestUpdates = 0;
+
+    void stepBody(ServerBody &body);
+    // Runs the client's next queued input(s) on its body
+    void stepClient(ServerClient &player);
+    void queueInput(ServerClient &player, uint32_t sequence, uint8_t keys);
+    // Open tile picked from seed, (0, seed * 16) when there is no map
+    void findSpawn(uint32_t seed, Fixed &x, Fixed &y) const;
+    void handleInput(int client, const uint8_t *data, int size);
+    void handleView(int client, const uint8_t *data, int size);
+    // The client's view around its body, kept inside the map like the camera
+    InterestRect viewRect(const ServerClient &player, const ServerBody &body) const;
+
+public:
+    ComfyServer();
+
+    // Tiles and collision only, false (and no map, everything walkable) if it failed
+    bool loadMap(const std::string &jsonPath);
+    // Reads player_data.ini / collision_data.ini from dataDirectory, keeps the defaults for anything missing
+    bool loadTuning(const std::string &dataDirectory);
+
+    PoolHandle spawnBody(Fixed x, Fixed y, bool isBot = false);
+    // Spreads count bots over open tiles
+    void spawnBots(int count);
+    bool removeBody(PoolHandle handle);
+    // SERVER_KEY_* bits held for the next tick
+    bool setKeys(PoolHandle handle, uint8_t keys);
+
+    // UDP on port (0 picks one, see getNet().getPort())
+    bool listen(uint16_t port, int maxClients);
+    // Connects / drops players and applies their inputs, before the ticks
+    void pollNetwork(double now);
+    // The world to every client, after the ticks
+    void sendState(double now);
+
+    // One fixed tick of every body
+    void update();
+    // Runs ticks (and the network if listening) on the wall clock until stop() (or maxTicks ticks, 0 = forever)
+    void run(uint64_t maxTicks = 0);
+    // Safe from a signal handler
+    void stop();
+
+    // Seconds on the steady clock, what the network and the loop run on
+    static double clockSeconds();
+
+    // Getters
+    uint64_t getTick() const { return tick; }
+    int getBodyCount() const { return bodies.size(); }
+    const ServerBody *getBody(PoolHandle handle) const { return bodies.get(handle); }
+    const TSDL_TileMap &getMap() const { return map; }
+    ComponentStore &getComponents() { return components; }
+    const ServerTuning &getTuning() const { return tuning; }
+    // Tuning and map as one step, what a client needs to predict its body the same way
+    const BodyMovement &getMovement() const { return movement; }
+    NetServer &getNet() { return net; }
+    const ServerClient *getClient(int client) const { return net.isConnected(client) ? &clients[client] : nullptr; }
+    double getLastTickMilliseconds() const { return lastTickMilliseconds; }
+    double getMaxTickMilliseconds() const { return maxTickMilliseconds; }
+    double getAverageTickMilliseconds() const { return tick > 0 ? totalTickMilliseconds / tick : 0.0; }
+    // Enter / leave events over every client since the start
+    uint64_t getInterestEntered() const { return interestEntered; }
+    uint64_t getInterestLeft() const { return interestLeft; }
+    // Bodies a client gets in a state, on average
+    double getAverageVisible() const { return interestUpdates > 0 ? (double)interestVisible / interestUpdates : 0.0; }
+};
+
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+#ifndef SERVER_NET_SELF_TEST_H
+#define SERVER_NET_SELF_TEST_H
+
+/**
+    Server + BotClients in one process over real UDP sockets on 127.0.0.1: handshake,
+    inputs moving bodies, delta states rebuilding the server's bodies bit for bit,
+    predicted bodies needing no corrections (and a forced one replaying), only bodies
+    in view getting sent (and entering / leaving it), acks / rtt,
+    a full server denying, disconnects and timeouts. Also that the batched movement
+    kernels match the scalar step bit for bit, which breaks if the build fuses
+    multiply adds. Logs a PASS / FAIL line per check
+    (ComfyServer --selftest), takes a few seconds of wall clock
+**/
+class NetSelfTest
+{
+public:
+    static bool run(int clientCount);
+};
+
+#endif
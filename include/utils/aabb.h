@@ -0,0 +1,50 @@
+#pragma once
+
+#ifndef UTILS_AABB_H
+#define UTILS_AABB_H
+
+/**
+    Axis Aligned Bounding Box in world units (not scaled by the map scale)
+
+    Everything that does overlap tests (collision, broadphase, culling) should
+    talk in these so we stop building SDL_FRects just to compare floats
+**/
+struct AABB
+{
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+
+    static AABB fromRect(float x, float y, float width, float height)
+    {
+        return AABB{x, y, x + width, y + height};
+    }
+
+    float getWidth() const { return maxX - minX; }
+    float getHeight() const { return maxY - minY; }
+
+    // Touching edges do not count as overlapping
+    bool overlaps(const AABB &other) const
+    {
+        return minX < other.maxX && maxX > other.minX &&
+               minY < other.maxY && maxY > other.minY;
+    }
+
+    bool contains(const AABB &other) const
+    {
+        return minX <= other.minX && minY <= other.minY &&
+               maxX >= other.maxX && maxY >= other.maxY;
+    }
+
+    // Box covering this box at the start and the end of a move by (dx, dy)
+    AABB swept(float dx, float dy) const
+    {
+        AABB out = *this;
+        if (dx < 0) out.minX += dx; else out.maxX += dx;
+        if (dy < 0) out.minY += dy; else out.maxY += dy;
+        return out;
+    }
+};
+
+#endif
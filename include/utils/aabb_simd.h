@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef UTILS_AABB_SIMD_H
+#define UTILS_AABB_SIMD_H
+
+#include <cstdint>
+#include <vector>
+#include "utils/aabb.h"
+#include "utils/collision_grid.h"
+
+/**
+    Boxes stored as a structure of arrays (all the minX together, all the minY together...)
+    so the kernels below can load 4 or 8 of them straight into a SIMD register.
+
+    The arrays are always padded up to a multiple of 8 with "inside out" boxes
+    (min = +inf, max = -inf) that can never overlap anything, so the kernels never
+    need a scalar tail loop.
+**/
+class AABBArray
+{
+private:
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    int count = 0;
+
+    void pad();
+
+public:
+    // Getters
+    int getCount() const { return count; }
+    int getPaddedCount() const { return (int)minX.size(); }
+    const float *getMinX() const { return minX.data(); }
+    const float *getMinY() const { return minY.data(); }
+    const float *getMaxX() const { return maxX.data(); }
+    const float *getMaxY() const { return maxY.data(); }
+    AABB get(int index) const { return AABB{minX[index], minY[index], maxX[index], maxY[index]}; }
+
+    // Setters
+    void set(int index, const AABB &box);
+
+    // Methods
+    void clear();
+    void push(const AABB &box);
+    void assign(const AABB *boxes, int count);
+
+    // How many uint32_t words a hit mask for this array needs
+    int getMaskWords() const { return (count + 31) / 32; }
+};
+
+/**
+    Batched box tests, 8 boxes per instruction with AVX, 4 with SSE2 / NEON and a plain
+    loop when none of those are available.
+
+    Results come back as a bit mask, bit (i % 32) of mask[i / 32] is set if box i hit,
+    the mask needs getMaskWords() words. Both return how many boxes hit.
+**/
+class AABBKernels
+{
+public:
+    // Which boxes overlap the query box (camera culling, area queries)
+    static int overlapMask(const AABBArray &boxes, const AABB &query, uint32_t *mask);
+    // Which boxes overlap a solid tile (or leave the map), batch version of Collision::overlapsGrid
+    // shaped tiles count as whole tiles here so run overlapsGrid on the hits if you need exact
+    static int tileGridMask(const AABBArray &boxes, const CollisionGrid &grid, uint32_t *mask);
+
+    static bool isSet(const uint32_t *mask, int index) { return (mask[index >> 5] >> (index & 31)) & 1u; }
+    static const char *getInstructionSet();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifndef UTILS_AABB_TREE_H
+#define UTILS_AABB_TREE_H
+
+#include <vector>
+#include "utils/aabb.h"
+
+/**
+    Dynamic AABB tree (bounding volume hierarchy) for things that dont fit the
+    SpatialHash well, huge static stuff like buildings and trigger zones mixed
+    with tiny projectiles.
+
+    Each proxy keeps its real box plus a "fat" box grown by a margin (and stretched
+    in the direction it is moving). While the real box stays inside the fat box
+    moving it costs nothing, once it leaves the leaf gets pulled out and put back
+    in, refitting and rebalancing only the nodes on its way up to the root.
+
+    Nodes live in one vector and get recycled through a free list so proxies can
+    be created and destroyed every tick without allocating.
+**/
+class AABBTree
+{
+public:
+    static const int NULL_NODE = -1;
+
+    struct RayCastResult
+    {
+        bool hit = false;
+        int proxy = NULL_NODE;
+        float fraction = 1.0f;  // 0 -> 1 along the ray
+    };
+
+    struct NearestResult
+    {
+        int proxy = NULL_NODE;
+        float distance = 0.0f;
+    };
+
+private:
+    struct Node
+    {
+        AABB fatBox;
+        AABB box;           // the real box, only used by leaves
+        int parent;         // doubles as the next free node when the node is free
+        int child1;
+        int child2;
+        int height;         // leaf = 0, free node = -1
+        int userData;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int root = NULL_NODE;
+    int freeList = NULL_NODE;
+    int proxyCount = 0;
+    float margin;
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int node);
+
+public:
+    AABBTree(float margin = 4.0f);
+
+    // Getters
+    int getProxyCount() const { return proxyCount; }
+    int getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+    const AABB &getBox(int proxy) const { return nodes[proxy].box; }
+    const AABB &getFatBox(int proxy) const { return nodes[proxy].fatBox; }
+    int getUserData(int proxy) const { return nodes[proxy].userData; }
+
+    // Methods
+    int createProxy(const AABB &box, int userData = 0);
+    void destroyProxy(int proxy);
+    // (dx, dy) is how far it moved this tick, returns true if the proxy had to be re-inserted
+    bool moveProxy(int proxy, const AABB &box, float dx = 0.0f, float dy = 0.0f);
+    void clear();
+
+    // Every proxy whose real box overlaps the query box
+    void query(const AABB &box, std::vector<int> &results) const;
+    // Closest proxy hit by the segment (x1, y1) -> (x2, y2)
+    RayCastResult rayCast(float x1, float y1, float x2, float y2) const;
+    // Closest proxy to a point (distance 0 if the point is inside its box), NULL_NODE if nothing within maxDistance
+    NearestResult nearest(float x, float y, float maxDistance = 1e30f) const;
+};
+
+#endif
@@ -3,37 +3,57 @@
 #ifndef UTILS_COLLISION_H
 #define UTILS_COLLISION_H
 
-#include <SDL2/SDL.h>
 #include "comfy_lib.h"
+#include "utils/aabb.h"
+#include "utils/collision_grid.h"
+#include "utils/debug_draw.h"
 
 // Since we dont want circular imports we need this here
 // inside the implimentation file include the player.h
 class Player;
 class TSDL_TileMap;
 
+/**
+    Result of sweeping a box through the collision grid
+
+    time is how far along the move (0 -> 1) the box got before touching something,
+    normal is the face of the tile it touched (points back at the box), unit length
+    and only axis aligned for full tiles, slopes give diagonal normals
+**/
+struct SweepResult
+{
+    bool hit = false;
+    float time = 1.0f;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+};
+
 /**
     This File Works Simple When A Player Is Created This is attached to them
+
+    Nothing in here talks to the renderer, when showCollision is on the checks record
+    what they tested into the debugDraw buffer and the player draws that in its
+    render pass
  **/
 class Collision {
 private:
     // By Default We Dont Want to show the collision box
     bool showCollision = false;
     // Default Collision Color is Red
-    SDL_Color collisionColor = {255, 0, 0, 255};
+    DebugDrawColor collisionColor = {255, 0, 0, 255};
     Player* player;
-    SDL_FRect playerCollisionRect;
+    DebugDraw debugDraw;
 
-    float width;
-    float height;
-    float xOffset;
-    float yOffset;
+    int colliderSlot();
+    // The box itself (size / offset) is the player's collider component in the ComponentStore
 
 public:
     // Constructor
     Collision(Player *player);
     // Getters
     bool getShowingCollision();
-    SDL_Color getCollisionColor();
+    DebugDrawColor getCollisionColor();
+    DebugDraw *getDebugDraw();
     Player *getPlayer();
     float getWidth();
     float getHeight();
@@ -41,7 +61,7 @@ public:
     float getYOffset();
     // Setters
     void setShowingCollision(bool showCollision);
-    void setCollisionColor(SDL_Color collisionColor);
+    void setCollisionColor(DebugDrawColor collisionColor);
     void setPlayer(Player *player);
     void setWidth(float width);
     void setHeight(float height);
@@ -49,11 +69,21 @@ public:
     void setYOffset(float yOffset);
     // Methods
 
-    void setPlayerCollision();
-    void drawPlayerCollision();
+    // Collision box of the player in world units
+    AABB getBounds();
+    // Records the player collision box into the debug buffer (if showing collision)
+    void recordPlayerCollision();
 
     // Checking Collision With Map Layer
     bool collidesWithMapLayer(TSDL_TileMap *tileMap,float scale);
+    static bool overlapsGrid(const CollisionGrid &grid, const AABB &box, DebugDraw *debugDraw = nullptr);
+
+    /**
+        Sweeps the player collision box by (dx, dy) through the map in one pass,
+        this is what movement should use since it cant tunnel through thin walls
+    **/
+    SweepResult sweepMapLayer(TSDL_TileMap *tileMap, float dx, float dy);
+    static SweepResult sweepGrid(const CollisionGrid &grid, const AABB &box, float dx, float dy, DebugDraw *debugDraw = nullptr);
 };
 
 #endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifndef UTILS_COLLISION_GRID_H
+#define UTILS_COLLISION_GRID_H
+
+#include "utils/tile_shapes.h"
+#include <cstdint>
+#include <vector>
+
+/**
+    Flat copy of the "Collision" layer of a map
+
+    Looking the layer up by name and indexing the raw tile data every time we
+    wanna know if something is solid is slow, so TSDL builds this once when the
+    map is loaded (and on hot reload) and everything else just asks it.
+
+    Anything outside of the map counts as solid so nothing can walk off of it.
+
+    Tiles that have collision shapes in their tileset are marked CELL_SHAPED, the grid
+    keeps the gid of those and its own copy of the shapes so Collision can do the
+    exact test. Everything that only cares about whole tiles (isSolid, the SIMD kernels)
+    treats them as solid.
+**/
+enum CollisionCell : uint8_t
+{
+    CELL_EMPTY = 0,
+    CELL_SOLID = 1,
+    CELL_SHAPED = 2,
+};
+
+class CollisionGrid
+{
+private:
+    int width = 0;
+    int height = 0;
+    int tileWidth = 0;
+    int tileHeight = 0;
+    // Changes every time a tile changes, see getVersion
+    uint32_t version = 0;
+    // CollisionCell values
+    std::vector<uint8_t> cells;
+    // Gid of every cell, only filled in when the map has shaped tiles
+    std::vector<int> cellGids;
+    TileShapeTable shapes;
+
+public:
+    CollisionGrid() = default;
+
+    void build(int width, int height, int tileWidth, int tileHeight, const std::vector<int> &layerData, const TileShapeTable *shapes = nullptr);
+    void clear();
+
+    // Getters
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getTileWidth() const { return tileWidth; }
+    int getTileHeight() const { return tileHeight; }
+    bool isEmpty() const { return cells.empty(); }
+    /**
+        Bumped on every build / clear / setSolid that changes something and unique across
+        all grids, so anything caching results off of a grid (paths, ...) can just remember
+        the version it saw and throw its cache away when it changes
+    **/
+    uint32_t getVersion() const { return version; }
+    const uint8_t *getCells() const { return cells.data(); }
+
+    bool inBounds(int x, int y) const
+    {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
+    bool isSolid(int x, int y) const
+    {
+        if (!inBounds(x, y)) return true;
+        return cells[x + y * width] != CELL_EMPTY;
+    }
+    CollisionCell getCell(int x, int y) const
+    {
+        if (!inBounds(x, y)) return CELL_SOLID;
+        return (CollisionCell)cells[x + y * width];
+    }
+    // Returns how many shapes the cell has and points out at the first one
+    int getShapes(int x, int y, const TileShape **out) const
+    {
+        if (getCell(x, y) != CELL_SHAPED) return 0;
+        return shapes.getShapes(cellGids[x + y * width], out);
+    }
+
+    // Setters
+    void setSolid(int x, int y, bool solid);
+};
+
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifndef UTILS_DEBUG_DRAW_H
+#define UTILS_DEBUG_DRAW_H
+
+#include <cstdint>
+#include <vector>
+#include "utils/aabb.h"
+
+// Only the render pass needs these, recording never touches SDL
+struct SDL_Renderer;
+class Camera;
+
+struct DebugDrawColor
+{
+    uint8_t r = 255;
+    uint8_t g = 255;
+    uint8_t b = 255;
+    uint8_t a = 255;
+};
+
+/**
+    Buffer of debug shapes
+
+    Physics code (collision checks, sweeps) records what it looked at in here
+    instead of talking to the renderer, that way the checks can run anywhere
+    (another thread, a server with no window) and the render pass draws and clears
+    the buffer once a frame, only when someone actually wants to see it.
+
+    Everything is in world units, the camera and map scale get applied when drawing
+**/
+class DebugDraw
+{
+public:
+    struct Command
+    {
+        AABB box;
+        DebugDrawColor color;
+        bool filled;
+    };
+
+private:
+    std::vector<Command> commands;
+
+public:
+    void addRect(const AABB &box, DebugDrawColor color) { commands.push_back({box, color, false}); }
+    void addFilledRect(const AABB &box, DebugDrawColor color) { commands.push_back({box, color, true}); }
+    void clear() { commands.clear(); }
+
+    const std::vector<Command> &getCommands() const { return commands; }
+    bool isEmpty() const { return commands.empty(); }
+
+    // Render Pass: draws everything recorded since the last call then clears it
+    void render(SDL_Renderer *renderer, Camera *camera, float scale);
+};
+
+#endif
@@ -0,0 +1,134 @@
+#pragma once
+
+#ifndef UTILS_FIXED_H
+#define UTILS_FIXED_H
+
+#include <cmath>
+#include <cstdint>
+
+// Q16.16, 16 bits of whole number (+-32767 world units) and 16 bits of fraction (~0.000015)
+#define FIXED_FRACTION_BITS 16
+#define FIXED_ONE (1 << FIXED_FRACTION_BITS)
+
+/**
+    Fixed point number for the deterministic simulation (COMFY_DETERMINISTIC)
+
+    Everything here is integer math, so the same inputs give the same bits on every
+    compiler, optimisation level and CPU, which floats with pow / sqrt / fused multiply
+    adds dont promise. Lockstep / rollback needs every machine to land on exactly the
+    same world, this is how we get that.
+
+    - + and - wrap instead of being undefined on overflow
+    - * and / round towards -infinity, / saturates instead of overflowing (and on / 0)
+    - fromFloat is only for loading data and tuning values, never convert back and
+      forth in the middle of a tick
+**/
+struct Fixed
+{
+    int32_t raw = 0;
+
+    constexpr Fixed() = default;
+    static constexpr Fixed fromRaw(int32_t raw) { return Fixed(raw, 0); }
+    static constexpr Fixed fromInt(int value) { return fromRaw((int32_t)((int64_t)value * FIXED_ONE)); }
+    // Rounds to the nearest step, float * 2^16 is exact so this is the same everywhere
+    static Fixed fromFloat(float value) { return fromRaw((int32_t)std::lround((double)value * FIXED_ONE)); }
+    static constexpr Fixed max() { return fromRaw(INT32_MAX); }
+    static constexpr Fixed min() { return fromRaw(INT32_MIN); }
+
+    float toFloat() const { return (float)this->raw / (float)FIXED_ONE; }
+    // Rounds towards -infinity like std::floor
+    int floorToInt() const { return (int)(this->raw >> FIXED_FRACTION_BITS); }
+
+    constexpr Fixed operator+(Fixed other) const { return fromRaw((int32_t)((uint32_t)raw + (uint32_t)other.raw)); }
+    constexpr Fixed operator-(Fixed other) const { return fromRaw((int32_t)((uint32_t)raw - (uint32_t)other.raw)); }
+    constexpr Fixed operator-() const { return fromRaw((int32_t)(0u - (uint32_t)raw)); }
+    constexpr Fixed operator*(Fixed other) const { return fromRaw((int32_t)(((int64_t)raw * other.raw) >> FIXED_FRACTION_BITS)); }
+    Fixed operator/(Fixed other) const;
+    constexpr Fixed operator*(int value) const { return fromRaw((int32_t)((int64_t)raw * value)); }
+    Fixed operator/(int value) const { return *this / fromInt(value); }
+
+    Fixed &operator+=(Fixed other) { return *this = *this + other; }
+    Fixed &operator-=(Fixed other) { return *this = *this - other; }
+    Fixed &operator*=(Fixed other) { return *this = *this * other; }
+    Fixed &operator/=(Fixed other) { return *this = *this / other; }
+
+    constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+    constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+    constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+    constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+    constexpr bool operator<=(Fixed other) const { return raw <= other.raw; }
+    constexpr bool operator>=(Fixed other) const { return raw >= other.raw; }
+
+    static Fixed abs(Fixed value) { return value.raw < 0 ? -value : value; }
+    static Fixed minOf(Fixed a, Fixed b) { return a < b ? a : b; }
+    static Fixed maxOf(Fixed a, Fixed b) { return a > b ? a : b; }
+    // Integer square root, exact to the last bit (0 for negatives)
+    static Fixed sqrt(Fixed value);
+    // sqrt(x^2 + y^2) with the squares in 64 bits, x^2 alone overflows Q16.16 past ~181
+    static Fixed hypot(Fixed x, Fixed y);
+    // log2 / exp2 by squaring and a table of 2^(2^-k), good to a few steps at the bottom
+    static Fixed log2(Fixed value);
+    static Fixed exp2(Fixed value);
+    // base ^ exponent for base > 0 (friction per tick and the like)
+    static Fixed pow(Fixed base, Fixed exponent);
+
+private:
+    constexpr Fixed(int32_t raw, int) : raw(raw) {}
+};
+
+/**
+    Vec2 for the deterministic simulation, same idea as Vec2 just in Fixed
+**/
+struct FixedVec2
+{
+    Fixed x;
+    Fixed y;
+
+    FixedVec2() = default;
+    FixedVec2(Fixed x, Fixed y) : x(x), y(y) {}
+
+    FixedVec2 operator+(const FixedVec2 &other) const { return FixedVec2(x + other.x, y + other.y); }
+    FixedVec2 operator-(const FixedVec2 &other) const { return FixedVec2(x - other.x, y - other.y); }
+    FixedVec2 operator*(Fixed scalar) const { return FixedVec2(x * scalar, y * scalar); }
+    FixedVec2 &operator+=(const FixedVec2 &other) { x += other.x; y += other.y; return *this; }
+    FixedVec2 &operator-=(const FixedVec2 &other) { x -= other.x; y -= other.y; return *this; }
+    bool operator==(const FixedVec2 &other) const { return x == other.x && y == other.y; }
+
+    Fixed dot(const FixedVec2 &other) const { return x * other.x + y * other.y; }
+    // Q32.32 in 64 bits so it cant overflow, compare it against other lengthSquaredRaw's
+    int64_t lengthSquaredRaw() const { return (int64_t)x.raw * x.raw + (int64_t)y.raw * y.raw; }
+    Fixed length() const { return Fixed::hypot(x, y); }
+    FixedVec2 normalize() const
+    {
+        Fixed len = this->length();
+        if (len.raw == 0) return FixedVec2();
+        return FixedVec2(x / len, y / len);
+    }
+};
+
+// AABB in Fixed, see AABB
+struct FixedAABB
+{
+    Fixed minX;
+    Fixed minY;
+    Fixed maxX;
+    Fixed maxY;
+
+    static FixedAABB fromRect(Fixed x, Fixed y, Fixed width, Fixed height)
+    {
+        return FixedAABB{x, y, x + width, y + height};
+    }
+
+    Fixed getWidth() const { return maxX - minX; }
+    Fixed getHeight() const { return maxY - minY; }
+
+    FixedAABB swept(Fixed dx, Fixed dy) const
+    {
+        FixedAABB out = *this;
+        if (dx.raw < 0) out.minX += dx; else out.maxX += dx;
+        if (dy.raw < 0) out.minY += dy; else out.maxY += dy;
+        return out;
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#ifndef UTILS_FIXED_COLLISION_H
+#define UTILS_FIXED_COLLISION_H
+
+#include "utils/collision_grid.h"
+#include "utils/fixed.h"
+
+// SweepResult in Fixed
+struct FixedSweepResult
+{
+    bool hit = false;
+    Fixed time = Fixed::fromInt(1);
+    Fixed normalX;
+    Fixed normalY;
+};
+
+/**
+    Collision::sweepGrid for the deterministic simulation, the same swept SAT against
+    full tiles and tile shapes, just in Fixed all the way through
+
+    Tile shapes are loaded as floats, every value gets rounded onto the Fixed grid when
+    it is used (fromFloat is exact and the same everywhere), so the shape data itself
+    is the only thing that has to match between machines and it comes from the map file.
+**/
+class FixedCollision
+{
+public:
+    static FixedSweepResult sweepGrid(const CollisionGrid &grid, const FixedAABB &box, Fixed dx, Fixed dy);
+
+    /**
+        Moves position by velocity * dt, sweeping collider (relative to position) through
+        the grid and sliding along whatever it hits, up to maxIterations times. The part
+        of velocity going into a wall is dropped. No grid just moves. Returns true if it
+        hit something
+    **/
+    static bool moveAndSlide(const CollisionGrid *grid, const FixedAABB &collider, FixedVec2 &position, FixedVec2 &velocity,
+                             Fixed dt, int maxIterations);
+};
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#ifndef UTILS_FIXED_TIMESTEP_H
+#define UTILS_FIXED_TIMESTEP_H
+
+#include <cstdint>
+
+// 60 simulation ticks a second no matter how fast we render
+#define SIM_TICK_RATE 60
+/**
+    Most ticks we run in one frame to catch up, after a long stall (window drag,
+    breakpoint, map hot reload) we throw the extra time away instead of running a
+    hundred ticks in a row and stalling the next frame as well (spiral of death)
+**/
+#define SIM_MAX_STEPS_PER_FRAME 5
+
+/**
+    Fixed timestep accumulator
+
+    Every frame we hand it the high resolution clock (SDL_GetPerformanceCounter) and it
+    says how many fixed ticks the simulation owes, the leftover time is kept for the next
+    frame. alpha is how far between the last two ticks we are, the renderer draws things
+    at lerp(previous, current, alpha) so movement is smooth even when the frame rate and
+    the tick rate dont line up.
+
+    The simulation only ever sees getStepSeconds() so the same inputs give the same
+    result on every machine (and on a server).
+
+    Counter based so it doesnt need SDL, the caller passes the clock in
+**/
+class FixedTimestep
+{
+private:
+    uint64_t frequency = 1;
+    uint64_t stepTicks = 1;
+    uint64_t lastCounter = 0;
+    uint64_t accumulator = 0;
+    int tickRate = SIM_TICK_RATE;
+    int maxStepsPerFrame = SIM_MAX_STEPS_PER_FRAME;
+    float stepSeconds = 1.0f / SIM_TICK_RATE;
+    bool started = false;
+
+    // Stats for the debug gui
+    uint64_t totalSteps = 0;
+    int lastFrameSteps = 0;
+    uint64_t droppedTicks = 0;
+
+public:
+    FixedTimestep(int tickRate = SIM_TICK_RATE, int maxStepsPerFrame = SIM_MAX_STEPS_PER_FRAME);
+
+    // Clock ticks per second (SDL_GetPerformanceFrequency), resets the accumulator
+    void reset(uint64_t counter, uint64_t frequency);
+    // How many fixed ticks to run this frame, never more than maxStepsPerFrame
+    int advance(uint64_t counter);
+
+    // Getters
+    float getStepSeconds() const { return stepSeconds; }
+    // 0 -> 1, how far we are from the last tick towards the next one
+    float getAlpha() const;
+    uint64_t getTotalSteps() const { return totalSteps; }
+    int getLastFrameSteps() const { return lastFrameSteps; }
+    // Time thrown away by the catch up cap, in seconds
+    double getDroppedSeconds() const;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#pragma once
+
+#ifndef UTILS_FLOW_FIELD_H
+#define UTILS_FLOW_FIELD_H
+
+#include "utils/collision_grid.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Costs are in tenths of a tile so diagonals can be 1.4 without floats
+#define FLOW_STRAIGHT_COST 10
+#define FLOW_DIAGONAL_COST 14
+#define FLOW_UNREACHABLE 0xFFFFFFFFu
+#define FLOW_NO_DIRECTION 8
+// What the goal is stored as after a full build, see costBase
+#define FLOW_COST_BASE 0x40000000u
+
+/**
+    Flow field towards one goal tile
+
+    Instead of every NPC running its own A* to the same target we work out the distance
+    from every tile to the goal once (the integration field) and then which neighbour is
+    downhill from every tile (the direction field). An agent just looks up the tile it is
+    standing on, so a thousand agents chasing the player cost one build.
+
+    Movement is 8 way but diagonals cant cut wall corners, shaped tiles count as walls.
+**/
+class FlowField
+{
+private:
+    int width = 0;
+    int height = 0;
+    int tileWidth = 0;
+    int tileHeight = 0;
+    int goalX = -1;
+    int goalY = -1;
+    bool incremental = false;
+    int changedCount = 0;
+    // Stored costs are the distance + costBase, a goal move takes the step off costBase
+    // instead of adding it to every tile
+    uint32_t costBase = FLOW_COST_BASE;
+
+    std::vector<uint32_t> cost;     // FLOW_UNREACHABLE for walls and cut off areas, see costBase
+    std::vector<uint8_t> direction; // 0 -> 7 index into the direction table or FLOW_NO_DIRECTION
+    std::vector<uint8_t> steps;     // bit n set if moving in direction n from the tile is allowed
+
+    // Dijkstra scratch, kept around so rebuilding doesnt allocate
+    std::vector<int> buckets[FLOW_DIAGONAL_COST + 1];
+    std::vector<int> changed;
+    std::vector<int> touched;
+    std::vector<uint8_t> dirty; // 1 relaxed by the current moveGoal, 2 already in touched
+
+    void resize(const CollisionGrid &grid);
+    void buildStepMasks(const CollisionGrid &grid);
+    void propagate(bool trackChanges);
+    void updateDirection(int index);
+    bool canStep(const CollisionGrid &grid, int x, int y, int dir) const;
+
+public:
+    FlowField() = default;
+
+    // Full rebuild, returns false if the goal is not a walkable tile (everything is unreachable)
+    bool build(const CollisionGrid &grid, int goalX, int goalY);
+    /**
+        Moves the goal, when the new goal is next to the old one we start from the old
+        distances (+ the step between the goals, which can only be too high) and only
+        spread out the tiles that got closer, anything else does a full build.
+        The grid has to be the same one the field was built on
+
+        On open ground most of the map does get closer (every tile the goal stepped
+        towards, and the diagonal fans either side), so this only saves the step masks
+        and whatever is behind the goal, about a third of a full build at 960x640
+    **/
+    bool moveGoal(const CollisionGrid &grid, int goalX, int goalY);
+    void clear();
+
+    // Getters
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getGoalX() const { return goalX; }
+    int getGoalY() const { return goalY; }
+    bool isEmpty() const { return cost.empty(); }
+    // Did the last build / moveGoal get away with the incremental update
+    bool wasIncremental() const { return incremental; }
+    // Tiles the last incremental moveGoal had to spread out again
+    int getChangedCount() const { return changedCount; }
+    uint32_t getCost(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= width || y >= height) return FLOW_UNREACHABLE;
+        uint32_t value = cost[x + y * width];
+        return value == FLOW_UNREACHABLE ? FLOW_UNREACHABLE : value - costBase;
+    }
+    int getDirection(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= width || y >= height) return FLOW_NO_DIRECTION;
+        return direction[x + y * width];
+    }
+
+    /**
+        Which way to go from a world position, the direction is unit length.
+        Returns false (and 0, 0) on the goal tile, on walls and where the goal cant be reached
+    **/
+    bool sample(float worldX, float worldY, float &dirX, float &dirY) const;
+};
+
+/**
+    Builds flow fields on a worker thread so a goal that moves every tick (the player)
+    never stalls the frame
+
+    The main thread asks for a goal and calls update() once a tick, the worker builds into
+    its own field and hands over a copy when it is done, update() then swaps that in as
+    the field agents read. Agents keep following the previous field until then which
+    is at most a tick or two behind. Requests that come in while the worker is busy
+    just replace each other so it always builds the newest goal.
+**/
+class FlowFieldService
+{
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running = false;
+
+    // Main thread -> worker (guarded by mutex)
+    bool hasRequest = false;
+    bool gridChanged = false;
+    int requestX = -1;
+    int requestY = -1;
+    CollisionGrid pendingGrid;
+
+    // Worker -> main thread (guarded by mutex)
+    bool hasResult = false;
+    FlowField ready;
+    double lastBuildMilliseconds = 0.0;
+    int buildCount = 0;
+    int incrementalCount = 0;
+
+    // Only touched by the worker
+    CollisionGrid workerGrid;
+    FlowField working;
+
+    // Only touched by the main thread
+    FlowField front;
+    int lastRequestX = -1;
+    int lastRequestY = -1;
+
+    void run();
+
+public:
+    FlowFieldService() = default;
+    ~FlowFieldService();
+
+    void start();
+    void stop();
+
+    // Copies the grid over to the worker, the next build is a full one
+    void setGrid(const CollisionGrid &grid);
+    // Does nothing if the goal did not change
+    void requestGoal(int tileX, int tileY);
+    // Picks up a finished field, returns true if the field changed
+    bool update();
+
+    // Getters
+    const FlowField &getField() const { return front; }
+    bool isRunning() const { return running; }
+    double getLastBuildMilliseconds();
+    int getBuildCount();
+    int getIncrementalCount();
+};
+
+#endif
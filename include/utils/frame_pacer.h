@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef UTILS_FRAME_PACER_H
+#define UTILS_FRAME_PACER_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+// Frame rates the debug gui offers, 0 is uncapped
+#define FRAME_PACER_UNCAPPED 0
+/**
+    SDL_Delay can oversleep by a millisecond or two (more on some schedulers), so we
+    only sleep until this far from the deadline and spin the rest
+**/
+#define FRAME_PACER_SPIN_MS 2.0
+// How many frames the frame time mean / variance are over
+#define FRAME_PACER_HISTORY 120
+
+/**
+    Extra time on top of the measured frame cost we leave before the deadline, covers
+    a frame that runs a bit slower than the last few
+**/
+#define FRAME_PACER_WORK_MARGIN_MS 1.0
+// The frame cost estimate drops by 1 / this every frame it isnt topped up
+#define FRAME_PACER_WORK_DECAY 32
+
+/**
+    Holds every frame to the same length, and does the waiting at the start of the
+    frame instead of the end
+
+    beginFrame() waits until just enough time is left before the next deadline to get
+    the frame done (how long the recent frames took plus a margin), then we poll input,
+    simulate, draw and present. Waiting after present instead would leave every input
+    sitting around for the whole wait before we even look at it. endFrame() goes right
+    after present and records how long everything took.
+
+    Waiting is a coarse SDL_Delay for most of it and a spin on SDL_GetPerformanceCounter
+    for the last couple of milliseconds, so we land on time instead of wherever the
+    scheduler wakes us up. Deadlines advance by exactly one frame each time so small
+    overshoots dont add up, if we fall more than a frame behind (hitch, loading) we
+    start counting from now again instead of rushing a bunch of frames out.
+
+    With vsync on present already blocks until the refresh, so we only pace when the
+    target is below the refresh rate (30 on a 60Hz monitor), otherwise pacing on top of
+    vsync would just make us miss refreshes.
+**/
+class FramePacer
+{
+private:
+    int targetFps = 60;
+    bool vsync = false;
+    int refreshRate = 0;
+
+    uint64_t frequency = 1;
+    uint64_t frameTicks = 0;    // 0 = not pacing
+    uint64_t deadline = 0;      // when the next present should happen
+    uint64_t frameStart = 0;
+    uint64_t lastPresent = 0;
+    uint64_t workEstimate = 0;  // counter ticks from beginFrame to present
+
+    // Frame to frame times in ms, ring buffer with running sums for the mean / variance
+    double history[FRAME_PACER_HISTORY] = {};
+    int historyCount = 0;
+    int historyNext = 0;
+    double historySum = 0.0;
+    double historySumSquares = 0.0;
+
+    double lastFrameMs = 0.0;
+    double lastWorkMs = 0.0;
+    double lastWaitMs = 0.0;
+
+    void updateFrameTicks();
+    void waitUntil(uint64_t target);
+    void recordFrame(double milliseconds);
+
+public:
+    FramePacer();
+
+    // Getters
+    int getTargetFps() const { return targetFps; }
+    bool getVsync() const { return vsync; }
+    int getRefreshRate() const { return refreshRate; }
+    // True when beginFrame actually waits (false when uncapped or vsync does the pacing)
+    bool isPacing() const { return frameTicks != 0; }
+    double getLastFrameMs() const { return lastFrameMs; }
+    // beginFrame -> endFrame, input to present
+    double getLastWorkMs() const { return lastWorkMs; }
+    double getLastWaitMs() const { return lastWaitMs; }
+    double getMeanFrameMs() const;
+    // ms^2, a perfectly paced game sits near 0
+    double getFrameVariance() const;
+
+    // Setters
+    void setTargetFps(int fps);
+    void setVsync(bool vsync, int refreshRate);
+
+    // Methods
+    // Waits until it is time to start the frame, call before polling input
+    void beginFrame();
+    // Right after present
+    void endFrame();
+};
+
+#endif
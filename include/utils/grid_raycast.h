@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef UTILS_GRID_RAYCAST_H
+#define UTILS_GRID_RAYCAST_H
+
+#include "utils/collision_grid.h"
+#include <cstdint>
+#include <vector>
+
+/**
+    A segment from (x1, y1) to (x2, y2) in world units
+**/
+struct GridRay
+{
+    float x1 = 0.0f;
+    float y1 = 0.0f;
+    float x2 = 0.0f;
+    float y2 = 0.0f;
+};
+
+/**
+    Where a ray stopped
+
+    fraction is how far along the ray (0 -> 1) the hit is, x / y is the hit point and
+    the normal is the face that was hit (0, 0 if the ray started inside of something)
+**/
+struct GridRayHit
+{
+    bool hit = false;
+    float fraction = 1.0f;
+    float x = 0.0f;
+    float y = 0.0f;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+    int tileX = -1;
+    int tileY = -1;
+};
+
+/**
+    Line of sight / raycasts through the CollisionGrid
+
+    Walks the tiles the ray passes through in order (Amanatides & Woo) so the cost is
+    the number of tiles crossed, not the size of the map, and it stops at the first
+    blocker. Full tiles block where the ray enters them, shaped tiles are clipped
+    against their actual shapes so a ray can pass over half tiles and along slopes.
+
+    Outside the map counts as solid like everywhere else, a ray that leaves the map
+    hits its edge.
+**/
+class GridRaycast
+{
+public:
+    static GridRayHit cast(const CollisionGrid &grid, float x1, float y1, float x2, float y2);
+    static GridRayHit cast(const CollisionGrid &grid, const GridRay &ray)
+    {
+        return cast(grid, ray.x1, ray.y1, ray.x2, ray.y2);
+    }
+    // Can (x1, y1) see (x2, y2)?
+    static bool lineOfSight(const CollisionGrid &grid, float x1, float y1, float x2, float y2)
+    {
+        return !cast(grid, x1, y1, x2, y2).hit;
+    }
+
+    /**
+        Batch versions for when AI / projectiles / the server have a lot of rays to
+        check in a tick, hits is resized to match and both return how many rays hit.
+        The visible mask works like the AABBKernels ones, bit (i % 32) of mask[i / 32]
+        is set if ray i can see its end point, it needs (count + 31) / 32 words
+    **/
+    static int castBatch(const CollisionGrid &grid, const std::vector<GridRay> &rays, std::vector<GridRayHit> &hits);
+    static int lineOfSightBatch(const CollisionGrid &grid, const GridRay *rays, int count, uint32_t *visibleMask);
+};
+
+#endif
@@ -0,0 +1,161 @@
+#pragma once
+
+#ifndef UTILS_HIERARCHICAL_PATHFINDER_H
+#define UTILS_HIERARCHICAL_PATHFINDER_H
+
+#include "utils/collision_grid.h"
+#include "utils/jump_point_search.h"
+#include <cstdint>
+#include <vector>
+
+/**
+    A path from the HierarchicalPathfinder
+
+    waypoints are the start, the cluster entrances the route goes through and the goal.
+    Two waypoints next to each other are always in the same cluster (or on both sides of
+    an entrance) so turning a segment into tiles is a tiny search, agents only do that
+    for the segment they are walking (HierarchicalPathfinder::refineSegment).
+**/
+struct HierarchicalPath
+{
+    std::vector<PathPoint> waypoints;
+    uint32_t cost = 0;  // same tenth of a tile units as JPS / flow fields
+};
+
+/**
+    HPA*, pathfinding on a small graph of cluster entrances instead of on tiles
+
+    The map is cut into clusterSize x clusterSize clusters. Wherever two clusters touch
+    and both sides are open we put an entrance (one in the middle of a short opening,
+    one at each end of a long one) and for every cluster we work out how far each of its
+    entrances is from the others without leaving the cluster. A query only has to connect
+    the start and goal to the entrances of their own clusters and then search the entrance
+    graph, a cross map route on a 960x640 map expands a few hundred entrances where JPS
+    would go through thousands of jump points. Paths come out a percent or two longer than
+    the best one.
+
+    When tiles change only the clusters they are in (and the ones sharing a border with
+    those, their entrances might have moved) get rebuilt, see update().
+
+    Same movement rules as JPS / flow fields, 8 way without cutting corners.
+**/
+class HierarchicalPathfinder
+{
+private:
+    struct Entrance
+    {
+        int tileA;  // left / top cluster side
+        int tileB;  // right / bottom cluster side
+    };
+
+    struct ClusterNode
+    {
+        int tile;
+        int x;
+        int y;
+        int partners[2];    // tile on the other side of each entrance this node is part of
+        int partnerCount;
+    };
+
+    struct Cluster
+    {
+        std::vector<ClusterNode> nodes;
+        std::vector<uint32_t> distances;    // nodes x nodes, FLOW style unreachable = 0xFFFFFFFF
+        // Steps allowed from each tile that stay inside the cluster, bit n for direction n,
+        // indexed like localCost
+        std::vector<uint8_t> steps;
+        // Tile paths between nodes, worked out the first time a segment needs one.
+        // pathStart is nodes x nodes, -1 until then, else where the path starts in
+        // pathTiles: its length followed by the cluster local tiles (0 if unreachable)
+        std::vector<int> pathStart;
+        std::vector<int> pathTiles;
+    };
+
+    struct OpenNode
+    {
+        uint32_t f;
+        uint32_t g;
+        int slot;
+    };
+
+    int clusterSize;
+    // Node slots a cluster gets in the search arrays, enough for an entrance on every other border tile
+    int slotsPerCluster;
+    int width = 0;
+    int height = 0;
+    int clustersX = 0;
+    int clustersY = 0;
+    uint32_t gridVersion = 0;
+    std::vector<uint8_t> walkable;
+
+    std::vector<Cluster> clusters;
+    // Border to the right of / below each cluster
+    std::vector<std::vector<Entrance>> rightBorders;
+    std::vector<std::vector<Entrance>> bottomBorders;
+    // Which node of its cluster a tile is, -1 if it is not one
+    std::vector<int16_t> tileNode;
+
+    // Abstract search state by node slot (cluster * slotsPerCluster + node, the start and
+    // goal get the two after the last cluster's when they arent nodes themselves), only
+    // valid when the stamp matches
+    uint32_t generation = 0;
+    std::vector<uint32_t> visited;
+    std::vector<uint32_t> closed;
+    std::vector<uint32_t> cost;
+    std::vector<int> parent;
+    /**
+        Open list as a radix heap on f, bucket n holds the nodes whose f first differs from
+        openLast (the last f popped) at bit n - 1. With the octile heuristic f never goes
+        down, so the next node is always in the lowest bucket that isnt empty and a pop
+        only sorts that one bucket out instead of keeping the whole list in order
+    **/
+    std::vector<OpenNode> openBuckets[33];
+    uint32_t openLast = 0;
+
+    // Cluster local search scratch
+    std::vector<uint32_t> localCost;
+    std::vector<int> localParent;
+    std::vector<int> localBuckets[15];
+    std::vector<uint32_t> goalCost;
+
+    int expanded = 0;
+
+    void buildBorders(int clusterX, int clusterY);
+    void buildCluster(int clusterX, int clusterY);
+    void addEntrances(std::vector<Entrance> &border, int startA, int startB, int step, int length);
+    void searchCluster(int clusterIndex, int startTile);
+    void cachePathsFrom(int clusterIndex, int node);
+    void pushOpen(const OpenNode &node);
+    bool popOpen(OpenNode &node);
+    void getClusterBounds(int clusterIndex, int &minX, int &minY, int &maxX, int &maxY) const;
+    int getClusterOf(int tile) const;
+    int getSlotOf(int tile) const;
+
+public:
+    HierarchicalPathfinder(int clusterSize = 32);
+
+    // Full build of everything (first load, hot reload, map size changed)
+    void build(const CollisionGrid &grid);
+    /**
+        Brings the graph up to date with the grid, only the clusters that have changed
+        tiles (and their neighbours) are rebuilt. Returns how many clusters were rebuilt
+    **/
+    int update(const CollisionGrid &grid);
+
+    bool findPath(int startX, int startY, int goalX, int goalY, HierarchicalPath &path);
+    /**
+        Tiles of waypoints[segment] -> waypoints[segment + 1] (both ends included), node to
+        node segments come out of the cluster's path cache after the first time
+    **/
+    bool refineSegment(const HierarchicalPath &path, size_t segment, std::vector<PathPoint> &tiles);
+
+    // Getters
+    int getClusterSize() const { return clusterSize; }
+    int getClusterCount() const { return (int)clusters.size(); }
+    int getNodeCount() const;
+    uint32_t getGridVersion() const { return gridVersion; }
+    // Entrance nodes taken off the open list by the last search
+    int getExpanded() const { return expanded; }
+};
+
+#endif
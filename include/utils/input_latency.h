@@ -0,0 +1,67 @@
+#pragma once
+
+#ifndef UTILS_INPUT_LATENCY_H
+#define UTILS_INPUT_LATENCY_H
+
+#include <cstdint>
+
+// How many frames the averages / worst case are over
+#define INPUT_LATENCY_HISTORY 120
+
+/**
+    Measures how long input takes to get on screen
+
+    Every frame has two parts:
+        - sample -> present : from when we polled the input to when the frame with its
+          result was presented, this is what the frame layout controls
+        - queue age : how long the oldest key event of the frame sat in SDL's queue
+          before we polled it (event timestamps are SDL_GetTicks milliseconds), this is
+          what sampling late shrinks
+
+    input -> present is the two added up, only counted on frames that had key events.
+    All counters are SDL_GetPerformanceCounter ticks.
+**/
+class InputLatency
+{
+private:
+    struct History
+    {
+        float samples[INPUT_LATENCY_HISTORY] = {};
+        int count = 0;
+        int next = 0;
+
+        void add(float milliseconds);
+        float mean() const;
+        float max() const;
+    };
+
+    uint64_t frequency = 1;
+    uint64_t sampledAt = 0;
+    float oldestEventAgeMs = -1.0f;     // < 0 = no input this frame
+
+    History sampleToPresent;
+    History inputToPresent;
+
+    float lastSampleToPresentMs = 0.0f;
+    float lastInputToPresentMs = 0.0f;
+
+public:
+    InputLatency();
+
+    // Right after polling, eventAgeMs is how old the oldest input event was (< 0 if none)
+    void markSampled(uint64_t counter, float eventAgeMs);
+    // Right after SDL_RenderPresent
+    void markPresented(uint64_t counter);
+
+    // Getters
+    float getLastSampleToPresentMs() const { return lastSampleToPresentMs; }
+    float getMeanSampleToPresentMs() const { return sampleToPresent.mean(); }
+    float getLastInputToPresentMs() const { return lastInputToPresentMs; }
+    float getMeanInputToPresentMs() const { return inputToPresent.mean(); }
+    float getMaxInputToPresentMs() const { return inputToPresent.max(); }
+    // Last INPUT_LATENCY_HISTORY sample -> present times for plotting (ring buffer order)
+    const float *getSampleToPresentHistory() const { return sampleToPresent.samples; }
+    int getHistoryOffset() const { return sampleToPresent.next; }
+};
+
+#endif
@@ -0,0 +1,184 @@
+#pragma once
+
+#ifndef UTILS_JOB_SYSTEM_H
+#define UTILS_JOB_SYSTEM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Below this many items parallelFor just runs the loop, handing out jobs costs more
+#define JOB_MIN_PARALLEL_ITEMS 256
+
+class JobCounter;
+
+/**
+    One piece of work, function(data, begin, end)
+
+    Plain function pointer + data instead of std::function so queueing a job never
+    allocates, parallelFor wraps lambdas in one of these for you
+**/
+typedef void (*JobFunction)(void *data, int begin, int end);
+
+struct Job
+{
+    JobFunction function = nullptr;
+    void *data = nullptr;
+    int begin = 0;
+    int end = 0;
+    JobCounter *counter = nullptr;  // gets counted down when the job finishes
+};
+
+/**
+    Counts unfinished jobs, this is how you wait on work and chain work after other work
+
+    Every job run with a counter bumps it and counts it back down when it finishes, so a
+    counter at 0 means everything that was run with it is done. Jobs run "after" a counter
+    are held on it and only get queued once it hits 0 (a fence).
+**/
+class JobCounter
+{
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{0};
+    // Workers still inside the counter after counting it down, the counter cant be
+    // destroyed (it usually lives on the waiter's stack) until they are out
+    std::atomic<int> finishing{0};
+    std::mutex mutex;
+    std::vector<Job> continuations;
+
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    bool isDone() const
+    {
+        return pending.load(std::memory_order_acquire) == 0 && finishing.load(std::memory_order_acquire) == 0;
+    }
+};
+
+/**
+    Work stealing job scheduler
+
+    Every worker thread has its own deque of jobs. A worker pushes and pops at the back
+    of its own deque (last in first out, the data it just touched is still in cache) and
+    when it runs dry it steals from the front of someone else's, the oldest and usually
+    biggest piece of work. Workers with nothing to do sleep on a condition variable.
+
+    The thread that made the JobSystem (the main thread) is worker 0. It doesnt have a
+    thread of its own, it runs jobs while it waits on a counter, so waiting never
+    deadlocks and the main thread isnt just idling while the workers go.
+
+    Each deque has its own mutex instead of a lock free Chase-Lev deque, the locks are
+    almost never contended since thieves only show up when a worker is out of work.
+**/
+class JobSystem
+{
+public:
+    struct WorkerStats
+    {
+        uint64_t jobs = 0;          // jobs run since the last snapshot
+        uint64_t steals = 0;        // of those, how many were stolen from another worker
+        double busyMilliseconds = 0.0;
+        double utilisation = 0.0;   // busy / wall time between the last two snapshots
+    };
+
+private:
+    struct alignas(64) Worker
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::atomic<uint64_t> jobsRun{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> busyNanoseconds{0};
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<Worker> workers;
+    std::atomic<bool> running{true};
+    std::atomic<int> queued{0};
+    std::atomic<uint32_t> nextVictim{0};
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    std::vector<WorkerStats> stats;
+    std::chrono::steady_clock::time_point lastSnapshot;
+
+    int currentWorker() const;
+    void push(int worker, const Job &job);
+    bool findJob(int worker, Job &job);
+    void execute(int worker, const Job &job);
+    void workerLoop(int worker);
+    void wakeWorkers(int count);
+
+    template <typename Fn>
+    static void callRange(void *data, int begin, int end) { (*static_cast<const Fn *>(data))(begin, end); }
+
+public:
+    // -1 = one thread per core minus the main thread
+    JobSystem(int workerThreads = -1);
+    ~JobSystem();
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /**
+        Queues a job. counter (if any) is bumped now and counted down when the job is
+        done, if after is given the job waits on that counter before it can start
+    **/
+    void run(Job job, JobCounter *counter = nullptr, JobCounter *after = nullptr);
+    // Runs jobs until the counter hits 0
+    void wait(JobCounter &counter);
+
+    /**
+        Splits [0, count) into ranges of about grain items and runs fn(begin, end) on
+        each, on every worker. Returns once they are all done. Small loops run inline
+    **/
+    template <typename Fn>
+    void parallelFor(int count, int grain, const Fn &fn)
+    {
+        if (count <= 0) return;
+        if (count < JOB_MIN_PARALLEL_ITEMS || this->threads.empty())
+        {
+            fn(0, count);
+            return;
+        }
+        JobCounter counter;
+        this->parallelForAsync(count, grain, fn, counter);
+        this->wait(counter);
+    }
+
+    // Same as parallelFor but doesnt wait, fn has to live until counter is done
+    template <typename Fn>
+    void parallelForAsync(int count, int grain, const Fn &fn, JobCounter &counter, JobCounter *after = nullptr)
+    {
+        if (grain < 1) grain = 1;
+        Job job;
+        job.function = &JobSystem::callRange<Fn>;
+        job.data = const_cast<Fn *>(&fn);
+        for (int begin = 0; begin < count; begin += grain)
+        {
+            job.begin = begin;
+            job.end = begin + grain < count ? begin + grain : count;
+            this->run(job, &counter, after);
+        }
+    }
+
+    // Getters
+    // Worker threads + the main thread
+    int getWorkerCount() const { return (int)this->workers.size(); }
+    // Grain that gives every worker a few ranges to balance with
+    int suggestGrain(int count) const;
+
+    // Collects the per worker counters since the last call into getStats, once a frame or so
+    void snapshotStats();
+    const std::vector<WorkerStats> &getStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#ifndef UTILS_JUMP_POINT_SEARCH_H
+#define UTILS_JUMP_POINT_SEARCH_H
+
+#include "utils/collision_grid.h"
+#include <cstdint>
+#include <vector>
+
+struct PathPoint
+{
+    int x = 0;
+    int y = 0;
+};
+
+/**
+    A* with Jump Point Search over the collision grid
+
+    On open maps plain A* puts every tile of a corridor in the open list, JPS instead runs
+    along straight and diagonal lines until something interesting happens (a wall corner
+    opens up a new way to go) and only those jump points go in the open list. Same path
+    cost as A*, a lot less heap work.
+
+    8 way movement where diagonals cant cut wall corners (same rules as the FlowField),
+    shaped tiles count as walls. Paths come back as the jump points from start to goal,
+    consecutive points are always on a straight or 45 degree line.
+
+    Everything the search needs is kept between queries: the per tile costs / parents are
+    only valid when their stamp matches the query generation so nothing is cleared
+    between searches, and the open list keeps its capacity. After the first few queries
+    a search doesnt allocate (apart from growing the output path).
+**/
+class JumpPointSearch
+{
+private:
+    struct OpenNode
+    {
+        uint32_t f;
+        uint32_t g;
+        int index;
+    };
+
+    int width = 0;
+    int height = 0;
+    // Rows are padded by one blocked tile on every side so jumps never bounds check
+    int stride = 0;
+    uint32_t gridVersion = 0;
+    std::vector<uint8_t> walkable;
+
+    // Per tile search state, all indexed by padded index
+    uint32_t generation = 0;
+    std::vector<uint32_t> visited;  // == generation when cost / parent are from this search
+    std::vector<uint32_t> closed;   // == generation when the tile was expanded
+    std::vector<uint32_t> cost;
+    std::vector<int> parent;
+
+    std::vector<OpenNode> open;
+    int goal = -1;
+    int goalX = 0;
+    int goalY = 0;
+    int expanded = 0;
+
+    int jump(int index, int dx, int dy) const;
+    void pushJumpPoint(int from, int to);
+    uint32_t heuristic(int index) const;
+
+public:
+    JumpPointSearch() = default;
+
+    // Copies the walkable tiles out of the grid, needs to run again when the grid changes
+    void build(const CollisionGrid &grid);
+    /**
+        Tile coordinates in, jump points out (start and goal included).
+        Returns false if either end is a wall or there is no way between them
+    **/
+    bool findPath(int startX, int startY, int goalX, int goalY, std::vector<PathPoint> &path);
+
+    // Getters
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    uint32_t getGridVersion() const { return gridVersion; }
+    // Tiles taken off the open list by the last search
+    int getExpanded() const { return expanded; }
+};
+
+#endif
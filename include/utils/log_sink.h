@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef UTILS_LOG_SINK_H
+#define UTILS_LOG_SINK_H
+
+#include "utils/error_code.h"
+#include <string>
+
+typedef void (*LogSinkFunction)(const std::string &log, ErrorCode code);
+
+/**
+    Where code that doesnt know about the debug gui sends its logs (map loading, the
+    server, ...). Prints to stdout until someone sets a sink, the game points it at
+    DebugGUI::addDebugLog so nothing changes there, the headless server just keeps
+    the stdout one
+**/
+class LogSink
+{
+private:
+    static LogSinkFunction sink;
+
+public:
+    static void print(const std::string &log, ErrorCode code);
+
+    // nullptr goes back to print
+    static void set(LogSinkFunction sink);
+    static void write(const std::string &log, ErrorCode code = ErrorCode::NONE);
+};
+
+#endif
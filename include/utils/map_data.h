@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef UTILS_MAP_DATA_H
+#define UTILS_MAP_DATA_H
+
+#include <pugixml.hpp>
+#include <string>
+#include <vector>
+#include "utils/collision_grid.h"
+#include "utils/tile_shapes.h"
+
+// Only ever a pointer here, the map data itself doesnt need SDL
+struct SDL_Texture;
+
+struct TSDL_Layer
+{
+    std::string name;
+    int width;
+    int height;
+    std::vector<int> data;
+};
+struct TSDL_Tileset
+{
+    int firstGid;
+    std::string source;
+};
+/**
+The TSDL_Tileset will have a source file which will be a .tsx xml file
+which we will load and parse to get the tileset information.
+    **/
+struct TSDL_TilesetSource
+{
+    std::string name;
+    int tileWidth;
+    int tileHeight;
+    int tileCount;
+    int columns;
+    std::string imagePath;
+    int imageWidth;
+    int imageHeight;
+    SDL_Texture *texture = nullptr;     // Only the client loads these (TSDL::loadTexture)
+};
+struct TSDL_TileMap
+{
+    int width;
+    int height;
+    int tileWidth;
+    int tileHeight;
+    std::vector<TSDL_Layer> layers;    // Multiple layers
+    std::vector<TSDL_Tileset> tilesets; // Tilesets used
+    std::vector<TSDL_TilesetSource> tilesetSources; // Tilesets used
+    int maxTileCount = 0;
+    TileShapeTable tileShapes;                      // Collision shapes from the tsx files, by gid
+    CollisionGrid collisionGrid;                    // Built from the "Collision" layer
+};
+
+/**
+    Everything about loading a Tiled map that isnt textures: the json layers, the tsx
+    tilesets, their collision shapes and the collision grid. No SDL in here so the
+    headless server loads maps with exactly the same code the client does, TSDL::loadMap
+    is this plus the textures
+**/
+class MapData
+{
+public:
+    /**
+    Load the map and store it inside the TSDL_TileMap Struct, no textures
+    **/
+    static bool load(TSDL_TileMap *tileMap, const std::string &jsonPath, const std::string &tsxPath);
+
+    /**
+    Load the Tileset Source from the .tsx file
+    **/
+    static bool loadTsx(TSDL_TileMap *tileMap, const std::string &path);
+
+    /**
+    Read the per tile collision shapes (<objectgroup>) of a tileset into tileMap->tileShapes
+    **/
+    static void loadTileShapes(TSDL_TileMap *tileMap, pugi::xml_node tilesetNode, int firstGid, const TSDL_TilesetSource &ts);
+
+    /**
+    Flatten the "Collision" layer into the tileMap's collisionGrid
+    **/
+    static void buildCollisionGrid(TSDL_TileMap *tileMap);
+};
+
+#endif
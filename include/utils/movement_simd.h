@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef UTILS_MOVEMENT_SIMD_H
+#define UTILS_MOVEMENT_SIMD_H
+
+#include "utils/fixed.h"
+#include <cmath>
+#include <cstdint>
+
+/**
+    Everything about a movement tick that is the same for every entity, worked out once
+    per tick instead of once per entity (the friction pow especially)
+**/
+struct MovementParams
+{
+    float dt = 0.0f;
+    float accelerationStep = 0.0f;  // acceleration * dt, velocity gained this tick at full input
+    float frictionFactor = 1.0f;    // friction ^ (dt * 60), friction is tuned per 60 Hz frame
+
+    static MovementParams make(float dt, float acceleration, float friction);
+};
+
+/**
+    MovementParams for the deterministic simulation (COMFY_DETERMINISTIC). Takes the
+    tick rate instead of dt so dt * 60 comes out exact (1 at 60 Hz) and the friction
+    pow goes through Fixed::pow, the same bits everywhere
+**/
+struct FixedMovementParams
+{
+    Fixed dt;
+    Fixed accelerationStep;
+    Fixed frictionFactor = Fixed::fromInt(1);
+
+    static FixedMovementParams make(int tickRate, Fixed acceleration, Fixed friction);
+};
+
+/**
+    Pointers into the structure of arrays the kernels run over, slot i of each is one
+    entity. direction is where the entity wants to go, unit length or 0 on an axis it
+    isnt pushing (player input, AI steering, ...)
+**/
+struct MovementArrays
+{
+    float *x = nullptr;
+    float *y = nullptr;
+    float *velocityX = nullptr;
+    float *velocityY = nullptr;
+    const float *directionX = nullptr;
+    const float *directionY = nullptr;
+    const float *maxSpeed = nullptr;
+};
+
+/**
+    Batched movement integration, 8 entities per instruction with AVX, 4 with SSE2 /
+    NEON, the scalar step for the tail and when none of those are available.
+
+    Per entity: accelerate towards direction, clamp to maxSpeed (squared lengths, the
+    one sqrt only happens for entities that are actually over), apply friction on axes
+    with no input, move by velocity * dt. Player::update runs the same stepVelocity
+    before its collision sweep so a crowd would move the way the player does.
+
+    Nothing ticks a crowd through this yet: the player is the only thing the game
+    moves and it needs its swept tile collision after every step, and the server's
+    bodies move in fixed point (BodyMovement) so clients can predict them bit for bit.
+    The movement bench and ComfyServer --selftest are what run integrate for now,
+    ComponentStore::integrateMovement is the system for entities without tile
+    collision once there are some
+
+    The SIMD paths do the exact same IEEE operations in the same order as the scalar
+    step (real sqrt and divide, no rsqrt estimates), so results match bit for bit as
+    long as the compiler isnt allowed to fuse multiply adds. CMake builds every target
+    with -ffp-contract=off (/fp:precise on MSVC) for that, ComfyServer --selftest and
+    the movement bench flag any mismatch.
+**/
+class MovementKernels
+{
+public:
+    // The scalar reference, velocity only
+    static inline void stepVelocity(const MovementParams &params, float directionX, float directionY, float maxSpeed,
+                                    float &velocityX, float &velocityY)
+    {
+        velocityX += directionX * params.accelerationStep;
+        velocityY += directionY * params.accelerationStep;
+
+        float lengthSquared = velocityX * velocityX + velocityY * velocityY;
+        if (lengthSquared > maxSpeed * maxSpeed)
+        {
+            float scale = maxSpeed / std::sqrt(lengthSquared);
+            velocityX *= scale;
+            velocityY *= scale;
+        }
+
+        if (directionX == 0.0f) velocityX *= params.frictionFactor;
+        if (directionY == 0.0f) velocityY *= params.frictionFactor;
+    }
+
+    // stepVelocity in Fixed, the speed clamp compares 64 bit squared lengths
+    static void stepVelocityFixed(const FixedMovementParams &params, const FixedVec2 &direction, Fixed maxSpeed, FixedVec2 &velocity);
+
+    // Slots [begin, end), the SIMD version
+    static void integrate(const MovementParams &params, const MovementArrays &arrays, int begin, int end);
+    // Slots [begin, end), stepVelocity + move one entity at a time, what integrate is checked against
+    static void integrateScalar(const MovementParams &params, const MovementArrays &arrays, int begin, int end);
+
+    static const char *getInstructionSet();
+};
+
+#endif
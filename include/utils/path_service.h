@@ -0,0 +1,59 @@
+#pragma once
+
+#ifndef UTILS_PATH_SERVICE_H
+#define UTILS_PATH_SERVICE_H
+
+#include "utils/jump_point_search.h"
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+    Where agents ask for paths
+
+    Lots of agents end up asking for the same route (a group walking to the same door,
+    an agent re-asking every few ticks) so the last few hundred results are kept by
+    (start tile, goal tile), least recently used goes first. The cache and the JPS copy
+    of the grid are thrown away as soon as the grid version changes so a path never
+    walks through a tile that was just made solid.
+**/
+class PathService
+{
+private:
+    struct CachedPath
+    {
+        uint64_t key;
+        bool found;
+        std::vector<PathPoint> path;
+    };
+
+    JumpPointSearch search;
+    const CollisionGrid *grid = nullptr;
+    uint32_t gridVersion = 0;
+
+    size_t capacity;
+    std::list<CachedPath> recent; // most recently used at the front
+    std::unordered_map<uint64_t, std::list<CachedPath>::iterator> lookup;
+
+    int hits = 0;
+    int misses = 0;
+
+public:
+    PathService(size_t capacity = 256);
+
+    /**
+        Same as JumpPointSearch::findPath but cached, the grid is checked for changes
+        on every call so there is nothing to remember to invalidate
+    **/
+    bool findPath(const CollisionGrid &grid, int startX, int startY, int goalX, int goalY, std::vector<PathPoint> &path);
+    void invalidate();
+
+    // Getters
+    size_t getCachedCount() const { return recent.size(); }
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+    const JumpPointSearch &getSearch() const { return search; }
+};
+
+#endif
@@ -0,0 +1,168 @@
+#pragma once
+
+#ifndef UTILS_POOL_H
+#define UTILS_POOL_H
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Items per block, a block is allocated once and never moves or gets freed until the pool goes
+#define POOL_BLOCK_ITEMS 64
+
+/**
+    Names something in a Pool (or an entity in the ComponentStore)
+
+    index picks the slot, generation is bumped every time the slot is taken and every
+    time it is given back. Live slots have odd generations, so a default handle (0) or a
+    handle to something that was destroyed never matches whatever lives there now.
+**/
+struct PoolHandle
+{
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == 0xFFFFFFFF; }
+    bool operator==(const PoolHandle &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PoolHandle &other) const { return !(*this == other); }
+};
+
+/**
+    Just the handle bookkeeping, generations + a free list of indices
+
+    Freed indices are handed out again last in first out, the most recently freed slot
+    is the one most likely still in cache. Pool and ComponentStore both sit on this.
+**/
+class HandleTable
+{
+private:
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeIndices;
+    int liveCount = 0;
+
+public:
+    HandleTable() = default;
+
+    PoolHandle allocate();
+    // Returns false if the handle was already stale
+    bool release(PoolHandle handle);
+    void clear();
+    void reserve(int count);
+
+    // Getters
+    bool isAlive(PoolHandle handle) const
+    {
+        return handle.index < this->generations.size() && this->generations[handle.index] == handle.generation &&
+               (handle.generation & 1);
+    }
+    bool isIndexAlive(uint32_t index) const { return index < this->generations.size() && (this->generations[index] & 1); }
+    // Handle for whatever is alive at index right now
+    PoolHandle handleAt(uint32_t index) const { return PoolHandle{index, this->generations[index]}; }
+    // Every index ever handed out, live or free
+    int getIndexCount() const { return (int)this->generations.size(); }
+    int getLiveCount() const { return liveCount; }
+    int getFreeCount() const { return (int)this->freeIndices.size(); }
+};
+
+/**
+    Fixed block pool of T with generational handles
+
+    Items live in blocks of BlockItems, once a block exists it never moves so a T* stays
+    good until that item is destroyed. Destroyed slots go on the free list and the next
+    create reuses them, so once a pool has grown to its working size spawning and
+    despawning dont touch the heap at all.
+
+    maxItems caps the pool (0 = no cap), create hands back a null handle when it is
+    full instead of growing, so the memory a pool can take is known up front.
+**/
+template <typename T, int BlockItems = POOL_BLOCK_ITEMS>
+class Pool
+{
+private:
+    struct Block
+    {
+        alignas(T) unsigned char bytes[sizeof(T) * BlockItems];
+    };
+
+    HandleTable handles;
+    std::vector<std::unique_ptr<Block>> blocks;
+    int maxItems;
+
+    T *itemAt(uint32_t index) const
+    {
+        return reinterpret_cast<T *>(this->blocks[index / BlockItems]->bytes + (index % BlockItems) * sizeof(T));
+    }
+
+public:
+    explicit Pool(int maxItems = 0) : maxItems(maxItems) {}
+    ~Pool() { this->clear(); }
+    Pool(const Pool &) = delete;
+    Pool &operator=(const Pool &) = delete;
+
+    // Null handle if the pool is at maxItems
+    template <typename... Args>
+    PoolHandle create(Args &&...args)
+    {
+        if (this->maxItems > 0 && this->handles.getLiveCount() >= this->maxItems) return PoolHandle();
+
+        PoolHandle handle = this->handles.allocate();
+        while (handle.index >= this->blocks.size() * BlockItems)
+        {
+            this->blocks.emplace_back(new Block());
+        }
+        new (this->itemAt(handle.index)) T(std::forward<Args>(args)...);
+        return handle;
+    }
+
+    // Returns false if it was already gone
+    bool destroy(PoolHandle handle)
+    {
+        if (!this->handles.isAlive(handle)) return false;
+        this->itemAt(handle.index)->~T();
+        this->handles.release(handle);
+        return true;
+    }
+
+    // Destroys everything, the blocks stay around for the next creates
+    void clear()
+    {
+        for (int i = 0; i < this->handles.getIndexCount(); i++)
+        {
+            if (this->handles.isIndexAlive(i)) this->destroy(this->handles.handleAt(i));
+        }
+    }
+
+    // Allocates the blocks for count items now so creates up to there never allocate
+    void reserve(int count)
+    {
+        if (this->maxItems > 0 && count > this->maxItems) count = this->maxItems;
+        while ((int)this->blocks.size() * BlockItems < count)
+        {
+            this->blocks.emplace_back(new Block());
+        }
+        this->handles.reserve(count);
+    }
+
+    // Runs fn(handle, item) on every live item
+    template <typename Fn>
+    void forEach(Fn fn)
+    {
+        for (int i = 0; i < this->handles.getIndexCount(); i++)
+        {
+            if (this->handles.isIndexAlive(i)) fn(this->handles.handleAt(i), *this->itemAt(i));
+        }
+    }
+
+    // Getters
+    // nullptr if the handle is stale
+    T *get(PoolHandle handle) const { return this->handles.isAlive(handle) ? this->itemAt(handle.index) : nullptr; }
+    bool isAlive(PoolHandle handle) const { return this->handles.isAlive(handle); }
+    int size() const { return this->handles.getLiveCount(); }
+    int getCapacity() const { return (int)this->blocks.size() * BlockItems; }
+    int getMaxItems() const { return maxItems; }
+    size_t getBytes() const { return this->blocks.size() * sizeof(Block); }
+};
+
+#endif
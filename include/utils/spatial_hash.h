@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef UTILS_SPATIAL_HASH_H
+#define UTILS_SPATIAL_HASH_H
+
+#include <cstdint>
+#include <vector>
+#include "utils/aabb.h"
+
+/**
+    Uniform grid broadphase for entity vs entity collision
+
+    The cells line up with the map tiles (a cell is tilesPerCell x tilesPerCell tiles)
+    and get hashed into a table so entities walking off the map or huge maps dont
+    need a giant dense grid.
+
+    Every tick call rebuild() with the AABBs of everything that moved, it is a counting
+    sort so it is O(n) and once the vectors have grown to fit it stops allocating.
+    findPairs() then hands back every pair of overlapping boxes exactly once.
+
+    Works best when the entities are around the size of a cell, for a mix of tiny and
+    huge things use the AABBTree instead.
+**/
+struct BroadphasePair
+{
+    int a;
+    int b;
+};
+
+class SpatialHash
+{
+private:
+    struct Entry
+    {
+        int proxy;
+        int64_t cellKey;
+    };
+
+    float cellWidth = 32.0f;
+    float cellHeight = 32.0f;
+
+    // Buckets are stored flat: entries for bucket b live in [bucketStart[b], bucketStart[b + 1])
+    uint32_t bucketMask = 0;
+    std::vector<uint32_t> bucketStart;
+    std::vector<Entry> entries;
+    std::vector<AABB> boxes;
+
+    int64_t cellKey(int cellX, int cellY) const { return ((int64_t)cellX << 32) | (uint32_t)cellY; }
+    uint32_t hashCell(int cellX, int cellY) const;
+    void cellRange(const AABB &box, int &startX, int &startY, int &endX, int &endY) const;
+
+public:
+    SpatialHash(int tileWidth = 16, int tileHeight = 16, int tilesPerCell = 2);
+
+    // Getters
+    float getCellWidth() const { return cellWidth; }
+    float getCellHeight() const { return cellHeight; }
+    int getProxyCount() const { return (int)boxes.size(); }
+    const AABB &getBox(int proxy) const { return boxes[proxy]; }
+
+    // Setters
+    void setCellSize(int tileWidth, int tileHeight, int tilesPerCell = 2);
+
+    // Methods
+    void rebuild(const AABB *boxes, int count);
+    void rebuild(const std::vector<AABB> &boxes) { rebuild(boxes.data(), (int)boxes.size()); }
+
+    // Clears out and fills pairs, reuse the same vector every tick so it doesnt allocate
+    void findPairs(std::vector<BroadphasePair> &pairs) const;
+
+    // Every proxy whose box overlaps the query box (each proxy once)
+    void query(const AABB &box, std::vector<int> &results) const;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef UTILS_TILE_SHAPES_H
+#define UTILS_TILE_SHAPES_H
+
+#include "utils/aabb.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tiled lets you draw anything, we only keep convex shapes up to this many points
+#define MAX_SHAPE_VERTICES 8
+
+/**
+    One convex collision shape of a tile, in tile local pixels (0,0 is the top left of the tile)
+
+    The separating axes are worked out once when the tileset is loaded so the narrowphase
+    only has to project the box onto them. X and Y are always tested through the bounds
+    so they are not stored again, which means a rectangle has no extra axes at all and
+    costs exactly the same as a full tile.
+**/
+struct TileShape
+{
+    AABB bounds;
+    int vertexCount = 0;
+    float vertices[MAX_SHAPE_VERTICES * 2];
+
+    // Unit length edge normals that are not X or Y (duplicates removed)
+    int axisCount = 0;
+    float axes[MAX_SHAPE_VERTICES * 2];
+    // The shape projected onto each of the axes
+    float axisMin[MAX_SHAPE_VERTICES];
+    float axisMax[MAX_SHAPE_VERTICES];
+
+    static TileShape fromRect(float x, float y, float width, float height);
+    /**
+        points are x,y pairs, returns false if the polygon is not convex, has less than
+        3 points or more than MAX_SHAPE_VERTICES (the caller decides what to fall back to)
+    **/
+    static bool fromPolygon(const float *points, int count, TileShape &out);
+};
+
+/**
+    Every collision shape of every tileset, indexed by gid
+
+    The shapes of a gid sit next to each other in one vector so looking them up is
+    just two array reads, gids without shapes have a count of 0 and are treated as
+    a full solid tile by the collision grid.
+**/
+class TileShapeTable
+{
+private:
+    std::vector<TileShape> shapes;
+    std::vector<uint32_t> firstShape;
+    std::vector<uint8_t> shapeCount;
+
+public:
+    TileShapeTable() = default;
+
+    // Replaces whatever shapes the gid had
+    void setShapes(int gid, const std::vector<TileShape> &tileShapes);
+    void clear();
+
+    // Getters
+    bool isEmpty() const { return shapes.empty(); }
+    size_t getShapeCount() const { return shapes.size(); }
+    bool hasShapes(int gid) const
+    {
+        return gid >= 0 && gid < (int)shapeCount.size() && shapeCount[gid] != 0;
+    }
+    // Returns how many shapes the gid has and points out at the first one
+    int getShapes(int gid, const TileShape **out) const
+    {
+        if (!hasShapes(gid)) return 0;
+        *out = &shapes[firstShape[gid]];
+        return shapeCount[gid];
+    }
+};
+
+#endif
@@ -1,174 +1,27 @@
 #include "TSDL.h"
 #include "comfy_lib.h"
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
 
     /** 
-    Load the map and store it inside the TSDL_TileMap Struct
+    Load the map and store it inside the TSDL_TileMap Struct (MapData::load) then
+    load the tileset textures for it
     **/
     bool
     TSDL::loadMap(SDL_Renderer* renderer, TSDL_TileMap *tileMap, const std::string& jsonPath, const std::string& tsxPath)
     {
-        std::ifstream file(jsonPath);
-        // Open the file
-        if (!file.is_open())
+        if (!MapData::load(tileMap, jsonPath, tsxPath))
         {
-            DebugGUI::addDebugLog("Error: Could not open the file:", std::vector<ErrorCode>{ErrorCode::FILE_ERROR, ErrorCode::JSON_ERROR});
-            return false;
-        }
-
-        // Read the file
-        json j;
-        file >> j;
-        // Close the File
-        file.close();
-
-        // Load Basic Information
-        tileMap->width = j.at("width");
-        tileMap->height = j.at("height");
-        tileMap->tileWidth = j.at("tilewidth");
-        tileMap->tileHeight = j.at("tileheight");
-
-        // Load Tilesets
-
-        for (auto &tileset : j.at("tilesets"))
-        {
-            // Create a Tileset Object
-            TSDL_Tileset t;
-
-            // Load Basic Information
-            t.source = tileset.at("source");
-            t.firstGid = tileset.at("firstgid");
-
-            tileMap->tilesets.push_back(t);
-        }
-
-        // Load Layers
-        for (auto &layer : j.at("layers"))
-        {
-            // Create a Layer Object
-            TSDL_Layer l;
-
-            // Load Basic Information
-            l.name = layer.at("name");
-
-            // Only assign width and height if it's a tile layer
-            if (layer.contains("width") && layer.contains("height"))
-            {
-                l.width = layer.at("width");
-                l.height = layer.at("height");
-            }
-            else
-            {
-                // If it's an object layer, set width/height to 0 or handle differently
-                l.width = 0;
-                l.height = 0;
-            }
-
-            // Only parse "data" if it's present (Tile layers have data, object layers do not)
-            if (layer.contains("data"))
-            {
-                l.data = layer.at("data").get<std::vector<int>>();
-            }
-
-            tileMap->layers.push_back(l);
-        }
-
-        // We Will load the tsx files right now
-        // this will be whaterver ......assets/......
-        // we wanna remove everything after the last /
-        std::string path = tsxPath;
-        size_t lastSlash = path.find_last_of("/\\");
-        if (lastSlash != std::string::npos)
-        {
-            path = path.substr(0, lastSlash + 1);
-        }
-        else
-        {
-            path = "";
-        }
-        if (!loadTsx(tileMap, path))
-        {
-            DebugGUI::addDebugLog("Error: Could not load the tsx file: (" + path + ")", {ErrorCode::FILE_ERROR, ErrorCode::MAP_ERROR});
-            DebugGUI::addDebugLog(path, ErrorCode::FILE_ERROR);
             return false;
         }
 
         if (!loadTexture(renderer, tileMap))
         {
-            DebugGUI::addDebugLog("Error: Could not load the texture from the tsx file: (" + path + ")", {ErrorCode::TEXTURE_ERROR, ErrorCode::MAP_ERROR});
-            DebugGUI::addDebugLog(path, ErrorCode::TEXTURE_ERROR);
+            DebugGUI::addDebugLog("Error: Could not load the texture from the tsx file: (" + tsxPath + ")", {ErrorCode::TEXTURE_ERROR, ErrorCode::MAP_ERROR});
+            DebugGUI::addDebugLog(tsxPath, ErrorCode::TEXTURE_ERROR);
             return false;
         }
-
-        DebugGUI::addDebugLog("Succesfully Loaded Json Into Map Struct", ErrorCode::SUCCESS);
-        /*std::cout << "Path: " << path << std::endl;*/
-        DebugGUI::addDebugLog("Sources: " + std::to_string(tileMap->tilesets.size()), ErrorCode::SUCCESS);
-        for (int i = 0; i < tileMap->tilesets.size(); i++)
-        {
-            TSDL_Tileset tile = tileMap->tilesets[i];
-            TSDL_TilesetSource tileSource = tileMap->tilesetSources[i];
-            // End GID will be the firstGid + tileCount
-            int endGid = tile.firstGid + tileSource.tileCount;
-            tileMap->maxTileCount = endGid;
-
-            DebugGUI::addDebugLog("Source:\t" + tile.source + " | " + std::to_string(tile.firstGid) + " -> " + std::to_string(endGid), ErrorCode::SUCCESS);
-        }
-        DebugGUI::addDebugLog("Max Size: " + std::to_string(tileMap->maxTileCount), ErrorCode::NONE);
-        std::cout << "======================================" << std::endl;
-        
-        return true;
-    }
-
-    /**
-    Load the Tileset Source from the .tsx file
-    **/
-    bool TSDL::loadTsx(TSDL_TileMap *tileMap, const std::string &path)
-    {
-        // Tsx is a xml file there could be many inside tilesets so we need to parse it
-        for (auto &t : tileMap->tilesets)
-        {
-            std::string tempPath = path;
-            // Create a Tileset Source Object
-            pugi::xml_document doc;
-
-            // Load the file
-            if (!doc.load_file(std::string(tempPath + t.source).c_str()))
-            {
-                std::cerr << "❌ Error: Could not load the file: (" << tempPath + t.source << ")" << std::endl;
-                return false;
-            }
-
-            // find the tileset node
-            pugi::xml_node tilesetNode = doc.child("tileset");
-            if (!tilesetNode)
-            {
-                std::cerr << "❌ Error: Could not find the <tileset> node in (" << tempPath + t.source << ")" << std::endl;
-                return false;
-            }
-
-            TSDL_TilesetSource ts;
-            // Store The Values
-            ts.name = tilesetNode.attribute("name").as_string();
-            ts.tileWidth = tilesetNode.attribute("tilewidth").as_int();
-            ts.tileHeight = tilesetNode.attribute("tileheight").as_int();
-            ts.tileCount = tilesetNode.attribute("tilecount").as_int();
-            ts.columns = tilesetNode.attribute("columns").as_int();
-
-            // Getting Image Path
-            pugi::xml_node imageNode = tilesetNode.child("image");
-            if (!imageNode)
-            {
-                std::cerr << "❌ Error: Could not find the <image> node in tileset " << ts.name << std::endl;
-                return false;
-            }
-
-            ts.imagePath = imageNode.attribute("source").as_string();
-            ts.imageWidth = imageNode.attribute("width").as_int();
-            ts.imageHeight = imageNode.attribute("height").as_int();
-
-            // Add to the vector
-            tileMap->tilesetSources.push_back(ts);
-            DebugGUI::addDebugLog("Succesfully Loaded Tsx: " + ts.name, ErrorCode::SUCCESS);
-        }
         return true;
     }
 
@@ -249,6 +102,21 @@
         draw the bottom layer first and start going up.
         **/
 
+        // ==========================================================================================================================
+        // Culling : only the tiles the camera can see get drawn
+        // ==========================================================================================================================
+        SDL_Rect viewport;
+        SDL_RenderGetViewport(renderer, &viewport);
+        float viewLeft = camera->getX();
+        float viewTop = camera->getY();
+        float viewRight = viewLeft + viewport.w / mapScale;
+        float viewBottom = viewTop + viewport.h / mapScale;
+
+        int startTileX = std::max(0, (int)std::floor(viewLeft / tileMap->tileWidth));
+        int startTileY = std::max(0, (int)std::floor(viewTop / tileMap->tileHeight));
+        int endTileX = (int)std::floor(viewRight / tileMap->tileWidth);
+        int endTileY = (int)std::floor(viewBottom / tileMap->tileHeight);
+
         // ==========================================================================================================================
         // Iterating Layers
         // ==========================================================================================================================
@@ -261,12 +129,14 @@
             // ==========================================================================================================================
             // Iterating Tiles Horizontally
             // ==========================================================================================================================
-            for (int y = 0 ; y < tileMap->layers[i].height; y++)
+            int layerEndX = std::min(endTileX, tileMap->layers[i].width - 1);
+            int layerEndY = std::min(endTileY, tileMap->layers[i].height - 1);
+            for (int y = startTileY; y <= layerEndY; y++)
             {
                 // ==========================================================================================================================
                 // Iterating Tiles Vertically
                 // ==========================================================================================================================
-                for (int x = 0; x < tileMap->layers[i].width; x++)
+                for (int x = startTileX; x <= layerEndX; x++)
                 {
                     // ==========================================================================================================================
                     // This is the index of the tile we have to map onto the screen
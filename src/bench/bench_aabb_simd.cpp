@@ -0,0 +1,61 @@
+#include "bench/benchmarks.h"
+#include "utils/aabb_simd.h"
+#include <random>
+
+/**
+    Batched kernels against a plain loop over an array of AABBs doing the same test
+**/
+std::vector<BenchResult> Benchmarks::aabbKernels()
+{
+    std::vector<BenchResult> results;
+    const int counts[] = {1000, 10000, 100000};
+    const int runs = 50;
+
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // 256x256 tile map with roughly 1 in 8 tiles solid
+    CollisionGrid grid;
+    std::vector<int> tiles(256 * 256);
+    for (auto &tile : tiles) tile = unit(rng) < 0.125f ? 1 : 0;
+    grid.build(256, 256, 16, 16, tiles);
+    const float worldSize = 256.0f * 16.0f;
+
+    for (int count : counts)
+    {
+        std::vector<AABB> boxes(count);
+        for (auto &box : boxes)
+        {
+            box = AABB::fromRect(unit(rng) * worldSize, unit(rng) * worldSize, 4.0f + unit(rng) * 20.0f, 4.0f + unit(rng) * 20.0f);
+        }
+        AABBArray array;
+        array.assign(boxes.data(), count);
+        std::vector<uint32_t> mask(array.getMaskWords());
+        AABB view = AABB::fromRect(worldSize * 0.25f, worldSize * 0.25f, 800.0f, 600.0f);
+
+        // ==========================================================================================
+        // Culling
+        // ==========================================================================================
+        int hits = 0;
+        BenchTimer timer;
+        for (int run = 0; run < runs; run++) hits = AABBKernels::overlapMask(array, view, mask.data());
+        results.push_back({std::string("Cull ") + AABBKernels::getInstructionSet(), count, timer.elapsedMilliseconds() / runs, std::to_string(hits) + " visible"});
+
+        int scalarHits = 0;
+        timer.reset();
+        for (int run = 0; run < runs; run++)
+        {
+            scalarHits = 0;
+            for (auto &box : boxes) scalarHits += view.overlaps(box) ? 1 : 0;
+        }
+        results.push_back({"Cull scalar loop", count, timer.elapsedMilliseconds() / runs, std::to_string(scalarHits) + " visible"});
+
+        // ==========================================================================================
+        // Batch tile collision
+        // ==========================================================================================
+        timer.reset();
+        for (int run = 0; run < runs; run++) hits = AABBKernels::tileGridMask(array, grid, mask.data());
+        results.push_back({std::string("Tile collision ") + AABBKernels::getInstructionSet(), count, timer.elapsedMilliseconds() / runs, std::to_string(hits) + " colliding"});
+    }
+    return results;
+}
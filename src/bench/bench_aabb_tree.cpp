@@ -0,0 +1,155 @@
+#include "bench/benchmarks.h"
+#include "utils/aabb_tree.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+/**
+    Mix of mostly tiny projectiles, some entity sized boxes and a few huge static
+    ones (buildings, trigger zones), the tree against looping over every box
+**/
+std::vector<BenchResult> Benchmarks::aabbTree()
+{
+    std::vector<BenchResult> results;
+    const int counts[] = {1000, 10000, 100000};
+    const int queries = 500;
+
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int count : counts)
+    {
+        float worldSize = std::sqrt((float)count) * 64.0f;
+
+        std::vector<AABB> boxes(count);
+        for (auto &box : boxes)
+        {
+            float kind = unit(rng);
+            float width, height;
+            if (kind < 0.90f) { width = 2.0f + unit(rng) * 6.0f; height = 2.0f + unit(rng) * 6.0f; }          // projectiles
+            else if (kind < 0.99f) { width = 16.0f + unit(rng) * 16.0f; height = 16.0f + unit(rng) * 16.0f; } // entities
+            else { width = 200.0f + unit(rng) * 600.0f; height = 200.0f + unit(rng) * 600.0f; }               // buildings
+            box = AABB::fromRect(unit(rng) * worldSize, unit(rng) * worldSize, width, height);
+        }
+
+        std::vector<AABB> queryBoxes(queries);
+        std::vector<float> points(queries * 4);
+        for (int i = 0; i < queries; i++)
+        {
+            queryBoxes[i] = AABB::fromRect(unit(rng) * worldSize, unit(rng) * worldSize, 64.0f, 64.0f);
+            points[i * 4 + 0] = unit(rng) * worldSize;
+            points[i * 4 + 1] = unit(rng) * worldSize;
+            // Rays are 300 pixels long in a random direction
+            float angle = unit(rng) * 6.2831853f;
+            points[i * 4 + 2] = points[i * 4 + 0] + std::cos(angle) * 300.0f;
+            points[i * 4 + 3] = points[i * 4 + 1] + std::sin(angle) * 300.0f;
+        }
+
+        // ==========================================================================================
+        // Build
+        // ==========================================================================================
+        AABBTree tree;
+        std::vector<int> proxies(count);
+        BenchTimer timer;
+        for (int i = 0; i < count; i++) proxies[i] = tree.createProxy(boxes[i], i);
+        double buildMs = timer.elapsedMilliseconds();
+        results.push_back({"AABBTree build", count, buildMs, "height " + std::to_string(tree.getHeight())});
+
+        // ==========================================================================================
+        // Move everything a little (one tick)
+        // ==========================================================================================
+        timer.reset();
+        int reinserted = 0;
+        for (int i = 0; i < count; i++)
+        {
+            float dx = (unit(rng) - 0.5f) * 16.0f;
+            float dy = (unit(rng) - 0.5f) * 16.0f;
+            boxes[i] = AABB{boxes[i].minX + dx, boxes[i].minY + dy, boxes[i].maxX + dx, boxes[i].maxY + dy};
+            if (tree.moveProxy(proxies[i], boxes[i], dx, dy)) reinserted++;
+        }
+        results.push_back({"AABBTree move all", count, timer.elapsedMilliseconds(), std::to_string(reinserted) + " reinserted"});
+
+        // ==========================================================================================
+        // Overlap
+        // ==========================================================================================
+        std::vector<int> hits;
+        size_t treeHits = 0;
+        timer.reset();
+        for (auto &query : queryBoxes)
+        {
+            tree.query(query, hits);
+            treeHits += hits.size();
+        }
+        results.push_back({"AABBTree overlap x" + std::to_string(queries), count, timer.elapsedMilliseconds(), std::to_string(treeHits) + " hits"});
+
+        size_t bruteHits = 0;
+        timer.reset();
+        for (auto &query : queryBoxes)
+        {
+            for (auto &box : boxes)
+            {
+                if (query.overlaps(box)) bruteHits++;
+            }
+        }
+        results.push_back({"Brute overlap x" + std::to_string(queries), count, timer.elapsedMilliseconds(), std::to_string(bruteHits) + " hits"});
+
+        // ==========================================================================================
+        // Raycast
+        // ==========================================================================================
+        int treeRayHits = 0;
+        timer.reset();
+        for (int i = 0; i < queries; i++)
+        {
+            if (tree.rayCast(points[i * 4], points[i * 4 + 1], points[i * 4 + 2], points[i * 4 + 3]).hit) treeRayHits++;
+        }
+        results.push_back({"AABBTree raycast x" + std::to_string(queries), count, timer.elapsedMilliseconds(), std::to_string(treeRayHits) + " hits"});
+
+        int bruteRayHits = 0;
+        timer.reset();
+        for (int i = 0; i < queries; i++)
+        {
+            float x1 = points[i * 4], y1 = points[i * 4 + 1];
+            float invX = 1.0f / (points[i * 4 + 2] - x1);
+            float invY = 1.0f / (points[i * 4 + 3] - y1);
+            float best = 2.0f;
+            for (auto &box : boxes)
+            {
+                float tx1 = (box.minX - x1) * invX, tx2 = (box.maxX - x1) * invX;
+                float ty1 = (box.minY - y1) * invY, ty2 = (box.maxY - y1) * invY;
+                float tMin = std::max(std::min(tx1, tx2), std::min(ty1, ty2));
+                float tMax = std::min(std::max(tx1, tx2), std::max(ty1, ty2));
+                if (tMax >= 0.0f && tMin <= tMax && tMin <= 1.0f) best = std::min(best, std::max(tMin, 0.0f));
+            }
+            if (best <= 1.0f) bruteRayHits++;
+        }
+        results.push_back({"Brute raycast x" + std::to_string(queries), count, timer.elapsedMilliseconds(), std::to_string(bruteRayHits) + " hits"});
+
+        // ==========================================================================================
+        // Nearest
+        // ==========================================================================================
+        double treeDistance = 0.0;
+        timer.reset();
+        for (int i = 0; i < queries; i++)
+        {
+            treeDistance += tree.nearest(points[i * 4], points[i * 4 + 1]).distance;
+        }
+        results.push_back({"AABBTree nearest x" + std::to_string(queries), count, timer.elapsedMilliseconds(), "avg dist " + std::to_string(treeDistance / queries)});
+
+        double bruteDistance = 0.0;
+        timer.reset();
+        for (int i = 0; i < queries; i++)
+        {
+            float x = points[i * 4], y = points[i * 4 + 1];
+            float best = 1e30f;
+            for (auto &box : boxes)
+            {
+                float dx = std::max(std::max(box.minX - x, 0.0f), x - box.maxX);
+                float dy = std::max(std::max(box.minY - y, 0.0f), y - box.maxY);
+                best = std::min(best, dx * dx + dy * dy);
+            }
+            bruteDistance += std::sqrt(best);
+        }
+        results.push_back({"Brute nearest x" + std::to_string(queries), count, timer.elapsedMilliseconds(), "avg dist " + std::to_string(bruteDistance / queries)});
+    }
+    return results;
+}
@@ -0,0 +1,145 @@
+#include "bench/benchmarks.h"
+#include "entity/component_store.h"
+#include <memory>
+#include <random>
+
+/**
+    What entities looked like before the component store, every field behind a virtual
+    getter / setter and every entity its own heap allocation
+**/
+class LegacyEntity
+{
+protected:
+    float x = 0.0f, y = 0.0f;
+    float previousX = 0.0f, previousY = 0.0f;
+    float width = 16.0f, height = 16.0f;
+    float velocityX = 0.0f, velocityY = 0.0f;
+    float maxSpeed = 100.0f;
+    float colliderOffsetX = 2.0f, colliderOffsetY = 4.0f;
+    float colliderWidth = 12.0f, colliderHeight = 12.0f;
+    void *sprite = nullptr;
+
+public:
+    virtual ~LegacyEntity() = default;
+    virtual float getX() { return x; }
+    virtual float getY() { return y; }
+    virtual float getVelocityX() { return velocityX; }
+    virtual float getVelocityY() { return velocityY; }
+    virtual float getColliderOffsetX() { return colliderOffsetX; }
+    virtual float getColliderOffsetY() { return colliderOffsetY; }
+    virtual float getColliderWidth() { return colliderWidth; }
+    virtual float getColliderHeight() { return colliderHeight; }
+    virtual void setX(float value) { x = value; }
+    virtual void setY(float value) { y = value; }
+    virtual void setVelocity(float vx, float vy) { velocityX = vx; velocityY = vy; }
+    virtual void storePrevious() { previousX = x; previousY = y; }
+};
+
+class LegacyWalker : public LegacyEntity
+{
+public:
+    float getVelocityX() override { return velocityX * 0.5f; }
+    float getVelocityY() override { return velocityY * 0.5f; }
+};
+
+/**
+    One simulation tick over every entity (remember the previous position, integrate
+    velocity, gather collider boxes for the broadphase) with the SoA component store
+    against virtual accessors on separately allocated entities
+**/
+std::vector<BenchResult> Benchmarks::componentStore()
+{
+    std::vector<BenchResult> results;
+    const int counts[] = {1000, 10000, 50000};
+    const int runs = 100;
+    const float dt = 1.0f / 60.0f;
+
+    std::mt19937 rng(39);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<AABB> bounds;
+
+    for (int count : counts)
+    {
+        // ==========================================================================================
+        // Component store
+        // ==========================================================================================
+        ComponentStore store;
+        store.reserve(count);
+        std::vector<EntityHandle> handles(count);
+        for (int i = 0; i < count; i++)
+        {
+            handles[i] = store.create(unit(rng) * 4096.0f, unit(rng) * 4096.0f);
+            int slot = store.slotOf(handles[i]);
+            store.getVelocities().x[slot] = unit(rng) * 200.0f - 100.0f;
+            store.getVelocities().y[slot] = unit(rng) * 200.0f - 100.0f;
+            store.getColliders().offsetX[slot] = 2.0f;
+            store.getColliders().offsetY[slot] = 4.0f;
+            store.getColliders().width[slot] = 12.0f;
+            store.getColliders().height[slot] = 12.0f;
+        }
+
+        BenchTimer timer;
+        for (int run = 0; run < runs; run++)
+        {
+            store.storePreviousPositions();
+            store.integrate(dt);
+            store.gatherColliderBounds(bounds);
+        }
+        double storeMs = timer.elapsedMilliseconds() / runs;
+        results.push_back({"Tick SoA store", count, storeMs, std::to_string((int)(storeMs * 1e6 / count)) + " ns / entity"});
+
+        // ==========================================================================================
+        // Virtual accessors
+        // ==========================================================================================
+        std::vector<std::unique_ptr<LegacyEntity>> legacy(count);
+        for (int i = 0; i < count; i++)
+        {
+            legacy[i].reset(i % 2 ? new LegacyWalker() : new LegacyEntity());
+            legacy[i]->setX(unit(rng) * 4096.0f);
+            legacy[i]->setY(unit(rng) * 4096.0f);
+            legacy[i]->setVelocity(unit(rng) * 200.0f - 100.0f, unit(rng) * 200.0f - 100.0f);
+        }
+
+        timer.reset();
+        for (int run = 0; run < runs; run++)
+        {
+            for (auto &entity : legacy) entity->storePrevious();
+            for (auto &entity : legacy)
+            {
+                entity->setX(entity->getX() + entity->getVelocityX() * dt);
+                entity->setY(entity->getY() + entity->getVelocityY() * dt);
+            }
+            bounds.resize(count);
+            for (int i = 0; i < count; i++)
+            {
+                LegacyEntity *entity = legacy[i].get();
+                bounds[i] = AABB::fromRect(entity->getX() + entity->getColliderOffsetX(),
+                                           entity->getY() + entity->getColliderOffsetY(),
+                                           entity->getColliderWidth(), entity->getColliderHeight());
+            }
+        }
+        double legacyMs = timer.elapsedMilliseconds() / runs;
+        results.push_back({"Tick virtual entities", count, legacyMs, std::to_string((int)(legacyMs * 1e6 / count)) + " ns / entity"});
+
+        // ==========================================================================================
+        // Churn, a tenth of the entities die and get replaced every tick
+        // ==========================================================================================
+        std::uniform_int_distribution<int> pick(0, count - 1);
+        int stale = 0;
+        timer.reset();
+        for (int run = 0; run < runs; run++)
+        {
+            for (int i = 0; i < count / 10; i++)
+            {
+                int which = pick(rng);
+                EntityHandle old = handles[which];
+                store.destroy(old);
+                handles[which] = store.create(unit(rng) * 4096.0f, unit(rng) * 4096.0f);
+                if (store.isAlive(old)) stale++;
+            }
+        }
+        results.push_back({"Destroy + create", count / 10, timer.elapsedMilliseconds() / runs,
+                           std::to_string(store.size()) + " alive, " + std::to_string(stale) + " stale handles alive"});
+    }
+    return results;
+}
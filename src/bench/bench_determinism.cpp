@@ -0,0 +1,137 @@
+#include "bench/benchmarks.h"
+#include "utils/fixed_collision.h"
+#include "utils/movement_simd.h"
+#include "utils/tile_shapes.h"
+#include <cstdio>
+
+/**
+    Hash of the world after the scripted run below, from a build where it was checked
+    by hand. Every build (any compiler, any -O, with or without -ffast-math / -mfma,
+    x86 or ARM) has to land on exactly this. If the simulation rules change on purpose
+    run the benchmark and paste the new hash in here
+**/
+#define DETERMINISM_GOLDEN_HASH 0xc75ab88c95b59bc6ull
+#define DETERMINISM_TICKS 1200
+#define DETERMINISM_BODIES 64
+#define DETERMINISM_SLIDE_ITERATIONS 3
+
+// Integer hash so the script doesnt depend on a standard library's random distributions
+static uint32_t scriptHash(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+/**
+    64 x 48 tiles of 16 px, walls round the edge, scattered pillars and a few 45 degree
+    slopes (gid 2) so the slide along tile shape axes gets exercised too
+**/
+static void buildScriptedGrid(CollisionGrid &grid)
+{
+    const int width = 64, height = 48;
+    std::vector<int> layer(width * height, 0);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t roll = scriptHash(x * 73856093u ^ y * 19349663u) % 100;
+            int gid = 0;
+            if (x == 0 || y == 0 || x == width - 1 || y == height - 1 || roll < 8) gid = 1;
+            else if (roll < 11) gid = 2;
+            layer[x + y * width] = gid;
+        }
+    }
+
+    TileShapeTable shapes;
+    const float slope[] = {0.0f, 16.0f, 16.0f, 0.0f, 16.0f, 16.0f};
+    TileShape shape;
+    TileShape::fromPolygon(slope, 3, shape);
+    shapes.setShapes(2, {shape});
+    grid.build(width, height, 16, 16, layer, &shapes);
+}
+
+// FNV-1a over the raw Fixed bits
+static void hashFixed(uint64_t &hash, Fixed value)
+{
+    uint32_t bits = (uint32_t)value.raw;
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= (bits >> (i * 8)) & 0xFF;
+        hash *= 0x100000001b3ull;
+    }
+}
+
+/**
+    Deterministic simulation check: DETERMINISM_BODIES players on a scripted map with
+    scripted input for DETERMINISM_TICKS ticks at 60 Hz, through exactly what
+    Player::moveFixed runs (stepVelocityFixed + FixedCollision::moveAndSlide). The
+    world gets hashed at the end and compared against DETERMINISM_GOLDEN_HASH
+**/
+std::vector<BenchResult> Benchmarks::determinism()
+{
+    std::vector<BenchResult> results;
+    CollisionGrid grid;
+    buildScriptedGrid(grid);
+
+    // The player's tuning, as it would come out of the config
+    const FixedMovementParams params = FixedMovementParams::make(60, Fixed::fromFloat(900.0f), Fixed::fromFloat(0.85f));
+    const Fixed maxSpeed = Fixed::fromFloat(150.0f);
+    const FixedAABB collider = FixedAABB::fromRect(Fixed::fromInt(2), Fixed::fromInt(4), Fixed::fromInt(12), Fixed::fromInt(12));
+    const Fixed one = Fixed::fromInt(1);
+
+    std::vector<FixedVec2> positions(DETERMINISM_BODIES);
+    std::vector<FixedVec2> velocities(DETERMINISM_BODIES);
+    for (int i = 0; i < DETERMINISM_BODIES; i++)
+    {
+        // Spread over open tiles
+        int tile = (int)(scriptHash(i + 1) % (62 * 46));
+        int tileX = 1 + tile % 62, tileY = 1 + tile / 62;
+        while (grid.isSolid(tileX, tileY)) tileX = tileX % 62 + 1;
+        positions[i] = FixedVec2(Fixed::fromInt(tileX * 16), Fixed::fromInt(tileY * 16));
+    }
+
+    int collisions = 0;
+    BenchTimer timer;
+    for (int tick = 0; tick < DETERMINISM_TICKS; tick++)
+    {
+        for (int i = 0; i < DETERMINISM_BODIES; i++)
+        {
+            // W A S D held for 20 tick stretches, picked by the script
+            uint32_t keys = scriptHash((uint32_t)(tick / 20) * 2654435761u + i);
+            FixedVec2 direction;
+            if (keys & 1) direction.y -= one;
+            if (keys & 2) direction.y += one;
+            if (keys & 4) direction.x -= one;
+            if (keys & 8) direction.x += one;
+            if (direction.x.raw != 0 && direction.y.raw != 0) direction = direction.normalize();
+
+            MovementKernels::stepVelocityFixed(params, direction, maxSpeed, velocities[i]);
+            if (FixedCollision::moveAndSlide(&grid, collider, positions[i], velocities[i], params.dt, DETERMINISM_SLIDE_ITERATIONS))
+            {
+                collisions++;
+            }
+        }
+    }
+    double ms = timer.elapsedMilliseconds();
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (int i = 0; i < DETERMINISM_BODIES; i++)
+    {
+        hashFixed(hash, positions[i].x);
+        hashFixed(hash, positions[i].y);
+        hashFixed(hash, velocities[i].x);
+        hashFixed(hash, velocities[i].y);
+    }
+
+    char hashText[32];
+    std::snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)hash);
+    results.push_back({"Scripted ticks (Q16.16)", DETERMINISM_TICKS, ms / DETERMINISM_TICKS,
+                       std::to_string(DETERMINISM_BODIES) + " bodies, " + std::to_string(collisions) + " hits"});
+    results.push_back({hash == DETERMINISM_GOLDEN_HASH ? "Hash matches golden" : "HASH MISMATCH", DETERMINISM_BODIES, 0.0,
+                       hashText});
+    return results;
+}
@@ -0,0 +1,139 @@
+#include "bench/benchmarks.h"
+#include "utils/flow_field.h"
+#include <cstdio>
+#include <random>
+#include <thread>
+
+/**
+    Flow field builds on map.json tiled out to bigger maps
+
+    The goal walks around one tile at a time like a player would, so after the first
+    build every move should take the incremental path. Every run also checks the
+    incremental field against a full build of the same goal, and samples the field for
+    10k agents to show that part costs nothing next to the build.
+
+    A move still relaxes most of the map on open ground (see moveGoal), the goal moved
+    row says how much of it on average so it can be held against the full build row.
+**/
+std::vector<BenchResult> Benchmarks::flowField()
+{
+    std::vector<BenchResult> results;
+    const int sizes[][2] = {{30, 20}, {240, 160}, {960, 640}};
+    const int moves = 50;
+    const int agentCount = 10000;
+
+    std::mt19937 rng(3);
+    for (auto &size : sizes)
+    {
+        CollisionGrid grid;
+        buildMapGrid(size[0], size[1], grid);
+        std::string label = std::to_string(size[0]) + "x" + std::to_string(size[1]);
+
+        // Start the goal on the first walkable tile near the middle
+        int goalX = size[0] / 2;
+        int goalY = size[1] / 2;
+        while (grid.isSolid(goalX, goalY)) goalX++;
+
+        // ==========================================================================================
+        // Full build
+        // ==========================================================================================
+        FlowField field;
+        BenchTimer timer;
+        field.build(grid, goalX, goalY);
+        results.push_back({"FlowField full build " + label, size[0] * size[1], timer.elapsedMilliseconds(), ""});
+
+        // ==========================================================================================
+        // Goal walking around one tile at a time
+        // ==========================================================================================
+        std::uniform_int_distribution<int> step(-1, 1);
+        double total = 0.0;
+        int incremental = 0;
+        double changedTiles = 0.0;
+        for (int move = 0; move < moves; move++)
+        {
+            int nextX = goalX + step(rng);
+            int nextY = goalY + step(rng);
+            if (grid.isSolid(nextX, nextY)) continue;
+            goalX = nextX;
+            goalY = nextY;
+
+            timer.reset();
+            field.moveGoal(grid, goalX, goalY);
+            total += timer.elapsedMilliseconds();
+            if (field.wasIncremental())
+            {
+                incremental++;
+                changedTiles += field.getChangedCount();
+            }
+        }
+
+        FlowField check;
+        check.build(grid, goalX, goalY);
+        bool matches = true;
+        for (int y = 0; y < size[1] && matches; y++)
+        {
+            for (int x = 0; x < size[0]; x++)
+            {
+                if (check.getCost(x, y) != field.getCost(x, y))
+                {
+                    matches = false;
+                    break;
+                }
+            }
+        }
+        char relaxed[64];
+        std::snprintf(relaxed, sizeof(relaxed), "%.0f%% of tiles relaxed a move, ",
+                      incremental > 0 ? changedTiles / incremental * 100.0 / (size[0] * size[1]) : 0.0);
+        results.push_back({"FlowField goal moved " + label, moves, total / moves,
+                           std::to_string(incremental) + " incremental, " + relaxed + (matches ? "matches full build" : "MISMATCH")});
+
+        // ==========================================================================================
+        // Agents sampling the field
+        // ==========================================================================================
+        std::uniform_real_distribution<float> x(0.0f, size[0] * 16.0f);
+        std::uniform_real_distribution<float> y(0.0f, size[1] * 16.0f);
+        std::vector<float> agents(agentCount * 2);
+        for (int i = 0; i < agentCount; i++)
+        {
+            agents[i * 2] = x(rng);
+            agents[i * 2 + 1] = y(rng);
+        }
+        timer.reset();
+        int moving = 0;
+        float sum = 0.0f;
+        for (int i = 0; i < agentCount; i++)
+        {
+            float dirX, dirY;
+            if (field.sample(agents[i * 2], agents[i * 2 + 1], dirX, dirY)) moving++;
+            sum += dirX + dirY;
+        }
+        // The sum goes in the detail to keep the compiler from throwing the sampling away
+        results.push_back({"FlowField sample agents " + label, agentCount, timer.elapsedMilliseconds(),
+                           std::to_string(moving) + " have a direction, checksum " + std::to_string((int)sum)});
+    }
+
+    // ==========================================================================================
+    // Worker thread round trip, request a goal and wait for the field to come back
+    // ==========================================================================================
+    CollisionGrid grid;
+    buildMapGrid(240, 160, grid);
+    FlowFieldService service;
+    service.setGrid(grid);
+    service.start();
+    int goalX = 120;
+    int goalY = 80;
+    while (grid.isSolid(goalX, goalY)) goalX++;
+
+    BenchTimer timer;
+    for (int move = 0; move < moves; move++)
+    {
+        if (!grid.isSolid(goalX + 1, goalY)) goalX++;
+        else if (!grid.isSolid(goalX, goalY + 1)) goalY++;
+        service.requestGoal(goalX, goalY);
+        while (!service.update()) std::this_thread::yield();
+    }
+    results.push_back({"FlowFieldService round trip 240x160", moves, timer.elapsedMilliseconds() / moves,
+                       std::to_string(service.getIncrementalCount()) + "/" + std::to_string(service.getBuildCount()) + " incremental"});
+    service.stop();
+    return results;
+}
@@ -0,0 +1,63 @@
+#include "bench/benchmarks.h"
+#include "utils/grid_raycast.h"
+#include <random>
+
+/**
+    Rays per second through map.json tiled out to bigger and bigger maps
+
+    Short rays are what AI sight checks look like (up to 16 tiles), long rays go
+    anywhere on the map like a projectile or a server side hit check could. The cost
+    of a ray should only depend on how many tiles it crosses so the short rays should
+    stay flat as the map grows.
+**/
+std::vector<BenchResult> Benchmarks::gridRaycast()
+{
+    std::vector<BenchResult> results;
+    // 1x, 8x, 32x and 64x the size of map.json on each side
+    const int sizes[][2] = {{30, 20}, {240, 160}, {960, 640}, {1920, 1280}};
+    const int rayCount = 10000;
+    const int runs = 10;
+
+    std::mt19937 rng(42);
+    for (auto &size : sizes)
+    {
+        CollisionGrid grid;
+        bool fromMap = buildMapGrid(size[0], size[1], grid);
+        const float worldWidth = size[0] * 16.0f;
+        const float worldHeight = size[1] * 16.0f;
+
+        std::uniform_real_distribution<float> x(0.0f, worldWidth);
+        std::uniform_real_distribution<float> y(0.0f, worldHeight);
+        std::uniform_real_distribution<float> offset(-16.0f * 16.0f, 16.0f * 16.0f);
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            bool shortRays = pass == 0;
+            std::vector<GridRay> rays(rayCount);
+            for (auto &ray : rays)
+            {
+                ray.x1 = x(rng);
+                ray.y1 = y(rng);
+                ray.x2 = shortRays ? ray.x1 + offset(rng) : x(rng);
+                ray.y2 = shortRays ? ray.y1 + offset(rng) : y(rng);
+            }
+
+            std::vector<GridRayHit> hits;
+            int hitCount = GridRaycast::castBatch(grid, rays, hits);
+
+            BenchTimer timer;
+            for (int run = 0; run < runs; run++) hitCount = GridRaycast::castBatch(grid, rays, hits);
+            double milliseconds = timer.elapsedMilliseconds() / runs;
+
+            BenchResult result;
+            result.name = std::string(shortRays ? "Raycast short " : "Raycast long ") +
+                          std::to_string(size[0]) + "x" + std::to_string(size[1]) + (fromMap ? "" : " (random)");
+            result.count = rayCount;
+            result.milliseconds = milliseconds;
+            result.detail = std::to_string((long long)(rayCount / (milliseconds / 1000.0))) + " rays/s, " +
+                            std::to_string(hitCount * 100 / rayCount) + "% blocked";
+            results.push_back(result);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,124 @@
+#include "bench/benchmarks.h"
+#include "utils/hierarchical_pathfinder.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+/**
+    HPA* on map.json tiled out to large maps
+
+    Queries are long on purpose (start in the left quarter, goal in the right quarter)
+    since that is where tile level searches fall over. JPS runs the same queries for
+    the time and path length comparison, just fewer of them on the big map, its row
+    says how many times faster HPA* answered them. The update
+    run flips one tile and checks that only a handful of clusters get rebuilt.
+**/
+std::vector<BenchResult> Benchmarks::hierarchicalPathfinding()
+{
+    std::vector<BenchResult> results;
+    const int sizes[][2] = {{240, 160}, {960, 640}, {1920, 1280}};
+    const int queryCount = 200;
+
+    std::mt19937 rng(23);
+    for (auto &size : sizes)
+    {
+        CollisionGrid grid;
+        buildMapGrid(size[0], size[1], grid);
+        std::string label = std::to_string(size[0]) + "x" + std::to_string(size[1]);
+
+        // ==========================================================================================
+        // Build
+        // ==========================================================================================
+        HierarchicalPathfinder pathfinder;
+        BenchTimer timer;
+        pathfinder.build(grid);
+        results.push_back({"HPA* build " + label, pathfinder.getClusterCount(), timer.elapsedMilliseconds(),
+                           std::to_string(pathfinder.getNodeCount()) + " entrance nodes"});
+
+        std::uniform_int_distribution<int> left(0, size[0] / 4);
+        std::uniform_int_distribution<int> right(size[0] * 3 / 4, size[0] - 1);
+        std::uniform_int_distribution<int> y(0, size[1] - 1);
+        std::vector<PathPoint> ends;
+        while ((int)ends.size() < queryCount * 2)
+        {
+            PathPoint start = {left(rng), y(rng)};
+            PathPoint goal = {right(rng), y(rng)};
+            if (grid.isSolid(start.x, start.y) || grid.isSolid(goal.x, goal.y)) continue;
+            ends.push_back(start);
+            ends.push_back(goal);
+        }
+
+        // ==========================================================================================
+        // Long queries
+        // ==========================================================================================
+        HierarchicalPath path;
+        std::vector<HierarchicalPath> paths(queryCount);
+        long long expanded = 0;
+        timer.reset();
+        for (int i = 0; i < queryCount; i++)
+        {
+            pathfinder.findPath(ends[i * 2].x, ends[i * 2].y, ends[i * 2 + 1].x, ends[i * 2 + 1].y, paths[i]);
+            expanded += pathfinder.getExpanded();
+        }
+        double milliseconds = timer.elapsedMilliseconds();
+        const double hpaMilliseconds = milliseconds / queryCount;
+        results.push_back({"HPA* long query " + label, queryCount, hpaMilliseconds,
+                           std::to_string((long long)(milliseconds * 1000.0 / queryCount)) + " us/query, " +
+                           std::to_string(expanded / queryCount) + " nodes expanded"});
+
+        // Walking the path one segment at a time
+        std::vector<PathPoint> tiles;
+        int segments = 0;
+        timer.reset();
+        for (int i = 0; i < queryCount; i++)
+        {
+            for (size_t s = 0; s + 1 < paths[i].waypoints.size(); s++)
+            {
+                pathfinder.refineSegment(paths[i], s, tiles);
+                segments++;
+            }
+        }
+        milliseconds = timer.elapsedMilliseconds();
+        results.push_back({"HPA* refine segment " + label, segments, segments > 0 ? milliseconds / segments : 0.0,
+                           std::to_string(segments / queryCount) + " segments per path"});
+
+        // ==========================================================================================
+        // JPS on the same queries
+        // ==========================================================================================
+        JumpPointSearch search;
+        search.build(grid);
+        std::vector<PathPoint> jpsPath;
+        int jpsCount = size[0] * size[1] > 960 * 640 ? 10 : 50;
+        double hpaCost = 0.0;
+        double jpsCost = 0.0;
+        timer.reset();
+        for (int i = 0; i < jpsCount; i++)
+        {
+            if (!search.findPath(ends[i * 2].x, ends[i * 2].y, ends[i * 2 + 1].x, ends[i * 2 + 1].y, jpsPath)) continue;
+            for (size_t p = 1; p < jpsPath.size(); p++)
+            {
+                int dx = std::abs(jpsPath[p].x - jpsPath[p - 1].x);
+                int dy = std::abs(jpsPath[p].y - jpsPath[p - 1].y);
+                jpsCost += std::min(dx, dy) * 14 + (std::max(dx, dy) - std::min(dx, dy)) * 10;
+            }
+            hpaCost += paths[i].cost;
+        }
+        milliseconds = timer.elapsedMilliseconds();
+        char detail[96];
+        std::snprintf(detail, sizeof(detail), "HPA* %.0fx faster, its paths %.1f%% longer", milliseconds / jpsCount / hpaMilliseconds,
+                      (hpaCost / std::max(1.0, jpsCost) - 1.0) * 100.0);
+        results.push_back({"JPS long query " + label, jpsCount, milliseconds / jpsCount, detail});
+
+        // ==========================================================================================
+        // One tile changing
+        // ==========================================================================================
+        int tileX = size[0] / 2;
+        int tileY = size[1] / 2;
+        grid.setSolid(tileX, tileY, !grid.isSolid(tileX, tileY));
+        timer.reset();
+        int rebuilt = pathfinder.update(grid);
+        results.push_back({"HPA* update one tile " + label, rebuilt, timer.elapsedMilliseconds(),
+                           std::to_string(rebuilt) + " of " + std::to_string(pathfinder.getClusterCount()) + " clusters rebuilt"});
+    }
+    return results;
+}
@@ -0,0 +1,194 @@
+#include "bench/benchmarks.h"
+#include "net/body_movement.h"
+#include "net/interest_grid.h"
+#include "net/snapshot.h"
+#include "utils/fixed_timestep.h"
+#include <algorithm>
+#include <cstdio>
+
+#define INTEREST_BENCH_TICKS 300
+// 512 x 512 tiles of 16 px
+#define INTEREST_BENCH_MAP_SIZE 8192
+// One way, in ticks (50 ms), acks come back after two of these
+#define INTEREST_BENCH_LATENCY 3
+// ComfyServer's defaults, a 600x500 viewport at 2x
+#define INTEREST_BENCH_VIEW_WIDTH 300.0f
+#define INTEREST_BENCH_VIEW_HEIGHT 250.0f
+#define INTEREST_BENCH_MARGIN 64.0f
+#define INTEREST_BENCH_HYSTERESIS 32.0f
+
+// See botHash in comfy_server.cpp
+static uint32_t interestHash(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+struct BenchPendingAck
+{
+    uint32_t arriveTick;
+    uint16_t sequence;
+};
+
+struct BenchInterestClient
+{
+    SnapshotRing sent;
+    uint16_t nextSequence = 0;
+    std::vector<BenchPendingAck> acks;
+    InterestSet interest;
+};
+
+struct BenchInterestResult
+{
+    double interestMilliseconds = 0.0;
+    double encodeMilliseconds = 0.0;
+    uint64_t bytes = 0;
+    uint64_t visible = 0;
+    uint64_t events = 0;
+};
+
+/**
+    One body a client spread over the map, moving like players (new keys every second,
+    a third of the time none) through BodyMovement with walls at the map edge. Every
+    tick the server's sendState: the grid, each client's InterestSet and a delta of
+    what it can see against its acked baseline. withInterest false sends everyone
+    everything like before
+**/
+static BenchInterestResult runInterest(int clientCount, bool withInterest)
+{
+    BenchInterestResult result;
+    // ServerTuning's defaults, no map so the collider never touches anything
+    BodyMovement movement = BodyMovement::make(Fixed::fromInt(2000), Fixed::fromFloat(0.85f), Fixed::fromInt(400),
+                                               FixedAABB::fromRect(Fixed(), Fixed(), Fixed::fromInt(8), Fixed::fromInt(8)), nullptr);
+    const Fixed edge = Fixed::fromInt(INTEREST_BENCH_MAP_SIZE);
+
+    std::vector<BodyState> world(clientCount);
+    for (int i = 0; i < clientCount; i++)
+    {
+        world[i].id = (uint16_t)i;
+        world[i].generation = 1;
+        uint32_t hash = interestHash((uint32_t)i + 1);
+        world[i].position = BodyPositionCodec::quantize(FixedVec2(Fixed::fromInt((int)(hash % INTEREST_BENCH_MAP_SIZE)),
+                                                                  Fixed::fromInt((int)((hash >> 16) % INTEREST_BENCH_MAP_SIZE))));
+    }
+
+    InterestGrid grid;
+    std::vector<BenchInterestClient> clients(clientCount);
+    StateMessage state;
+    Snapshot written;
+    uint8_t payload[NET_MAX_PAYLOAD_BYTES];
+
+    for (uint32_t tick = 0; tick < INTEREST_BENCH_TICKS; tick++)
+    {
+        for (BodyState &body : world)
+        {
+            uint32_t hash = interestHash(tick / SIM_TICK_RATE * 2654435761u + body.id * 40503u);
+            uint8_t keys = hash % 3 == 0 ? 0 : (uint8_t)((hash >> 8) & SERVER_KEY_ALL);
+            movement.step(keys, body.position, body.velocity);
+            if (body.position.x < Fixed() || body.position.x > edge)
+            {
+                body.position.x = Fixed::maxOf(Fixed(), Fixed::minOf(edge, body.position.x));
+                body.velocity.x = Fixed();
+            }
+            if (body.position.y < Fixed() || body.position.y > edge)
+            {
+                body.position.y = Fixed::maxOf(Fixed(), Fixed::minOf(edge, body.position.y));
+                body.velocity.y = Fixed();
+            }
+            BodyMovement::snapToWire(body.position, body.velocity);
+        }
+
+        for (BenchInterestClient &client : clients)
+        {
+            size_t arrived = 0;
+            for (; arrived < client.acks.size() && client.acks[arrived].arriveTick <= tick; arrived++) client.sent.ack(client.acks[arrived].sequence);
+            client.acks.erase(client.acks.begin(), client.acks.begin() + arrived);
+        }
+
+        state.tick = tick;
+        if (!withInterest) state.bodies = world;
+        BenchTimer interestTimer;
+        if (withInterest) grid.rebuild(world);
+        for (int i = 0; i < clientCount; i++)
+        {
+            BenchInterestClient &client = clients[i];
+            if (withInterest)
+            {
+                float x = world[i].position.x.toFloat() - INTEREST_BENCH_VIEW_WIDTH / 2.0f;
+                float y = world[i].position.y.toFloat() - INTEREST_BENCH_VIEW_HEIGHT / 2.0f;
+                InterestRect inner = InterestRect{x, y, x + INTEREST_BENCH_VIEW_WIDTH, y + INTEREST_BENCH_VIEW_HEIGHT}.grow(INTEREST_BENCH_MARGIN);
+                client.interest.update(grid, inner, inner.grow(INTEREST_BENCH_HYSTERESIS), (uint16_t)i);
+                result.events += client.interest.getEntered().size() + client.interest.getLeft().size();
+            }
+        }
+        result.interestMilliseconds += interestTimer.elapsedMilliseconds();
+
+        BenchTimer encodeTimer;
+        for (int i = 0; i < clientCount; i++)
+        {
+            BenchInterestClient &client = clients[i];
+            if (withInterest)
+            {
+                state.bodies.clear();
+                for (uint16_t id : client.interest.getVisible()) state.bodies.push_back(world[id]);
+            }
+            const int count = (int)state.bodies.size();
+            const int start = count > 0 ? (int)((tick * (uint64_t)(StateMessage::maxBodiesPerPacket() - 1)) % (uint64_t)count) : 0;
+            state.yourId = (uint16_t)i;
+            state.yourGeneration = 1;
+
+            BitWriter writer(payload, NET_MAX_PAYLOAD_BYTES);
+            state.write(writer, client.sent.getNewestAcked(), start, written);
+            writer.flush();
+            uint16_t sequence = client.nextSequence++;
+            client.sent.insert(written, sequence);
+            client.acks.push_back({tick + 2 * INTEREST_BENCH_LATENCY, sequence});
+
+            result.bytes += writer.getBytes() + NET_HEADER_BYTES;
+            result.visible += count;
+        }
+        result.encodeMilliseconds += encodeTimer.elapsedMilliseconds();
+    }
+    result.interestMilliseconds /= INTEREST_BENCH_TICKS;
+    result.encodeMilliseconds /= INTEREST_BENCH_TICKS;
+    return result;
+}
+
+/**
+    Server cost a tick and bandwidth for 100, 500 and 2000 clients on an 8192 px map
+    with interest management, against everyone getting everything at 100 (past that
+    everything is more than a packet holds, and a ring of those a client)
+**/
+std::vector<BenchResult> Benchmarks::interest()
+{
+    std::vector<BenchResult> results;
+    struct Mode
+    {
+        const char *name;
+        int clients;
+        bool withInterest;
+    };
+    const Mode modes[] = {
+        {"100 clients, everything", 100, false},
+        {"100 clients, interest", 100, true},
+        {"500 clients, interest", 500, true},
+        {"2000 clients, interest", 2000, true},
+    };
+
+    const double seconds = (double)INTEREST_BENCH_TICKS / SIM_TICK_RATE;
+    for (const Mode &mode : modes)
+    {
+        BenchInterestResult run = runInterest(mode.clients, mode.withInterest);
+        const double clientSeconds = seconds * mode.clients;
+        char detail[200];
+        std::snprintf(detail, sizeof(detail), "interest %.3f ms + encode %.3f ms a tick, %.2f KB/s a client (%.0f KB/s out), %.1f bodies a state, %.1f enter / leave a s",
+                      run.interestMilliseconds, run.encodeMilliseconds, run.bytes / clientSeconds / 1024.0, run.bytes / seconds / 1024.0,
+                      (double)run.visible / INTEREST_BENCH_TICKS / mode.clients, run.events / clientSeconds);
+        results.push_back({mode.name, mode.clients, run.interestMilliseconds + run.encodeMilliseconds, detail});
+    }
+    return results;
+}
@@ -0,0 +1,201 @@
+#include "bench/benchmarks.h"
+#include "net/interpolation.h"
+#include "utils/fixed_timestep.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#define INTERPOLATION_BENCH_SECONDS 10.0
+#define INTERPOLATION_BENCH_FRAME_RATE 144.0
+// One way before any jitter
+#define INTERPOLATION_BENCH_LATENCY 0.05
+// Bodies go round 100 px circles at 200 px/s
+#define INTERPOLATION_BENCH_RADIUS 100.0
+#define INTERPOLATION_BENCH_SPEED 200.0
+
+// Where body i really is at a (fractional) server tick
+static void benchTruth(int i, double tick, double &x, double &y)
+{
+    double angle = tick / SIM_TICK_RATE * (INTERPOLATION_BENCH_SPEED / INTERPOLATION_BENCH_RADIUS) + i * 0.37;
+    x = 1000.0 + (i % 64) * 250.0 + INTERPOLATION_BENCH_RADIUS * std::cos(angle);
+    y = 1000.0 + (i / 64) * 250.0 + INTERPOLATION_BENCH_RADIUS * std::sin(angle);
+}
+
+static BodyState benchBody(int i, uint32_t tick)
+{
+    const double omega = INTERPOLATION_BENCH_SPEED / INTERPOLATION_BENCH_RADIUS;
+    double x, y;
+    benchTruth(i, tick, x, y);
+    double angle = (double)tick / SIM_TICK_RATE * omega + i * 0.37;
+    BodyState body;
+    body.id = (uint16_t)i;
+    body.generation = 1;
+    body.position = BodyPositionCodec::quantize(FixedVec2(Fixed::fromFloat((float)x), Fixed::fromFloat((float)y)));
+    body.velocity = BodyVelocityCodec::quantize(FixedVec2(Fixed::fromFloat((float)(-std::sin(angle) * INTERPOLATION_BENCH_SPEED)),
+                                                          Fixed::fromFloat((float)(std::cos(angle) * INTERPOLATION_BENCH_SPEED))));
+    return body;
+}
+
+struct InterpolationArrival
+{
+    double time;
+    uint32_t tick;
+};
+
+struct InterpolationBenchResult
+{
+    double frameMilliseconds = 0.0;
+    // How far the on screen speed of body 0 is from its real 200 px/s, averaged over frames
+    double speedError = 0.0;
+    // How far body 0 is from where it really was at the render tick
+    double positionError = 0.0;
+    double extrapolatedPercent = 0.0;
+    double delayMilliseconds = 0.0;
+    double jitterMilliseconds = 0.0;
+};
+
+/**
+    bodies on circles, a state every tick over a link with INTERPOLATION_BENCH_LATENCY
+    plus up to jitter seconds and loss, drawn at 144 fps. latestOnly draws body 0 at the
+    newest state that arrived instead of through the buffer, what we had before
+**/
+static InterpolationBenchResult runInterpolation(int bodies, double jitter, float loss, bool latestOnly)
+{
+    InterpolationBenchResult result;
+    std::mt19937 rng(49);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const uint32_t ticks = (uint32_t)(INTERPOLATION_BENCH_SECONDS * SIM_TICK_RATE);
+    std::vector<InterpolationArrival> arrivals;
+    for (uint32_t tick = 0; tick < ticks; tick++)
+    {
+        if (unit(rng) < loss) continue;
+        arrivals.push_back({(double)tick / SIM_TICK_RATE + INTERPOLATION_BENCH_LATENCY + unit(rng) * jitter, tick});
+    }
+    std::sort(arrivals.begin(), arrivals.end(), [](const InterpolationArrival &a, const InterpolationArrival &b) { return a.time < b.time; });
+
+    InterpolationBuffer buffer;
+    StateMessage state;
+    state.bodies.resize(bodies);
+    size_t nextArrival = 0;
+    uint32_t newestTick = 0;
+    bool hasNewest = false;
+
+    const double frameSeconds = 1.0 / INTERPOLATION_BENCH_FRAME_RATE;
+    double previousX = 0.0, previousY = 0.0;
+    bool hasPrevious = false;
+    int frames = 0, measured = 0;
+    double sampleMilliseconds = 0.0;
+    InterpolatedBody out;
+
+    // A second in so the buffer has settled
+    for (double now = 1.0; now < INTERPOLATION_BENCH_SECONDS; now += frameSeconds)
+    {
+        for (; nextArrival < arrivals.size() && arrivals[nextArrival].time <= now; nextArrival++)
+        {
+            uint32_t tick = arrivals[nextArrival].tick;
+            if (!hasNewest || tick > newestTick) newestTick = tick;
+            hasNewest = true;
+            if (latestOnly) continue;
+            state.tick = tick;
+            for (int i = 0; i < bodies; i++) state.bodies[i] = benchBody(i, tick);
+            buffer.addState(state, now, 0xFFFF);
+        }
+        if (!hasNewest) continue;
+
+        double x, y;
+        if (latestOnly)
+        {
+            BodyState newest = benchBody(0, newestTick);
+            x = newest.position.x.toFloat();
+            y = newest.position.y.toFloat();
+        }
+        else
+        {
+            BenchTimer timer;
+            buffer.update(now);
+            InterpolatedBody first;
+            for (int i = 0; i < bodies; i++)
+            {
+                buffer.sample((uint16_t)i, out);
+                if (i == 0) first = out;
+            }
+            sampleMilliseconds += timer.elapsedMilliseconds();
+            x = first.x;
+            y = first.y;
+
+            double truthX, truthY;
+            benchTruth(0, buffer.getClock().getRenderTick(), truthX, truthY);
+            result.positionError += std::sqrt((x - truthX) * (x - truthX) + (y - truthY) * (y - truthY));
+            result.extrapolatedPercent += first.extrapolating ? 1.0 : 0.0;
+            result.delayMilliseconds += buffer.getClock().getDelayTicks() * 1000.0 / SIM_TICK_RATE;
+            result.jitterMilliseconds += buffer.getClock().getJitterMilliseconds();
+        }
+        frames++;
+
+        if (hasPrevious)
+        {
+            double speed = std::sqrt((x - previousX) * (x - previousX) + (y - previousY) * (y - previousY)) / frameSeconds;
+            result.speedError += std::fabs(speed - INTERPOLATION_BENCH_SPEED);
+            measured++;
+        }
+        previousX = x;
+        previousY = y;
+        hasPrevious = true;
+    }
+
+    result.speedError /= std::max(1, measured);
+    result.frameMilliseconds = sampleMilliseconds / std::max(1, frames);
+    result.positionError /= std::max(1, frames);
+    result.extrapolatedPercent = result.extrapolatedPercent * 100.0 / std::max(1, frames);
+    result.delayMilliseconds /= std::max(1, frames);
+    result.jitterMilliseconds /= std::max(1, frames);
+    return result;
+}
+
+/**
+    Remote bodies drawn at 144 fps from 60 Hz states, the newest state as it arrives
+    against the interpolation buffer on a clean link, with jitter and with jitter plus
+    loss. Then what sampling costs a frame with 2000 bodies
+**/
+std::vector<BenchResult> Benchmarks::interpolation()
+{
+    std::vector<BenchResult> results;
+    struct Mode
+    {
+        const char *name;
+        double jitter;
+        float loss;
+        bool latestOnly;
+    };
+    const Mode modes[] = {
+        {"Newest state, 10 ms jitter", 0.010, 0.0f, true},
+        {"Buffer, no jitter", 0.0, 0.0f, false},
+        {"Buffer, 10 ms jitter", 0.010, 0.0f, false},
+        {"Buffer, 30 ms jitter, 5% loss", 0.030, 0.05f, false},
+    };
+
+    for (const Mode &mode : modes)
+    {
+        InterpolationBenchResult run = runInterpolation(1, mode.jitter, mode.loss, mode.latestOnly);
+        char detail[200];
+        if (mode.latestOnly)
+        {
+            std::snprintf(detail, sizeof(detail), "speed off by %.0f px/s a frame (moves at %.0f)", run.speedError, INTERPOLATION_BENCH_SPEED);
+        }
+        else
+        {
+            std::snprintf(detail, sizeof(detail), "delay %.1f ms (jitter %.1f ms), speed off by %.1f px/s, %.2f px off, %.1f%% extrapolated",
+                          run.delayMilliseconds, run.jitterMilliseconds, run.speedError, run.positionError, run.extrapolatedPercent);
+        }
+        results.push_back({mode.name, 1, 0.0, detail});
+    }
+
+    const int bodies = 2000;
+    InterpolationBenchResult cost = runInterpolation(bodies, 0.010, 0.0f, false);
+    char detail[96];
+    std::snprintf(detail, sizeof(detail), "%.1f ns a body a frame", cost.frameMilliseconds * 1e6 / bodies);
+    results.push_back({"Sample 2000 bodies", bodies, cost.frameMilliseconds, detail});
+    return results;
+}
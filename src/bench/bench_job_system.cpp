@@ -0,0 +1,168 @@
+#include "bench/benchmarks.h"
+#include "entity/component_store.h"
+#include "utils/job_system.h"
+#include "utils/jump_point_search.h"
+#include <algorithm>
+#include <random>
+
+/**
+    Stress test for the job system
+
+    - tiny jobs so we see what handing out a job costs
+    - the component store systems over a lot of entities, serial vs split up
+    - batches of JPS queries, one searcher per range since they keep scratch state
+    - chains of fenced parallel fors (a -> b -> c) to check dependencies hold up
+**/
+std::vector<BenchResult> Benchmarks::jobSystem()
+{
+    std::vector<BenchResult> results;
+    JobSystem jobs;
+    const int workers = jobs.getWorkerCount();
+    const std::string workerText = std::to_string(workers) + " workers";
+
+    // ==========================================================================================
+    // Job overhead
+    // ==========================================================================================
+    {
+        const int count = 100000;
+        std::vector<uint32_t> out(count, 0);
+        BenchTimer timer;
+        jobs.parallelFor(count, 1, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) out[i] = i * 2654435761u;
+        });
+        double ms = timer.elapsedMilliseconds();
+        results.push_back({"Empty jobs", count, ms, std::to_string((int)(ms * 1e6 / count)) + " ns / job, " + workerText});
+    }
+
+    // ==========================================================================================
+    // Entity systems
+    // ==========================================================================================
+    {
+        const int count = 200000;
+        const int runs = 20;
+        std::mt19937 rng(40);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        ComponentStore store;
+        store.reserve(count);
+        for (int i = 0; i < count; i++)
+        {
+            EntityHandle handle = store.create(unit(rng) * 4096.0f, unit(rng) * 4096.0f);
+            int slot = store.slotOf(handle);
+            store.getVelocities().x[slot] = unit(rng) * 200.0f - 100.0f;
+            store.getVelocities().y[slot] = unit(rng) * 200.0f - 100.0f;
+            store.getColliders().width[slot] = 12.0f;
+            store.getColliders().height[slot] = 12.0f;
+        }
+        std::vector<AABB> bounds;
+
+        BenchTimer timer;
+        for (int run = 0; run < runs; run++)
+        {
+            store.storePreviousPositions();
+            store.integrate(1.0f / 60.0f);
+            store.interpolate(0.5f);
+            store.gatherColliderBounds(bounds);
+        }
+        double serialMs = timer.elapsedMilliseconds() / runs;
+        results.push_back({"Entity tick serial", count, serialMs, ""});
+
+        timer.reset();
+        for (int run = 0; run < runs; run++)
+        {
+            store.storePreviousPositions(&jobs);
+            store.integrate(1.0f / 60.0f, &jobs);
+            store.interpolate(0.5f, &jobs);
+            store.gatherColliderBounds(bounds, &jobs);
+        }
+        double parallelMs = timer.elapsedMilliseconds() / runs;
+        results.push_back({"Entity tick jobs", count, parallelMs,
+                           std::to_string(serialMs / parallelMs).substr(0, 4) + "x, " + workerText});
+    }
+
+    // ==========================================================================================
+    // Pathfinding batch
+    // ==========================================================================================
+    {
+        CollisionGrid grid;
+        buildMapGrid(240, 160, grid);
+        const int queries = 2000;
+        std::mt19937 rng(41);
+        std::uniform_int_distribution<int> pickX(0, grid.getWidth() - 1);
+        std::uniform_int_distribution<int> pickY(0, grid.getHeight() - 1);
+        std::vector<PathPoint> ends;
+        while ((int)ends.size() < queries * 2)
+        {
+            int x = pickX(rng);
+            int y = pickY(rng);
+            if (!grid.isSolid(x, y)) ends.push_back({x, y});
+        }
+
+        // JPS keeps per search scratch so every range gets its own
+        const int grain = 16;
+        const int ranges = (queries + grain - 1) / grain;
+        std::vector<JumpPointSearch> searchers(ranges);
+        for (auto &searcher : searchers) searcher.build(grid);
+        std::vector<std::vector<PathPoint>> paths(ranges);
+        std::vector<int> found(ranges, 0);
+
+        auto runRange = [&](int begin, int end) {
+            int range = begin / grain;
+            for (int i = begin; i < end; i++)
+            {
+                if (searchers[range].findPath(ends[i * 2].x, ends[i * 2].y, ends[i * 2 + 1].x, ends[i * 2 + 1].y, paths[range])) found[range]++;
+            }
+        };
+
+        BenchTimer timer;
+        for (int begin = 0; begin < queries; begin += grain) runRange(begin, std::min(begin + grain, queries));
+        double serialMs = timer.elapsedMilliseconds();
+        results.push_back({"JPS batch serial", queries, serialMs, ""});
+
+        std::fill(found.begin(), found.end(), 0);
+        timer.reset();
+        JobCounter counter;
+        jobs.parallelForAsync(queries, grain, runRange, counter);
+        jobs.wait(counter);
+        double parallelMs = timer.elapsedMilliseconds();
+        int foundTotal = 0;
+        for (int value : found) foundTotal += value;
+        results.push_back({"JPS batch jobs", queries, parallelMs,
+                           std::to_string(serialMs / parallelMs).substr(0, 4) + "x, " + std::to_string(foundTotal) + " found"});
+    }
+
+    // ==========================================================================================
+    // Fenced chains
+    // ==========================================================================================
+    {
+        const int count = 65536;
+        const int chains = 200;
+        std::vector<int> a(count), b(count), c(count);
+        int wrong = 0;
+        auto fillA = [&](int begin, int end) { for (int i = begin; i < end; i++) a[i] = i; };
+        auto fillB = [&](int begin, int end) { for (int i = begin; i < end; i++) b[i] = a[i] * 3; };
+        auto fillC = [&](int begin, int end) { for (int i = begin; i < end; i++) c[i] = b[i] + a[i]; };
+
+        BenchTimer timer;
+        for (int chain = 0; chain < chains; chain++)
+        {
+            JobCounter doneA, doneB, doneC;
+            jobs.parallelForAsync(count, 1024, fillA, doneA);
+            jobs.parallelForAsync(count, 1024, fillB, doneB, &doneA);
+            jobs.parallelForAsync(count, 1024, fillC, doneC, &doneB);
+            jobs.wait(doneC);
+            for (int i = 0; i < count; i += 97) wrong += c[i] != i * 4;
+            std::fill(a.begin(), a.end(), 0);
+        }
+        results.push_back({"Fenced a -> b -> c", chains, timer.elapsedMilliseconds() / chains,
+                           std::to_string(wrong) + " wrong results"});
+    }
+
+    jobs.snapshotStats();
+    int worker = 0;
+    for (const auto &stats : jobs.getStats())
+    {
+        results.push_back({"Worker " + std::to_string(worker++), (int)stats.jobs, stats.busyMilliseconds,
+                           std::to_string(stats.steals) + " steals, " + std::to_string((int)(stats.utilisation * 100)) + "% busy"});
+    }
+    return results;
+}
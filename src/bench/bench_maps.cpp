@@ -0,0 +1,63 @@
+#include "bench/benchmarks.h"
+#include "utils/collision_grid.h"
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <random>
+
+using json = nlohmann::json;
+
+/**
+    The Collision layer of assets/map.json repeated until it covers width x height tiles,
+    so the big maps still have the wall layout of a real map. If the map cant be read we
+    fall back to random walls (about as many as the real map has) so the numbers still
+    mean something, returns false in that case
+**/
+bool Benchmarks::buildMapGrid(int width, int height, CollisionGrid &grid)
+{
+    // Same trick as fetchMapConfigs, find the assets folder from this file
+    std::string basePath = __FILE__;
+    basePath = basePath.substr(0, basePath.find_last_of("/"));
+    std::ifstream file(basePath + "/../../assets/map.json");
+
+    int mapWidth = 0;
+    int mapHeight = 0;
+    std::vector<int> collision;
+    if (file)
+    {
+        json j = json::parse(file, nullptr, false);
+        if (!j.is_discarded() && j.contains("layers"))
+        {
+            mapWidth = j.value("width", 0);
+            mapHeight = j.value("height", 0);
+            for (auto &layer : j.at("layers"))
+            {
+                if (layer.value("name", "") == "Collision" && layer.contains("data"))
+                {
+                    collision = layer.at("data").get<std::vector<int>>();
+                }
+            }
+        }
+    }
+
+    std::vector<int> tiles(static_cast<size_t>(width) * height, 0);
+    bool loaded = mapWidth > 0 && mapHeight > 0 && collision.size() >= (size_t)(mapWidth * mapHeight);
+    if (loaded)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                tiles[x + y * width] = collision[(x % mapWidth) + (y % mapHeight) * mapWidth];
+            }
+        }
+    }
+    else
+    {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> percent(0, 99);
+        for (auto &tile : tiles) tile = percent(rng) < 10 ? 1 : 0;
+    }
+
+    grid.build(width, height, 16, 16, tiles);
+    return loaded;
+}
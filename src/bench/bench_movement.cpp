@@ -0,0 +1,162 @@
+#include "bench/benchmarks.h"
+#include "utils/log_sink.h"
+#include "utils/movement_simd.h"
+#include "Vec2.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+// How far the scalar reference may end up from the legacy code after the bench's
+// 60 ticks, in px for positions and px / s for velocities
+#define MOVEMENT_LEGACY_TOLERANCE 0.01f
+
+/**
+    Movement the way Player::update used to do it, one entity at a time with Vec2, two
+    pows for friction and a length + normalize for the clamp
+**/
+static void legacyMovement(float dt, float acceleration, float friction, const MovementArrays &arrays, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        Vec2 velocity(arrays.velocityX[i], arrays.velocityY[i]);
+        velocity.x += arrays.directionX[i] * acceleration * dt;
+        velocity.y += arrays.directionY[i] * acceleration * dt;
+        if (velocity.length() > arrays.maxSpeed[i]) velocity = velocity.normalize() * arrays.maxSpeed[i];
+        if (arrays.directionX[i] == 0.0f) velocity.x *= pow(friction, dt * 60.0f);
+        if (arrays.directionY[i] == 0.0f) velocity.y *= pow(friction, dt * 60.0f);
+        arrays.velocityX[i] = velocity.x;
+        arrays.velocityY[i] = velocity.y;
+        arrays.x[i] += velocity.x * dt;
+        arrays.y[i] += velocity.y * dt;
+    }
+}
+
+// Own copy of every array so the three runs start from the same state
+struct MovementState
+{
+    std::vector<float> x, y, velocityX, velocityY, directionX, directionY, maxSpeed;
+
+    MovementArrays arrays()
+    {
+        MovementArrays out;
+        out.x = x.data();
+        out.y = y.data();
+        out.velocityX = velocityX.data();
+        out.velocityY = velocityY.data();
+        out.directionX = directionX.data();
+        out.directionY = directionY.data();
+        out.maxSpeed = maxSpeed.data();
+        return out;
+    }
+};
+
+// Largest absolute difference between two runs, positions and velocities apart
+static void maxDifference(const MovementState &a, const MovementState &b, float &position, float &velocity)
+{
+    position = velocity = 0.0f;
+    for (size_t i = 0; i < a.x.size(); i++)
+    {
+        position = std::max(position, std::max(std::fabs(a.x[i] - b.x[i]), std::fabs(a.y[i] - b.y[i])));
+        velocity = std::max(velocity, std::max(std::fabs(a.velocityX[i] - b.velocityX[i]), std::fabs(a.velocityY[i] - b.velocityY[i])));
+    }
+}
+
+/**
+    A crowd moving for a number of ticks: the old per entity scalar code, the scalar
+    reference (stepVelocity) and the batched SIMD kernel. The SIMD run is checked
+    against the reference bit for bit. The reference isnt the old code rearranged bit
+    for bit (acceleration * dt is done once, the clamp scales by maxSpeed / length
+    instead of normalize() * maxSpeed) so it is checked against the old code within
+    MOVEMENT_LEGACY_TOLERANCE
+**/
+std::vector<BenchResult> Benchmarks::movement()
+{
+    std::vector<BenchResult> results;
+    const int counts[] = {1000, 10000, 100000};
+    const int ticks = 60;
+    const float dt = 1.0f / 60.0f;
+    const float acceleration = 900.0f;
+    const float friction = 0.85f;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> axis(-1, 1);
+
+    for (int count : counts)
+    {
+        MovementState start;
+        for (int i = 0; i < count; i++)
+        {
+            // Same kind of directions the player input gives, normalized on diagonals
+            Vec2 direction((float)axis(rng), (float)axis(rng));
+            if (direction.x != 0.0f && direction.y != 0.0f) direction = direction.normalize();
+            start.x.push_back(unit(rng) * 4096.0f);
+            start.y.push_back(unit(rng) * 4096.0f);
+            start.velocityX.push_back(unit(rng) * 400.0f - 200.0f);
+            start.velocityY.push_back(unit(rng) * 400.0f - 200.0f);
+            start.directionX.push_back(direction.x);
+            start.directionY.push_back(direction.y);
+            start.maxSpeed.push_back(100.0f + unit(rng) * 100.0f);
+        }
+
+        MovementState legacy = start;
+        BenchTimer timer;
+        for (int tick = 0; tick < ticks; tick++) legacyMovement(dt, acceleration, friction, legacy.arrays(), count);
+        double legacyMs = timer.elapsedMilliseconds() / ticks;
+        results.push_back({"Vec2 + pow per entity", count, legacyMs, std::to_string((int)(legacyMs * 1e6 / count)) + " ns / entity"});
+
+        MovementState scalar = start;
+        timer.reset();
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            MovementParams params = MovementParams::make(dt, acceleration, friction);
+            MovementKernels::integrateScalar(params, scalar.arrays(), 0, count);
+        }
+        double scalarMs = timer.elapsedMilliseconds() / ticks;
+
+        float positionDrift, velocityDrift;
+        maxDifference(legacy, scalar, positionDrift, velocityDrift);
+        bool drifted = positionDrift > MOVEMENT_LEGACY_TOLERANCE || velocityDrift > MOVEMENT_LEGACY_TOLERANCE;
+        if (drifted)
+        {
+            LogSink::write("Scalar movement drifted from the old Vec2 code (" + std::to_string(positionDrift) + " px, " +
+                               std::to_string(velocityDrift) + " px/s)",
+                           ErrorCode::ERROR);
+        }
+        char detail[120];
+        std::snprintf(detail, sizeof(detail), "%d ns / entity, off the Vec2 code by %.2g px, %.2g px/s (tolerance %.2g)",
+                      (int)(scalarMs * 1e6 / count), positionDrift, velocityDrift, MOVEMENT_LEGACY_TOLERANCE);
+        results.push_back({drifted ? "SCALAR DRIFT" : "Scalar reference", count, scalarMs, detail});
+
+        MovementState batched = start;
+        timer.reset();
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            MovementParams params = MovementParams::make(dt, acceleration, friction);
+            MovementKernels::integrate(params, batched.arrays(), 0, count);
+        }
+        double simdMs = timer.elapsedMilliseconds() / ticks;
+
+        // Bit for bit, not "close enough"
+        int mismatches = 0;
+        for (int i = 0; i < count; i++)
+        {
+            mismatches += std::memcmp(&scalar.x[i], &batched.x[i], sizeof(float)) != 0 ||
+                          std::memcmp(&scalar.y[i], &batched.y[i], sizeof(float)) != 0 ||
+                          std::memcmp(&scalar.velocityX[i], &batched.velocityX[i], sizeof(float)) != 0 ||
+                          std::memcmp(&scalar.velocityY[i], &batched.velocityY[i], sizeof(float)) != 0;
+        }
+        // Anything but 0 means the build fused multiply adds somewhere (see COMFY_FP_OPTIONS)
+        std::string name = mismatches == 0 ? std::string("Batched ") + MovementKernels::getInstructionSet() : "BATCHED MISMATCH";
+        if (mismatches > 0)
+        {
+            LogSink::write("Batched movement doesnt match the scalar step (" + std::to_string(mismatches) + " entities), built with fused multiply adds?",
+                           ErrorCode::ERROR);
+        }
+        results.push_back({name, count, simdMs,
+                           std::to_string(scalarMs / simdMs).substr(0, 4) + "x scalar, " + std::to_string(mismatches) + " mismatches"});
+    }
+    return results;
+}
@@ -0,0 +1,180 @@
+#include "bench/benchmarks.h"
+#include "utils/path_service.h"
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+#include <random>
+
+/**
+    Plain A* with the same movement rules and costs as the JPS, only here so the
+    benchmark has something to compare the expanded tile count against
+**/
+static int plainAStar(const CollisionGrid &grid, int startX, int startY, int goalX, int goalY, uint32_t &pathCost)
+{
+    const int width = grid.getWidth();
+    const int dirX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    const int dirY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    auto octile = [](int dx, int dy) {
+        dx = std::abs(dx);
+        dy = std::abs(dy);
+        return (uint32_t)(std::min(dx, dy) * 14 + (std::max(dx, dy) - std::min(dx, dy)) * 10);
+    };
+
+    std::vector<uint32_t> cost(grid.getWidth() * grid.getHeight(), 0xFFFFFFFFu);
+    std::vector<uint8_t> closed(cost.size(), 0);
+    typedef std::pair<uint32_t, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    int expanded = 0;
+    cost[startX + startY * width] = 0;
+    open.push({octile(goalX - startX, goalY - startY), startX + startY * width});
+    while (!open.empty())
+    {
+        int index = open.top().second;
+        open.pop();
+        if (closed[index]) continue;
+        closed[index] = 1;
+        expanded++;
+
+        int x = index % width;
+        int y = index / width;
+        if (x == goalX && y == goalY)
+        {
+            pathCost = cost[index];
+            return expanded;
+        }
+        for (int dir = 0; dir < 8; dir++)
+        {
+            int nx = x + dirX[dir];
+            int ny = y + dirY[dir];
+            if (grid.isSolid(nx, ny)) continue;
+            if ((dir & 1) && (grid.isSolid(nx, y) || grid.isSolid(x, ny))) continue;
+
+            int next = nx + ny * width;
+            uint32_t g = cost[index] + ((dir & 1) ? 14 : 10);
+            if (g >= cost[next]) continue;
+            cost[next] = g;
+            open.push({g + octile(goalX - nx, goalY - ny), next});
+        }
+    }
+    pathCost = 0xFFFFFFFFu;
+    return expanded;
+}
+
+/**
+    Random walkable start / goal pairs on map.json tiled out to bigger maps
+
+    JPS gets timed on its own, the plain A* reference only runs on the smaller map (it is
+    the slow one) to show how many fewer tiles JPS pulls off the open list. The path
+    service run asks for the same 200 routes over and over like a crowd of agents would,
+    and then flips a tile to show the cache being thrown away.
+**/
+std::vector<BenchResult> Benchmarks::pathfinding()
+{
+    std::vector<BenchResult> results;
+    const int sizes[][2] = {{240, 160}, {960, 640}};
+    const int queryCount = 1000;
+
+    std::mt19937 rng(17);
+    for (auto &size : sizes)
+    {
+        CollisionGrid grid;
+        buildMapGrid(size[0], size[1], grid);
+        std::string label = std::to_string(size[0]) + "x" + std::to_string(size[1]);
+
+        std::uniform_int_distribution<int> x(0, size[0] - 1);
+        std::uniform_int_distribution<int> y(0, size[1] - 1);
+        std::vector<PathPoint> ends;
+        while ((int)ends.size() < queryCount * 2)
+        {
+            PathPoint point = {x(rng), y(rng)};
+            if (!grid.isSolid(point.x, point.y)) ends.push_back(point);
+        }
+
+        // ==========================================================================================
+        // JPS
+        // ==========================================================================================
+        JumpPointSearch search;
+        search.build(grid);
+        std::vector<PathPoint> path;
+        long long expanded = 0;
+        int found = 0;
+        BenchTimer timer;
+        for (int i = 0; i < queryCount; i++)
+        {
+            if (search.findPath(ends[i * 2].x, ends[i * 2].y, ends[i * 2 + 1].x, ends[i * 2 + 1].y, path)) found++;
+            expanded += search.getExpanded();
+        }
+        double milliseconds = timer.elapsedMilliseconds();
+        results.push_back({"JPS " + label, queryCount, milliseconds / queryCount,
+                           std::to_string((long long)(queryCount / (milliseconds / 1000.0))) + " queries/s, " +
+                           std::to_string(expanded / queryCount) + " expanded, " + std::to_string(found) + " found"});
+
+        // ==========================================================================================
+        // Plain A* reference
+        // ==========================================================================================
+        if (size[0] * size[1] <= 240 * 160)
+        {
+            const int referenceCount = 200;
+            long long referenceExpanded = 0;
+            int costMismatches = 0;
+            timer.reset();
+            for (int i = 0; i < referenceCount; i++)
+            {
+                uint32_t cost;
+                referenceExpanded += plainAStar(grid, ends[i * 2].x, ends[i * 2].y, ends[i * 2 + 1].x, ends[i * 2 + 1].y, cost);
+            }
+            milliseconds = timer.elapsedMilliseconds();
+
+            // Same path lengths as JPS or something is wrong
+            for (int i = 0; i < referenceCount; i++)
+            {
+                uint32_t cost;
+                plainAStar(grid, ends[i * 2].x, ends[i * 2].y, ends[i * 2 + 1].x, ends[i * 2 + 1].y, cost);
+                bool hasPath = search.findPath(ends[i * 2].x, ends[i * 2].y, ends[i * 2 + 1].x, ends[i * 2 + 1].y, path);
+                uint32_t jpsCost = hasPath ? 0 : 0xFFFFFFFFu;
+                for (size_t p = 1; p < path.size(); p++)
+                {
+                    int dx = std::abs(path[p].x - path[p - 1].x);
+                    int dy = std::abs(path[p].y - path[p - 1].y);
+                    jpsCost += std::min(dx, dy) * 14 + (std::max(dx, dy) - std::min(dx, dy)) * 10;
+                }
+                if (jpsCost != cost) costMismatches++;
+            }
+            results.push_back({"A* reference " + label, referenceCount, milliseconds / referenceCount,
+                               std::to_string((long long)(referenceCount / (milliseconds / 1000.0))) + " queries/s, " +
+                               std::to_string(referenceExpanded / referenceCount) + " expanded, " +
+                               (costMismatches == 0 ? "same costs as JPS" : std::to_string(costMismatches) + " COST MISMATCHES")});
+        }
+
+        // ==========================================================================================
+        // Path service with a small working set of routes
+        // ==========================================================================================
+        PathService service(256);
+        const int routeCount = 200;
+        const int requests = 5000;
+        std::uniform_int_distribution<int> route(0, routeCount - 1);
+        timer.reset();
+        for (int i = 0; i < requests; i++)
+        {
+            int r = route(rng);
+            service.findPath(grid, ends[r * 2].x, ends[r * 2].y, ends[r * 2 + 1].x, ends[r * 2 + 1].y, path);
+        }
+        milliseconds = timer.elapsedMilliseconds();
+        results.push_back({"PathService cached " + label, requests, milliseconds / requests,
+                           std::to_string((long long)(requests / (milliseconds / 1000.0))) + " queries/s, " +
+                           std::to_string(service.getHits()) + " hits / " + std::to_string(service.getMisses()) + " misses"});
+
+        // One tile changing has to throw everything away
+        grid.setSolid(ends[0].x, ends[0].y, true);
+        int missesBefore = service.getMisses();
+        timer.reset();
+        for (int r = 0; r < routeCount; r++)
+        {
+            service.findPath(grid, ends[r * 2].x, ends[r * 2].y, ends[r * 2 + 1].x, ends[r * 2 + 1].y, path);
+        }
+        results.push_back({"PathService after tile change " + label, routeCount, timer.elapsedMilliseconds() / routeCount,
+                           std::to_string(service.getMisses() - missesBefore) + " misses (expect " + std::to_string(routeCount) + ")"});
+    }
+    return results;
+}
@@ -0,0 +1,117 @@
+#include "bench/benchmarks.h"
+#include "utils/pool.h"
+#include <cstdio>
+#include <memory>
+#include <random>
+
+/**
+    Something about the size of what we spawn and despawn all the time in a match,
+    projectiles, hit effects, ...
+**/
+struct BenchProjectile
+{
+    float x, y;
+    float velocityX, velocityY;
+    float lifetime;
+    uint32_t owner;
+    float padding[10];
+
+    BenchProjectile(float x, float y, float velocityX, float velocityY)
+        : x(x), y(y), velocityX(velocityX), velocityY(velocityY), lifetime(2.0f), owner(0), padding{} {}
+};
+
+/**
+    Spawn / despawn churn through a Pool against new / delete, a tenth of the live
+    projectiles die and get replaced every tick. Also counts stale handles that still
+    resolve (should be 0) and checks a capped pool refuses to grow
+**/
+std::vector<BenchResult> Benchmarks::pools()
+{
+    std::vector<BenchResult> results;
+    const int counts[] = {1000, 10000, 100000};
+    const int runs = 100;
+
+    std::mt19937 rng(41);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int count : counts)
+    {
+        std::uniform_int_distribution<int> pick(0, count - 1);
+        const int churn = count / 10;
+
+        // ==========================================================================================
+        // Pool
+        // ==========================================================================================
+        Pool<BenchProjectile> pool;
+        std::vector<PoolHandle> handles(count);
+        for (int i = 0; i < count; i++)
+        {
+            handles[i] = pool.create(unit(rng), unit(rng), unit(rng), unit(rng));
+        }
+        size_t bytesBefore = pool.getBytes();
+
+        int stale = 0;
+        BenchTimer timer;
+        for (int run = 0; run < runs; run++)
+        {
+            for (int i = 0; i < churn; i++)
+            {
+                int which = pick(rng);
+                PoolHandle old = handles[which];
+                pool.destroy(old);
+                handles[which] = pool.create(unit(rng), unit(rng), unit(rng), unit(rng));
+                if (pool.get(old)) stale++;
+            }
+        }
+        double poolMs = timer.elapsedMilliseconds() / runs;
+        results.push_back({"Pool spawn + despawn", churn, poolMs,
+                           std::to_string((int)(poolMs * 1e6 / churn)) + " ns each, " + std::to_string(stale) + " stale, " +
+                           (pool.getBytes() == bytesBefore ? "no growth" : "grew")});
+
+        // ==========================================================================================
+        // new / delete
+        // ==========================================================================================
+        std::vector<std::unique_ptr<BenchProjectile>> heap(count);
+        for (int i = 0; i < count; i++)
+        {
+            heap[i].reset(new BenchProjectile(unit(rng), unit(rng), unit(rng), unit(rng)));
+        }
+
+        timer.reset();
+        for (int run = 0; run < runs; run++)
+        {
+            for (int i = 0; i < churn; i++)
+            {
+                heap[pick(rng)].reset(new BenchProjectile(unit(rng), unit(rng), unit(rng), unit(rng)));
+            }
+        }
+        double heapMs = timer.elapsedMilliseconds() / runs;
+        results.push_back({"new + delete", churn, heapMs, std::to_string((int)(heapMs * 1e6 / churn)) + " ns each"});
+
+        // ==========================================================================================
+        // Walking every live item
+        // ==========================================================================================
+        float sum = 0.0f;
+        timer.reset();
+        for (int run = 0; run < runs; run++)
+        {
+            pool.forEach([&sum](PoolHandle, BenchProjectile &projectile) { sum += projectile.x; });
+        }
+        // The sum goes in the detail so the walk cant be thrown away
+        char detail[96];
+        std::snprintf(detail, sizeof(detail), "%d KB in blocks, checksum %.0f", (int)(pool.getBytes() / 1024), sum);
+        results.push_back({"Pool forEach", count, timer.elapsedMilliseconds() / runs, detail});
+    }
+
+    // ==========================================================================================
+    // Capped pool
+    // ==========================================================================================
+    Pool<BenchProjectile> capped(500);
+    int refused = 0;
+    for (int i = 0; i < 600; i++)
+    {
+        if (capped.create(0.0f, 0.0f, 0.0f, 0.0f).isNull()) refused++;
+    }
+    results.push_back({"Capped at 500", 600, 0.0, std::to_string(refused) + " refused, " + std::to_string(capped.getCapacity()) + " slots"});
+    return results;
+}
@@ -0,0 +1,224 @@
+#include "bench/benchmarks.h"
+#include "net/net_messages.h"
+#include "net/player_net_state.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+/**
+    The Player fields as they sit in memory, what we would send without a serializer
+**/
+struct BenchPlayerDump
+{
+    float x, y;
+    float velocityX, velocityY;
+    int health, level, experience;
+    int state;
+};
+
+static std::string bytesText(double bytes)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f B", bytes);
+    return text;
+}
+
+static std::string throughputText(double milliseconds, int count, double bytes)
+{
+    char text[64];
+    std::snprintf(text, sizeof(text), "%.1f ns each, %.0f MB/s", milliseconds * 1e6 / count, bytes / (milliseconds * 1e3));
+    return text;
+}
+
+/**
+    10k players with plausible values through PlayerNetSchema against a struct dump:
+    bytes per player, encode / decode time and that everything comes back within half
+    a quantisation step, then as deltas against what the reader already has. Then the
+    server's BodyState the same way, those have to come back bit for bit since the
+    server snaps onto the wire grid
+**/
+std::vector<BenchResult> Benchmarks::serialization()
+{
+    std::vector<BenchResult> results;
+    const int count = 10000;
+    const int runs = 50;
+
+    std::mt19937 rng(46);
+    std::uniform_real_distribution<float> position(0.0f, 4096.0f);
+    std::uniform_real_distribution<float> velocity(-400.0f, 400.0f);
+    std::uniform_int_distribution<int> health(0, 100);
+    std::uniform_int_distribution<int> level(1, 60);
+    std::uniform_int_distribution<int> experience(0, 50000);
+    std::uniform_int_distribution<int> state(0, (int)NetPlayerState::COUNT - 1);
+
+    std::vector<PlayerNetState> players(count);
+    for (int i = 0; i < count; i++)
+    {
+        PlayerNetState &player = players[i];
+        player.id = (uint16_t)i;
+        player.x = position(rng);
+        player.y = position(rng);
+        // A third of them standing still
+        player.velocityX = i % 3 == 0 ? 0.0f : velocity(rng);
+        player.velocityY = i % 3 == 0 ? 0.0f : velocity(rng);
+        player.health = health(rng);
+        player.level = level(rng);
+        player.experience = experience(rng);
+        player.state = (NetPlayerState)state(rng);
+    }
+
+    // ==========================================================================================
+    // Struct dump
+    // ==========================================================================================
+    std::vector<uint8_t> dump(count * sizeof(BenchPlayerDump));
+    BenchTimer timer;
+    for (int run = 0; run < runs; run++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const PlayerNetState &player = players[i];
+            BenchPlayerDump raw = {player.x, player.y, player.velocityX, player.velocityY,
+                                   player.health, player.level, player.experience, (int)player.state};
+            std::memcpy(dump.data() + i * sizeof(BenchPlayerDump), &raw, sizeof(raw));
+        }
+    }
+    double dumpMs = timer.elapsedMilliseconds() / runs;
+    results.push_back({"Struct dump", count, dumpMs,
+                       bytesText((double)sizeof(BenchPlayerDump)) + " each, " + throughputText(dumpMs, count, (double)dump.size())});
+
+    // ==========================================================================================
+    // Bit packed players
+    // ==========================================================================================
+    std::vector<uint8_t> packed(count * PlayerNetSchema::maxBytes);
+    int packedBytes = 0;
+    timer.reset();
+    for (int run = 0; run < runs; run++)
+    {
+        BitWriter writer(packed.data(), (int)packed.size());
+        for (const PlayerNetState &player : players) PlayerNetSchema::write(writer, player);
+        writer.flush();
+        packedBytes = writer.getBytes();
+    }
+    double encodeMs = timer.elapsedMilliseconds() / runs;
+    results.push_back({"Bit packed encode", count, encodeMs,
+                       bytesText((double)packedBytes / count) + " each (max " + std::to_string(PlayerNetSchema::maxBytes) + "), " +
+                           throughputText(encodeMs, count, packedBytes)});
+
+    std::vector<PlayerNetState> decoded(count);
+    bool overflowed = false;
+    timer.reset();
+    for (int run = 0; run < runs; run++)
+    {
+        BitReader reader(packed.data(), packedBytes);
+        for (PlayerNetState &player : decoded) PlayerNetSchema::read(reader, player);
+        overflowed = overflowed || reader.hasOverflowed();
+    }
+    double decodeMs = timer.elapsedMilliseconds() / runs;
+
+    // Half a step plus float rounding at 4096 px
+    int mismatches = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const PlayerNetState &in = players[i];
+        const PlayerNetState &out = decoded[i];
+        bool close = std::fabs(in.x - out.x) <= 0.5f / 8 + 1e-3f && std::fabs(in.y - out.y) <= 0.5f / 8 + 1e-3f &&
+                     std::fabs(in.velocityX - out.velocityX) <= 0.5f / 16 + 1e-4f &&
+                     std::fabs(in.velocityY - out.velocityY) <= 0.5f / 16 + 1e-4f;
+        bool exact = in.id == out.id && in.health == out.health && in.level == out.level && in.experience == out.experience &&
+                     in.state == out.state;
+        if (!close || !exact) mismatches++;
+    }
+    results.push_back({"Bit packed decode", count, decodeMs,
+                       throughputText(decodeMs, count, packedBytes) + ", " + std::to_string(mismatches) + " off" +
+                           (overflowed ? ", overflowed" : "")});
+
+    // A fresh player standing still, the smallest update there is
+    uint8_t idleBuffer[PlayerNetSchema::maxBytes];
+    BitWriter idleWriter(idleBuffer, sizeof(idleBuffer));
+    PlayerNetState idle;
+    idle.health = 100;
+    PlayerNetSchema::write(idleWriter, idle);
+    idleWriter.flush();
+    results.push_back({"Idle player", 1, 0.0, bytesText(idleWriter.getBytes()) + ", " + std::to_string(idleWriter.getBitsWritten()) + " bits"});
+
+    // The same against what the other end already has, what it read back last time (quantised)
+    PlayerNetState idleHeld;
+    BitReader idleReader(idleBuffer, idleWriter.getBytes());
+    PlayerNetSchema::read(idleReader, idleHeld);
+    BitWriter idleDeltaWriter(idleBuffer, sizeof(idleBuffer));
+    PlayerNetSchema::writeDelta(idleDeltaWriter, idle, idleHeld);
+    idleDeltaWriter.flush();
+    results.push_back({"Idle player, delta", 1, 0.0,
+                       bytesText(idleDeltaWriter.getBytes()) + ", " + std::to_string(idleDeltaWriter.getBitsWritten()) + " bits"});
+
+    // Everyone a tick later against what the reader decoded, a third of them havent moved
+    std::vector<PlayerNetState> moved = players;
+    for (PlayerNetState &player : moved)
+    {
+        player.x += player.velocityX / 60.0f;
+        player.y += player.velocityY / 60.0f;
+    }
+    std::vector<uint8_t> deltas(count * ((PlayerNetSchema::maxDeltaBits + 7) / 8));
+    timer.reset();
+    BitWriter deltaWriter(deltas.data(), (int)deltas.size());
+    for (int i = 0; i < count; i++) PlayerNetSchema::writeDelta(deltaWriter, moved[i], decoded[i]);
+    deltaWriter.flush();
+    double deltaMs = timer.elapsedMilliseconds();
+
+    BitReader deltaReader(deltas.data(), deltaWriter.getBytes());
+    int deltaMismatches = 0;
+    for (int i = 0; i < count; i++)
+    {
+        PlayerNetState out;
+        PlayerNetSchema::readDelta(deltaReader, out, decoded[i]);
+        bool close = std::fabs(moved[i].x - out.x) <= 0.5f / 8 + 1e-3f && std::fabs(moved[i].y - out.y) <= 0.5f / 8 + 1e-3f;
+        if (!close || out.id != moved[i].id || out.health != moved[i].health || out.experience != moved[i].experience) deltaMismatches++;
+    }
+    results.push_back({"Moved a tick, delta", count, deltaMs,
+                       bytesText((double)deltaWriter.getBytes() / count) + " each (max " +
+                           std::to_string((PlayerNetSchema::maxDeltaBits + 7) / 8) + "), " + std::to_string(deltaMismatches) + " off"});
+
+    // ==========================================================================================
+    // Server bodies
+    // ==========================================================================================
+    std::vector<BodyState> bodies(count);
+    for (int i = 0; i < count; i++)
+    {
+        const PlayerNetState &player = players[i];
+        bodies[i].id = (uint16_t)i;
+        bodies[i].generation = (uint8_t)(i * 7);
+        bodies[i].position = BodyPositionCodec::quantize(FixedVec2(Fixed::fromFloat(player.x), Fixed::fromFloat(player.y)));
+        bodies[i].velocity = BodyVelocityCodec::quantize(FixedVec2(Fixed::fromFloat(player.velocityX), Fixed::fromFloat(player.velocityY)));
+    }
+
+    std::vector<uint8_t> bodyBuffer(count * BodyStateSchema::maxBytes);
+    int bodyBytes = 0;
+    timer.reset();
+    for (int run = 0; run < runs; run++)
+    {
+        BitWriter writer(bodyBuffer.data(), (int)bodyBuffer.size());
+        for (const BodyState &body : bodies) BodyStateSchema::write(writer, body);
+        writer.flush();
+        bodyBytes = writer.getBytes();
+    }
+    double bodyMs = timer.elapsedMilliseconds() / runs;
+
+    std::vector<BodyState> bodiesBack(count);
+    BitReader bodyReader(bodyBuffer.data(), bodyBytes);
+    for (BodyState &body : bodiesBack) BodyStateSchema::read(bodyReader, body);
+    int bodyMismatches = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const BodyState &in = bodies[i];
+        const BodyState &out = bodiesBack[i];
+        if (in.id != out.id || in.generation != out.generation || !(in.position == out.position) || !(in.velocity == out.velocity))
+        {
+            bodyMismatches++;
+        }
+    }
+    results.push_back({"Server bodies encode", count, bodyMs,
+                       bytesText((double)bodyBytes / count) + " each (was 20 B), " + std::to_string(bodyMismatches) + " not bit exact, " +
+                           std::to_string(StateMessage::maxBodiesPerPacket()) + " a packet"});
+    return results;
+}
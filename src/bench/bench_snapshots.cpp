@@ -0,0 +1,230 @@
+#include "bench/benchmarks.h"
+#include "net/snapshot.h"
+#include "utils/fixed_timestep.h"
+#include "utils/movement_simd.h"
+#include <cstdio>
+#include <random>
+
+#define SNAPSHOT_BENCH_PLAYERS 64
+#define SNAPSHOT_BENCH_TICKS 600
+// One way, in ticks (50 ms)
+#define SNAPSHOT_BENCH_LATENCY 3
+
+// See botHash in comfy_server.cpp
+static uint32_t sessionHash(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+/**
+    64 bodies moving like players would (new keys every second, about a third of the
+    time none), snapped onto the wire grid like ComfyServer::stepBody does. Walls round
+    an 8192 px box instead of a map
+**/
+static void stepSession(std::vector<BodyState> &world, const FixedMovementParams &params, uint32_t tick)
+{
+    const Fixed one = Fixed::fromInt(1);
+    const Fixed maxSpeed = Fixed::fromInt(400);
+    const Fixed edge = Fixed::fromInt(8192);
+    const int32_t step = BodyVelocityCodec::Axis::stepRaw;
+
+    for (BodyState &body : world)
+    {
+        uint32_t hash = sessionHash(tick / SIM_TICK_RATE * 2654435761u + body.id * 40503u);
+        uint32_t keys = hash % 3 == 0 ? 0 : (hash >> 8) & 0x0F;
+        FixedVec2 direction;
+        if (keys & 1) direction.y -= one;
+        if (keys & 2) direction.y += one;
+        if (keys & 4) direction.x -= one;
+        if (keys & 8) direction.x += one;
+        if (direction.x.raw != 0 && direction.y.raw != 0) direction = direction.normalize();
+
+        MovementKernels::stepVelocityFixed(params, direction, maxSpeed, body.velocity);
+        body.position += body.velocity * params.dt;
+        if (body.position.x < Fixed() || body.position.x > edge)
+        {
+            body.position.x = Fixed::maxOf(Fixed(), Fixed::minOf(edge, body.position.x));
+            body.velocity.x = Fixed();
+        }
+        if (body.position.y < Fixed() || body.position.y > edge)
+        {
+            body.position.y = Fixed::maxOf(Fixed(), Fixed::minOf(edge, body.position.y));
+            body.velocity.y = Fixed();
+        }
+        body.position = BodyPositionCodec::quantize(body.position);
+        body.velocity = BodyVelocityCodec::quantize(FixedVec2(Fixed::fromRaw(body.velocity.x.raw / step * step),
+                                                              Fixed::fromRaw(body.velocity.y.raw / step * step)));
+    }
+}
+
+struct BenchPacket
+{
+    uint32_t arriveTick;
+    uint16_t sequence;
+    std::vector<uint8_t> data;
+};
+
+// One player's end of the session, the server's ring of what it sent and the client's of what it read
+struct BenchSessionClient
+{
+    SnapshotRing sent;
+    SnapshotRing received;
+    uint16_t nextSequence = 0;
+    std::vector<BenchPacket> inFlight;
+    std::vector<BenchPacket> acksInFlight;
+    StateMessage read;
+};
+
+struct BenchSessionResult
+{
+    double encodeMilliseconds = 0.0;
+    uint64_t bytes = 0;
+    int packets = 0;
+    int fullStates = 0;
+    int mismatches = 0;
+};
+
+/**
+    A 64 player session over a fake link with SNAPSHOT_BENCH_LATENCY ticks each way and
+    loss of the server's packets. Acks come back on the client's own packets, those
+    repeat the last 32 so theyre treated as never lost. Every state the clients read
+    gets compared with the world at that tick
+**/
+static BenchSessionResult runSession(bool deltas, float loss)
+{
+    BenchSessionResult result;
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    FixedMovementParams params = FixedMovementParams::make(SIM_TICK_RATE, Fixed::fromInt(2000), Fixed::fromFloat(0.85f));
+
+    std::vector<BodyState> world(SNAPSHOT_BENCH_PLAYERS);
+    for (int i = 0; i < SNAPSHOT_BENCH_PLAYERS; i++)
+    {
+        world[i].id = (uint16_t)i;
+        world[i].generation = 1;
+        world[i].position = BodyPositionCodec::quantize(FixedVec2(Fixed::fromInt(3200 + (i % 8) * 240), Fixed::fromInt(3200 + (i / 8) * 240)));
+    }
+    // World at every tick, to check what clients rebuild against
+    std::vector<std::vector<BodyState>> history;
+    history.reserve(SNAPSHOT_BENCH_TICKS);
+
+    std::vector<BenchSessionClient> clients(SNAPSHOT_BENCH_PLAYERS);
+    StateMessage state;
+    Snapshot written;
+    uint8_t payload[NET_MAX_PAYLOAD_BYTES];
+
+    for (uint32_t tick = 0; tick < SNAPSHOT_BENCH_TICKS; tick++)
+    {
+        stepSession(world, params, tick);
+        history.push_back(world);
+
+        // Acks first, like ComfyServer::pollNetwork before the send
+        for (BenchSessionClient &client : clients)
+        {
+            for (size_t i = 0; i < client.acksInFlight.size();)
+            {
+                if (client.acksInFlight[i].arriveTick > tick) { i++; continue; }
+                client.sent.ack(client.acksInFlight[i].sequence);
+                client.acksInFlight.erase(client.acksInFlight.begin() + i);
+            }
+        }
+
+        state.tick = tick;
+        state.bodies = world;
+        int start = (int)((tick * (uint64_t)(StateMessage::maxBodiesPerPacket() - 1)) % world.size());
+        BenchTimer timer;
+        for (int i = 0; i < SNAPSHOT_BENCH_PLAYERS; i++)
+        {
+            BenchSessionClient &client = clients[i];
+            state.yourId = (uint16_t)i;
+            state.yourGeneration = 1;
+            const Snapshot *baseline = deltas ? client.sent.getNewestAcked() : nullptr;
+            if (!baseline) result.fullStates++;
+
+            BitWriter writer(payload, NET_MAX_PAYLOAD_BYTES);
+            state.write(writer, baseline, start, written);
+            writer.flush();
+            uint16_t sequence = client.nextSequence++;
+            client.sent.insert(written, sequence);
+
+            result.bytes += writer.getBytes() + NET_HEADER_BYTES;
+            result.packets++;
+            if (unit(rng) >= loss)
+            {
+                client.inFlight.push_back({tick + SNAPSHOT_BENCH_LATENCY, sequence, std::vector<uint8_t>(payload, payload + writer.getBytes())});
+            }
+        }
+        result.encodeMilliseconds += timer.elapsedMilliseconds();
+
+        // Clients read what arrived and ack it
+        for (BenchSessionClient &client : clients)
+        {
+            for (size_t i = 0; i < client.inFlight.size();)
+            {
+                BenchPacket &packet = client.inFlight[i];
+                if (packet.arriveTick > tick) { i++; continue; }
+
+                BitReader reader(packet.data.data(), (int)packet.data.size());
+                if (client.read.read(reader, client.received))
+                {
+                    Snapshot snapshot;
+                    snapshot.tick = client.read.tick;
+                    snapshot.bodies = client.read.bodies;
+                    client.received.insert(snapshot, packet.sequence);
+                    client.acksInFlight.push_back({tick + SNAPSHOT_BENCH_LATENCY, packet.sequence, {}});
+
+                    const std::vector<BodyState> &truth = history[client.read.tick];
+                    bool same = client.read.bodies.size() == truth.size();
+                    for (size_t j = 0; same && j < truth.size(); j++)
+                    {
+                        const BodyState &a = client.read.bodies[j], &b = truth[j];
+                        same = a.id == b.id && a.generation == b.generation && a.position == b.position && a.velocity == b.velocity;
+                    }
+                    if (!same) result.mismatches++;
+                }
+                else result.mismatches++;
+                client.inFlight.erase(client.inFlight.begin() + i);
+            }
+        }
+    }
+    result.encodeMilliseconds /= SNAPSHOT_BENCH_TICKS;
+    return result;
+}
+
+/**
+    Bandwidth a client for a 64 player session, full states every tick against deltas
+    on acked baselines with 0, 5 and 20% loss (100 ms round trip)
+**/
+std::vector<BenchResult> Benchmarks::snapshots()
+{
+    std::vector<BenchResult> results;
+    struct Mode
+    {
+        const char *name;
+        bool deltas;
+        float loss;
+    };
+    const Mode modes[] = {
+        {"Full states", false, 0.0f},
+        {"Deltas, no loss", true, 0.0f},
+        {"Deltas, 5% loss", true, 0.05f},
+        {"Deltas, 20% loss", true, 0.20f},
+    };
+
+    const double seconds = (double)SNAPSHOT_BENCH_TICKS / SIM_TICK_RATE;
+    for (const Mode &mode : modes)
+    {
+        BenchSessionResult session = runSession(mode.deltas, mode.loss);
+        char detail[160];
+        std::snprintf(detail, sizeof(detail), "%.1f KB/s a client, %.0f B a packet, %d full, %d wrong",
+                      session.bytes / seconds / SNAPSHOT_BENCH_PLAYERS / 1024.0, (double)session.bytes / session.packets,
+                      session.fullStates, session.mismatches);
+        results.push_back({mode.name, SNAPSHOT_BENCH_PLAYERS, session.encodeMilliseconds, detail});
+    }
+    return results;
+}
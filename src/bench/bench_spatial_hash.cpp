@@ -0,0 +1,88 @@
+#include "bench/benchmarks.h"
+#include "utils/spatial_hash.h"
+#include <cmath>
+#include <random>
+
+/**
+    Entities are spread over a map that grows with the entity count so the density
+    (and so the number of pairs per entity) stays the same. If the broadphase scales
+    linearly the ns per entity column should stay flat. Brute force runs on the boxes
+    of the last tick and has to find exactly the pairs the hash found that tick.
+**/
+std::vector<BenchResult> Benchmarks::spatialHash()
+{
+    std::vector<BenchResult> results;
+    const int counts[] = {100, 1000, 2500, 5000, 10000};
+    const int ticks = 20;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> size(8.0f, 24.0f);
+    std::uniform_real_distribution<float> jitter(-2.0f, 2.0f);
+
+    for (int count : counts)
+    {
+        // About one entity per 48x48 pixels, on a 16x16 tile map
+        float worldSize = std::sqrt((float)count) * 48.0f;
+        std::uniform_real_distribution<float> position(0.0f, worldSize);
+
+        std::vector<AABB> boxes(count);
+        for (auto &box : boxes)
+        {
+            box = AABB::fromRect(position(rng), position(rng), size(rng), size(rng));
+        }
+
+        SpatialHash spatialHash(16, 16, 2);
+        std::vector<BroadphasePair> pairs;
+        // Warm up so the vectors have grown before we time anything
+        spatialHash.rebuild(boxes);
+        spatialHash.findPairs(pairs);
+
+        double total = 0.0;
+        size_t pairCount = 0;
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            // Everyone moves a little every tick
+            for (auto &box : boxes)
+            {
+                float dx = jitter(rng);
+                float dy = jitter(rng);
+                box = AABB{box.minX + dx, box.minY + dy, box.maxX + dx, box.maxY + dy};
+            }
+
+            BenchTimer timer;
+            spatialHash.rebuild(boxes);
+            spatialHash.findPairs(pairs);
+            total += timer.elapsedMilliseconds();
+            pairCount += pairs.size();
+        }
+
+        BenchResult result;
+        result.name = "SpatialHash rebuild + pairs";
+        result.count = count;
+        result.milliseconds = total / ticks;
+        result.detail = std::to_string((long long)(result.milliseconds * 1e6 / count)) + " ns/entity, " +
+                        std::to_string(pairCount / ticks) + " pairs on average, " + std::to_string(pairs.size()) + " the last tick";
+        results.push_back(result);
+
+        // Brute force for reference, only on the small runs since it is O(n^2)
+        if (count <= 2500)
+        {
+            BenchTimer timer;
+            size_t brutePairs = 0;
+            for (int i = 0; i < count; i++)
+            {
+                for (int j = i + 1; j < count; j++)
+                {
+                    if (boxes[i].overlaps(boxes[j])) brutePairs++;
+                }
+            }
+            BenchResult brute;
+            brute.name = brutePairs == pairs.size() ? "Brute force pairs" : "PAIR MISMATCH";
+            brute.count = count;
+            brute.milliseconds = timer.elapsedMilliseconds();
+            brute.detail = std::to_string(brutePairs) + " pairs the last tick, hash found " + std::to_string(pairs.size());
+            results.push_back(brute);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,199 @@
+#include "entity/component_store.h"
+#include "utils/job_system.h"
+#include "utils/movement_simd.h"
+
+// Runs fn on every packed array so create / destroy / reserve cant forget one
+template <typename Fn>
+static void forEachArray(TransformComponents &transforms, VelocityComponents &velocities,
+                         ColliderComponents &colliders, SpriteComponents &sprites, Fn fn)
+{
+    fn(transforms.x); fn(transforms.y);
+    fn(transforms.previousX); fn(transforms.previousY);
+    fn(transforms.renderX); fn(transforms.renderY);
+    fn(transforms.width); fn(transforms.height);
+    fn(velocities.x); fn(velocities.y); fn(velocities.maxSpeed);
+    fn(velocities.directionX); fn(velocities.directionY);
+    fn(colliders.offsetX); fn(colliders.offsetY);
+    fn(colliders.width); fn(colliders.height);
+    fn(sprites.sprites);
+}
+
+EntityHandle ComponentStore::create(float x, float y)
+{
+    EntityHandle handle = this->handles.allocate();
+    uint32_t index = handle.index;
+    if (index >= this->sparse.size()) this->sparse.resize(index + 1, 0);
+
+    uint32_t slot = (uint32_t)this->slotToIndex.size();
+    this->sparse[index] = slot;
+    this->slotToIndex.push_back(index);
+
+    this->transforms.x.push_back(x);
+    this->transforms.y.push_back(y);
+    this->transforms.previousX.push_back(x);
+    this->transforms.previousY.push_back(y);
+    this->transforms.renderX.push_back(x);
+    this->transforms.renderY.push_back(y);
+    this->transforms.width.push_back(0.0f);
+    this->transforms.height.push_back(0.0f);
+    this->velocities.x.push_back(0.0f);
+    this->velocities.y.push_back(0.0f);
+    this->velocities.maxSpeed.push_back(0.0f);
+    this->velocities.directionX.push_back(0.0f);
+    this->velocities.directionY.push_back(0.0f);
+    this->colliders.offsetX.push_back(0.0f);
+    this->colliders.offsetY.push_back(0.0f);
+    this->colliders.width.push_back(0.0f);
+    this->colliders.height.push_back(0.0f);
+    this->sprites.sprites.push_back(nullptr);
+
+    return handle;
+}
+
+bool ComponentStore::destroy(EntityHandle handle)
+{
+    if (!this->isAlive(handle)) return false;
+
+    this->removeSlot(this->sparse[handle.index]);
+    // Anything still holding the old handle is now pointing at a dead generation
+    this->handles.release(handle);
+    return true;
+}
+
+/**
+    Moves the last entity into slot and shrinks everything by one, so the arrays
+    stay packed
+**/
+void ComponentStore::removeSlot(uint32_t slot)
+{
+    uint32_t last = (uint32_t)this->slotToIndex.size() - 1;
+    if (slot != last)
+    {
+        forEachArray(this->transforms, this->velocities, this->colliders, this->sprites,
+                     [slot, last](auto &array) { array[slot] = array[last]; });
+        uint32_t movedIndex = this->slotToIndex[last];
+        this->slotToIndex[slot] = movedIndex;
+        this->sparse[movedIndex] = slot;
+    }
+    this->slotToIndex.pop_back();
+    forEachArray(this->transforms, this->velocities, this->colliders, this->sprites,
+                 [](auto &array) { array.pop_back(); });
+}
+
+void ComponentStore::clear()
+{
+    // Every live handle goes stale, indices stay around to be reused
+    this->handles.clear();
+    this->slotToIndex.clear();
+    forEachArray(this->transforms, this->velocities, this->colliders, this->sprites,
+                 [](auto &array) { array.clear(); });
+}
+
+void ComponentStore::reserve(int count)
+{
+    this->slotToIndex.reserve(count);
+    this->sparse.reserve(count);
+    this->handles.reserve(count);
+    forEachArray(this->transforms, this->velocities, this->colliders, this->sprites,
+                 [count](auto &array) { array.reserve(count); });
+}
+
+EntityHandle ComponentStore::handleAt(int slot) const
+{
+    if (slot < 0 || slot >= this->size()) return EntityHandle();
+    return this->handles.handleAt(this->slotToIndex[slot]);
+}
+
+// ==========================================================================================
+// Systems
+// ==========================================================================================
+
+// Runs fn(begin, end) over all count slots, split across the job system if there is one
+template <typename Fn>
+static void forSlots(JobSystem *jobs, int count, const Fn &fn)
+{
+    if (jobs) jobs->parallelFor(count, jobs->suggestGrain(count), fn);
+    else fn(0, count);
+}
+
+void ComponentStore::storePreviousPositions(JobSystem *jobs)
+{
+    const float *x = this->transforms.x.data();
+    const float *y = this->transforms.y.data();
+    float *previousX = this->transforms.previousX.data();
+    float *previousY = this->transforms.previousY.data();
+    forSlots(jobs, this->size(), [=](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            previousX[i] = x[i];
+            previousY[i] = y[i];
+        }
+    });
+}
+
+void ComponentStore::integrate(float dt, JobSystem *jobs)
+{
+    float *x = this->transforms.x.data();
+    float *y = this->transforms.y.data();
+    const float *velocityX = this->velocities.x.data();
+    const float *velocityY = this->velocities.y.data();
+    forSlots(jobs, this->size(), [=](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            x[i] += velocityX[i] * dt;
+            y[i] += velocityY[i] * dt;
+        }
+    });
+}
+
+void ComponentStore::integrateMovement(const MovementParams &params, JobSystem *jobs)
+{
+    MovementArrays arrays;
+    arrays.x = this->transforms.x.data();
+    arrays.y = this->transforms.y.data();
+    arrays.velocityX = this->velocities.x.data();
+    arrays.velocityY = this->velocities.y.data();
+    arrays.directionX = this->velocities.directionX.data();
+    arrays.directionY = this->velocities.directionY.data();
+    arrays.maxSpeed = this->velocities.maxSpeed.data();
+    forSlots(jobs, this->size(), [&params, arrays](int begin, int end) {
+        MovementKernels::integrate(params, arrays, begin, end);
+    });
+}
+
+void ComponentStore::interpolate(float alpha, JobSystem *jobs)
+{
+    const float *x = this->transforms.x.data();
+    const float *y = this->transforms.y.data();
+    const float *previousX = this->transforms.previousX.data();
+    const float *previousY = this->transforms.previousY.data();
+    float *renderX = this->transforms.renderX.data();
+    float *renderY = this->transforms.renderY.data();
+    forSlots(jobs, this->size(), [=](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            renderX[i] = previousX[i] + (x[i] - previousX[i]) * alpha;
+            renderY[i] = previousY[i] + (y[i] - previousY[i]) * alpha;
+        }
+    });
+}
+
+void ComponentStore::gatherColliderBounds(std::vector<AABB> &bounds, JobSystem *jobs) const
+{
+    bounds.resize(this->size());
+    const float *x = this->transforms.x.data();
+    const float *y = this->transforms.y.data();
+    const float *offsetX = this->colliders.offsetX.data();
+    const float *offsetY = this->colliders.offsetY.data();
+    const float *width = this->colliders.width.data();
+    const float *height = this->colliders.height.data();
+    AABB *out = bounds.data();
+    forSlots(jobs, this->size(), [=](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            float minX = x[i] + offsetX[i];
+            float minY = y[i] + offsetY[i];
+            out[i] = AABB{minX, minY, minX + width[i], minY + height[i]};
+        }
+    });
+}
@@ -1,28 +1,58 @@
 #include "entity/player.h"
+#include "entity/entity_pools.h"
+#include "utils/movement_simd.h"
+#include "utils/fixed_collision.h"
+#include "utils/fixed_timestep.h"
 #include "Vec2.h"
 #include "TSDL.h"
 #include "comfy_lib.h"
+#include <limits>
 
-Player::Player() :
+/**
+    A move that hits a wall gets the rest of it slid along the wall, with slopes the
+    slide can run into a second wall before we end up stuck in a corner
+**/
+#define MAX_SLIDE_ITERATIONS 3
+
+Player::Player(ComponentStore *store, EntityPools *pools) :
+Entity(store),
+pools(pools),
 // Setting Player Collision Here
-collision(new Collision(this)),
-camera(new Camera(this)),
-sprite(new Sprites(this))
+collisionHandle(pools->collisions.create(this)),
+cameraHandle(pools->cameras.create(this)),
+spritesHandle(pools->sprites.create(this))
 {
+    // Pool blocks never move, these stay good until we give the handles back
+    this->collision = pools->collisions.get(this->collisionHandle);
+    this->camera = pools->cameras.get(this->cameraHandle);
+    this->setSprite(pools->sprites.get(this->spritesHandle));
+    this->stepSeconds = 0.0f;
+    this->predictRender = true;
+    this->networked = false;
+#if defined(COMFY_DETERMINISTIC)
+    // NaN never matches, so the first tick picks the position up from the store
+    this->syncedX = this->syncedY = std::numeric_limits<float>::quiet_NaN();
+#endif
     // We wanna load from a file
     this->loadPlayer();
     // Give a pointer to the debug gui to display its values
     DebugGUI::SetPlayer(this);
     // lol be tiny at first
-    this->width = 0;
-    this->height = 0;
+    this->setSize(0, 0);
+}
+
+Player::~Player()
+{
+    this->setSprite(nullptr);
+    this->pools->collisions.destroy(this->collisionHandle);
+    this->pools->cameras.destroy(this->cameraHandle);
+    this->pools->sprites.destroy(this->spritesHandle);
 }
 
 // Getters
-float Player::getX() { return position.x; }
-float Player::getY() { return position.y; }
-float Player::getWidth() { return width; }
-float Player::getHeight() { return height; }
+bool Player::getPredictRender() { return predictRender; }
+bool Player::getNetworked() { return networked; }
+const ClientPrediction &Player::getPrediction() { return prediction; }
 int Player::getHealth() { return health; }
 int Player::getDamage() { return damage; }
 int Player::getLevel() { return level; }
@@ -30,20 +60,14 @@ int Player::getExperience() { return experience; }
 int Player::getMaxHealth() { return maxHealth; }
 SDL_Renderer* Player::getRenderer() { return renderer; }
 float Player::getAcceleration() { return acceleration; }
-float Player::getMaxSpeed() { return maxSpeed; }
 float Player::getFriction() { return friction; }
-float Player::getVelocityX() { return velocity.x; }
-float Player::getVelocityY() { return velocity.y; }
 Collision *Player::getCollision() { return collision; }
 TSDL_TileMap *Player::getTileMap() { return tileMap; }
 Player::PlayerState Player::getState() { return this->state; }
 float Player::getPlayerScale() { return playerScale; }
 Camera *Player::getCamera() { return camera; }
-Sprites *Player::getSprite() { return sprite; }
 
 // Setters
-void Player::setX(float value) { position.x = value; }
-void Player::setY(float value) { position.y = value; }
 void Player::setHealth(int value) { health = value; }
 void Player::setDamage(int value) { damage = value; }
 void Player::setLevel(int value) { level = value; }
@@ -51,24 +75,76 @@ void Player::setExperience(int value) { experience = value; }
 void Player::setMaxHealth(int value) { maxHealth = value; }
 void Player::setRenderer(SDL_Renderer* newRenderer) { renderer = newRenderer; }
 void Player::setAcceleration(float value) { acceleration = value; }
-void Player::setMaxSpeed(float value) { maxSpeed = value; }
 void Player::setFriction(float value) { friction = value; }
-void Player::setVelocityX(float value) { velocity.x = value; }
-void Player::setVelocityY(float value) { velocity.y = value; }
-void Player::setCollision(Collision *value) { collision = value; }
 void Player::setTileMap(TSDL_TileMap *value) 
 { 
     tileMap = value; 
-    this->width = tileMap->tileWidth;
-    this->height = tileMap->tileHeight;
+    this->setSize(tileMap->tileWidth, tileMap->tileHeight);
 }
 void Player::setState(Player::PlayerState value) { state = value; }
 void Player::setPlayerScale(float value) { playerScale = value; }
-void Player::setCamera(Camera *value) { camera = value; }
-void Player::setSprite(Sprites *value) { sprite = value; }
+void Player::setPredictRender(bool value) { predictRender = value; }
+void Player::setNetworked(bool value)
+{
+    if (value == networked) return;
+    networked = value;
+    prediction.reset();
+}
+
+/**
+    Where to draw the player this frame, runs after ComponentStore::interpolate
+
+    Interpolating between the last two ticks is always up to a tick behind, and the keys
+    we just polled havent been simulated at all if no tick ran this frame. With
+    predictRender on we go the other way and push forward from the last tick by alpha
+    of a tick using the velocity the fresh keys would give, the camera follows this so
+    turning shows up on the very next frame. Its only ever a fraction of a tick of
+    movement and the velocity into walls was already dropped by the slide, so it cant
+    show us noticeably inside a wall.
+**/
+void Player::updateRenderPosition(float alpha)
+{
+    if (!this->predictRender) return;
+
+    TransformComponents &transforms = this->store->getTransforms();
+    VelocityComponents &velocities = this->store->getVelocities();
+    int i = this->slot();
+    Vec2 direction = this->getInputDirection();
+    float velocityX = velocities.x[i] + direction.x * acceleration * stepSeconds;
+    float velocityY = velocities.y[i] + direction.y * acceleration * stepSeconds;
+    transforms.renderX[i] = transforms.x[i] + velocityX * stepSeconds * alpha;
+    transforms.renderY[i] = transforms.y[i] + velocityY * stepSeconds * alpha;
+}
 
+void Player::reconcile(uint32_t acknowledgedSequence, const BodyState &server)
+{
+    if (!this->networked) return;
+    this->prediction.reconcile(this->getBodyMovement(), acknowledgedSequence, server);
+    this->writePredicted();
+}
 
+uint8_t Player::getNetKeys()
+{
+    // W, S, A, D
+    return (keysPressed[0] ? SERVER_KEY_UP : 0) | (keysPressed[1] ? SERVER_KEY_DOWN : 0) |
+           (keysPressed[2] ? SERVER_KEY_LEFT : 0) | (keysPressed[3] ? SERVER_KEY_RIGHT : 0);
+}
 
+/**
+    Same rounding onto Fixed as moveFixed and the server's loadTuning, both read the
+    same ini files so this is the server's movement as long as the Data folders match
+**/
+BodyMovement Player::getBodyMovement()
+{
+    const ColliderComponents &colliders = this->store->getColliders();
+    const VelocityComponents &velocities = this->store->getVelocities();
+    const int slot = this->slot();
+    FixedAABB collider = FixedAABB::fromRect(
+        Fixed::fromFloat(colliders.offsetX[slot]), Fixed::fromFloat(colliders.offsetY[slot]),
+        Fixed::fromFloat(colliders.width[slot]), Fixed::fromFloat(colliders.height[slot]));
+    return BodyMovement::make(Fixed::fromFloat(acceleration), Fixed::fromFloat(friction), Fixed::fromFloat(velocities.maxSpeed[slot]),
+                              collider, this->tileMap ? &this->tileMap->collisionGrid : nullptr);
+}
 
 // Methods
 
@@ -92,17 +168,25 @@ void Player::draw(float dt, float scale)
     }
     SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
     SDL_FRect playerRect = {
-        (position.x - this->camera->getX()) * scale,  // Offset by camera X
-        (position.y - this->camera->getY()) * scale,  // Offset by camera Y
-        this->width * scale,
-        this->height * scale
+        (this->getRenderX() - this->camera->getX()) * scale,  // Offset by camera X
+        (this->getRenderY() - this->camera->getY()) * scale,  // Offset by camera Y
+        this->getWidth() * scale,
+        this->getHeight() * scale
     };
     SDL_RenderFillRectF(renderer, &playerRect);
 
 
-    // Draw The Collision Box (This is a debug feature)
-    // In Production You Wouldnt Want This
-    this->collision->drawPlayerCollision();
+    // Draw The Collision Box and whatever the collision checks recorded since the
+    // last frame (This is a debug feature) In Production You Wouldnt Want This
+    if (this->collision->getShowingCollision())
+    {
+        this->collision->recordPlayerCollision();
+        this->collision->getDebugDraw()->render(renderer, this->camera, scale);
+    }
+    else
+    {
+        this->collision->getDebugDraw()->clear();
+    }
 }
 
 void Player::handleInput(SDL_Event &event, float dt)
@@ -119,91 +203,204 @@ void Player::handleInput(SDL_Event &event, float dt)
     }
 }
 
-void Player::update(float dt)
+// Direction the held keys point in, normalized on diagonals
+Vec2 Player::getInputDirection()
 {
-    // Create a direction vector based on the keys pressed
     Vec2 direction(0.0f, 0.0f);
-    bool isMoving = false;
     // W, S, A, D
-    if (keysPressed[0]) 
-    {
-        direction.y -= 1.0f; // W
-        isMoving = true;
-    }
-    if (keysPressed[1]) 
-    {
-        direction.y += 1.0f; // S
-        isMoving = true;
-    }
-    if (keysPressed[2]) 
-    {
-        direction.x -= 1.0f; // A
-        isMoving = true;
-    }
-    if (keysPressed[3]) 
-    {
-        direction.x += 1.0f; // D
-        isMoving = true;
-    }
+    if (keysPressed[0]) direction.y -= 1.0f;
+    if (keysPressed[1]) direction.y += 1.0f;
+    if (keysPressed[2]) direction.x -= 1.0f;
+    if (keysPressed[3]) direction.x += 1.0f;
 
     // Normalize the direction vector if moving diagonally
     if (direction.x != 0.0f && direction.y != 0.0f) 
     {
         direction = direction.normalize();
     }
+    return direction;
+}
 
-    // Update the velocity based on the direction
-    velocity.x += direction.x * acceleration * dt;
-    velocity.y += direction.y * acceleration * dt;
+#if defined(COMFY_DETERMINISTIC)
+// getInputDirection in Fixed, the diagonal normalize is Fixed too
+FixedVec2 Player::getInputDirectionFixed()
+{
+    const Fixed one = Fixed::fromInt(1);
+    FixedVec2 direction;
+    if (keysPressed[0]) direction.y -= one;
+    if (keysPressed[1]) direction.y += one;
+    if (keysPressed[2]) direction.x -= one;
+    if (keysPressed[3]) direction.x += one;
 
-    // Clamp the velocity to the max speed
-    float currentSpeed = velocity.length();
-    if (currentSpeed > maxSpeed) 
+    if (direction.x.raw != 0 && direction.y.raw != 0)
     {
-        velocity = velocity.normalize() * maxSpeed;
+        direction = direction.normalize();
     }
+    return direction;
+}
 
-    // Apply friction
-    if (direction.x == 0.0f) 
-    {
-        velocity.x *= pow(friction, dt * 60.0f);
-    }
-    
-    if (direction.y == 0.0f) 
+/**
+    The movement half of update in Fixed (COMFY_DETERMINISTIC), same steps through
+    MovementKernels::stepVelocityFixed and FixedCollision::moveAndSlide
+
+    simPosition / simVelocity are the real state, the store only gets float copies of
+    them for rendering, the camera and the broadphase. If the store position isnt what we
+    wrote last tick something teleported us (setPosition, a map load) and we pick it up
+    from there. Tuning values come in as floats from the config and get rounded onto the
+    Fixed grid, that rounding is the same everywhere
+**/
+bool Player::moveFixed()
+{
+    TransformComponents &transforms = this->store->getTransforms();
+    VelocityComponents &velocities = this->store->getVelocities();
+    const ColliderComponents &colliders = this->store->getColliders();
+    const int slot = this->slot();
+
+    if (transforms.x[slot] != this->syncedX || transforms.y[slot] != this->syncedY)
     {
-        velocity.y *= pow(friction, dt * 60.0f);
+        this->simPosition = FixedVec2(Fixed::fromFloat(transforms.x[slot]), Fixed::fromFloat(transforms.y[slot]));
+        this->simVelocity = FixedVec2(Fixed::fromFloat(velocities.x[slot]), Fixed::fromFloat(velocities.y[slot]));
     }
 
-    // Used For Collision
-    Vec2 previousPosition = position;
+    FixedVec2 direction = this->getInputDirectionFixed();
+    velocities.directionX[slot] = direction.x.toFloat();
+    velocities.directionY[slot] = direction.y.toFloat();
 
-    // TODO !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    // TODO This funciton now works perfectly but its not optimized to be the best it can be
-    // TODO so when i dont feel lazy and tired i'll do it then
-    // TODO !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    bool isColliding = false;
+    FixedMovementParams params = FixedMovementParams::make(SIM_TICK_RATE, Fixed::fromFloat(acceleration), Fixed::fromFloat(friction));
+    MovementKernels::stepVelocityFixed(params, direction, Fixed::fromFloat(velocities.maxSpeed[slot]), this->simVelocity);
+
+    FixedAABB collider = FixedAABB::fromRect(
+        Fixed::fromFloat(colliders.offsetX[slot]), Fixed::fromFloat(colliders.offsetY[slot]),
+        Fixed::fromFloat(colliders.width[slot]), Fixed::fromFloat(colliders.height[slot]));
+    bool isColliding = FixedCollision::moveAndSlide(this->tileMap ? &this->tileMap->collisionGrid : nullptr, collider,
+                                                    this->simPosition, this->simVelocity, params.dt, MAX_SLIDE_ITERATIONS);
+
+    transforms.x[slot] = this->syncedX = this->simPosition.x.toFloat();
+    transforms.y[slot] = this->syncedY = this->simPosition.y.toFloat();
+    velocities.x[slot] = this->simVelocity.x.toFloat();
+    velocities.y[slot] = this->simVelocity.y.toFloat();
+    return isColliding;
+}
+#else
+/**
+    The movement half of update, the float sweep against the map layer
+**/
+bool Player::moveFloat(float dt)
+{
+    TransformComponents &transforms = this->store->getTransforms();
+    VelocityComponents &velocities = this->store->getVelocities();
+    const int slot = this->slot();
+
+    // Create a direction vector based on the keys pressed
+    Vec2 direction = this->getInputDirection();
+    velocities.directionX[slot] = direction.x;
+    velocities.directionY[slot] = direction.y;
+
+    // Accelerate, clamp to max speed and apply friction the same way the batched
+    // movement does for everything else (MovementKernels::stepVelocity)
+    Vec2 velocity(velocities.x[slot], velocities.y[slot]);
+    MovementParams params = MovementParams::make(dt, acceleration, friction);
+    MovementKernels::stepVelocity(params, direction.x, direction.y, velocities.maxSpeed[slot], velocity.x, velocity.y);
 
-    // Update the x pos and check if its colliding
-    position.x += velocity.x * dt;
-    if (this->collision->collidesWithMapLayer(this->getTileMap(), this->getPlayerScale()))
+    // ==========================================================================================
+    // Move by sweeping the collision box through the map, if we hit a wall we stop
+    // right on it and slide whatever is left of the move along it
+    // ==========================================================================================
+    bool isColliding = false;
+    Vec2 move = velocity * dt;
+    for (int i = 0; i < MAX_SLIDE_ITERATIONS; i++)
     {
-        // if it does collide then we set the position back to the previous position
-        position.x = previousPosition.x;
-        this->setState(PlayerState::COLLIDING);
+        if (move.x == 0.0f && move.y == 0.0f) break;
+
+        SweepResult sweep = this->collision->sweepMapLayer(this->getTileMap(), move.x, move.y);
+        transforms.x[slot] += move.x * sweep.time;
+        transforms.y[slot] += move.y * sweep.time;
+        if (!sweep.hit) break;
+
         isColliding = true;
-        velocity.x = 0; // Stop the player from moving
+        move = move * (1.0f - sweep.time);
+        // Drop the part of the move (and velocity) that goes into the wall, for slopes
+        // this turns the rest of the move into sliding along them
+        float moveInto = move.x * sweep.normalX + move.y * sweep.normalY;
+        if (moveInto < 0.0f)
+        {
+            move.x -= sweep.normalX * moveInto;
+            move.y -= sweep.normalY * moveInto;
+        }
+        float velocityInto = velocity.x * sweep.normalX + velocity.y * sweep.normalY;
+        if (velocityInto < 0.0f)
+        {
+            velocity.x -= sweep.normalX * velocityInto;
+            velocity.y -= sweep.normalY * velocityInto;
+        }
     }
+    velocities.x[slot] = velocity.x;
+    velocities.y[slot] = velocity.y;
+    return isColliding;
+}
+#endif
 
-    // Update the y pos and check if its colliding
-    position.y += velocity.y * dt;
-    if (this->collision->collidesWithMapLayer(this->getTileMap(), this->getPlayerScale()))
+/**
+    The movement half of update when connected: the keys are the next input, moved with
+    the server's BodyMovement from where prediction has us. Before the first state
+    comes in we dont know where that is and stay put
+**/
+bool Player::movePredicted()
+{
+    VelocityComponents &velocities = this->store->getVelocities();
+    const int slot = this->slot();
+    uint8_t keys = this->getNetKeys();
+    FixedVec2 direction = BodyMovement::directionFromKeys(keys);
+    velocities.directionX[slot] = direction.x.toFloat();
+    velocities.directionY[slot] = direction.y.toFloat();
+
+    bool isColliding = this->prediction.predict(this->getBodyMovement(), this->prediction.getNewestSequence() + 1, keys);
+    this->writePredicted();
+    return isColliding;
+}
+
+void Player::writePredicted()
+{
+    if (!this->prediction.getHasState()) return;
+    TransformComponents &transforms = this->store->getTransforms();
+    VelocityComponents &velocities = this->store->getVelocities();
+    const int slot = this->slot();
+    transforms.x[slot] = this->prediction.getPosition().x.toFloat();
+    transforms.y[slot] = this->prediction.getPosition().y.toFloat();
+    velocities.x[slot] = this->prediction.getVelocity().x.toFloat();
+    velocities.y[slot] = this->prediction.getVelocity().y.toFloat();
+}
+
+/**
+    One fixed simulation tick, dt is always FixedTimestep::getStepSeconds() so the same
+    keys held for the same ticks end up in the same place whatever the frame rate is
+
+    Position and velocity live in the ComponentStore, we work on local copies and write
+    them back (the position after every sweep, the collision box is read from the store).
+    Connected to a server the move is the next predicted input instead (movePredicted)
+**/
+void Player::update(float dt)
+{
+    this->stepSeconds = dt;
+    TransformComponents &transforms = this->store->getTransforms();
+    VelocityComponents &velocities = this->store->getVelocities();
+    const int slot = this->slot();
+
+    bool isMoving = keysPressed[0] || keysPressed[1] || keysPressed[2] || keysPressed[3];
+    bool isColliding;
+    if (this->networked)
     {
-        // if it does collide then we set the position boxack to the previous position
-        position.y = previousPosition.y;
-        this->setState(PlayerState::COLLIDING);
-        isColliding = true;
-        velocity.y = 0; // Stop the player from moving
+        isColliding = this->movePredicted();
+    }
+    else
+    {
+#if defined(COMFY_DETERMINISTIC)
+        isColliding = this->moveFixed();
+#else
+        isColliding = this->moveFloat(dt);
+#endif
     }
+    Vec2 velocity(velocities.x[slot], velocities.y[slot]);
 
     if (this->tileMap)
     {
@@ -219,28 +416,18 @@ void Player::update(float dt)
         float camMaxY = mapHeight - this->camera->getHeight();
 
         // Set the new camera position and clamp it
-        float newCamX = this->position.x - (this->camera->getWidth() / 2);
-        float newCamY = this->position.y - (this->camera->getHeight() / 2);
+        float newCamX = transforms.x[slot] - (this->camera->getWidth() / 2);
+        float newCamY = transforms.y[slot] - (this->camera->getHeight() / 2);
 
         this->camera->setX(std::max(camMinX, std::min(newCamX, camMaxX)));
         this->camera->setY(std::max(camMinY, std::min(newCamY, camMaxY)));
     }
 
-    // Update the collision box
-    if (this->collision->collidesWithMapLayer(this->getTileMap(), playerScale)) 
-    {
-        this->setState(PlayerState::COLLIDING);
-        isColliding = true;
-    }
-    if (
-        (isColliding && isMoving) || 
-        (this->collision->collidesWithMapLayer(this->getTileMap(), playerScale))
-    )
+    if (isColliding && isMoving)
     {
         this->setState(PlayerState::COLLIDING);
     }
-    // If the player is moving
-    else 
+    else
     {
         if (velocity.length() > 1.0f) 
         {
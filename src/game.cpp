@@ -2,9 +2,17 @@
 #include "comfy_lib.h"
 #define WIDTH 800
 #define HEIGHT 600
+// ComfyServer's SERVER_DEFAULT_PORT, for an address without one
+#define GAME_SERVER_PORT 40000
 
 extern "C" void print_hello();
 
+// Seconds on the high resolution counter, what the network runs on
+static double netSeconds()
+{
+    return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
+}
+
 void Game::start_game()
 {
     print_hello();
@@ -16,21 +24,20 @@ void Game::start_game()
     time_t lastTime = -1;
     time_t currentTime = 0;
 
-    // This is used to get delta time
-    Uint32 lastTicks = SDL_GetTicks();
+    // Simulation time comes from the high resolution counter, SDL_GetTicks is only milliseconds
+    this->timestep.reset(SDL_GetPerformanceCounter(), SDL_GetPerformanceFrequency());
+    const float dt = this->timestep.getStepSeconds();
 
     while (this->running)
     {
-        Uint32 nowTicks = SDL_GetTicks();
-        float dt = (nowTicks - lastTicks) * 0.001f;
-
-        SDL_Event e; while(SDL_PollEvent(&e)) this->handleEvent(e, dt);  
-        this->player->update(dt);
-
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); SDL_RenderClear(renderer);
-        SDL_RenderClear(renderer);
-
-        // Hot Reload
+        // ==========================================================================================
+        // Pace first, then input, then simulate, then draw. Waiting for the frame slot at
+        // the start means the input we poll is as fresh as it can be when the frame with
+        // its result gets presented
+        // ==========================================================================================
+        this->framePacer.beginFrame();
+
+        // Hot Reload (before input, loading a map isnt something to make input wait for)
         fileChanged(currentTime);
         if (lastTime != currentTime)
         {
@@ -39,15 +46,41 @@ void Game::start_game()
             this->player->setTileMap(this->map);
             lastTime = currentTime;
         }
+
+        this->pollInput(dt);
+        this->pollNetwork();
+        int steps = this->timestep.advance(SDL_GetPerformanceCounter());
+        for (int i = 0; i < steps; i++)
+        {
+            this->simulate(dt);
+        }
+        this->components.interpolate(this->timestep.getAlpha(), &this->jobs);
+        this->player->updateRenderPosition(this->timestep.getAlpha());
+        this->remoteBodies.update(netSeconds());
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); SDL_RenderClear(renderer);
+        SDL_RenderClear(renderer);
+
         // Draw Here
         this->player->getCamera()->update(this->viewportWidth, this->viewportHeight, this->gameScale);
         this->drawMap();
-        this->player->draw(dt, this->gameScale);
+        this->drawRemoteBodies();
+        this->cullEntities();
+        int playerSlot = this->components.slotOf(this->player->getHandle());
+        if (AABBKernels::isSet(this->visibleEntities.data(), playerSlot))
+        {
+            this->player->draw(dt, this->gameScale);
+        }
+        else
+        {
+            this->player->getCollision()->getDebugDraw()->clear();
+        }
         this->renderGui();
 
         SDL_RenderPresent(this->renderer);
-        lastTicks = nowTicks;
-        SDL_Delay(16);
+        this->inputLatency.markPresented(SDL_GetPerformanceCounter());
+        this->framePacer.endFrame();
+        this->jobs.snapshotStats();
     }
 
     // Cleanup
@@ -80,6 +113,167 @@ void Game::drawMap() {
                     mouseX, mouseY, this->gameScale, this->player->getCamera());
     }
 }
+/**
+    Drains SDL's event queue, right before the simulation reads the key states. Also
+    works out how long the oldest key event was waiting in the queue for InputLatency
+**/
+void Game::pollInput(float dt)
+{
+    Uint32 nowMs = SDL_GetTicks();
+    float oldestEventAgeMs = -1.0f;
+
+    SDL_Event e;
+    while (SDL_PollEvent(&e))
+    {
+        if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP)
+        {
+            float age = (float)(nowMs - e.common.timestamp);
+            if (age > oldestEventAgeMs) oldestEventAgeMs = age;
+        }
+        this->handleEvent(e, dt);
+    }
+    this->inputLatency.markSampled(SDL_GetPerformanceCounter(), oldestEventAgeMs);
+}
+
+/**
+    One fixed tick of everything that moves, dt is always the same so the results only
+    depend on the inputs and not on how long the last frame took
+**/
+void Game::simulate(float dt)
+{
+    this->components.storePreviousPositions(&this->jobs);
+    this->player->update(dt);
+    if (this->player->getNetworked()) this->sendInput();
+    this->updateBroadphase();
+}
+
+bool Game::connect(const std::string &address)
+{
+    NetAddress server;
+    if (!NetAddress::fromString(address, server, GAME_SERVER_PORT))
+    {
+        DebugGUI::addDebugLog("Cant read server address: " + address, ErrorCode::ERROR);
+        return false;
+    }
+    this->hasState = false;
+    this->receivedStates.clear();
+    this->remoteBodies.clear();
+    return this->net.connect(server, netSeconds());
+}
+
+/**
+    States from the server, right before the ticks so the player predicts on top of
+    the freshest correction. Every state we read goes in the ring (the server deltas
+    against them), only the newest one gets reconciled against and handed to the
+    interpolation buffer for everyone else
+**/
+void Game::pollNetwork()
+{
+    if (this->net.getState() == NetClientState::DISCONNECTED) return;
+    this->net.update(netSeconds());
+    this->player->setNetworked(this->net.isConnected());
+
+    for (const NetEvent &event : this->net.getEvents())
+    {
+        const uint8_t *data = this->net.getEventData(event);
+        if (peekMessageType(data, event.size) != MessageType::STATE) continue;
+
+        BitReader reader(data, event.size);
+        if (!this->state.read(reader, this->receivedStates)) continue;
+        this->stateScratch.tick = this->state.tick;
+        this->stateScratch.bodies = this->state.bodies;
+        this->receivedStates.insert(this->stateScratch, event.sequence);
+
+        if (this->hasState && this->state.tick <= this->lastStateTick) continue;
+        this->lastStateTick = this->state.tick;
+        this->hasState = true;
+        this->remoteBodies.addState(this->state, netSeconds(), this->state.yourId);
+        for (const BodyState &body : this->state.bodies)
+        {
+            if (body.id != this->state.yourId || body.generation != this->state.yourGeneration) continue;
+            this->player->reconcile(this->state.lastInputSequence, body);
+            break;
+        }
+    }
+}
+
+// Everyone else on the server, player sized boxes where the interpolation buffer has them
+void Game::drawRemoteBodies()
+{
+    Camera *camera = this->player->getCamera();
+    float width = this->player->getWidth();
+    float height = this->player->getHeight();
+    float viewWidth = this->viewportWidth / this->gameScale;
+    float viewHeight = this->viewportHeight / this->gameScale;
+
+    SDL_SetRenderDrawColor(this->renderer, 255, 140, 0, 255);
+    InterpolatedBody body;
+    for (uint16_t id : this->remoteBodies.getActive())
+    {
+        if (!this->remoteBodies.sample(id, body)) continue;
+        float x = body.x - camera->getX();
+        float y = body.y - camera->getY();
+        if (x + width < 0.0f || y + height < 0.0f || x > viewWidth || y > viewHeight) continue;
+        SDL_FRect rect = {x * this->gameScale, y * this->gameScale, width * this->gameScale, height * this->gameScale};
+        SDL_RenderFillRectF(this->renderer, &rect);
+    }
+}
+
+/**
+    The input the player just predicted, with the ones before it in case those got
+    lost. The view size goes with it when the zoom changed and once a second anyway
+**/
+void Game::sendInput()
+{
+    InputMessage input = this->player->getPrediction().makeInput();
+    uint8_t payload[16];
+    BitWriter writer(payload, sizeof(payload));
+    input.write(writer);
+    writer.flush();
+    this->net.send(writer.getData(), writer.getBytes(), netSeconds());
+
+    ViewMessage view;
+    view.width = (uint16_t)(this->viewportWidth / this->gameScale);
+    view.height = (uint16_t)(this->viewportHeight / this->gameScale);
+    if (view.width == this->sentView.width && view.height == this->sentView.height && input.sequence % SIM_TICK_RATE != 1) return;
+    this->sentView = view;
+    BitWriter viewWriter(payload, sizeof(payload));
+    view.write(viewWriter);
+    viewWriter.flush();
+    this->net.send(viewWriter.getData(), viewWriter.getBytes(), netSeconds());
+}
+
+/**
+    Gathers the collision box of every entity and rebuilds the broadphase, the
+    vectors are members so after the first few ticks this doesnt allocate.
+    entityBounds[i] is the entity in component store slot i
+**/
+void Game::updateBroadphase()
+{
+    this->components.gatherColliderBounds(this->entityBounds, &this->jobs);
+    this->broadphase.rebuild(this->entityBounds);
+    this->broadphase.findPairs(this->entityPairs);
+}
+
+/**
+    Tests every entity box against what the camera can see in one batch,
+    anything not on screen doesnt get drawn
+**/
+void Game::cullEntities()
+{
+    Camera *camera = this->player->getCamera();
+    AABB view = AABB::fromRect(
+        camera->getX(),
+        camera->getY(),
+        this->viewportWidth / this->gameScale,
+        this->viewportHeight / this->gameScale
+    );
+
+    this->entityBoxes.assign(this->entityBounds.data(), (int)this->entityBounds.size());
+    this->visibleEntities.resize(std::max(1, this->entityBoxes.getMaskWords()));
+    AABBKernels::overlapMask(this->entityBoxes, view, this->visibleEntities.data());
+}
+
 void Game::loadMap()
 {
     
@@ -115,6 +309,7 @@ void Game::loadMap()
                   DebugGUI::guiValues.layerInfo.end(), true);
         return;
     }
+    this->broadphase.setCellSize(this->map->tileWidth, this->map->tileHeight);
     DebugGUI::SetMapName(path);
     DebugGUI::guiValues.layerInfo.resize(TSDL::getLayersSize(*this->map));
     std::fill(DebugGUI::guiValues.layerInfo.begin(), DebugGUI::guiValues.layerInfo.end(), true);
@@ -143,6 +338,9 @@ void Game::handleEvent(SDL_Event e, float dt)
 
 Game::Game()
 {
+    // Map loading (and anything else shared with the server) logs into the debug gui
+    LogSink::set([](const std::string &log, ErrorCode code) { DebugGUI::addDebugLog(log, code); });
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
     {
         std::cout << "Failed to Initialize SDL2 Library" << std::endl;
@@ -169,11 +367,19 @@ Game::Game()
     this->initGui();
 
     this->gameScale = 2.0f;
-    this->player = new Player();
+    this->playerHandle = this->players.create(&this->components, &this->pools);
+    this->player = this->players.get(this->playerHandle);
     player->setRenderer(this->renderer);
 
     DebugGUI::setMapScale(&this->gameScale);
-
+    DebugGUI::guiValues.timestep = &this->timestep;
+    DebugGUI::guiValues.framePacer = &this->framePacer;
+    DebugGUI::guiValues.inputLatency = &this->inputLatency;
+    DebugGUI::guiValues.jobSystem = &this->jobs;
+    DebugGUI::guiValues.remoteBodies = &this->remoteBodies;
+
+    this->hasState = false;
+    this->lastStateTick = 0;
     this->running = false;
 }
 
@@ -248,10 +454,13 @@ void Game::initRenderer()
     SDL_GetRendererInfo(this->renderer, &info);
     DebugGUI::guiValues.rendererName = info.name;
 
-    int vsync = SDL_GetHintBoolean(SDL_HINT_RENDER_VSYNC, SDL_FALSE);
+    // Either asked for through the hint or the renderer picked it, present blocks either way
+    bool vsync = SDL_GetHintBoolean(SDL_HINT_RENDER_VSYNC, SDL_FALSE) ||
+        (info.flags & SDL_RENDERER_PRESENTVSYNC);
     DebugGUI::guiValues.vsync = vsync;
     SDL_DisplayMode mode;
     SDL_GetCurrentDisplayMode(0, &mode);
+    this->framePacer.setVsync(vsync, mode.refresh_rate);
 
     DebugGUI::guiValues.monitorWidth = mode.w;
     DebugGUI::guiValues.monitorHeight = mode.h;
@@ -129,6 +129,13 @@ void DebugGUI::Render(SDL_Renderer* renderer)
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(5, 5)); // Adjust spacing
     ImGui::Columns(2);
     ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+    if (guiValues.framePacer)
+    {
+        // Variance of the last couple seconds of frame times, high means stutter even if the FPS looks fine
+        ImGui::Text("Frame: %.2f ms  Var: %.3f ms^2",
+                    guiValues.framePacer->getMeanFrameMs(),
+                    guiValues.framePacer->getFrameVariance());
+    }
     ImGui::NextColumn();
 
     // =====================================================================================================================
@@ -224,6 +231,15 @@ void DebugGUI::Render(SDL_Renderer* renderer)
             ImGui::EndTabItem();
         }
 
+        // =====================================================================================================================
+        // Perf Tab
+        // =====================================================================================================================
+        if(ImGui::BeginTabItem("Perf"))
+        {
+            renderPerfInfo();
+            ImGui::EndTabItem();
+        }
+
         ImGui::EndTabBar();
     }
     ImGui::End();
@@ -0,0 +1,252 @@
+#include "debug_gui.h"
+#include "bench/benchmarks.h"
+
+static void renderBenchResults(const std::vector<BenchResult> &results)
+{
+    ImGui::Columns(4, "BenchResults");
+    ImGui::Text("Benchmark"); ImGui::NextColumn();
+    ImGui::Text("Count"); ImGui::NextColumn();
+    ImGui::Text("ms / run"); ImGui::NextColumn();
+    ImGui::Text("Detail"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (auto &result : results)
+    {
+        ImGui::Text("%s", result.name.c_str()); ImGui::NextColumn();
+        ImGui::Text("%d", result.count); ImGui::NextColumn();
+        ImGui::Text("%.4f", result.milliseconds); ImGui::NextColumn();
+        ImGui::Text("%s", result.detail.c_str()); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+void DebugGUI::renderPerfInfo()
+{
+    // =====================================================================================================================
+    // Simulation Ticks
+    // =====================================================================================================================
+    if (guiValues.timestep)
+    {
+        const FixedTimestep *timestep = guiValues.timestep;
+        ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "Simulation");
+        ImGui::Separator();
+        ImGui::Text("Tick: %.2f ms (%llu ticks)", timestep->getStepSeconds() * 1000.0f,
+                    (unsigned long long)timestep->getTotalSteps());
+        ImGui::Text("Ticks This Frame: %d", timestep->getLastFrameSteps());
+        ImGui::Text("Interpolation: %.2f", timestep->getAlpha());
+        ImGui::Text("Dropped Catch Up: %.3f s", timestep->getDroppedSeconds());
+        ImGui::Spacing();
+    }
+
+    // =====================================================================================================================
+    // Frame Pacing
+    // =====================================================================================================================
+    if (guiValues.framePacer)
+    {
+        FramePacer *pacer = guiValues.framePacer;
+        ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "Frame Pacing");
+        ImGui::Separator();
+
+        int target = pacer->getTargetFps();
+        const int targets[] = {30, 60, 144, FRAME_PACER_UNCAPPED};
+        const char *labels[] = {"30", "60", "144", "Uncapped"};
+        for (int i = 0; i < 4; i++)
+        {
+            if (i > 0) ImGui::SameLine();
+            if (ImGui::RadioButton(labels[i], &target, targets[i]))
+            {
+                pacer->setTargetFps(target);
+            }
+        }
+
+        if (pacer->getVsync())
+        {
+            ImGui::Text("Vsync: %d Hz%s", pacer->getRefreshRate(),
+                        pacer->isPacing() ? "" : " (vsync is pacing)");
+        }
+        ImGui::Text("Frame: %.2f ms (work %.2f ms, wait %.2f ms)",
+                    pacer->getLastFrameMs(), pacer->getLastWorkMs(), pacer->getLastWaitMs());
+        ImGui::Text("Mean: %.2f ms  Variance: %.3f ms^2", pacer->getMeanFrameMs(), pacer->getFrameVariance());
+        ImGui::Spacing();
+    }
+
+    // =====================================================================================================================
+    // Input Latency
+    // =====================================================================================================================
+    if (guiValues.inputLatency)
+    {
+        const InputLatency *latency = guiValues.inputLatency;
+        ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "Input Latency");
+        ImGui::Separator();
+
+        if (guiValues.player)
+        {
+            bool predict = guiValues.player->getPredictRender();
+            if (ImGui::Checkbox("Predict Camera From Input", &predict))
+            {
+                guiValues.player->setPredictRender(predict);
+            }
+        }
+        ImGui::Text("Sample -> Present: %.2f ms (mean %.2f ms)",
+                    latency->getLastSampleToPresentMs(), latency->getMeanSampleToPresentMs());
+        ImGui::Text("Input -> Present: %.2f ms (mean %.2f ms, worst %.2f ms)",
+                    latency->getLastInputToPresentMs(), latency->getMeanInputToPresentMs(),
+                    latency->getMaxInputToPresentMs());
+        ImGui::PlotLines("##SampleToPresent", latency->getSampleToPresentHistory(), INPUT_LATENCY_HISTORY,
+                         latency->getHistoryOffset(), "sample -> present (ms)", 0.0f, 34.0f, ImVec2(0, 50));
+        ImGui::Spacing();
+    }
+
+    // =====================================================================================================================
+    // Prediction (only while connected to a server)
+    // =====================================================================================================================
+    if (guiValues.player && guiValues.player->getNetworked())
+    {
+        const ClientPrediction &prediction = guiValues.player->getPrediction();
+        ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "Prediction");
+        ImGui::Separator();
+        float perMinute = prediction.getStatesChecked() > 0
+            ? (float)prediction.getCorrections() / prediction.getStatesChecked() * SIM_TICK_RATE * 60.0f : 0.0f;
+        ImGui::Text("Inputs waiting on the server: %u", prediction.getPendingCount());
+        ImGui::Text("Corrections: %llu of %llu states (%.1f a minute)", (unsigned long long)prediction.getCorrections(),
+                    (unsigned long long)prediction.getStatesChecked(), perMinute);
+        ImGui::Text("Correction size: last %.2f px, avg %.2f px, max %.2f px", prediction.getLastCorrection(),
+                    prediction.getAverageCorrection(), prediction.getMaxCorrection());
+        ImGui::Text("Inputs replayed: %llu", (unsigned long long)prediction.getInputsReplayed());
+        ImGui::Spacing();
+    }
+
+    // =====================================================================================================================
+    // Remote bodies (only while connected to a server)
+    // =====================================================================================================================
+    if (guiValues.remoteBodies && guiValues.remoteBodies->getClock().getHasBaseline())
+    {
+        const InterpolationBuffer *remote = guiValues.remoteBodies;
+        const InterpolationClock &clock = remote->getClock();
+        ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "Interpolation");
+        ImGui::Separator();
+        ImGui::Text("Bodies: %d (%d extrapolating)", (int)remote->getActive().size(), remote->getExtrapolatingCount());
+        ImGui::Text("Delay: %.1f ms (target %.1f ms), jitter %.1f ms", clock.getDelayTicks() * 1000.0 / SIM_TICK_RATE,
+                    clock.getTargetDelayTicks() * 1000.0 / SIM_TICK_RATE, clock.getJitterMilliseconds());
+        double extrapolated = remote->getSamplesDrawn() > 0 ? 100.0 * remote->getSamplesExtrapolated() / remote->getSamplesDrawn() : 0.0;
+        ImGui::Text("Extrapolated: %.2f%% of samples", extrapolated);
+        ImGui::Spacing();
+    }
+
+    // =====================================================================================================================
+    // Job System
+    // =====================================================================================================================
+    if (guiValues.jobSystem)
+    {
+        const JobSystem *jobs = guiValues.jobSystem;
+        ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "Jobs");
+        ImGui::Separator();
+
+        const auto &stats = jobs->getStats();
+        for (size_t i = 0; i < stats.size(); i++)
+        {
+            ImGui::Text("%s %zu: %4llu jobs %3llu steals %.2f ms", i == 0 ? "Main  " : "Worker", i,
+                        (unsigned long long)stats[i].jobs, (unsigned long long)stats[i].steals,
+                        stats[i].busyMilliseconds);
+            ImGui::SameLine();
+            ImGui::ProgressBar((float)stats[i].utilisation, ImVec2(-1, 0));
+        }
+        ImGui::Spacing();
+    }
+
+    // =====================================================================================================================
+    // Benchmarks <- These block the frame while they run
+    // =====================================================================================================================
+    ImGui::TextColored(ImVec4(0.5f, 0.8f, 1.0f, 1.0f), "Benchmarks");
+    ImGui::Separator();
+
+    if (ImGui::Button("Spatial Hash"))
+    {
+        guiValues.benchResults = Benchmarks::spatialHash();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("AABB Tree"))
+    {
+        guiValues.benchResults = Benchmarks::aabbTree();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("AABB Kernels"))
+    {
+        guiValues.benchResults = Benchmarks::aabbKernels();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Raycasts"))
+    {
+        guiValues.benchResults = Benchmarks::gridRaycast();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Flow Field"))
+    {
+        guiValues.benchResults = Benchmarks::flowField();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Pathfinding"))
+    {
+        guiValues.benchResults = Benchmarks::pathfinding();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("HPA*"))
+    {
+        guiValues.benchResults = Benchmarks::hierarchicalPathfinding();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Entities"))
+    {
+        guiValues.benchResults = Benchmarks::componentStore();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Jobs"))
+    {
+        guiValues.benchResults = Benchmarks::jobSystem();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Pools"))
+    {
+        guiValues.benchResults = Benchmarks::pools();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Movement"))
+    {
+        guiValues.benchResults = Benchmarks::movement();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Determinism"))
+    {
+        guiValues.benchResults = Benchmarks::determinism();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Serialize"))
+    {
+        guiValues.benchResults = Benchmarks::serialization();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Snapshots"))
+    {
+        guiValues.benchResults = Benchmarks::snapshots();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Interpolate"))
+    {
+        guiValues.benchResults = Benchmarks::interpolation();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Interest"))
+    {
+        guiValues.benchResults = Benchmarks::interest();
+    }
+
+    ImGui::Separator();
+    // =====================================================================================================================
+    // Results
+    // =====================================================================================================================
+    if (guiValues.benchResults.empty())
+    {
+        ImGui::Text("No Results Yet");
+        return;
+    }
+    renderBenchResults(guiValues.benchResults);
+}
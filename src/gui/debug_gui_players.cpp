@@ -121,7 +121,7 @@ void DebugGUI::renderPlayerInfo(SDL_Renderer* renderer)
             Collision *collision = guiValues.player->getCollision();
 
             bool showCollision = collision->getShowingCollision();
-            SDL_Color collisionColor = collision->getCollisionColor();
+            DebugDrawColor collisionColor = collision->getCollisionColor();
             float collisionWidth = collision->getWidth();
             float collisionHeight = collision->getHeight();
 
@@ -1,8 +1,13 @@
 #include <iostream>
 #include "game.h"
 
-int main()
+int main(int argc, char **argv)
 {
     Game game = Game();
+    // --connect host:port plays on a ComfyServer, without it its single player
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--connect") game.connect(argv[++i]);
+    }
     game.start_game();
 }
@@ -0,0 +1,132 @@
+#include "net/bit_stream.h"
+#include <cmath>
+
+Fixed quantizeFixed(Fixed value, int32_t min, int32_t max, int fractionBits)
+{
+    uint32_t limit = (uint32_t)((int64_t)(max - min) << fractionBits);
+    return stepsToFixed(fixedToSteps(value, min, fractionBits, limit), min, fractionBits);
+}
+
+// ==========================================================================================
+// Writer
+// ==========================================================================================
+void BitWriter::flushWord()
+{
+    uint32_t word = (uint32_t)this->scratch;
+    this->data[this->bytesFlushed + 0] = (uint8_t)word;
+    this->data[this->bytesFlushed + 1] = (uint8_t)(word >> 8);
+    this->data[this->bytesFlushed + 2] = (uint8_t)(word >> 16);
+    this->data[this->bytesFlushed + 3] = (uint8_t)(word >> 24);
+    this->bytesFlushed += 4;
+    this->scratch >>= 32;
+    this->scratchBits -= 32;
+}
+
+void BitWriter::writeRangedInt(int32_t value, int32_t min, int32_t max)
+{
+    uint32_t limit = (uint32_t)((int64_t)max - min);
+    this->writeBits(clampSteps((int64_t)value - min, limit), bitsRequired(limit));
+}
+
+void BitWriter::writeVarint(uint32_t value)
+{
+    do
+    {
+        uint32_t group = value & 0x7F;
+        value >>= 7;
+        this->writeBits(group | (value ? 0x80 : 0), 8);
+    } while (value);
+}
+
+void BitWriter::writeSignedVarint(int32_t value)
+{
+    this->writeVarint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+void BitWriter::writeFixed(Fixed value, int32_t min, int32_t max, int fractionBits)
+{
+    uint32_t limit = (uint32_t)((int64_t)(max - min) << fractionBits);
+    this->writeBits(fixedToSteps(value, min, fractionBits, limit), bitsRequired(limit));
+}
+
+void BitWriter::writeQuantizedFloat(float value, float min, float max, int stepsPerUnit)
+{
+    uint32_t limit = (uint32_t)std::lround((double)(max - min) * stepsPerUnit);
+    this->writeBits(floatToSteps(value, min, stepsPerUnit, limit), bitsRequired(limit));
+}
+
+void BitWriter::flush()
+{
+    while (this->scratchBits > 0)
+    {
+        this->data[this->bytesFlushed++] = (uint8_t)this->scratch;
+        this->scratch >>= 8;
+        this->scratchBits -= 8;
+    }
+    this->scratch = 0;
+    this->scratchBits = 0;
+}
+
+// ==========================================================================================
+// Reader
+// ==========================================================================================
+// Enough bytes into the scratch for bits more, a word at a time until the last few bytes
+void BitReader::refill(int bits)
+{
+    while (this->scratchBits < bits)
+    {
+        if (this->bytesRead + 4 <= this->size)
+        {
+            const uint8_t *bytes = this->data + this->bytesRead;
+            uint32_t word = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+            this->scratch |= (uint64_t)word << this->scratchBits;
+            this->scratchBits += 32;
+            this->bytesRead += 4;
+        }
+        else
+        {
+            this->scratch |= (uint64_t)this->data[this->bytesRead++] << this->scratchBits;
+            this->scratchBits += 8;
+        }
+    }
+}
+
+int32_t BitReader::readRangedInt(int32_t min, int32_t max)
+{
+    uint32_t offset = this->readBits(bitsRequired((uint32_t)((int64_t)max - min)));
+    int64_t value = (int64_t)min + offset;
+    // Only a corrupt packet gets past max
+    return value > max ? max : (int32_t)value;
+}
+
+uint32_t BitReader::readVarint()
+{
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        uint32_t group = this->readBits(8);
+        value |= (group & 0x7F) << shift;
+        if (!(group & 0x80)) return value;
+    }
+    // More than 5 groups, not something we wrote
+    this->overflow = true;
+    return 0;
+}
+
+int32_t BitReader::readSignedVarint()
+{
+    uint32_t value = this->readVarint();
+    return (int32_t)((value >> 1) ^ (0u - (value & 1)));
+}
+
+Fixed BitReader::readFixed(int32_t min, int32_t max, int fractionBits)
+{
+    uint32_t limit = (uint32_t)((int64_t)(max - min) << fractionBits);
+    return stepsToFixed(clampSteps(this->readBits(bitsRequired(limit)), limit), min, fractionBits);
+}
+
+float BitReader::readQuantizedFloat(float min, float max, int stepsPerUnit)
+{
+    uint32_t limit = (uint32_t)std::lround((double)(max - min) * stepsPerUnit);
+    return min + (float)clampSteps(this->readBits(bitsRequired(limit)), limit) * (1.0f / stepsPerUnit);
+}
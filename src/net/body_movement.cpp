@@ -0,0 +1,47 @@
+#include "net/body_movement.h"
+#include "utils/fixed_collision.h"
+#include "utils/fixed_timestep.h"
+
+BodyMovement BodyMovement::make(Fixed acceleration, Fixed friction, Fixed maxSpeed, const FixedAABB &collider,
+                                const CollisionGrid *grid)
+{
+    BodyMovement movement;
+    movement.params = FixedMovementParams::make(SIM_TICK_RATE, acceleration, friction);
+    movement.maxSpeed = maxSpeed;
+    movement.collider = collider;
+    movement.grid = grid;
+    return movement;
+}
+
+bool BodyMovement::step(uint8_t keys, FixedVec2 &position, FixedVec2 &velocity) const
+{
+    FixedVec2 direction = directionFromKeys(keys);
+    MovementKernels::stepVelocityFixed(this->params, direction, this->maxSpeed, velocity);
+    bool hit = FixedCollision::moveAndSlide(this->grid, this->collider, position, velocity, this->params.dt, BODY_SLIDE_ITERATIONS);
+    snapToWire(position, velocity);
+    return hit;
+}
+
+FixedVec2 BodyMovement::directionFromKeys(uint8_t keys)
+{
+    const Fixed one = Fixed::fromInt(1);
+    FixedVec2 direction;
+    if (keys & SERVER_KEY_UP) direction.y -= one;
+    if (keys & SERVER_KEY_DOWN) direction.y += one;
+    if (keys & SERVER_KEY_LEFT) direction.x -= one;
+    if (keys & SERVER_KEY_RIGHT) direction.x += one;
+
+    if (direction.x.raw != 0 && direction.y.raw != 0)
+    {
+        direction = direction.normalize();
+    }
+    return direction;
+}
+
+void BodyMovement::snapToWire(FixedVec2 &position, FixedVec2 &velocity)
+{
+    const int32_t step = BodyVelocityCodec::Axis::stepRaw;
+    position = BodyPositionCodec::quantize(position);
+    velocity = BodyVelocityCodec::quantize(FixedVec2(Fixed::fromRaw(velocity.x.raw / step * step),
+                                                     Fixed::fromRaw(velocity.y.raw / step * step)));
+}
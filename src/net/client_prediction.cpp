@@ -0,0 +1,101 @@
+#include "net/client_prediction.h"
+#include <algorithm>
+#include <cmath>
+
+void ClientPrediction::reset()
+{
+    *this = ClientPrediction();
+}
+
+bool ClientPrediction::predict(const BodyMovement &movement, uint32_t sequence, uint8_t keys)
+{
+    PredictedInput &input = this->inputs[sequence % PREDICTION_HISTORY];
+    input.sequence = sequence;
+    input.keys = keys;
+    this->newestSequence = sequence;
+
+    bool hit = false;
+    if (this->hasState) hit = movement.step(keys, this->position, this->velocity);
+    input.position = this->position;
+    input.velocity = this->velocity;
+    return hit;
+}
+
+/**
+    Every input from firstSequence to the newest again on top of position / velocity,
+    each one's prediction gets updated so the next state compares against the new ones
+**/
+void ClientPrediction::replayFrom(const BodyMovement &movement, uint32_t firstSequence)
+{
+    uint32_t oldest = this->newestSequence >= PREDICTION_HISTORY ? this->newestSequence - PREDICTION_HISTORY + 1 : 1;
+    for (uint32_t sequence = std::max(firstSequence, oldest); sequence <= this->newestSequence; sequence++)
+    {
+        PredictedInput &input = this->inputs[sequence % PREDICTION_HISTORY];
+        if (input.sequence != sequence) continue;
+        movement.step(input.keys, this->position, this->velocity);
+        input.position = this->position;
+        input.velocity = this->velocity;
+        this->inputsReplayed++;
+    }
+}
+
+bool ClientPrediction::reconcile(const BodyMovement &movement, uint32_t acknowledgedSequence, const BodyState &server)
+{
+    // Out of order, a newer state already moved us past this one
+    if (this->hasState && acknowledgedSequence < this->acknowledgedSequence) return false;
+    this->statesChecked++;
+    this->acknowledgedSequence = acknowledgedSequence;
+    // The server has inputs we dont (we reset), carry on numbering after them
+    if (acknowledgedSequence > this->newestSequence) this->newestSequence = acknowledgedSequence;
+
+    // First state, this is where we are. Anything we sent before it gets replayed on top
+    if (!this->hasState)
+    {
+        this->position = server.position;
+        this->velocity = server.velocity;
+        this->hasState = true;
+        this->replayFrom(movement, acknowledgedSequence + 1);
+        return false;
+    }
+
+    const PredictedInput &predicted = this->inputs[acknowledgedSequence % PREDICTION_HISTORY];
+    if (predicted.sequence == acknowledgedSequence && predicted.position == server.position && predicted.velocity == server.velocity)
+    {
+        return false;
+    }
+
+    // Rewind to the server and replay what it hasnt seen yet
+    FixedVec2 before = this->position;
+    this->position = server.position;
+    this->velocity = server.velocity;
+    this->replayFrom(movement, acknowledgedSequence + 1);
+
+    // Nothing applied yet, the server is just holding us where we spawned
+    if (acknowledgedSequence == 0) return false;
+
+    float dx = (this->position.x - before.x).toFloat();
+    float dy = (this->position.y - before.y).toFloat();
+    this->lastCorrection = std::sqrt(dx * dx + dy * dy);
+    if (this->lastCorrection > this->maxCorrection) this->maxCorrection = this->lastCorrection;
+    this->totalCorrection += this->lastCorrection;
+    this->corrections++;
+    return true;
+}
+
+uint8_t ClientPrediction::getKeys(uint32_t sequence) const
+{
+    const PredictedInput &input = this->inputs[sequence % PREDICTION_HISTORY];
+    return sequence > 0 && input.sequence == sequence ? input.keys : 0;
+}
+
+InputMessage ClientPrediction::makeInput() const
+{
+    InputMessage input;
+    input.sequence = this->newestSequence;
+    input.keys = this->getKeys(this->newestSequence);
+    for (uint32_t i = 0; i < INPUT_MESSAGE_REDUNDANCY; i++)
+    {
+        input.previousKeys[i] = this->newestSequence > i + 1 ? this->getKeys(this->newestSequence - i - 1) : 0;
+    }
+    return input;
+}
@@ -0,0 +1,149 @@
+#include "net/interest_grid.h"
+#include <algorithm>
+#include <cmath>
+
+// ==========================================================================================
+// Grid
+// ==========================================================================================
+void InterestGrid::setTileSize(int tileWidth, int tileHeight)
+{
+    this->tileWidth = (float)std::max(1, tileWidth);
+    this->tileHeight = (float)std::max(1, tileHeight);
+}
+
+int InterestGrid::cellX(float x) const
+{
+    return (int)std::floor((x - this->originX) / this->cellWidth);
+}
+
+int InterestGrid::cellY(float y) const
+{
+    return (int)std::floor((y - this->originY) / this->cellHeight);
+}
+
+/**
+    Origin snaps down onto a cell boundary measured from the map's (0, 0) so cells sit
+    on whole tiles wherever the bodies are
+**/
+void InterestGrid::rebuild(const std::vector<BodyState> &bodies)
+{
+    this->entries.resize(bodies.size());
+    this->cellOf.resize(bodies.size());
+    if (bodies.empty())
+    {
+        this->columns = this->rows = 0;
+        this->cellStart.assign(1, 0);
+        return;
+    }
+
+    float minX = bodies[0].position.x.toFloat(), maxX = minX;
+    float minY = bodies[0].position.y.toFloat(), maxY = minY;
+    for (const BodyState &body : bodies)
+    {
+        float x = body.position.x.toFloat(), y = body.position.y.toFloat();
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    this->cellWidth = this->tileWidth * INTEREST_CELL_TILES;
+    this->cellHeight = this->tileHeight * INTEREST_CELL_TILES;
+    for (;;)
+    {
+        this->originX = std::floor(minX / this->cellWidth) * this->cellWidth;
+        this->originY = std::floor(minY / this->cellHeight) * this->cellHeight;
+        this->columns = this->cellX(maxX) + 1;
+        this->rows = this->cellY(maxY) + 1;
+        if (this->columns <= INTEREST_MAX_CELLS_PER_AXIS && this->rows <= INTEREST_MAX_CELLS_PER_AXIS) break;
+        if (this->columns > INTEREST_MAX_CELLS_PER_AXIS) this->cellWidth *= 2.0f;
+        if (this->rows > INTEREST_MAX_CELLS_PER_AXIS) this->cellHeight *= 2.0f;
+    }
+
+    // Count, prefix sum, place
+    const int cells = this->columns * this->rows;
+    this->cellStart.assign(cells + 1, 0);
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        int cell = this->cellY(bodies[i].position.y.toFloat()) * this->columns + this->cellX(bodies[i].position.x.toFloat());
+        this->cellOf[i] = cell;
+        this->cellStart[cell + 1]++;
+    }
+    for (int c = 0; c < cells; c++) this->cellStart[c + 1] += this->cellStart[c];
+    // cellStart doubles as each cell's write cursor
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        int slot = this->cellStart[this->cellOf[i]]++;
+        this->entries[slot] = {bodies[i].id, bodies[i].position.x.toFloat(), bodies[i].position.y.toFloat()};
+    }
+    // The placing pass moved every start on to the next cell's, shift them back
+    for (int c = cells; c > 0; c--) this->cellStart[c] = this->cellStart[c - 1];
+    this->cellStart[0] = 0;
+}
+
+void InterestGrid::query(const InterestRect &rect, std::vector<uint16_t> &ids, std::vector<float> &xs, std::vector<float> &ys) const
+{
+    if (this->columns == 0) return;
+    int fromX = std::max(0, this->cellX(rect.minX));
+    int fromY = std::max(0, this->cellY(rect.minY));
+    int toX = std::min(this->columns - 1, this->cellX(rect.maxX));
+    int toY = std::min(this->rows - 1, this->cellY(rect.maxY));
+
+    for (int y = fromY; y <= toY; y++)
+    {
+        for (int x = fromX; x <= toX; x++)
+        {
+            int cell = y * this->columns + x;
+            for (int i = this->cellStart[cell]; i < this->cellStart[cell + 1]; i++)
+            {
+                const Entry &entry = this->entries[i];
+                if (!rect.contains(entry.x, entry.y)) continue;
+                ids.push_back(entry.id);
+                xs.push_back(entry.x);
+                ys.push_back(entry.y);
+            }
+        }
+    }
+}
+
+// ==========================================================================================
+// One client
+// ==========================================================================================
+void InterestSet::clear()
+{
+    this->visible.clear();
+    this->entered.clear();
+    this->left.clear();
+}
+
+void InterestSet::update(const InterestGrid &grid, const InterestRect &inner, const InterestRect &outer, uint16_t self)
+{
+    this->candidates.clear();
+    this->candidateX.clear();
+    this->candidateY.clear();
+    grid.query(outer, this->candidates, this->candidateX, this->candidateY);
+
+    this->next.clear();
+    for (size_t i = 0; i < this->candidates.size(); i++)
+    {
+        uint16_t id = this->candidates[i];
+        if (inner.contains(this->candidateX[i], this->candidateY[i]) ||
+            std::binary_search(this->visible.begin(), this->visible.end(), id))
+        {
+            this->next.push_back(id);
+        }
+    }
+    std::sort(this->next.begin(), this->next.end());
+    if (self != 0xFFFF)
+    {
+        auto it = std::lower_bound(this->next.begin(), this->next.end(), self);
+        if (it == this->next.end() || *it != self) this->next.insert(it, self);
+    }
+
+    // Both sorted, whats only in next came in and whats only in visible went
+    this->entered.clear();
+    this->left.clear();
+    std::set_difference(this->next.begin(), this->next.end(), this->visible.begin(), this->visible.end(), std::back_inserter(this->entered));
+    std::set_difference(this->visible.begin(), this->visible.end(), this->next.begin(), this->next.end(), std::back_inserter(this->left));
+    this->visible.swap(this->next);
+}
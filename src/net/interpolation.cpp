@@ -0,0 +1,221 @@
+#include "net/interpolation.h"
+#include "utils/fixed_timestep.h"
+#include <algorithm>
+#include <cmath>
+
+// How quickly the jitter average follows new states (RFC 3550 uses the same 1/16)
+#define INTERPOLATION_JITTER_SMOOTHING (1.0 / 16.0)
+// How much of each state's lateness the baseline moves up by
+#define INTERPOLATION_BASELINE_CREEP 0.01
+// Further than this from where we should be (a stall, a hitch) and the render tick jumps there
+#define INTERPOLATION_SNAP_TICKS 8.0
+
+// ==========================================================================================
+// Clock
+// ==========================================================================================
+void InterpolationClock::reset()
+{
+    *this = InterpolationClock();
+}
+
+void InterpolationClock::addState(uint32_t tick, double now)
+{
+    const double offset = now - (double)tick / SIM_TICK_RATE;
+    if (!this->hasBaseline)
+    {
+        // Nothing measured yet, assume a tick of jitter until we know better
+        this->hasBaseline = true;
+        this->baseline = offset;
+        this->jitter = 1.0 / SIM_TICK_RATE;
+        this->delayTicks = this->getTargetDelayTicks();
+        this->renderTick = (double)tick - this->delayTicks;
+        this->lastNow = now;
+        return;
+    }
+
+    double late = offset - this->baseline;
+    if (late < 0.0)
+    {
+        this->baseline = offset;
+        late = 0.0;
+    }
+    else
+    {
+        this->baseline += late * INTERPOLATION_BASELINE_CREEP;
+    }
+    this->jitter += (late - this->jitter) * INTERPOLATION_JITTER_SMOOTHING;
+}
+
+double InterpolationClock::getTargetDelayTicks() const
+{
+    double target = INTERPOLATION_MIN_DELAY_TICKS + INTERPOLATION_JITTER_SCALE * this->jitter * SIM_TICK_RATE;
+    return std::min(INTERPOLATION_MAX_DELAY_TICKS, std::max(INTERPOLATION_MIN_DELAY_TICKS, target));
+}
+
+/**
+    Runs at the wall clock's pace, sped up or slowed down by at most
+    INTERPOLATION_DELAY_SLEW to drift onto where the baseline and target delay say we
+    should be. Never less than 90% of the elapsed time so it only ever goes forwards
+**/
+double InterpolationClock::update(double now)
+{
+    if (!this->hasBaseline) return this->renderTick;
+
+    double elapsed = std::max(0.0, now - this->lastNow) * SIM_TICK_RATE;
+    this->lastNow = now;
+    double serverTick = (now - this->baseline) * SIM_TICK_RATE;
+    double target = serverTick - this->getTargetDelayTicks();
+    double error = target - (this->renderTick + elapsed);
+
+    if (std::fabs(error) > INTERPOLATION_SNAP_TICKS)
+    {
+        this->renderTick = std::max(this->renderTick, target);
+    }
+    else
+    {
+        double limit = elapsed * INTERPOLATION_DELAY_SLEW;
+        this->renderTick += elapsed + std::min(limit, std::max(-limit, error));
+    }
+    this->delayTicks = serverTick - this->renderTick;
+    return this->renderTick;
+}
+
+// ==========================================================================================
+// One entity
+// ==========================================================================================
+void EntityInterpolator::clear()
+{
+    this->newest = -1;
+    this->count = 0;
+    this->cursor = 0;
+}
+
+void EntityInterpolator::push(uint32_t tick, const BodyState &body)
+{
+    if (this->count > 0 && tick <= at(0).tick) return;
+
+    this->newest = (this->newest + 1) % INTERPOLATION_HISTORY;
+    if (this->count < INTERPOLATION_HISTORY) this->count++;
+    // Everything just got a tick older
+    if (this->cursor + 1 < this->count) this->cursor++;
+
+    Sample &sample = this->samples[this->newest];
+    sample.tick = tick;
+    sample.x = body.position.x.toFloat();
+    sample.y = body.position.y.toFloat();
+    sample.velocityX = body.velocity.x.toFloat();
+    sample.velocityY = body.velocity.y.toFloat();
+}
+
+/**
+    Between the two states either side of renderTick, position and velocity lerped.
+    Past the newest one its velocity carries us on for up to
+    INTERPOLATION_MAX_EXTRAPOLATION_TICKS, before the oldest we hold there
+**/
+bool EntityInterpolator::sample(double renderTick, InterpolatedBody &out)
+{
+    if (this->count == 0) return false;
+
+    const Sample &newestSample = at(0);
+    if (renderTick >= (double)newestSample.tick)
+    {
+        double ahead = std::min(renderTick - (double)newestSample.tick, INTERPOLATION_MAX_EXTRAPOLATION_TICKS);
+        float seconds = (float)(ahead / SIM_TICK_RATE);
+        out.x = newestSample.x + newestSample.velocityX * seconds;
+        out.y = newestSample.y + newestSample.velocityY * seconds;
+        out.velocityX = newestSample.velocityX;
+        out.velocityY = newestSample.velocityY;
+        out.extrapolating = true;
+        this->cursor = 0;
+        return true;
+    }
+
+    // The pair is at(cursor + 1) -> at(cursor), the render tick only moves a little a frame
+    while (this->cursor > 0 && (double)at(this->cursor).tick <= renderTick) this->cursor--;
+    while (this->cursor + 1 < this->count && (double)at(this->cursor + 1).tick > renderTick) this->cursor++;
+
+    out.extrapolating = false;
+    if (this->cursor + 1 >= this->count)
+    {
+        const Sample &oldest = at(this->count - 1);
+        out.x = oldest.x;
+        out.y = oldest.y;
+        out.velocityX = oldest.velocityX;
+        out.velocityY = oldest.velocityY;
+        return true;
+    }
+
+    const Sample &from = at(this->cursor + 1);
+    const Sample &to = at(this->cursor);
+    float alpha = (float)((renderTick - (double)from.tick) / (double)(to.tick - from.tick));
+    out.x = from.x + (to.x - from.x) * alpha;
+    out.y = from.y + (to.y - from.y) * alpha;
+    out.velocityX = from.velocityX + (to.velocityX - from.velocityX) * alpha;
+    out.velocityY = from.velocityY + (to.velocityY - from.velocityY) * alpha;
+    return true;
+}
+
+// ==========================================================================================
+// Buffer
+// ==========================================================================================
+void InterpolationBuffer::clear()
+{
+    this->clock.reset();
+    for (uint16_t id : this->active) this->entities[id].clear();
+    this->active.clear();
+    this->newestTick = 0;
+    this->hasState = false;
+    this->extrapolatingCount = 0;
+}
+
+void InterpolationBuffer::addState(const StateMessage &state, double now, uint16_t skipId)
+{
+    // Out of order, everything in it is older than what we have
+    if (this->hasState && state.tick <= this->newestTick) return;
+    this->hasState = true;
+    this->newestTick = state.tick;
+    this->clock.addState(state.tick, now);
+
+    this->scratch.clear();
+    for (const BodyState &body : state.bodies)
+    {
+        if (body.id == skipId) continue;
+        if (body.id >= this->entities.size())
+        {
+            this->entities.resize(body.id + 1);
+            this->generations.resize(body.id + 1, 0);
+        }
+        EntityInterpolator &entity = this->entities[body.id];
+        if (this->generations[body.id] != body.generation) entity.clear();
+        this->generations[body.id] = body.generation;
+        entity.push(state.tick, body);
+        this->scratch.push_back(body.id);
+    }
+
+    // Both sorted, whatever was active and isnt any more is gone
+    size_t next = 0;
+    for (uint16_t id : this->active)
+    {
+        while (next < this->scratch.size() && this->scratch[next] < id) next++;
+        if (next == this->scratch.size() || this->scratch[next] != id) this->entities[id].clear();
+    }
+    this->active.swap(this->scratch);
+}
+
+void InterpolationBuffer::update(double now)
+{
+    this->clock.update(now);
+    this->extrapolatingCount = 0;
+}
+
+bool InterpolationBuffer::sample(uint16_t id, InterpolatedBody &out)
+{
+    if (id >= this->entities.size() || !this->entities[id].sample(this->clock.getRenderTick(), out)) return false;
+    this->samplesDrawn++;
+    if (out.extrapolating)
+    {
+        this->extrapolatingCount++;
+        this->samplesExtrapolated++;
+    }
+    return true;
+}
@@ -0,0 +1,119 @@
+#include "net/net_connection.h"
+
+// How quickly the smoothed round trip follows new samples
+#define NET_RTT_SMOOTHING 0.1f
+
+void PacketHeader::write(ByteWriter &writer) const
+{
+    writer.writeU32(NET_PROTOCOL_ID);
+    writer.writeU8((uint8_t)this->type | (this->hasAck ? NET_HEADER_HAS_ACK : 0));
+    writer.writeU16(this->sequence);
+    writer.writeU16(this->ack);
+    writer.writeU32(this->ackBits);
+}
+
+bool PacketHeader::read(ByteReader &reader)
+{
+    if (reader.readU32() != NET_PROTOCOL_ID) return false;
+    uint8_t type = reader.readU8();
+    this->hasAck = (type & NET_HEADER_HAS_ACK) != 0;
+    type &= (uint8_t)~NET_HEADER_HAS_ACK;
+    this->sequence = reader.readU16();
+    this->ack = reader.readU16();
+    this->ackBits = reader.readU32();
+    if (reader.overflow || type >= (uint8_t)PacketType::COUNT) return false;
+    this->type = (PacketType)type;
+    return true;
+}
+
+void NetConnection::reset(const NetAddress &address, double now)
+{
+    *this = NetConnection();
+    this->address = address;
+    this->lastSendTime = now;
+    this->lastReceiveTime = now;
+}
+
+PacketHeader NetConnection::nextHeader(PacketType type, double now)
+{
+    PacketHeader header;
+    header.type = type;
+    header.sequence = this->localSequence;
+    header.ack = this->remoteSequence;
+    header.ackBits = this->receivedBits;
+    header.hasAck = this->receivedAny;
+
+    // Whatever used this slot last never got acked inside the window
+    SentPacket &entry = this->sent[this->localSequence % NET_SENT_HISTORY];
+    if (entry.valid && !entry.acked) this->packetsLost++;
+    entry.sequence = this->localSequence;
+    entry.valid = true;
+    entry.acked = false;
+    entry.sendTime = now;
+
+    this->localSequence++;
+    this->lastSendTime = now;
+    this->packetsSent++;
+    return header;
+}
+
+bool NetConnection::processHeader(const PacketHeader &header, double now)
+{
+    // What we got from them
+    if (!this->receivedAny)
+    {
+        this->remoteSequence = header.sequence;
+        this->receivedBits = 0;
+        this->receivedAny = true;
+    }
+    else if (sequenceGreaterThan(header.sequence, this->remoteSequence))
+    {
+        uint16_t shift = (uint16_t)(header.sequence - this->remoteSequence);
+        // The old newest becomes bit shift - 1
+        if (shift < 32) this->receivedBits = (this->receivedBits << shift) | (1u << (shift - 1));
+        else if (shift == 32) this->receivedBits = 1u << 31;
+        else this->receivedBits = 0;
+        this->remoteSequence = header.sequence;
+    }
+    else
+    {
+        uint16_t behind = (uint16_t)(this->remoteSequence - header.sequence);
+        if (behind == 0 || behind > 32) return false;
+        uint32_t bit = 1u << (behind - 1);
+        if (this->receivedBits & bit) return false;
+        this->receivedBits |= bit;
+    }
+    this->lastReceiveTime = now;
+    this->packetsReceived++;
+
+    // What they got from us, nothing yet if they havent heard from us
+    if (!header.hasAck) return true;
+    this->ackSequence(header.ack, now);
+    for (int i = 0; i < 32; i++)
+    {
+        if (header.ackBits & (1u << i)) this->ackSequence((uint16_t)(header.ack - 1 - i), now);
+    }
+    return true;
+}
+
+void NetConnection::ackSequence(uint16_t sequence, double now)
+{
+    SentPacket &entry = this->sent[sequence % NET_SENT_HISTORY];
+    if (!entry.valid || entry.acked || entry.sequence != sequence) return;
+
+    entry.acked = true;
+    this->packetsAcked++;
+    // Nobody taking them (a client that doesnt care), dont let them pile up
+    if (this->newAcks.size() >= NET_SENT_HISTORY) this->newAcks.erase(this->newAcks.begin());
+    this->newAcks.push_back(sequence);
+
+    float sample = (float)((now - entry.sendTime) * 1000.0);
+    if (this->packetsAcked == 1) this->roundTripMilliseconds = sample;
+    else this->roundTripMilliseconds += (sample - this->roundTripMilliseconds) * NET_RTT_SMOOTHING;
+}
+
+void NetConnection::takeAcks(std::vector<uint16_t> &out)
+{
+    out.insert(out.end(), this->newAcks.begin(), this->newAcks.end());
+    this->newAcks.clear();
+}
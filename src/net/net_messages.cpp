@@ -0,0 +1,280 @@
+#include "net/net_messages.h"
+#include "net/snapshot.h"
+#include "utils/fixed_timestep.h"
+#include <algorithm>
+
+MessageType peekMessageType(const uint8_t *payload, int size)
+{
+    // The type is the first 8 bits written, so all of byte 0
+    if (size < 1 || payload[0] >= (uint8_t)MessageType::COUNT) return MessageType::COUNT;
+    return (MessageType)payload[0];
+}
+
+void InputMessage::write(BitWriter &writer) const
+{
+    writer.writeBits((uint32_t)MessageType::INPUT, 8);
+    writer.writeBits(this->sequence, 32);
+    writer.writeBits(this->keys & 0x0F, 4);
+    for (int i = 0; i < INPUT_MESSAGE_REDUNDANCY; i++) writer.writeBits(this->previousKeys[i] & 0x0F, 4);
+}
+
+bool InputMessage::read(BitReader &reader)
+{
+    if (reader.readBits(8) != (uint32_t)MessageType::INPUT) return false;
+    this->sequence = reader.readBits(32);
+    this->keys = (uint8_t)reader.readBits(4);
+    for (int i = 0; i < INPUT_MESSAGE_REDUNDANCY; i++) this->previousKeys[i] = (uint8_t)reader.readBits(4);
+    return !reader.hasOverflowed();
+}
+
+void ViewMessage::write(BitWriter &writer) const
+{
+    writer.writeBits((uint32_t)MessageType::VIEW, 8);
+    writer.writeBits(this->width, 16);
+    writer.writeBits(this->height, 16);
+}
+
+bool ViewMessage::read(BitReader &reader)
+{
+    if (reader.readBits(8) != (uint32_t)MessageType::VIEW) return false;
+    this->width = (uint16_t)reader.readBits(16);
+    this->height = (uint16_t)reader.readBits(16);
+    return !reader.hasOverflowed();
+}
+
+// ==========================================================================================
+// State
+// ==========================================================================================
+#define BODY_FIELDS 4
+
+using PositionAxis = BodyPositionCodec::Axis;
+using VelocityAxis = BodyVelocityCodec::Axis;
+
+// position x, position y, velocity x, velocity y as wire steps
+static void bodyToSteps(const BodyState &body, uint32_t steps[BODY_FIELDS])
+{
+    steps[0] = PositionAxis::toSteps(body.position.x);
+    steps[1] = PositionAxis::toSteps(body.position.y);
+    steps[2] = VelocityAxis::toSteps(body.velocity.x);
+    steps[3] = VelocityAxis::toSteps(body.velocity.y);
+}
+
+static void bodyFromSteps(BodyState &body, const int64_t steps[BODY_FIELDS])
+{
+    body.position.x = PositionAxis::fromSteps(steps[0]);
+    body.position.y = PositionAxis::fromSteps(steps[1]);
+    body.velocity.x = VelocityAxis::fromSteps(steps[2]);
+    body.velocity.y = VelocityAxis::fromSteps(steps[3]);
+}
+
+/**
+    Baseline bodies moved on to where their velocity would have taken them ticks later,
+    on both ends before the delta goes on. Bodies the delta leaves out end up there
+    too, so a body that stopped or kept going in a straight line costs nothing. Integer
+    math so both ends get the same steps
+**/
+static void predictBodies(std::vector<BodyState> &bodies, uint32_t ticks)
+{
+    if (ticks == 0) return;
+    for (BodyState &body : bodies)
+    {
+        FixedVec2 position = body.position;
+        position.x += Fixed::fromRaw((int32_t)((int64_t)body.velocity.x.raw * ticks / SIM_TICK_RATE));
+        position.y += Fixed::fromRaw((int32_t)((int64_t)body.velocity.y.raw * ticks / SIM_TICK_RATE));
+        body.position = BodyPositionCodec::quantize(position);
+    }
+}
+
+// Binary search over the first count bodies (the sorted part)
+static BodyState *findBody(std::vector<BodyState> &bodies, size_t count, uint16_t id)
+{
+    auto end = bodies.begin() + count;
+    auto it = std::lower_bound(bodies.begin(), end, id, [](const BodyState &body, uint16_t value) { return body.id < value; });
+    return it != end && it->id == id ? &*it : nullptr;
+}
+
+static void sortBodies(std::vector<BodyState> &bodies)
+{
+    std::sort(bodies.begin(), bodies.end(), [](const BodyState &a, const BodyState &b) { return a.id < b.id; });
+}
+
+void StateMessage::write(BitWriter &writer, const Snapshot *baseline, int start, Snapshot &written) const
+{
+    written.tick = this->tick;
+    written.bodies.clear();
+    if (baseline) written.bodies = baseline->bodies;
+
+    writer.writeBits((uint32_t)MessageType::STATE, 8);
+    writer.writeBits(this->tick, 32);
+    writer.writeBits(this->lastInputSequence, 32);
+    writer.writeBits(this->yourId, 16);
+    writer.writeBits(this->yourGeneration, 8);
+    writer.writeBool(baseline != nullptr);
+    if (baseline) writer.writeBits(baseline->sequence, 16);
+
+    // Removed, both lists are sorted so one walk finds them
+    uint16_t removed[STATE_MAX_REMOVED];
+    int removedCount = 0;
+    size_t current = 0;
+    for (const BodyState &old : written.bodies)
+    {
+        while (current < this->bodies.size() && this->bodies[current].id < old.id) current++;
+        bool gone = current == this->bodies.size() || this->bodies[current].id != old.id;
+        if (gone && removedCount < STATE_MAX_REMOVED) removed[removedCount++] = old.id;
+    }
+    writer.writeVarint((uint32_t)removedCount);
+    uint16_t previousRemoved = 0;
+    for (int i = 0; i < removedCount; i++)
+    {
+        writer.writeVarint((uint32_t)(removed[i] - previousRemoved));
+        previousRemoved = removed[i];
+        BodyState *old = findBody(written.bodies, written.bodies.size(), removed[i]);
+        written.bodies.erase(written.bodies.begin() + (old - written.bodies.data()));
+    }
+
+    // New / changed bodies, new ones go on the end of written and get sorted in after
+    if (baseline) predictBodies(written.bodies, this->tick - baseline->tick);
+    const size_t sortedCount = written.bodies.size();
+    int previousId = 0;
+    bool full = false;
+    auto writeBody = [&](const BodyState &body) {
+        BodyState *old = findBody(written.bodies, sortedCount, body.id);
+        bool isNew = !old || old->generation != body.generation;
+        uint32_t now[BODY_FIELDS], was[BODY_FIELDS];
+        bodyToSteps(body, now);
+        uint32_t mask = 0;
+        if (!isNew)
+        {
+            bodyToSteps(*old, was);
+            for (int field = 0; field < BODY_FIELDS; field++)
+            {
+                if (now[field] != was[field]) mask |= 1u << field;
+            }
+            if (mask == 0) return;
+        }
+        // Room for this one and the 0 bit after the last
+        if (full || writer.getBitsRemaining() < 1 + STATE_BODY_MAX_BITS + 1)
+        {
+            full = true;
+            return;
+        }
+
+        writer.writeBool(true);
+        writer.writeSignedVarint((int32_t)body.id - previousId);
+        previousId = body.id;
+        writer.writeBool(isNew);
+
+        // What the client reads back, snapped onto the wire grid
+        BodyState sent;
+        sent.id = body.id;
+        sent.generation = body.generation;
+        int64_t steps[BODY_FIELDS] = {now[0], now[1], now[2], now[3]};
+        bodyFromSteps(sent, steps);
+
+        if (isNew)
+        {
+            BitsCodec<8>::write(writer, sent.generation);
+            BodyPositionCodec::write(writer, sent.position);
+            BodyVelocityCodec::write(writer, sent.velocity);
+        }
+        else
+        {
+            writer.writeBits(mask, BODY_FIELDS);
+            for (int field = 0; field < BODY_FIELDS; field++)
+            {
+                if (mask & (1u << field)) writer.writeSignedVarint((int32_t)(now[field] - was[field]));
+            }
+        }
+
+        if (old) *old = sent;
+        else written.bodies.push_back(sent);
+    };
+
+    // Our own body first, then everyone else from start round
+    const int count = (int)this->bodies.size();
+    int own = -1;
+    for (int i = 0; i < count; i++)
+    {
+        if (this->bodies[i].id == this->yourId) own = i;
+    }
+    if (own >= 0) writeBody(this->bodies[own]);
+    for (int i = 0; i < count; i++)
+    {
+        int index = (start + i) % count;
+        if (index != own) writeBody(this->bodies[index]);
+    }
+    writer.writeBool(false);
+
+    if (written.bodies.size() != sortedCount) sortBodies(written.bodies);
+}
+
+bool StateMessage::read(BitReader &reader, const SnapshotRing &received)
+{
+    if (reader.readBits(8) != (uint32_t)MessageType::STATE) return false;
+    this->tick = reader.readBits(32);
+    this->lastInputSequence = reader.readBits(32);
+    this->yourId = (uint16_t)reader.readBits(16);
+    this->yourGeneration = (uint8_t)reader.readBits(8);
+    this->wasDelta = reader.readBool();
+
+    this->bodies.clear();
+    uint32_t ticks = 0;
+    if (this->wasDelta)
+    {
+        const Snapshot *baseline = received.findSequence((uint16_t)reader.readBits(16));
+        // Older than our ring, the server stops using it once it sees newer acks
+        if (!baseline) return false;
+        this->bodies = baseline->bodies;
+        ticks = this->tick - baseline->tick;
+    }
+
+    uint32_t removedCount = reader.readVarint();
+    if (reader.hasOverflowed() || removedCount > STATE_MAX_REMOVED) return false;
+    uint32_t removedId = 0;
+    for (uint32_t i = 0; i < removedCount; i++)
+    {
+        removedId += reader.readVarint();
+        BodyState *old = findBody(this->bodies, this->bodies.size(), (uint16_t)removedId);
+        if (old) this->bodies.erase(this->bodies.begin() + (old - this->bodies.data()));
+    }
+
+    predictBodies(this->bodies, ticks);
+    const size_t sortedCount = this->bodies.size();
+    int previousId = 0;
+    while (reader.readBool())
+    {
+        int id = previousId + reader.readSignedVarint();
+        if (id < 0 || id > 0xFFFF) return false;
+        previousId = id;
+
+        BodyState *old = findBody(this->bodies, sortedCount, (uint16_t)id);
+        if (reader.readBool())
+        {
+            BodyState body;
+            body.id = (uint16_t)id;
+            BitsCodec<8>::read(reader, body.generation);
+            BodyPositionCodec::read(reader, body.position);
+            BodyVelocityCodec::read(reader, body.velocity);
+            if (old) *old = body;
+            else this->bodies.push_back(body);
+        }
+        else
+        {
+            // A change to something we dont have, not from a baseline we agree on
+            if (!old) return false;
+            uint32_t was[BODY_FIELDS];
+            bodyToSteps(*old, was);
+            uint32_t mask = reader.readBits(BODY_FIELDS);
+            int64_t steps[BODY_FIELDS];
+            for (int field = 0; field < BODY_FIELDS; field++)
+            {
+                steps[field] = was[field];
+                if (mask & (1u << field)) steps[field] += reader.readSignedVarint();
+            }
+            bodyFromSteps(*old, steps);
+        }
+    }
+
+    if (this->bodies.size() != sortedCount) sortBodies(this->bodies);
+    return !reader.hasOverflowed();
+}
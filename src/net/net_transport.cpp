@@ -0,0 +1,324 @@
+#include "net/net_transport.h"
+#include "utils/log_sink.h"
+#include <chrono>
+#include <random>
+
+static uint64_t makeSalt()
+{
+    std::random_device device;
+    uint64_t salt = ((uint64_t)device() << 32) ^ device();
+    return salt ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+// ==========================================================================================
+// Server
+// ==========================================================================================
+bool NetServer::start(uint16_t port, int maxClients)
+{
+    if (!this->socket.open(port)) return false;
+    this->clients.assign(maxClients, Client());
+    this->events.clear();
+    this->eventData.clear();
+    LogSink::write("Server listening on UDP port " + std::to_string(this->socket.getPort()) +
+                   " (" + std::to_string(maxClients) + " clients)", ErrorCode::SUCCESS);
+    return true;
+}
+
+void NetServer::stop(double now)
+{
+    for (int i = 0; i < (int)this->clients.size(); i++)
+    {
+        if (this->clients[i].connected) this->disconnect(i, now);
+    }
+    this->socket.close();
+}
+
+int NetServer::getConnectedCount() const
+{
+    int count = 0;
+    for (const Client &client : this->clients) count += client.connected ? 1 : 0;
+    return count;
+}
+
+int NetServer::findClient(const NetAddress &address) const
+{
+    for (int i = 0; i < (int)this->clients.size(); i++)
+    {
+        if (this->clients[i].connected && this->clients[i].connection.getAddress() == address) return i;
+    }
+    return -1;
+}
+
+void NetServer::sendHandshake(const NetAddress &to, PacketType type, uint64_t salt, uint16_t clientIndex)
+{
+    ByteWriter writer(this->packet, NET_MAX_PACKET_BYTES);
+    PacketHeader header;
+    header.type = type;
+    header.write(writer);
+    writer.writeU64(salt);
+    writer.writeU16(clientIndex);
+    if (this->socket.send(to, writer.data, writer.size)) this->bytesSent += writer.size;
+}
+
+uint16_t NetServer::sendPacket(int client, PacketType type, const uint8_t *payload, int size, double now)
+{
+    NetConnection &connection = this->clients[client].connection;
+    PacketHeader header = connection.nextHeader(type, now);
+
+    ByteWriter writer(this->packet, NET_MAX_PACKET_BYTES);
+    header.write(writer);
+    if (size > 0) writer.writeBytes(payload, size);
+    if (writer.overflow)
+    {
+        LogSink::write("Dropped a " + std::to_string(size) + " byte payload, bigger than a packet", ErrorCode::ERROR);
+        return header.sequence;
+    }
+    if (this->socket.send(connection.getAddress(), writer.data, writer.size)) this->bytesSent += writer.size;
+    return header.sequence;
+}
+
+uint16_t NetServer::send(int client, const uint8_t *payload, int size, double now)
+{
+    if (!this->isConnected(client)) return 0;
+    return this->sendPacket(client, PacketType::PAYLOAD, payload, size, now);
+}
+
+void NetServer::disconnect(int client, double now)
+{
+    if (!this->isConnected(client)) return;
+    // A few times, theres no ack for this and they time out anyway if it gets lost
+    for (int i = 0; i < 3; i++) this->sendPacket(client, PacketType::DISCONNECT, nullptr, 0, now);
+    this->dropClient(client);
+}
+
+void NetServer::dropClient(int client)
+{
+    this->clients[client].connected = false;
+    NetEvent event;
+    event.type = NetEventType::DISCONNECTED;
+    event.client = client;
+    this->events.push_back(event);
+}
+
+void NetServer::handleConnectRequest(const NetAddress &from, ByteReader &reader, double now)
+{
+    uint64_t salt = reader.readU64();
+    if (reader.overflow) return;
+
+    int existing = this->findClient(from);
+    if (existing >= 0)
+    {
+        // Our accept got lost, say it again
+        if (this->clients[existing].salt == salt)
+        {
+            this->sendHandshake(from, PacketType::CONNECT_ACCEPT, salt, (uint16_t)existing);
+            return;
+        }
+        // Same address, new salt, the client restarted
+        this->dropClient(existing);
+    }
+
+    int slot = -1;
+    for (int i = 0; i < (int)this->clients.size() && slot < 0; i++)
+    {
+        if (!this->clients[i].connected) slot = i;
+    }
+    if (slot < 0)
+    {
+        this->sendHandshake(from, PacketType::CONNECT_DENIED, salt, 0);
+        return;
+    }
+
+    Client &client = this->clients[slot];
+    client.connected = true;
+    client.salt = salt;
+    client.connection.reset(from, now);
+    this->sendHandshake(from, PacketType::CONNECT_ACCEPT, salt, (uint16_t)slot);
+
+    NetEvent event;
+    event.type = NetEventType::CONNECTED;
+    event.client = slot;
+    this->events.push_back(event);
+}
+
+void NetServer::update(double now)
+{
+    this->events.clear();
+    this->eventData.clear();
+    if (!this->socket.isOpen()) return;
+
+    NetAddress from;
+    uint8_t buffer[NET_MAX_PACKET_BYTES];
+    int received;
+    while ((received = this->socket.receive(from, buffer, sizeof(buffer))) > 0)
+    {
+        this->bytesReceived += received;
+        ByteReader reader(buffer, received);
+        PacketHeader header;
+        if (!header.read(reader)) continue;
+
+        if (header.type == PacketType::CONNECT_REQUEST)
+        {
+            this->handleConnectRequest(from, reader, now);
+            continue;
+        }
+
+        int client = this->findClient(from);
+        if (client < 0) continue;
+        if (!this->clients[client].connection.processHeader(header, now)) continue;
+
+        if (header.type == PacketType::DISCONNECT)
+        {
+            this->dropClient(client);
+        }
+        else if (header.type == PacketType::PAYLOAD)
+        {
+            NetEvent event;
+            event.type = NetEventType::PAYLOAD;
+            event.client = client;
+            event.sequence = header.sequence;
+            event.offset = (int)this->eventData.size();
+            event.size = reader.getRemaining();
+            this->eventData.insert(this->eventData.end(), buffer + reader.position, buffer + received);
+            this->events.push_back(event);
+        }
+    }
+
+    for (int i = 0; i < (int)this->clients.size(); i++)
+    {
+        if (!this->clients[i].connected) continue;
+        NetConnection &connection = this->clients[i].connection;
+        if (connection.hasTimedOut(now, this->timeout))
+        {
+            LogSink::write("Client " + std::to_string(i) + " (" + connection.getAddress().toString() + ") timed out", ErrorCode::NONE);
+            this->dropClient(i);
+        }
+        else if (connection.needsKeepalive(now))
+        {
+            this->sendPacket(i, PacketType::KEEPALIVE, nullptr, 0, now);
+        }
+    }
+}
+
+// ==========================================================================================
+// Client
+// ==========================================================================================
+bool NetClient::connect(const NetAddress &server, double now)
+{
+    if (!this->socket.isOpen() && !this->socket.open(0)) return false;
+
+    this->server = server;
+    this->salt = makeSalt();
+    this->clientIndex = -1;
+    this->state = NetClientState::CONNECTING;
+    this->connectStartTime = now;
+    this->sendConnectRequest(now);
+    return true;
+}
+
+void NetClient::disconnect(double now)
+{
+    if (this->state == NetClientState::CONNECTED)
+    {
+        for (int i = 0; i < 3; i++) this->sendPacket(PacketType::DISCONNECT, nullptr, 0, now);
+    }
+    this->state = NetClientState::DISCONNECTED;
+    this->socket.close();
+}
+
+void NetClient::sendConnectRequest(double now)
+{
+    ByteWriter writer(this->packet, NET_MAX_PACKET_BYTES);
+    PacketHeader header;
+    header.type = PacketType::CONNECT_REQUEST;
+    header.write(writer);
+    writer.writeU64(this->salt);
+    if (this->socket.send(this->server, writer.data, writer.size)) this->bytesSent += writer.size;
+    this->lastRequestTime = now;
+}
+
+uint16_t NetClient::sendPacket(PacketType type, const uint8_t *payload, int size, double now)
+{
+    PacketHeader header = this->connection.nextHeader(type, now);
+    ByteWriter writer(this->packet, NET_MAX_PACKET_BYTES);
+    header.write(writer);
+    if (size > 0) writer.writeBytes(payload, size);
+    if (writer.overflow)
+    {
+        LogSink::write("Dropped a " + std::to_string(size) + " byte payload, bigger than a packet", ErrorCode::ERROR);
+        return header.sequence;
+    }
+    if (this->socket.send(this->server, writer.data, writer.size)) this->bytesSent += writer.size;
+    return header.sequence;
+}
+
+uint16_t NetClient::send(const uint8_t *payload, int size, double now)
+{
+    if (this->state != NetClientState::CONNECTED) return 0;
+    return this->sendPacket(PacketType::PAYLOAD, payload, size, now);
+}
+
+void NetClient::update(double now)
+{
+    this->events.clear();
+    this->eventData.clear();
+    if (!this->socket.isOpen()) return;
+
+    NetAddress from;
+    uint8_t buffer[NET_MAX_PACKET_BYTES];
+    int received;
+    while ((received = this->socket.receive(from, buffer, sizeof(buffer))) > 0)
+    {
+        if (from != this->server) continue;
+        this->bytesReceived += received;
+        ByteReader reader(buffer, received);
+        PacketHeader header;
+        if (!header.read(reader)) continue;
+
+        if (header.type == PacketType::CONNECT_ACCEPT || header.type == PacketType::CONNECT_DENIED)
+        {
+            uint64_t salt = reader.readU64();
+            uint16_t index = reader.readU16();
+            if (reader.overflow || salt != this->salt || this->state != NetClientState::CONNECTING) continue;
+
+            if (header.type == PacketType::CONNECT_DENIED)
+            {
+                this->state = NetClientState::DENIED;
+                continue;
+            }
+            this->state = NetClientState::CONNECTED;
+            this->clientIndex = index;
+            this->connection.reset(this->server, now);
+            continue;
+        }
+
+        if (this->state != NetClientState::CONNECTED) continue;
+        if (!this->connection.processHeader(header, now)) continue;
+
+        if (header.type == PacketType::DISCONNECT)
+        {
+            this->state = NetClientState::DISCONNECTED;
+        }
+        else if (header.type == PacketType::PAYLOAD)
+        {
+            NetEvent event;
+            event.type = NetEventType::PAYLOAD;
+            event.sequence = header.sequence;
+            event.offset = (int)this->eventData.size();
+            event.size = reader.getRemaining();
+            this->eventData.insert(this->eventData.end(), buffer + reader.position, buffer + received);
+            this->events.push_back(event);
+        }
+    }
+
+    if (this->state == NetClientState::CONNECTING)
+    {
+        if (now - this->connectStartTime > this->timeout) this->state = NetClientState::TIMED_OUT;
+        else if (now - this->lastRequestTime > NET_CONNECT_RETRY_SECONDS) this->sendConnectRequest(now);
+    }
+    else if (this->state == NetClientState::CONNECTED)
+    {
+        if (this->connection.hasTimedOut(now, this->timeout)) this->state = NetClientState::TIMED_OUT;
+        else if (this->connection.needsKeepalive(now)) this->sendPacket(PacketType::KEEPALIVE, nullptr, 0, now);
+    }
+}
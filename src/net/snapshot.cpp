@@ -0,0 +1,61 @@
+#include "net/snapshot.h"
+#include <algorithm>
+#include <utility>
+
+const BodyState *Snapshot::find(uint16_t id) const
+{
+    auto it = std::lower_bound(this->bodies.begin(), this->bodies.end(), id,
+                               [](const BodyState &body, uint16_t value) { return body.id < value; });
+    return it != this->bodies.end() && it->id == id ? &*it : nullptr;
+}
+
+void SnapshotRing::clear()
+{
+    for (Snapshot &entry : this->entries)
+    {
+        entry.valid = false;
+        entry.acked = false;
+        entry.bodies.clear();
+    }
+    this->next = 0;
+    this->newestAcked = -1;
+}
+
+void SnapshotRing::insert(Snapshot &snapshot, uint16_t sequence)
+{
+    if (this->next == this->newestAcked) this->newestAcked = -1;
+
+    Snapshot &entry = this->entries[this->next];
+    entry.tick = snapshot.tick;
+    entry.sequence = sequence;
+    entry.valid = true;
+    entry.acked = false;
+    std::swap(entry.bodies, snapshot.bodies);
+    this->next = (this->next + 1) % SNAPSHOT_RING_SIZE;
+}
+
+void SnapshotRing::ack(uint16_t sequence)
+{
+    for (int i = 0; i < SNAPSHOT_RING_SIZE; i++)
+    {
+        Snapshot &entry = this->entries[i];
+        if (!entry.valid || entry.sequence != sequence) continue;
+
+        entry.acked = true;
+        // Acks can come in out of order, only move forward
+        if (this->newestAcked < 0 || sequenceGreaterThan(sequence, this->entries[this->newestAcked].sequence))
+        {
+            this->newestAcked = i;
+        }
+        return;
+    }
+}
+
+const Snapshot *SnapshotRing::findSequence(uint16_t sequence) const
+{
+    for (const Snapshot &entry : this->entries)
+    {
+        if (entry.valid && entry.sequence == sequence) return &entry;
+    }
+    return nullptr;
+}
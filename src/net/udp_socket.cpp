@@ -0,0 +1,122 @@
+#include "net/udp_socket.h"
+#include "utils/log_sink.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool NetAddress::fromString(const std::string &text, NetAddress &out, uint16_t defaultPort)
+{
+    std::string host = text;
+    uint16_t port = defaultPort;
+    size_t colon = text.find(':');
+    if (colon != std::string::npos)
+    {
+        host = text.substr(0, colon);
+        int parsed = std::atoi(text.c_str() + colon + 1);
+        if (parsed <= 0 || parsed > 65535) return false;
+        port = (uint16_t)parsed;
+    }
+    if (host == "localhost") host = "127.0.0.1";
+
+    in_addr address;
+    if (inet_pton(AF_INET, host.c_str(), &address) != 1) return false;
+    out.ip = ntohl(address.s_addr);
+    out.port = port;
+    return true;
+}
+
+std::string NetAddress::toString() const
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%u.%u.%u.%u:%u", (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF, port);
+    return text;
+}
+
+UdpSocket::~UdpSocket()
+{
+    this->close();
+}
+
+bool UdpSocket::open(uint16_t port)
+{
+    this->close();
+
+    this->handle = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (this->handle < 0)
+    {
+        LogSink::write(std::string("Could not create a UDP socket: ") + std::strerror(errno), ErrorCode::ERROR);
+        return false;
+    }
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(this->handle, (sockaddr *)&address, sizeof(address)) < 0)
+    {
+        LogSink::write("Could not bind UDP port " + std::to_string(port) + ": " + std::strerror(errno), ErrorCode::ERROR);
+        this->close();
+        return false;
+    }
+
+    int flags = fcntl(this->handle, F_GETFL, 0);
+    if (flags < 0 || fcntl(this->handle, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        LogSink::write(std::string("Could not make the UDP socket non blocking: ") + std::strerror(errno), ErrorCode::ERROR);
+        this->close();
+        return false;
+    }
+
+    // Whatever the OS picked when port was 0
+    socklen_t length = sizeof(address);
+    getsockname(this->handle, (sockaddr *)&address, &length);
+    this->port = ntohs(address.sin_port);
+    return true;
+}
+
+void UdpSocket::close()
+{
+    if (this->handle >= 0)
+    {
+        ::close(this->handle);
+        this->handle = -1;
+    }
+    this->port = 0;
+}
+
+bool UdpSocket::send(const NetAddress &to, const uint8_t *data, int size)
+{
+    if (this->handle < 0) return false;
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(to.ip);
+    address.sin_port = htons(to.port);
+    ssize_t sent = ::sendto(this->handle, data, (size_t)size, 0, (sockaddr *)&address, sizeof(address));
+    return sent == size;
+}
+
+int UdpSocket::receive(NetAddress &from, uint8_t *buffer, int capacity)
+{
+    if (this->handle < 0) return -1;
+
+    sockaddr_in address = {};
+    socklen_t length = sizeof(address);
+    ssize_t received = ::recvfrom(this->handle, buffer, (size_t)capacity, 0, (sockaddr *)&address, &length);
+    if (received < 0)
+    {
+        // Nothing queued (or an ICMP port unreachable from an old send, which UDP doesnt care about)
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED) return 0;
+        return -1;
+    }
+
+    from.ip = ntohl(address.sin_addr.s_addr);
+    from.port = ntohs(address.sin_port);
+    return (int)received;
+}
@@ -0,0 +1,107 @@
+#include "server/bot_client.h"
+#include "server/comfy_server.h"
+
+// See botHash in comfy_server.cpp
+static uint32_t scriptHash(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+BotClient::BotClient(uint32_t seed)
+: seed(seed), viewWidth(SERVER_DEFAULT_VIEW_WIDTH), viewHeight(SERVER_DEFAULT_VIEW_HEIGHT)
+{
+    ServerTuning tuning;
+    this->movement = BodyMovement::make(tuning.acceleration, tuning.friction, tuning.maxSpeed, tuning.collider, nullptr);
+}
+
+bool BotClient::connect(const NetAddress &server, double now)
+{
+    this->hasState = false;
+    this->statesReceived = 0;
+    this->deltasReceived = 0;
+    this->statesDropped = 0;
+    this->received.clear();
+    this->prediction.reset();
+    return this->net.connect(server, now);
+}
+
+void BotClient::disconnect(double now)
+{
+    this->net.disconnect(now);
+}
+
+void BotClient::update(double now)
+{
+    this->net.update(now);
+
+    for (const NetEvent &event : this->net.getEvents())
+    {
+        const uint8_t *data = this->net.getEventData(event);
+        if (peekMessageType(data, event.size) != MessageType::STATE) continue;
+
+        BitReader reader(data, event.size);
+        StateMessage &state = this->readState;
+        if (!state.read(reader, this->received))
+        {
+            this->statesDropped++;
+            continue;
+        }
+        // Kept even when its out of order, the server may have used it as a baseline
+        this->scratch.tick = state.tick;
+        this->scratch.bodies = state.bodies;
+        this->received.insert(this->scratch, event.sequence);
+
+        // Out of order, we already have a newer one
+        if (this->hasState && state.tick <= this->lastState.tick) continue;
+        this->lastState = state;
+        this->hasState = true;
+        this->statesReceived++;
+        if (state.wasDelta) this->deltasReceived++;
+
+        const BodyState *own = this->getOwnBody();
+        if (own) this->prediction.reconcile(this->movement, state.lastInputSequence, *own);
+    }
+
+    if (!this->net.isConnected()) return;
+
+    uint32_t sequence = this->prediction.getNewestSequence() + 1;
+    if (this->scripted && sequence % 20 == 1)
+    {
+        this->keys = (uint8_t)(scriptHash(sequence / 20 * 2654435761u + this->seed) & 0x0F);
+    }
+    this->prediction.predict(this->movement, sequence, this->keys);
+    InputMessage input = this->prediction.makeInput();
+
+    uint8_t payload[16];
+    BitWriter writer(payload, sizeof(payload));
+    input.write(writer);
+    writer.flush();
+    this->net.send(writer.getData(), writer.getBytes(), now);
+
+    // Once a second is plenty, a lost one just comes again next second
+    if (sequence % SIM_TICK_RATE == 1)
+    {
+        ViewMessage view;
+        view.width = this->viewWidth;
+        view.height = this->viewHeight;
+        BitWriter viewWriter(payload, sizeof(payload));
+        view.write(viewWriter);
+        viewWriter.flush();
+        this->net.send(viewWriter.getData(), viewWriter.getBytes(), now);
+    }
+}
+
+const BodyState *BotClient::getOwnBody() const
+{
+    if (!this->hasState) return nullptr;
+    for (const BodyState &body : this->lastState.bodies)
+    {
+        if (body.id == this->lastState.yourId && body.generation == this->lastState.yourGeneration) return &body;
+    }
+    return nullptr;
+}
@@ -0,0 +1,471 @@
+#include "server/comfy_server.h"
+#include "utils/fixed_collision.h"
+#include "utils/log_sink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+// Same hash the determinism bench scripts with
+static uint32_t botHash(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+// Nanoseconds on the steady clock, the counter we hand FixedTimestep
+static uint64_t clockCounter()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+    key='value' lines, the same format comfy_lib reads. Missing file is an empty map
+**/
+static std::map<std::string, std::string> readIni(const std::string &path)
+{
+    std::map<std::string, std::string> values;
+    std::ifstream file(path);
+    std::string line, key, value;
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line);
+        if (std::getline(iss, key, '=') && std::getline(iss, value))
+        {
+            if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'')
+            {
+                value = value.substr(1, value.size() - 2);
+            }
+            values[key] = value;
+        }
+    }
+    return values;
+}
+
+// Tuning values come in as floats and get rounded onto the Fixed grid once, here
+static void readFixed(const std::map<std::string, std::string> &values, const std::string &key, Fixed &out)
+{
+    auto it = values.find(key);
+    if (it == values.end()) return;
+    out = Fixed::fromFloat(std::strtof(it->second.c_str(), nullptr));
+}
+
+ComfyServer::ComfyServer()
+{
+    this->movement = BodyMovement::make(this->tuning.acceleration, this->tuning.friction, this->tuning.maxSpeed,
+                                        this->tuning.collider, nullptr);
+}
+
+bool ComfyServer::loadMap(const std::string &jsonPath)
+{
+    this->map = TSDL_TileMap();
+    this->hasMap = MapData::load(&this->map, jsonPath, jsonPath);
+    if (!this->hasMap)
+    {
+        LogSink::write("Failed to load map: (" + jsonPath + "), running without one", ErrorCode::MAP_ERROR);
+        this->map = TSDL_TileMap();
+    }
+    this->movement.grid = this->hasMap ? &this->map.collisionGrid : nullptr;
+    if (this->hasMap) this->interest.setTileSize(this->map.tileWidth, this->map.tileHeight);
+    return this->hasMap;
+}
+
+bool ComfyServer::loadTuning(const std::string &dataDirectory)
+{
+    std::map<std::string, std::string> player = readIni(dataDirectory + "/player_data.ini");
+    std::map<std::string, std::string> collision = readIni(dataDirectory + "/collision_data.ini");
+
+    readFixed(player, "acceleration", this->tuning.acceleration);
+    readFixed(player, "maxSpeed", this->tuning.maxSpeed);
+    readFixed(player, "friction", this->tuning.friction);
+
+    Fixed offsetX = this->tuning.collider.minX;
+    Fixed offsetY = this->tuning.collider.minY;
+    Fixed width = this->tuning.collider.getWidth();
+    Fixed height = this->tuning.collider.getHeight();
+    readFixed(collision, "xOffset", offsetX);
+    readFixed(collision, "yOffset", offsetY);
+    readFixed(collision, "width", width);
+    readFixed(collision, "height", height);
+    this->tuning.collider = FixedAABB::fromRect(offsetX, offsetY, width, height);
+
+    this->movement = BodyMovement::make(this->tuning.acceleration, this->tuning.friction, this->tuning.maxSpeed,
+                                        this->tuning.collider, this->movement.grid);
+
+    if (player.empty() || collision.empty())
+    {
+        LogSink::write("Missing player / collision ini in (" + dataDirectory + "), using default tuning", ErrorCode::PLAYER_ERROR);
+        return false;
+    }
+    return true;
+}
+
+PoolHandle ComfyServer::spawnBody(Fixed x, Fixed y, bool isBot)
+{
+    PoolHandle handle = this->bodies.create();
+    ServerBody *body = this->bodies.get(handle);
+    body->position = BodyPositionCodec::quantize(FixedVec2(x, y));
+    body->isBot = isBot;
+    body->botSeed = handle.index * 2654435761u + handle.generation;
+
+    body->entity = this->components.create(x.toFloat(), y.toFloat());
+    int slot = this->components.slotOf(body->entity);
+    ColliderComponents &colliders = this->components.getColliders();
+    colliders.offsetX[slot] = this->tuning.collider.minX.toFloat();
+    colliders.offsetY[slot] = this->tuning.collider.minY.toFloat();
+    colliders.width[slot] = this->tuning.collider.getWidth().toFloat();
+    colliders.height[slot] = this->tuning.collider.getHeight().toFloat();
+    this->components.getVelocities().maxSpeed[slot] = this->tuning.maxSpeed.toFloat();
+    return handle;
+}
+
+/**
+    Walks forward from a hashed tile until it finds one that isnt solid, same spread the
+    determinism bench uses. No map spawns them in a line
+**/
+void ComfyServer::findSpawn(uint32_t seed, Fixed &x, Fixed &y) const
+{
+    const CollisionGrid &grid = this->map.collisionGrid;
+    int width = this->hasMap ? grid.getWidth() : 0;
+    int height = this->hasMap ? grid.getHeight() : 0;
+    x = Fixed::fromInt((int)(seed % 1024) * 16);
+    y = Fixed();
+    if (width <= 2 || height <= 2) return;
+
+    int innerWidth = width - 2, innerHeight = height - 2;
+    int tile = (int)(botHash(seed + 1) % (uint32_t)(innerWidth * innerHeight));
+    for (int tries = 0; tries < innerWidth * innerHeight; tries++)
+    {
+        int tileX = 1 + tile % innerWidth, tileY = 1 + tile / innerWidth;
+        if (!grid.isSolid(tileX, tileY))
+        {
+            x = Fixed::fromInt(tileX * grid.getTileWidth());
+            y = Fixed::fromInt(tileY * grid.getTileHeight());
+            return;
+        }
+        tile = (tile + 1) % (innerWidth * innerHeight);
+    }
+}
+
+void ComfyServer::spawnBots(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        Fixed x, y;
+        this->findSpawn((uint32_t)this->bodies.size(), x, y);
+        this->spawnBody(x, y, true);
+    }
+}
+
+bool ComfyServer::removeBody(PoolHandle handle)
+{
+    ServerBody *body = this->bodies.get(handle);
+    if (!body) return false;
+    this->components.destroy(body->entity);
+    return this->bodies.destroy(handle);
+}
+
+bool ComfyServer::setKeys(PoolHandle handle, uint8_t keys)
+{
+    ServerBody *body = this->bodies.get(handle);
+    if (!body) return false;
+    body->keys = keys;
+    return true;
+}
+
+/**
+    Player::moveFixed for a body (BodyMovement, snapped onto the grid StateMessage
+    sends so clients get exactly this), then the float copies go into the store
+**/
+void ComfyServer::stepBody(ServerBody &body)
+{
+    if (body.isBot)
+    {
+        body.keys = (uint8_t)(botHash((uint32_t)(this->tick / 20) * 2654435761u + body.botSeed) & 0x0F);
+    }
+
+    this->movement.step(body.keys, body.position, body.velocity);
+    FixedVec2 direction = BodyMovement::directionFromKeys(body.keys);
+
+    int slot = this->components.slotOf(body.entity);
+    TransformComponents &transforms = this->components.getTransforms();
+    VelocityComponents &velocities = this->components.getVelocities();
+    transforms.x[slot] = body.position.x.toFloat();
+    transforms.y[slot] = body.position.y.toFloat();
+    velocities.x[slot] = body.velocity.x.toFloat();
+    velocities.y[slot] = body.velocity.y.toFloat();
+    velocities.directionX[slot] = direction.x.toFloat();
+    velocities.directionY[slot] = direction.y.toFloat();
+}
+
+double ComfyServer::clockSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ==========================================================================================
+// Network
+// ==========================================================================================
+bool ComfyServer::listen(uint16_t port, int maxClients)
+{
+    if (!this->net.start(port, maxClients)) return false;
+    this->clients.assign(maxClients, ServerClient());
+    return true;
+}
+
+void ComfyServer::handleInput(int client, const uint8_t *data, int size)
+{
+    BitReader reader(data, size);
+    InputMessage input;
+    if (!input.read(reader)) return;
+
+    // The repeated keys fill in inputs whose own packet got lost, except on the very
+    // first one where they would only start the queue a few ticks behind
+    ServerClient &player = this->clients[client];
+    int oldest = player.hasInput || !player.pendingInputs.empty() ? INPUT_MESSAGE_REDUNDANCY : 0;
+    for (int i = oldest; i >= 0; i--)
+    {
+        if (input.sequence <= (uint32_t)i) continue;
+        uint8_t keys = i == 0 ? input.keys : input.previousKeys[i - 1];
+        this->queueInput(player, input.sequence - i, keys & SERVER_KEY_ALL);
+    }
+}
+
+void ComfyServer::handleView(int client, const uint8_t *data, int size)
+{
+    BitReader reader(data, size);
+    ViewMessage view;
+    if (!view.read(reader)) return;
+    ServerClient &player = this->clients[client];
+    player.viewWidth = std::min((int)view.width, SERVER_MAX_VIEW_SIZE);
+    player.viewHeight = std::min((int)view.height, SERVER_MAX_VIEW_SIZE);
+}
+
+InterestRect ComfyServer::viewRect(const ServerClient &player, const ServerBody &body) const
+{
+    float width = (float)player.viewWidth, height = (float)player.viewHeight;
+    float x = body.position.x.toFloat() - width / 2.0f;
+    float y = body.position.y.toFloat() - height / 2.0f;
+    if (this->hasMap)
+    {
+        float mapWidth = (float)(this->map.width * this->map.tileWidth);
+        float mapHeight = (float)(this->map.height * this->map.tileHeight);
+        x = std::max(0.0f, std::min(x, mapWidth - width));
+        y = std::max(0.0f, std::min(y, mapHeight - height));
+    }
+    return {x, y, x + width, y + height};
+}
+
+void ComfyServer::queueInput(ServerClient &player, uint32_t sequence, uint8_t keys)
+{
+    // Packets can show up out of order, an older input than what we ran is stale
+    if (player.hasInput && sequence <= player.lastInputSequence) return;
+    std::vector<QueuedInput> &queue = player.pendingInputs;
+    auto it = std::lower_bound(queue.begin(), queue.end(), sequence,
+                               [](const QueuedInput &queued, uint32_t value) { return queued.sequence < value; });
+    if (it != queue.end() && it->sequence == sequence) return;
+    queue.insert(it, QueuedInput{sequence, keys});
+    // A client sending faster than we run them, the oldest go (it gets corrected)
+    if (queue.size() > SERVER_INPUT_QUEUE) queue.erase(queue.begin());
+}
+
+/**
+    One step per input in sequence order, a second one when more are waiting so a client
+    whose packets bunched up catches back up. Nothing queued, nothing moves. An input
+    that never arrived gets skipped once a later one is at the front
+**/
+void ComfyServer::stepClient(ServerClient &player)
+{
+    ServerBody *body = this->bodies.get(player.body);
+    if (!body) return;
+    std::vector<QueuedInput> &queue = player.pendingInputs;
+    int steps = std::min((int)queue.size(), queue.size() > 1 ? SERVER_MAX_INPUTS_PER_TICK : 1);
+    for (int i = 0; i < steps; i++)
+    {
+        body->keys = queue[i].keys;
+        player.lastInputSequence = queue[i].sequence;
+        player.hasInput = true;
+        this->stepBody(*body);
+    }
+    queue.erase(queue.begin(), queue.begin() + steps);
+}
+
+void ComfyServer::pollNetwork(double now)
+{
+    if (!this->net.isRunning()) return;
+    this->net.update(now);
+
+    // Acked states become baselines
+    for (int i = 0; i < this->net.getMaxClients(); i++)
+    {
+        if (!this->net.isConnected(i)) continue;
+        this->acks.clear();
+        this->net.getConnection(i)->takeAcks(this->acks);
+        for (uint16_t sequence : this->acks) this->clients[i].snapshots.ack(sequence);
+    }
+
+    for (const NetEvent &event : this->net.getEvents())
+    {
+        ServerClient &player = this->clients[event.client];
+        if (event.type == NetEventType::CONNECTED)
+        {
+            Fixed x, y;
+            this->findSpawn((uint32_t)this->bodies.size(), x, y);
+            player = ServerClient();
+            player.body = this->spawnBody(x, y);
+            this->bodies.get(player.body)->stepsOnInput = true;
+            LogSink::write("Client " + std::to_string(event.client) + " connected from " +
+                           this->net.getConnection(event.client)->getAddress().toString(), ErrorCode::SUCCESS);
+        }
+        else if (event.type == NetEventType::DISCONNECTED)
+        {
+            this->removeBody(player.body);
+            player = ServerClient();
+            LogSink::write("Client " + std::to_string(event.client) + " disconnected", ErrorCode::NONE);
+        }
+        else
+        {
+            MessageType type = peekMessageType(this->net.getEventData(event), event.size);
+            if (type == MessageType::INPUT) this->handleInput(event.client, this->net.getEventData(event), event.size);
+            else if (type == MessageType::VIEW) this->handleView(event.client, this->net.getEventData(event), event.size);
+        }
+    }
+}
+
+/**
+    Everyone gets a delta against the newest state they acked (everything if we dont
+    have one of those any more) with just the bodies their InterestSet has. Their own
+    body goes first, then the rest starting from a different body every tick so with
+    more changes than fit in a packet everyone still gets updated every few ticks
+**/
+void ComfyServer::sendState(double now)
+{
+    if (!this->net.isRunning()) return;
+
+    // The same world for every client, the pool walks in index order so its sorted by id already
+    std::vector<BodyState> &world = this->world;
+    std::vector<int> &worldIndex = this->worldIndex;
+    world.clear();
+    worldIndex.assign(this->bodies.getCapacity(), -1);
+    this->bodies.forEach([&world, &worldIndex](PoolHandle handle, ServerBody &body) {
+        BodyState bodyState;
+        bodyState.id = (uint16_t)handle.index;
+        bodyState.generation = (uint8_t)handle.generation;
+        bodyState.position = body.position;
+        bodyState.velocity = body.velocity;
+        worldIndex[handle.index] = (int)world.size();
+        world.push_back(bodyState);
+    });
+    this->interest.rebuild(world);
+    this->state.tick = (uint32_t)this->tick;
+
+    for (int i = 0; i < this->net.getMaxClients(); i++)
+    {
+        if (!this->net.isConnected(i)) continue;
+        ServerClient &player = this->clients[i];
+        const ServerBody *body = this->bodies.get(player.body);
+        if (!body) continue;
+
+        InterestRect inner = this->viewRect(player, *body).grow(SERVER_INTEREST_MARGIN);
+        player.interest.update(this->interest, inner, inner.grow(SERVER_INTEREST_HYSTERESIS), (uint16_t)player.body.index);
+        this->interestEntered += player.interest.getEntered().size();
+        this->interestLeft += player.interest.getLeft().size();
+        this->interestVisible += player.interest.getVisible().size();
+        this->interestUpdates++;
+
+        this->state.bodies.clear();
+        for (uint16_t id : player.interest.getVisible()) this->state.bodies.push_back(world[worldIndex[id]]);
+        const int count = (int)this->state.bodies.size();
+        const int start = count > 0 ? (int)((this->tick * (uint64_t)(StateMessage::maxBodiesPerPacket() - 1)) % (uint64_t)count) : 0;
+
+        this->state.lastInputSequence = player.lastInputSequence;
+        this->state.yourId = (uint16_t)player.body.index;
+        this->state.yourGeneration = (uint8_t)player.body.generation;
+
+        BitWriter writer(this->payload, NET_MAX_PAYLOAD_BYTES);
+        this->state.write(writer, player.snapshots.getNewestAcked(), start, this->written);
+        writer.flush();
+        uint16_t sequence = this->net.send(i, writer.getData(), writer.getBytes(), now);
+        player.snapshots.insert(this->written, sequence);
+    }
+}
+
+void ComfyServer::update()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    this->components.storePreviousPositions();
+    this->bodies.forEach([this](PoolHandle, ServerBody &body) {
+        if (!body.stepsOnInput) this->stepBody(body);
+    });
+    for (int i = 0; i < (int)this->clients.size(); i++)
+    {
+        if (this->net.isConnected(i)) this->stepClient(this->clients[i]);
+    }
+    this->tick++;
+
+    this->lastTickMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    this->totalTickMilliseconds += this->lastTickMilliseconds;
+    if (this->lastTickMilliseconds > this->maxTickMilliseconds) this->maxTickMilliseconds = this->lastTickMilliseconds;
+}
+
+/**
+    FixedTimestep does the catching up (and drops time after a stall same as the
+    client), between ticks we sleep until the next one is due instead of spinning
+**/
+void ComfyServer::run(uint64_t maxTicks)
+{
+    this->running = true;
+    this->timestep.reset(clockCounter(), 1000000000ull);
+    const double stepSeconds = this->timestep.getStepSeconds();
+    uint64_t nextStatusTick = this->tick + (uint64_t)SERVER_STATUS_SECONDS * SIM_TICK_RATE;
+    uint64_t statusBytesSent = this->net.getBytesSent();
+
+    while (this->running && (maxTicks == 0 || this->tick < maxTicks))
+    {
+        this->pollNetwork(clockSeconds());
+        int steps = this->timestep.advance(clockCounter());
+        for (int i = 0; i < steps && (maxTicks == 0 || this->tick < maxTicks); i++)
+        {
+            this->update();
+        }
+        if (steps > 0) this->sendState(clockSeconds());
+
+        if (this->tick >= nextStatusTick)
+        {
+            int connected = this->net.getConnectedCount();
+            double bytesPerClient = connected > 0 ? (double)(this->net.getBytesSent() - statusBytesSent) / SERVER_STATUS_SECONDS / connected : 0.0;
+            statusBytesSent = this->net.getBytesSent();
+
+            char status[300];
+            std::snprintf(status, sizeof(status),
+                          "Tick %llu | %d bodies | %d clients | tick %.3f ms avg %.3f ms max | %.2f s dropped | %llu KB out, %.0f B/s a client | %.1f bodies in view, %llu entered %llu left",
+                          (unsigned long long)this->tick, this->getBodyCount(), connected, this->getAverageTickMilliseconds(),
+                          this->maxTickMilliseconds, this->timestep.getDroppedSeconds(),
+                          (unsigned long long)(this->net.getBytesSent() / 1024), bytesPerClient, this->getAverageVisible(),
+                          (unsigned long long)this->interestEntered, (unsigned long long)this->interestLeft);
+            LogSink::write(status, ErrorCode::NONE);
+            nextStatusTick += (uint64_t)SERVER_STATUS_SECONDS * SIM_TICK_RATE;
+        }
+
+        // alpha is how far into the current tick we already are
+        double untilNextTick = stepSeconds * (1.0 - this->timestep.getAlpha());
+        std::this_thread::sleep_for(std::chrono::duration<double>(untilNextTick));
+    }
+    this->running = false;
+    if (this->net.isRunning()) this->net.stop(clockSeconds());
+}
+
+void ComfyServer::stop()
+{
+    this->running = false;
+}
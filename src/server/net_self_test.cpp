@@ -0,0 +1,287 @@
+#include "server/net_self_test.h"
+#include "server/bot_client.h"
+#include "server/comfy_server.h"
+#include "utils/log_sink.h"
+#include "utils/movement_simd.h"
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Whether the client's newest state has body id in it
+static bool stateHas(const BotClient &client, uint16_t id)
+{
+    for (const BodyState &body : client.getLastState().bodies)
+    {
+        if (body.id == id) return true;
+    }
+    return false;
+}
+
+/**
+    A crowd through the batched kernel and through the scalar step for a second of
+    ticks, how many entities came out different in any bit (a build that fuses
+    multiply adds, see COMFY_FP_OPTIONS)
+**/
+static int movementMismatches()
+{
+    const int count = 1003;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> axis(-1, 1);
+    std::vector<float> start[7];
+    for (int i = 0; i < count; i++)
+    {
+        float directionX = (float)axis(rng), directionY = (float)axis(rng);
+        if (directionX != 0.0f && directionY != 0.0f)
+        {
+            directionX *= 0.70710678f;
+            directionY *= 0.70710678f;
+        }
+        start[0].push_back(unit(rng) * 4096.0f);
+        start[1].push_back(unit(rng) * 4096.0f);
+        start[2].push_back(unit(rng) * 400.0f - 200.0f);
+        start[3].push_back(unit(rng) * 400.0f - 200.0f);
+        start[4].push_back(directionX);
+        start[5].push_back(directionY);
+        start[6].push_back(100.0f + unit(rng) * 100.0f);
+    }
+
+    std::vector<float> scalar[7], batched[7];
+    MovementArrays arrays[2];
+    for (int run = 0; run < 2; run++)
+    {
+        std::vector<float> *values = run == 0 ? scalar : batched;
+        for (int field = 0; field < 7; field++) values[field] = start[field];
+        arrays[run].x = values[0].data();
+        arrays[run].y = values[1].data();
+        arrays[run].velocityX = values[2].data();
+        arrays[run].velocityY = values[3].data();
+        arrays[run].directionX = values[4].data();
+        arrays[run].directionY = values[5].data();
+        arrays[run].maxSpeed = values[6].data();
+    }
+
+    MovementParams params = MovementParams::make(1.0f / SIM_TICK_RATE, 900.0f, 0.85f);
+    for (int tick = 0; tick < SIM_TICK_RATE; tick++)
+    {
+        MovementKernels::integrateScalar(params, arrays[0], 0, count);
+        MovementKernels::integrate(params, arrays[1], 0, count);
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < count; i++)
+    {
+        bool same = true;
+        for (int field = 0; field < 4; field++) same = same && std::memcmp(&scalar[field][i], &batched[field][i], sizeof(float)) == 0;
+        if (!same) mismatches++;
+    }
+    return mismatches;
+}
+
+static bool check(bool passed, const std::string &what, int &failures)
+{
+    LogSink::write((passed ? "PASS " : "FAIL ") + what, passed ? ErrorCode::SUCCESS : ErrorCode::ERROR);
+    if (!passed) failures++;
+    return passed;
+}
+
+/**
+    Server and clients taking turns at the tick rate for seconds of wall clock, the
+    same order the real loops run in (poll, tick, send)
+**/
+static void pump(ComfyServer &server, const std::vector<BotClient *> &clients, double seconds)
+{
+    double end = ComfyServer::clockSeconds() + seconds;
+    while (ComfyServer::clockSeconds() < end)
+    {
+        double now = ComfyServer::clockSeconds();
+        server.pollNetwork(now);
+        server.update();
+        server.sendState(now);
+        for (BotClient *client : clients) client->update(now);
+        std::this_thread::sleep_for(std::chrono::microseconds(1000000 / SIM_TICK_RATE));
+    }
+}
+
+bool NetSelfTest::run(int clientCount)
+{
+    int failures = 0;
+    if (clientCount < 3) clientCount = 3;
+
+    // Not network, but everything a client predicts with has to be the same bits as here
+    int mismatches = movementMismatches();
+    check(mismatches == 0, std::string("batched movement (") + MovementKernels::getInstructionSet() + ") matches the scalar step bit for bit, " +
+                               std::to_string(mismatches) + " mismatches", failures);
+
+    ComfyServer server;
+    if (!check(server.listen(0, clientCount), "server listens on an ephemeral port", failures)) return false;
+    server.getNet().setTimeout(1.0);
+    NetAddress address = NetAddress::loopback(server.getNet().getPort());
+
+    std::vector<std::unique_ptr<BotClient>> owned;
+    std::vector<BotClient *> clients;
+    for (int i = 0; i < clientCount; i++)
+    {
+        owned.emplace_back(new BotClient(0x9E3779B9u * (i + 1)));
+        clients.push_back(owned.back().get());
+        clients.back()->connect(address, ComfyServer::clockSeconds());
+    }
+    // Client 0 holds right the whole time so we know where it should be going
+    clients[0]->setKeys(SERVER_KEY_RIGHT);
+
+    pump(server, clients, 2.0);
+
+    // ==========================================================================================
+    // Handshake
+    // ==========================================================================================
+    bool allConnected = true;
+    for (BotClient *client : clients) allConnected = allConnected && client->getNet().isConnected();
+    check(allConnected, "all " + std::to_string(clientCount) + " clients connected", failures);
+    check(server.getNet().getConnectedCount() == clientCount && server.getBodyCount() == clientCount,
+          "server has a body per client", failures);
+
+    // ==========================================================================================
+    // State and authority
+    // ==========================================================================================
+    bool enoughStates = true;
+    for (BotClient *client : clients) enoughStates = enoughStates && client->getStatesReceived() >= 60;
+    check(enoughStates, "every client got at least 60 states", failures);
+
+    const BodyState *own = clients[0]->getOwnBody();
+    check(own && own->velocity.x > Fixed() && own->velocity.y == Fixed(), "holding right moves the body right", failures);
+
+    // One more state without a tick in between, every client should then be exactly where the server says
+    server.sendState(ComfyServer::clockSeconds());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    bool inSync = true;
+    for (BotClient *client : clients)
+    {
+        client->update(ComfyServer::clockSeconds());
+        const ServerClient *player = server.getClient(client->getNet().getClientIndex());
+        const ServerBody *body = player ? server.getBody(player->body) : nullptr;
+        const BodyState *state = client->getOwnBody();
+        inSync = inSync && body && state && body->position == state->position && body->velocity == state->velocity &&
+                 client->getLastState().tick == (uint32_t)server.getTick();
+    }
+    check(inSync, "client bodies match the server bit for bit", failures);
+
+    bool inputsEchoed = true;
+    for (BotClient *client : clients)
+    {
+        uint32_t echoed = client->getLastState().lastInputSequence;
+        inputsEchoed = inputsEchoed && echoed > 0 && echoed <= client->getInputSequence() && client->getInputSequence() - echoed < 10;
+    }
+    check(inputsEchoed, "states echo the newest input the server applied", failures);
+
+    bool deltas = true;
+    for (BotClient *client : clients)
+    {
+        deltas = deltas && client->getDeltasReceived() > client->getStatesReceived() / 2 && client->getStatesDropped() == 0;
+    }
+    check(deltas, "states come as deltas against acked baselines and every one applies", failures);
+
+    // ==========================================================================================
+    // Prediction
+    // ==========================================================================================
+    bool predicted = true;
+    for (BotClient *client : clients)
+    {
+        const ClientPrediction &prediction = client->getPrediction();
+        predicted = predicted && prediction.getHasState() && prediction.getStatesChecked() >= 60 && prediction.getCorrections() == 0;
+    }
+    check(predicted, "predicted bodies agree with every state, no corrections over loopback", failures);
+
+    // The server moves us somewhere we didnt expect after input 4, the rest gets replayed from there
+    const BodyMovement &movement = server.getMovement();
+    ClientPrediction prediction;
+    BodyState truth;
+    truth.position = FixedVec2(Fixed::fromInt(100), Fixed::fromInt(100));
+    prediction.reconcile(movement, 0, truth);
+    for (uint32_t sequence = 1; sequence <= 10; sequence++)
+    {
+        prediction.predict(movement, sequence, SERVER_KEY_RIGHT);
+        if (sequence <= 4) movement.step(SERVER_KEY_RIGHT, truth.position, truth.velocity);
+    }
+    truth.position.x += Fixed::fromInt(8);
+    bool corrected = prediction.reconcile(movement, 4, truth);
+    for (uint32_t sequence = 5; sequence <= 10; sequence++) movement.step(SERVER_KEY_RIGHT, truth.position, truth.velocity);
+    check(corrected && prediction.getPosition() == truth.position && prediction.getVelocity() == truth.velocity &&
+              prediction.getInputsReplayed() == 6 && prediction.getPendingCount() == 6,
+          "a wrong prediction rewinds to the server and replays the inputs after it", failures);
+
+    // ==========================================================================================
+    // Interest
+    // ==========================================================================================
+    // One body well out of everyones view, one right next to client 1
+    const BodyState *near = clients[1]->getOwnBody();
+    PoolHandle far = server.spawnBody(Fixed::fromInt(20000), Fixed::fromInt(20000));
+    PoolHandle beside = server.spawnBody(near ? near->position.x + Fixed::fromInt(32) : Fixed(), near ? near->position.y : Fixed());
+    uint64_t enteredBefore = server.getInterestEntered();
+    pump(server, clients, 0.3);
+
+    bool farHidden = true;
+    for (BotClient *client : clients) farHidden = farHidden && !stateHas(*client, (uint16_t)far.index);
+    check(farHidden, "a body outside every view isnt sent to anyone", failures);
+    check(near && stateHas(*clients[1], (uint16_t)beside.index) && server.getInterestEntered() > enteredBefore,
+          "a body entering a client's view is sent to it", failures);
+
+    uint64_t leftBefore = server.getInterestLeft();
+    server.removeBody(far);
+    server.removeBody(beside);
+    pump(server, clients, 0.2);
+    check(!stateHas(*clients[1], (uint16_t)beside.index) && server.getInterestLeft() > leftBefore,
+          "a removed body leaves the view and the state", failures);
+
+    // ==========================================================================================
+    // Acks
+    // ==========================================================================================
+    NetConnection &clientConnection = clients[0]->getNet().getConnection();
+    NetConnection *serverConnection = server.getNet().getConnection(clients[0]->getNet().getClientIndex());
+    check(clientConnection.getPacketsAcked() > 60 && serverConnection && serverConnection->getPacketsAcked() > 60,
+          "both ends see their packets acked", failures);
+    check(clientConnection.getRoundTripMilliseconds() > 0.0f && clientConnection.getRoundTripMilliseconds() < 100.0f,
+          "round trip " + std::to_string(clientConnection.getRoundTripMilliseconds()) + " ms", failures);
+
+    // Before hearing anything back a packet acks nothing, even though its ack field is 0
+    NetConnection first, second;
+    first.reset(address, 0.0);
+    second.reset(address, 0.0);
+    first.nextHeader(PacketType::PAYLOAD, 0.0);
+    PacketHeader early = second.nextHeader(PacketType::PAYLOAD, 0.0);
+    first.processHeader(early, 0.1);
+    PacketHeader reply = first.nextHeader(PacketType::PAYLOAD, 0.1);
+    second.processHeader(reply, 0.2);
+    PacketHeader answer = second.nextHeader(PacketType::PAYLOAD, 0.2);
+    first.processHeader(answer, 0.3);
+    check(!early.hasAck && first.getPacketsAcked() == 1 && second.getPacketsAcked() == 1,
+          "nothing gets acked until the other side has heard from us", failures);
+
+    // ==========================================================================================
+    // Full, disconnect, timeout
+    // ==========================================================================================
+    BotClient extra(1);
+    extra.connect(address, ComfyServer::clockSeconds());
+    std::vector<BotClient *> withExtra = clients;
+    withExtra.push_back(&extra);
+    pump(server, withExtra, 0.3);
+    check(extra.getNet().getState() == NetClientState::DENIED, "a full server denies the next client", failures);
+
+    clients.back()->disconnect(ComfyServer::clockSeconds());
+    clients.pop_back();
+    pump(server, clients, 0.2);
+    check(server.getNet().getConnectedCount() == clientCount - 1 && server.getBodyCount() == clientCount - 1,
+          "disconnecting removes the client and its body", failures);
+
+    // Client 0 goes quiet
+    std::vector<BotClient *> others(clients.begin() + 1, clients.end());
+    pump(server, others, 1.5);
+    check(server.getNet().getConnectedCount() == clientCount - 2 && server.getBodyCount() == clientCount - 2,
+          "a silent client times out", failures);
+
+    LogSink::write(failures == 0 ? "Loopback self test passed" : std::to_string(failures) + " loopback checks failed",
+                   failures == 0 ? ErrorCode::SUCCESS : ErrorCode::ERROR);
+    return failures == 0;
+}
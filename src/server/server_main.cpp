@@ -0,0 +1,186 @@
+#include "server/bot_client.h"
+#include "server/comfy_server.h"
+#include "server/net_self_test.h"
+#include "utils/log_sink.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+
+static ComfyServer *activeServer = nullptr;
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void handleSignal(int)
+{
+    stopRequested = 1;
+    if (activeServer) activeServer->stop();
+}
+
+// Peak resident memory in KB (ru_maxrss is bytes on macOS, KB everywhere else)
+static long peakMemoryKilobytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static void printUsage()
+{
+    std::printf("ComfyServer [--map path.json] [--data dir] [--bots count] [--ticks count] [--port port] [--max-clients count]\n");
+    std::printf("ComfyServer --connect host:port [--clients count] [--ticks count] [--map path.json] [--data dir]\n");
+    std::printf("ComfyServer --selftest [--clients count]\n");
+    std::printf("  --map          Tiled json map (default: assets/map.json)\n");
+    std::printf("  --data         directory with player_data.ini / collision_data.ini (default: Data)\n");
+    std::printf("  --bots         bodies with scripted input to simulate (default: 0)\n");
+    std::printf("  --ticks        stop after this many ticks (default: run until ctrl c)\n");
+    std::printf("  --port         UDP port to listen on, 0 for any, -1 for no network (default: %d)\n", SERVER_DEFAULT_PORT);
+    std::printf("  --max-clients  players that can connect (default: %d)\n", SERVER_DEFAULT_MAX_CLIENTS);
+    std::printf("  --connect      run headless bot clients against a server instead of being one\n");
+    std::printf("  --clients      how many bot clients (default: 4)\n");
+    std::printf("  --selftest     server and clients in this process over loopback, exits 1 on failure\n");
+}
+
+/**
+    --connect: count bot clients against another process at the tick rate, prints what
+    each of them saw at the end. They predict with the same --map / --data the server
+    was started with, otherwise every wall shows up as corrections
+**/
+static int runBotClients(const NetAddress &address, int count, uint64_t ticks, const std::string &mapPath,
+                         const std::string &dataDirectory)
+{
+    // Never listens or ticks, just loads the tuning and map the same way the server does
+    ComfyServer world;
+    world.loadTuning(dataDirectory);
+    world.loadMap(mapPath);
+
+    std::vector<std::unique_ptr<BotClient>> clients;
+    for (int i = 0; i < count; i++)
+    {
+        clients.emplace_back(new BotClient(0x9E3779B9u * (i + 1) ^ (uint32_t)(ComfyServer::clockSeconds() * 1000.0)));
+        clients.back()->setMovement(world.getMovement());
+        clients.back()->connect(address, ComfyServer::clockSeconds());
+    }
+
+    uint64_t tick = 0;
+    const double stepSeconds = 1.0 / SIM_TICK_RATE;
+    double next = ComfyServer::clockSeconds();
+    while (!stopRequested && (ticks == 0 || tick < ticks))
+    {
+        double now = ComfyServer::clockSeconds();
+        for (auto &client : clients) client->update(now);
+        tick++;
+        next += stepSeconds;
+        double wait = next - ComfyServer::clockSeconds();
+        if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    }
+
+    int connected = 0;
+    for (int i = 0; i < count; i++)
+    {
+        BotClient &client = *clients[i];
+        NetConnection &connection = client.getNet().getConnection();
+        connected += client.getNet().isConnected() ? 1 : 0;
+        const ClientPrediction &prediction = client.getPrediction();
+        char line[320];
+        std::snprintf(line, sizeof(line), "Bot %d | client %d | %s | %llu states (%llu deltas, %llu dropped) | %llu corrections (avg %.2f px, max %.2f px) | rtt %.2f ms | %llu sent %llu acked %llu lost",
+                      i, client.getNet().getClientIndex(), client.getNet().isConnected() ? "connected" : "not connected",
+                      (unsigned long long)client.getStatesReceived(), (unsigned long long)client.getDeltasReceived(),
+                      (unsigned long long)client.getStatesDropped(), (unsigned long long)prediction.getCorrections(),
+                      prediction.getAverageCorrection(), prediction.getMaxCorrection(), connection.getRoundTripMilliseconds(),
+                      (unsigned long long)connection.getPacketsSent(), (unsigned long long)connection.getPacketsAcked(),
+                      (unsigned long long)connection.getPacketsLost());
+        LogSink::write(line, ErrorCode::NONE);
+        client.disconnect(ComfyServer::clockSeconds());
+    }
+    return connected == count ? 0 : 1;
+}
+
+/**
+    Dedicated server, no window no renderer. Paths default to the repo layout, a
+    deployed server passes its own
+**/
+int main(int argc, char **argv)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::string mapPath = "assets/map.json";
+    std::string dataDirectory = "Data";
+    std::string connectTo;
+    int bots = 0;
+    int clients = 4;
+    int port = SERVER_DEFAULT_PORT;
+    int maxClients = SERVER_DEFAULT_MAX_CLIENTS;
+    bool selfTest = false;
+    uint64_t ticks = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--map") && hasValue) mapPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--data") && hasValue) dataDirectory = argv[++i];
+        else if (!std::strcmp(argv[i], "--bots") && hasValue) bots = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--ticks") && hasValue) ticks = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--port") && hasValue) port = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--max-clients") && hasValue) maxClients = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--connect") && hasValue) connectTo = argv[++i];
+        else if (!std::strcmp(argv[i], "--clients") && hasValue) clients = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--selftest")) selfTest = true;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    if (selfTest)
+    {
+        return NetSelfTest::run(clients) ? 0 : 1;
+    }
+    if (!connectTo.empty())
+    {
+        NetAddress address;
+        if (!NetAddress::fromString(connectTo, address, SERVER_DEFAULT_PORT))
+        {
+            LogSink::write("Cant read address: " + connectTo, ErrorCode::ERROR);
+            return 1;
+        }
+        return runBotClients(address, clients, ticks, mapPath, dataDirectory);
+    }
+
+    ComfyServer server;
+    server.loadTuning(dataDirectory);
+    server.loadMap(mapPath);
+    server.spawnBots(bots);
+    if (port >= 0 && !server.listen((uint16_t)port, maxClients))
+    {
+        return 1;
+    }
+
+    double startupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    char status[160];
+    std::snprintf(status, sizeof(status), "Server up in %.2f ms | %d bodies | %ld KB peak memory",
+                  startupMs, server.getBodyCount(), peakMemoryKilobytes());
+    LogSink::write(status, ErrorCode::SUCCESS);
+
+    activeServer = &server;
+    if (!stopRequested) server.run(ticks);
+    activeServer = nullptr;
+
+    std::snprintf(status, sizeof(status), "Server stopped at tick %llu | tick %.3f ms avg %.3f ms max | %ld KB peak memory",
+                  (unsigned long long)server.getTick(), server.getAverageTickMilliseconds(),
+                  server.getMaxTickMilliseconds(), peakMemoryKilobytes());
+    LogSink::write(status, ErrorCode::SUCCESS);
+    return 0;
+}
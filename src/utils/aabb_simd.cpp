@@ -0,0 +1,272 @@
+#include "utils/aabb_simd.h"
+#include <algorithm>
+#include <limits>
+
+// COMFY_NO_SIMD forces the plain loops (handy for checking the SIMD paths against them)
+#if defined(COMFY_NO_SIMD)
+    #define AABB_SIMD_LANES 4
+#elif defined(__AVX__)
+    #include <immintrin.h>
+    #define AABB_SIMD_AVX 1
+    #define AABB_SIMD_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define AABB_SIMD_SSE2 1
+    #define AABB_SIMD_LANES 4
+#elif defined(__aarch64__)
+    #include <arm_neon.h>
+    #define AABB_SIMD_NEON 1
+    #define AABB_SIMD_LANES 4
+#else
+    #define AABB_SIMD_LANES 4
+#endif
+
+// Everything gets padded to this so any of the paths can run without a tail loop
+#define AABB_ARRAY_PADDING 8
+
+// =====================================================================================================================
+// AABBArray
+// =====================================================================================================================
+void AABBArray::pad()
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    size_t padded = ((size_t)this->count + AABB_ARRAY_PADDING - 1) / AABB_ARRAY_PADDING * AABB_ARRAY_PADDING;
+    this->minX.resize(this->count);
+    this->minY.resize(this->count);
+    this->maxX.resize(this->count);
+    this->maxY.resize(this->count);
+    this->minX.resize(padded, inf);
+    this->minY.resize(padded, inf);
+    this->maxX.resize(padded, -inf);
+    this->maxY.resize(padded, -inf);
+}
+
+void AABBArray::set(int index, const AABB &box)
+{
+    this->minX[index] = box.minX;
+    this->minY[index] = box.minY;
+    this->maxX[index] = box.maxX;
+    this->maxY[index] = box.maxY;
+}
+
+void AABBArray::clear()
+{
+    this->count = 0;
+    this->pad();
+}
+
+void AABBArray::push(const AABB &box)
+{
+    this->count++;
+    this->pad();
+    this->set(this->count - 1, box);
+}
+
+void AABBArray::assign(const AABB *boxes, int count)
+{
+    this->count = count;
+    this->pad();
+    for (int i = 0; i < count; i++) this->set(i, boxes[i]);
+}
+
+// =====================================================================================================================
+// Kernels
+// =====================================================================================================================
+const char *AABBKernels::getInstructionSet()
+{
+#if defined(AABB_SIMD_AVX)
+    return "AVX (8 wide)";
+#elif defined(AABB_SIMD_SSE2)
+    return "SSE2 (4 wide)";
+#elif defined(AABB_SIMD_NEON)
+    return "NEON (4 wide)";
+#else
+    return "Scalar";
+#endif
+}
+
+static int popCount(uint32_t value)
+{
+    int count = 0;
+    while (value)
+    {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+}
+
+int AABBKernels::overlapMask(const AABBArray &boxes, const AABB &query, uint32_t *mask)
+{
+    int words = boxes.getMaskWords();
+    std::fill(mask, mask + words, 0u);
+
+    const float *minX = boxes.getMinX();
+    const float *minY = boxes.getMinY();
+    const float *maxX = boxes.getMaxX();
+    const float *maxY = boxes.getMaxY();
+    int count = boxes.getCount();
+
+    for (int i = 0; i < count; i += AABB_SIMD_LANES)
+    {
+#if defined(AABB_SIMD_AVX)
+        __m256 hit = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minX + i), _mm256_set1_ps(query.maxX), _CMP_LT_OQ),
+                          _mm256_cmp_ps(_mm256_loadu_ps(maxX + i), _mm256_set1_ps(query.minX), _CMP_GT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minY + i), _mm256_set1_ps(query.maxY), _CMP_LT_OQ),
+                          _mm256_cmp_ps(_mm256_loadu_ps(maxY + i), _mm256_set1_ps(query.minY), _CMP_GT_OQ)));
+        uint32_t bits = (uint32_t)_mm256_movemask_ps(hit);
+#elif defined(AABB_SIMD_SSE2)
+        __m128 hit = _mm_and_ps(
+            _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(minX + i), _mm_set1_ps(query.maxX)),
+                       _mm_cmpgt_ps(_mm_loadu_ps(maxX + i), _mm_set1_ps(query.minX))),
+            _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(minY + i), _mm_set1_ps(query.maxY)),
+                       _mm_cmpgt_ps(_mm_loadu_ps(maxY + i), _mm_set1_ps(query.minY))));
+        uint32_t bits = (uint32_t)_mm_movemask_ps(hit);
+#elif defined(AABB_SIMD_NEON)
+        uint32x4_t hit = vandq_u32(
+            vandq_u32(vcltq_f32(vld1q_f32(minX + i), vdupq_n_f32(query.maxX)),
+                      vcgtq_f32(vld1q_f32(maxX + i), vdupq_n_f32(query.minX))),
+            vandq_u32(vcltq_f32(vld1q_f32(minY + i), vdupq_n_f32(query.maxY)),
+                      vcgtq_f32(vld1q_f32(maxY + i), vdupq_n_f32(query.minY))));
+        // No movemask on NEON, take the top bit of each lane and shift it into place
+        const int32_t shifts[4] = {0, 1, 2, 3};
+        uint32_t bits = vaddvq_u32(vshlq_u32(vshrq_n_u32(hit, 31), vld1q_s32(shifts)));
+#else
+        uint32_t bits = 0;
+        for (int lane = 0; lane < AABB_SIMD_LANES; lane++)
+        {
+            int j = i + lane;
+            if (minX[j] < query.maxX && maxX[j] > query.minX && minY[j] < query.maxY && maxY[j] > query.minY)
+                bits |= 1u << lane;
+        }
+#endif
+        mask[i >> 5] |= bits << (i & 31);
+    }
+
+    // Padding lanes can never hit but clear anything past count just to be safe
+    if (count & 31) mask[words - 1] &= (1u << (count & 31)) - 1u;
+
+    int hits = 0;
+    for (int w = 0; w < words; w++) hits += popCount(mask[w]);
+    return hits;
+}
+
+/**
+    The SIMD part works out which boxes leave the map and where every box sits in tile
+    space, then each box inside the map walks the handful of tiles it covers.
+    Same rules as Collision::overlapsGrid, touching a tile edge is not a hit
+**/
+int AABBKernels::tileGridMask(const AABBArray &boxes, const CollisionGrid &grid, uint32_t *mask)
+{
+    int words = boxes.getMaskWords();
+    std::fill(mask, mask + words, 0u);
+    if (grid.isEmpty()) return 0;
+
+    const float *minX = boxes.getMinX();
+    const float *minY = boxes.getMinY();
+    const float *maxX = boxes.getMaxX();
+    const float *maxY = boxes.getMaxY();
+    int count = boxes.getCount();
+
+    const float invTileWidth = 1.0f / grid.getTileWidth();
+    const float invTileHeight = 1.0f / grid.getTileHeight();
+    const float mapWidth = (float)(grid.getWidth() * grid.getTileWidth());
+    const float mapHeight = (float)(grid.getHeight() * grid.getTileHeight());
+
+    float tileMinX[AABB_SIMD_LANES], tileMinY[AABB_SIMD_LANES], tileMaxX[AABB_SIMD_LANES], tileMaxY[AABB_SIMD_LANES];
+
+    for (int i = 0; i < count; i += AABB_SIMD_LANES)
+    {
+#if defined(AABB_SIMD_AVX)
+        __m256 bMinX = _mm256_loadu_ps(minX + i), bMinY = _mm256_loadu_ps(minY + i);
+        __m256 bMaxX = _mm256_loadu_ps(maxX + i), bMaxY = _mm256_loadu_ps(maxY + i);
+        __m256 zero = _mm256_setzero_ps();
+        __m256 outside = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(bMinX, zero, _CMP_LT_OQ), _mm256_cmp_ps(bMinY, zero, _CMP_LT_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(bMaxX, _mm256_set1_ps(mapWidth), _CMP_GT_OQ), _mm256_cmp_ps(bMaxY, _mm256_set1_ps(mapHeight), _CMP_GT_OQ)));
+        uint32_t outsideBits = (uint32_t)_mm256_movemask_ps(outside);
+        _mm256_storeu_ps(tileMinX, _mm256_mul_ps(bMinX, _mm256_set1_ps(invTileWidth)));
+        _mm256_storeu_ps(tileMinY, _mm256_mul_ps(bMinY, _mm256_set1_ps(invTileHeight)));
+        _mm256_storeu_ps(tileMaxX, _mm256_mul_ps(bMaxX, _mm256_set1_ps(invTileWidth)));
+        _mm256_storeu_ps(tileMaxY, _mm256_mul_ps(bMaxY, _mm256_set1_ps(invTileHeight)));
+#elif defined(AABB_SIMD_SSE2)
+        __m128 bMinX = _mm_loadu_ps(minX + i), bMinY = _mm_loadu_ps(minY + i);
+        __m128 bMaxX = _mm_loadu_ps(maxX + i), bMaxY = _mm_loadu_ps(maxY + i);
+        __m128 zero = _mm_setzero_ps();
+        __m128 outside = _mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(bMinX, zero), _mm_cmplt_ps(bMinY, zero)),
+            _mm_or_ps(_mm_cmpgt_ps(bMaxX, _mm_set1_ps(mapWidth)), _mm_cmpgt_ps(bMaxY, _mm_set1_ps(mapHeight))));
+        uint32_t outsideBits = (uint32_t)_mm_movemask_ps(outside);
+        _mm_storeu_ps(tileMinX, _mm_mul_ps(bMinX, _mm_set1_ps(invTileWidth)));
+        _mm_storeu_ps(tileMinY, _mm_mul_ps(bMinY, _mm_set1_ps(invTileHeight)));
+        _mm_storeu_ps(tileMaxX, _mm_mul_ps(bMaxX, _mm_set1_ps(invTileWidth)));
+        _mm_storeu_ps(tileMaxY, _mm_mul_ps(bMaxY, _mm_set1_ps(invTileHeight)));
+#elif defined(AABB_SIMD_NEON)
+        float32x4_t bMinX = vld1q_f32(minX + i), bMinY = vld1q_f32(minY + i);
+        float32x4_t bMaxX = vld1q_f32(maxX + i), bMaxY = vld1q_f32(maxY + i);
+        float32x4_t zero = vdupq_n_f32(0.0f);
+        uint32x4_t outside = vorrq_u32(
+            vorrq_u32(vcltq_f32(bMinX, zero), vcltq_f32(bMinY, zero)),
+            vorrq_u32(vcgtq_f32(bMaxX, vdupq_n_f32(mapWidth)), vcgtq_f32(bMaxY, vdupq_n_f32(mapHeight))));
+        const int32_t shifts[4] = {0, 1, 2, 3};
+        uint32_t outsideBits = vaddvq_u32(vshlq_u32(vshrq_n_u32(outside, 31), vld1q_s32(shifts)));
+        vst1q_f32(tileMinX, vmulq_n_f32(bMinX, invTileWidth));
+        vst1q_f32(tileMinY, vmulq_n_f32(bMinY, invTileHeight));
+        vst1q_f32(tileMaxX, vmulq_n_f32(bMaxX, invTileWidth));
+        vst1q_f32(tileMaxY, vmulq_n_f32(bMaxY, invTileHeight));
+#else
+        uint32_t outsideBits = 0;
+        for (int lane = 0; lane < AABB_SIMD_LANES; lane++)
+        {
+            int j = i + lane;
+            if (minX[j] < 0 || minY[j] < 0 || maxX[j] > mapWidth || maxY[j] > mapHeight) outsideBits |= 1u << lane;
+            tileMinX[lane] = minX[j] * invTileWidth;
+            tileMinY[lane] = minY[j] * invTileHeight;
+            tileMaxX[lane] = maxX[j] * invTileWidth;
+            tileMaxY[lane] = maxY[j] * invTileHeight;
+        }
+#endif
+        uint32_t bits = 0;
+        int lanes = std::min(AABB_SIMD_LANES, count - i);
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            if (outsideBits & (1u << lane))
+            {
+                bits |= 1u << lane;
+                continue;
+            }
+
+            int startX = (int)tileMinX[lane];
+            int startY = (int)tileMinY[lane];
+            int endX = (int)tileMaxX[lane];
+            int endY = (int)tileMaxY[lane];
+            // A box ending exactly on a tile edge doesnt touch the next tile
+            if ((float)endX == tileMaxX[lane]) endX--;
+            if ((float)endY == tileMaxY[lane]) endY--;
+            endX = std::min(endX, grid.getWidth() - 1);
+            endY = std::min(endY, grid.getHeight() - 1);
+
+            const uint8_t *cells = grid.getCells();
+            bool hit = false;
+            for (int y = startY; y <= endY && !hit; y++)
+            {
+                const uint8_t *row = cells + y * grid.getWidth();
+                for (int x = startX; x <= endX; x++)
+                {
+                    if (row[x])
+                    {
+                        hit = true;
+                        break;
+                    }
+                }
+            }
+            if (hit) bits |= 1u << lane;
+        }
+        mask[i >> 5] |= bits << (i & 31);
+    }
+
+    int hits = 0;
+    for (int w = 0; w < words; w++) hits += popCount(mask[w]);
+    return hits;
+}
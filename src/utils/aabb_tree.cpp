@@ -0,0 +1,503 @@
+#include "utils/aabb_tree.h"
+#include <algorithm>
+#include <cmath>
+
+// Moving proxies get their fat box stretched this many ticks ahead
+#define DISPLACEMENT_MULTIPLIER 2.0f
+
+static AABB combine(const AABB &a, const AABB &b)
+{
+    return AABB{std::min(a.minX, b.minX), std::min(a.minY, b.minY), std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+}
+
+static float perimeter(const AABB &box)
+{
+    return 2.0f * (box.getWidth() + box.getHeight());
+}
+
+// Squared distance from a point to a box, 0 if the point is inside
+static float distanceSquared(const AABB &box, float x, float y)
+{
+    float dx = std::max(std::max(box.minX - x, 0.0f), x - box.maxX);
+    float dy = std::max(std::max(box.minY - y, 0.0f), y - box.maxY);
+    return dx * dx + dy * dy;
+}
+
+/**
+    Slab test of the segment start + t * delta (t in 0 -> maxFraction) against a box,
+    gives back the t where the segment enters the box
+**/
+static bool raySlab(const AABB &box, float startX, float startY, float invDeltaX, float invDeltaY, float maxFraction, float &entry)
+{
+    float tx1 = (box.minX - startX) * invDeltaX;
+    float tx2 = (box.maxX - startX) * invDeltaX;
+    float ty1 = (box.minY - startY) * invDeltaY;
+    float ty2 = (box.maxY - startY) * invDeltaY;
+
+    float tMin = std::max(std::min(tx1, tx2), std::min(ty1, ty2));
+    float tMax = std::min(std::max(tx1, tx2), std::max(ty1, ty2));
+
+    // NaN shows up when the ray starts exactly on a slab it is parallel to, treat it as inside
+    if (std::isnan(tMin)) tMin = 0.0f;
+    if (std::isnan(tMax)) tMax = maxFraction;
+
+    if (tMax < 0.0f || tMin > tMax || tMin > maxFraction) return false;
+    entry = std::max(tMin, 0.0f);
+    return true;
+}
+
+/**
+    Traversal stack for the queries, lives on the stack unless the tree gets
+    unreasonably deep so queries dont allocate
+**/
+class TraversalStack
+{
+private:
+    int fixed[256];
+    std::vector<int> overflow;
+    int count = 0;
+
+public:
+    void push(int value)
+    {
+        if (count < 256) fixed[count] = value;
+        else overflow.push_back(value);
+        count++;
+    }
+    int pop()
+    {
+        count--;
+        if (count < 256) return fixed[count];
+        int value = overflow.back();
+        overflow.pop_back();
+        return value;
+    }
+    bool empty() const { return count == 0; }
+};
+
+AABBTree::AABBTree(float margin)
+: margin(margin)
+{
+}
+
+// =====================================================================================================================
+// Node Pool
+// =====================================================================================================================
+int AABBTree::allocateNode()
+{
+    if (this->freeList == NULL_NODE)
+    {
+        Node node;
+        node.parent = NULL_NODE;
+        node.height = -1;
+        this->nodes.push_back(node);
+        this->freeList = (int)this->nodes.size() - 1;
+    }
+
+    int node = this->freeList;
+    this->freeList = this->nodes[node].parent;
+    this->nodes[node].parent = NULL_NODE;
+    this->nodes[node].child1 = NULL_NODE;
+    this->nodes[node].child2 = NULL_NODE;
+    this->nodes[node].height = 0;
+    this->nodes[node].userData = 0;
+    return node;
+}
+
+void AABBTree::freeNode(int node)
+{
+    this->nodes[node].parent = this->freeList;
+    this->nodes[node].height = -1;
+    this->freeList = node;
+}
+
+void AABBTree::clear()
+{
+    this->nodes.clear();
+    this->root = NULL_NODE;
+    this->freeList = NULL_NODE;
+    this->proxyCount = 0;
+}
+
+// =====================================================================================================================
+// Proxies
+// =====================================================================================================================
+int AABBTree::createProxy(const AABB &box, int userData)
+{
+    int proxy = this->allocateNode();
+    Node &node = this->nodes[proxy];
+    node.box = box;
+    node.fatBox = AABB{box.minX - margin, box.minY - margin, box.maxX + margin, box.maxY + margin};
+    node.userData = userData;
+
+    this->insertLeaf(proxy);
+    this->proxyCount++;
+    return proxy;
+}
+
+void AABBTree::destroyProxy(int proxy)
+{
+    this->removeLeaf(proxy);
+    this->freeNode(proxy);
+    this->proxyCount--;
+}
+
+bool AABBTree::moveProxy(int proxy, const AABB &box, float dx, float dy)
+{
+    Node &node = this->nodes[proxy];
+    node.box = box;
+
+    // Still inside the fat box so the tree doesnt need to know
+    if (node.fatBox.contains(box)) return false;
+
+    this->removeLeaf(proxy);
+
+    // Grow by the margin and stretch it the way we are moving so next tick is free too
+    AABB fat = AABB{box.minX - margin, box.minY - margin, box.maxX + margin, box.maxY + margin};
+    float predictX = dx * DISPLACEMENT_MULTIPLIER;
+    float predictY = dy * DISPLACEMENT_MULTIPLIER;
+    if (predictX < 0) fat.minX += predictX; else fat.maxX += predictX;
+    if (predictY < 0) fat.minY += predictY; else fat.maxY += predictY;
+    this->nodes[proxy].fatBox = fat;
+
+    this->insertLeaf(proxy);
+    return true;
+}
+
+// =====================================================================================================================
+// Tree Building
+// =====================================================================================================================
+
+/**
+    Walks down picking the child that would grow the least (surface area heuristic),
+    stops once making a new parent right here is cheaper than going further down
+**/
+void AABBTree::insertLeaf(int leaf)
+{
+    if (this->root == NULL_NODE)
+    {
+        this->root = leaf;
+        this->nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    AABB leafBox = this->nodes[leaf].fatBox;
+    int index = this->root;
+    while (!this->nodes[index].isLeaf())
+    {
+        int child1 = this->nodes[index].child1;
+        int child2 = this->nodes[index].child2;
+
+        float area = perimeter(this->nodes[index].fatBox);
+        float combinedArea = perimeter(combine(this->nodes[index].fatBox, leafBox));
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // Cost every child further down pays for this node growing
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float cost1 = perimeter(combine(leafBox, this->nodes[child1].fatBox)) + inheritanceCost;
+        if (!this->nodes[child1].isLeaf()) cost1 -= perimeter(this->nodes[child1].fatBox);
+        float cost2 = perimeter(combine(leafBox, this->nodes[child2].fatBox)) + inheritanceCost;
+        if (!this->nodes[child2].isLeaf()) cost2 -= perimeter(this->nodes[child2].fatBox);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int sibling = index;
+    int oldParent = this->nodes[sibling].parent;
+    int newParent = this->allocateNode();
+    this->nodes[newParent].parent = oldParent;
+    this->nodes[newParent].fatBox = combine(leafBox, this->nodes[sibling].fatBox);
+    this->nodes[newParent].height = this->nodes[sibling].height + 1;
+    this->nodes[newParent].child1 = sibling;
+    this->nodes[newParent].child2 = leaf;
+    this->nodes[sibling].parent = newParent;
+    this->nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE)
+    {
+        if (this->nodes[oldParent].child1 == sibling) this->nodes[oldParent].child1 = newParent;
+        else this->nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        this->root = newParent;
+    }
+
+    // Refit everything on the way back up
+    index = this->nodes[leaf].parent;
+    while (index != NULL_NODE)
+    {
+        index = this->balance(index);
+        Node &node = this->nodes[index];
+        node.height = 1 + std::max(this->nodes[node.child1].height, this->nodes[node.child2].height);
+        node.fatBox = combine(this->nodes[node.child1].fatBox, this->nodes[node.child2].fatBox);
+        index = node.parent;
+    }
+}
+
+void AABBTree::removeLeaf(int leaf)
+{
+    if (leaf == this->root)
+    {
+        this->root = NULL_NODE;
+        return;
+    }
+
+    int parent = this->nodes[leaf].parent;
+    int grandParent = this->nodes[parent].parent;
+    int sibling = this->nodes[parent].child1 == leaf ? this->nodes[parent].child2 : this->nodes[parent].child1;
+
+    if (grandParent == NULL_NODE)
+    {
+        this->root = sibling;
+        this->nodes[sibling].parent = NULL_NODE;
+        this->freeNode(parent);
+        return;
+    }
+
+    // The sibling takes the parents spot
+    if (this->nodes[grandParent].child1 == parent) this->nodes[grandParent].child1 = sibling;
+    else this->nodes[grandParent].child2 = sibling;
+    this->nodes[sibling].parent = grandParent;
+    this->freeNode(parent);
+
+    int index = grandParent;
+    while (index != NULL_NODE)
+    {
+        index = this->balance(index);
+        Node &node = this->nodes[index];
+        node.height = 1 + std::max(this->nodes[node.child1].height, this->nodes[node.child2].height);
+        node.fatBox = combine(this->nodes[node.child1].fatBox, this->nodes[node.child2].fatBox);
+        index = node.parent;
+    }
+}
+
+/**
+    AVL style rotation, if one side of the node is more than one level taller than the
+    other the taller child gets rotated up. Returns whatever node is now in that spot
+**/
+int AABBTree::balance(int iA)
+{
+    Node &A = this->nodes[iA];
+    if (A.isLeaf() || A.height < 2) return iA;
+
+    int iB = A.child1;
+    int iC = A.child2;
+    Node &B = this->nodes[iB];
+    Node &C = this->nodes[iC];
+    int difference = C.height - B.height;
+
+    // ==========================================================================================
+    // Rotate C up
+    // ==========================================================================================
+    if (difference > 1)
+    {
+        int iF = C.child1;
+        int iG = C.child2;
+        Node &F = this->nodes[iF];
+        Node &G = this->nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != NULL_NODE)
+        {
+            if (this->nodes[C.parent].child1 == iA) this->nodes[C.parent].child1 = iC;
+            else this->nodes[C.parent].child2 = iC;
+        }
+        else
+        {
+            this->root = iC;
+        }
+
+        if (F.height > G.height)
+        {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.fatBox = combine(B.fatBox, G.fatBox);
+            C.fatBox = combine(A.fatBox, F.fatBox);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.fatBox = combine(B.fatBox, F.fatBox);
+            C.fatBox = combine(A.fatBox, G.fatBox);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+        return iC;
+    }
+
+    // ==========================================================================================
+    // Rotate B up
+    // ==========================================================================================
+    if (difference < -1)
+    {
+        int iD = B.child1;
+        int iE = B.child2;
+        Node &D = this->nodes[iD];
+        Node &E = this->nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != NULL_NODE)
+        {
+            if (this->nodes[B.parent].child1 == iA) this->nodes[B.parent].child1 = iB;
+            else this->nodes[B.parent].child2 = iB;
+        }
+        else
+        {
+            this->root = iB;
+        }
+
+        if (D.height > E.height)
+        {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.fatBox = combine(C.fatBox, E.fatBox);
+            B.fatBox = combine(A.fatBox, D.fatBox);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.fatBox = combine(C.fatBox, D.fatBox);
+            B.fatBox = combine(A.fatBox, E.fatBox);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+// =====================================================================================================================
+// Queries
+// =====================================================================================================================
+void AABBTree::query(const AABB &box, std::vector<int> &results) const
+{
+    results.clear();
+    if (this->root == NULL_NODE) return;
+
+    TraversalStack stack;
+    stack.push(this->root);
+    while (!stack.empty())
+    {
+        const Node &node = this->nodes[stack.pop()];
+        if (!node.fatBox.overlaps(box)) continue;
+
+        if (node.isLeaf())
+        {
+            if (node.box.overlaps(box)) results.push_back((int)(&node - this->nodes.data()));
+        }
+        else
+        {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+AABBTree::RayCastResult AABBTree::rayCast(float x1, float y1, float x2, float y2) const
+{
+    RayCastResult result;
+    if (this->root == NULL_NODE) return result;
+
+    float invDeltaX = 1.0f / (x2 - x1);
+    float invDeltaY = 1.0f / (y2 - y1);
+
+    TraversalStack stack;
+    stack.push(this->root);
+    while (!stack.empty())
+    {
+        int index = stack.pop();
+        const Node &node = this->nodes[index];
+
+        // Anything the ray reaches after the closest hit so far can be skipped
+        float entry;
+        if (!raySlab(node.fatBox, x1, y1, invDeltaX, invDeltaY, result.fraction, entry)) continue;
+
+        if (node.isLeaf())
+        {
+            if (!raySlab(node.box, x1, y1, invDeltaX, invDeltaY, result.fraction, entry)) continue;
+            if (!result.hit || entry < result.fraction)
+            {
+                result.hit = true;
+                result.proxy = index;
+                result.fraction = entry;
+            }
+        }
+        else
+        {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+    return result;
+}
+
+/**
+    Branch and bound, the distance to a fat box is never more than the distance to
+    anything inside it so any subtree further away than the best so far is skipped.
+    The closer child gets visited first so the best distance shrinks quickly
+**/
+AABBTree::NearestResult AABBTree::nearest(float x, float y, float maxDistance) const
+{
+    NearestResult result;
+    if (this->root == NULL_NODE) return result;
+
+    float bestSquared = maxDistance * maxDistance;
+
+    TraversalStack stack;
+    stack.push(this->root);
+    while (!stack.empty())
+    {
+        int index = stack.pop();
+        const Node &node = this->nodes[index];
+        if (distanceSquared(node.fatBox, x, y) > bestSquared) continue;
+
+        if (node.isLeaf())
+        {
+            float d = distanceSquared(node.box, x, y);
+            if (d <= bestSquared)
+            {
+                bestSquared = d;
+                result.proxy = index;
+            }
+            continue;
+        }
+
+        float d1 = distanceSquared(this->nodes[node.child1].fatBox, x, y);
+        float d2 = distanceSquared(this->nodes[node.child2].fatBox, x, y);
+        // Pushed last gets popped first
+        if (d1 < d2)
+        {
+            stack.push(node.child2);
+            stack.push(node.child1);
+        }
+        else
+        {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+
+    if (result.proxy != NULL_NODE) result.distance = std::sqrt(bestSquared);
+    return result;
+}
@@ -34,8 +34,9 @@ void Camera::update(int width, int height, float gameScale)
     // so in most cases the width and the height is the viewport size
 
     // Get entity's center position (assuming entity position is top-left)
-    float entityCenterX = this->entity->getX() + (this->entity->getWidth() / 2);
-    float entityCenterY = this->entity->getY() + (this->entity->getHeight() / 2);
+    // (the interpolated one, following the last tick would make the entity jitter on screen)
+    float entityCenterX = this->entity->getRenderX() + (this->entity->getWidth() / 2);
+    float entityCenterY = this->entity->getRenderY() + (this->entity->getHeight() / 2);
     
     // Calculate camera position to center the entity
     // Divide by gameScale if your entity positions are in scaled world coordinates
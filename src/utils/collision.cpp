@@ -4,19 +4,33 @@
 #include "entity/player.h"
 #include "TSDL.h"
 // End of last checked required includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+    How far (in world units) a box can be inside a tile and still count as just
+    touching it. Float error after stopping on a wall leaves us a hair inside of it
+    and without this we would snag on the seams between tiles while sliding
+**/
+static const float CONTACT_SLOP = 0.01f;
+
+// Debug colors for what the checks looked at
+static const DebugDrawColor SWEEP_AREA_COLOR = {255, 255, 0, 128};
+static const DebugDrawColor TESTED_TILE_COLOR = {0, 255, 0, 128};
+static const DebugDrawColor HIT_TILE_COLOR = {255, 0, 0, 96};
 
 Collision::Collision(Player *player) 
 { 
     this->player = player; 
-    this->setPlayerCollision();
 
     if (!fetchCollisionConfigs(this))
     {
         SM_WARN("No collision_data.ini found. Using default collision.");
-        this->width = 200;
-        this->height = 200;
-        this->xOffset = 0;
-        this->yOffset = 0;
+        this->setWidth(200);
+        this->setHeight(200);
+        this->setXOffset(0);
+        this->setYOffset(0);
     } else {
         std::cout << "Collision width: " << this->getWidth() << std::endl;
         std::cout << "Collision height: " << this->getHeight() << std::endl;
@@ -27,125 +41,300 @@ Collision::Collision(Player *player)
 
 // Getters
 bool Collision::getShowingCollision() {return showCollision;}
-SDL_Color Collision::getCollisionColor() {return collisionColor;}
+DebugDrawColor Collision::getCollisionColor() {return collisionColor;}
+DebugDraw *Collision::getDebugDraw() {return &debugDraw;}
 Player* Collision::getPlayer() {return player;}
-float Collision::getWidth() {return width;}
-float Collision::getHeight() {return height;}
-float Collision::getXOffset() {return xOffset;}
-float Collision::getYOffset() {return yOffset;}
+float Collision::getWidth() {return player->getStore()->getColliders().width[colliderSlot()];}
+float Collision::getHeight() {return player->getStore()->getColliders().height[colliderSlot()];}
+float Collision::getXOffset() {return player->getStore()->getColliders().offsetX[colliderSlot()];}
+float Collision::getYOffset() {return player->getStore()->getColliders().offsetY[colliderSlot()];}
 // Setters
 void Collision::setShowingCollision(bool showCollision) {this->showCollision = showCollision;}
-void Collision::setCollisionColor(SDL_Color collisionColor) {this->collisionColor = collisionColor;}
+void Collision::setCollisionColor(DebugDrawColor collisionColor) {this->collisionColor = collisionColor;}
 void Collision::setPlayer(Player *player) {this->player = player;}
-void Collision::setWidth(float width) {this->width = width;}
-void Collision::setHeight(float height) {this->height = height;}
-void Collision::setXOffset(float xOffset) {this->xOffset = xOffset;}
-void Collision::setYOffset(float yOffset) {this->yOffset = yOffset;}
+void Collision::setWidth(float width) {player->getStore()->getColliders().width[colliderSlot()] = width;}
+void Collision::setHeight(float height) {player->getStore()->getColliders().height[colliderSlot()] = height;}
+void Collision::setXOffset(float xOffset) {player->getStore()->getColliders().offsetX[colliderSlot()] = xOffset;}
+void Collision::setYOffset(float yOffset) {player->getStore()->getColliders().offsetY[colliderSlot()] = yOffset;}
 
 // Methods
-void Collision::setPlayerCollision()
+int Collision::colliderSlot()
+{
+    return this->player->getStore()->slotOf(this->player->getHandle());
+}
+
+AABB Collision::getBounds()
+{
+    const ColliderComponents &colliders = this->player->getStore()->getColliders();
+    int slot = this->colliderSlot();
+    return AABB::fromRect(
+        this->player->getX() + colliders.offsetX[slot],
+        this->player->getY() + colliders.offsetY[slot],
+        colliders.width[slot],
+        colliders.height[slot]
+    );
+}
+
+void Collision::recordPlayerCollision()
+{
+    if (!this->showCollision) return;
+    this->debugDraw.addRect(this->getBounds(), this->collisionColor);
+}
+
+SweepResult Collision::sweepMapLayer(TSDL_TileMap *tileMap, float dx, float dy)
+{
+    if (!tileMap) return SweepResult();
+    return sweepGrid(tileMap->collisionGrid, this->getBounds(), dx, dy, this->showCollision ? &this->debugDraw : nullptr);
+}
+
+// ==========================================================================================
+// Separating axis tests against a single tile shape
+// ==========================================================================================
+
+/**
+    Slower than this (world units per move) along an axis counts as not moving on it,
+    after sliding along a slope whats left of the move into it is just float error
+    and dividing by it would throw the entry time way off
+**/
+static const float MIN_AXIS_SPEED = 0.00001f;
+
+/**
+    When does the box interval start and stop overlapping the shape interval on one axis,
+    as a fraction of the move. Returns false if they can never overlap on this axis
+**/
+static bool sweepAxis(float boxMin, float boxMax, float shapeMin, float shapeMax, float speed, float &gap, float &entry, float &exit)
 {
-    float scale = this->player->getPlayerScale();
-    if (this->getPlayer()->getCamera())
+    const float infinity = std::numeric_limits<float>::infinity();
+    if (std::fabs(speed) > MIN_AXIS_SPEED)
     {
-        DebugGUI::addDebugLog("Player camera is not null", ErrorCode::NONE);
-        this->playerCollisionRect = {
-            ((this->player->getX() - this->player->getCamera()->getX()) * scale) + (this->getXOffset() * scale),
-            ((this->player->getY() - this->player->getCamera()->getY()) * scale) + (this->getYOffset() * scale),
-            this->getWidth() * scale,
-            this->getHeight() * scale
-        };
-    } 
-    else 
+        // Distance to the near face and far face in the direction we are moving
+        gap = speed > 0 ? shapeMin - boxMax : boxMin - shapeMax;
+        float far = speed > 0 ? shapeMax - boxMin : boxMax - shapeMin;
+        entry = gap / std::fabs(speed);
+        exit = far / std::fabs(speed);
+        return true;
+    }
+
+    // Not moving on this axis so we either always overlap or never do
+    if (boxMin >= shapeMax - CONTACT_SLOP || boxMax <= shapeMin + CONTACT_SLOP) return false;
+    gap = -infinity;
+    entry = -infinity;
+    exit = infinity;
+    return true;
+}
+
+/**
+    Swept SAT of a box against one shape sitting at (originX, originY)
+
+    Same idea as a swept AABB, just with more axes: the box only hits the shape if
+    every axis overlaps at the same time, so the hit time is the latest entry and the
+    normal is the axis that entered last. Returns true if this is an earlier hit than
+    what result already has.
+**/
+static bool sweepShape(const AABB &box, float dx, float dy, const TileShape &shape, float originX, float originY, SweepResult &result)
+{
+    float entry, exit, gap;
+    float axisEntry, axisExit, axisGap;
+    float normalX, normalY;
+
+    // X Axis
+    if (!sweepAxis(box.minX, box.maxX, originX + shape.bounds.minX, originX + shape.bounds.maxX, dx, gap, entry, exit)) return false;
+    normalX = dx > 0 ? -1.0f : 1.0f;
+    normalY = 0.0f;
+
+    // Y Axis
+    if (!sweepAxis(box.minY, box.maxY, originY + shape.bounds.minY, originY + shape.bounds.maxY, dy, axisGap, axisEntry, axisExit)) return false;
+    if (axisEntry > entry)
     {
-        DebugGUI::addDebugLog("Player camera is null", ErrorCode::COLLISION_ERROR);
+        entry = axisEntry;
+        gap = axisGap;
+        normalX = 0.0f;
+        normalY = dy > 0 ? -1.0f : 1.0f;
     }
+    exit = std::min(exit, axisExit);
+
+    // Edge normals of the shape, the box projects to its center +- its half size
+    // squashed onto the axis
+    float centerX = (box.minX + box.maxX) * 0.5f;
+    float centerY = (box.minY + box.maxY) * 0.5f;
+    float halfWidth = box.getWidth() * 0.5f;
+    float halfHeight = box.getHeight() * 0.5f;
+    for (int i = 0; i < shape.axisCount; i++)
+    {
+        float axisX = shape.axes[i * 2];
+        float axisY = shape.axes[i * 2 + 1];
+        float center = centerX * axisX + centerY * axisY;
+        float radius = halfWidth * std::fabs(axisX) + halfHeight * std::fabs(axisY);
+        float offset = originX * axisX + originY * axisY;
+        float speed = dx * axisX + dy * axisY;
+
+        if (!sweepAxis(center - radius, center + radius, offset + shape.axisMin[i], offset + shape.axisMax[i], speed, axisGap, axisEntry, axisExit)) return false;
+        if (axisEntry > entry)
+        {
+            entry = axisEntry;
+            gap = axisGap;
+            normalX = speed > 0 ? -axisX : axisX;
+            normalY = speed > 0 ? -axisY : axisY;
+        }
+        exit = std::min(exit, axisExit);
+    }
+
+    // Never overlap, overlap after this move, or later than what we already hit
+    if (entry >= exit || entry >= result.time || exit <= 0.0f) return false;
+
+    // Already properly inside this shape (spawned in a wall or the tile was just added)
+    // ignore it so the player can walk back out
+    if (gap < -CONTACT_SLOP) return false;
+
+    result.hit = true;
+    result.time = std::max(0.0f, entry);
+    result.normalX = normalX;
+    result.normalY = normalY;
+    return true;
 }
 
-void Collision::drawPlayerCollision()
+static bool overlapsShape(const AABB &box, const TileShape &shape, float originX, float originY)
 {
-    // If we are not showing the collision then return
-    if (!this->showCollision) return;
+    AABB bounds = shape.bounds;
+    bounds.minX += originX;
+    bounds.maxX += originX;
+    bounds.minY += originY;
+    bounds.maxY += originY;
+    if (!box.overlaps(bounds)) return false;
+
+    float centerX = (box.minX + box.maxX) * 0.5f;
+    float centerY = (box.minY + box.maxY) * 0.5f;
+    float halfWidth = box.getWidth() * 0.5f;
+    float halfHeight = box.getHeight() * 0.5f;
+    for (int i = 0; i < shape.axisCount; i++)
+    {
+        float axisX = shape.axes[i * 2];
+        float axisY = shape.axes[i * 2 + 1];
+        float center = centerX * axisX + centerY * axisY;
+        float radius = halfWidth * std::fabs(axisX) + halfHeight * std::fabs(axisY);
+        float offset = originX * axisX + originY * axisY;
 
-    this->setPlayerCollision();
-    // Set the color of the renderer to the collision color
-    SDL_SetRenderDrawColor(this->player->getRenderer(), this->collisionColor.r, this->collisionColor.g, this->collisionColor.b, this->collisionColor.a);
-    // Draw the rect
-    SDL_RenderDrawRectF(this->player->getRenderer(), &this->playerCollisionRect);
+        // Found a gap, touching does not count
+        if (center + radius <= offset + shape.axisMin[i] || center - radius >= offset + shape.axisMax[i]) return false;
+    }
+    return true;
 }
 
+static AABB shapeBounds(const TileShape &shape, float originX, float originY)
+{
+    return AABB{
+        originX + shape.bounds.minX, originY + shape.bounds.minY,
+        originX + shape.bounds.maxX, originY + shape.bounds.maxY
+    };
+}
+
+/**
+    Swept test against every solid tile and tile shape the move could touch, keeping
+    the earliest hit. Full tiles are just a shape with no extra axes
+**/
+SweepResult Collision::sweepGrid(const CollisionGrid &grid, const AABB &box, float dx, float dy, DebugDraw *debugDraw)
+{
+    SweepResult result;
+    if (grid.isEmpty() || (dx == 0.0f && dy == 0.0f)) return result;
+
+    const float tileWidth = (float)grid.getTileWidth();
+    const float tileHeight = (float)grid.getTileHeight();
+    const TileShape fullTile = TileShape::fromRect(0, 0, tileWidth, tileHeight);
+
+    // Every tile the box could touch along the way, one tile past the map edge
+    // is included since outside the map is solid
+    AABB area = box.swept(dx, dy);
+    int startTileX = std::max(-1, (int)std::floor(area.minX / tileWidth));
+    int endTileX = std::min(grid.getWidth(), (int)std::floor(area.maxX / tileWidth));
+    int startTileY = std::max(-1, (int)std::floor(area.minY / tileHeight));
+    int endTileY = std::min(grid.getHeight(), (int)std::floor(area.maxY / tileHeight));
+
+    if (debugDraw) debugDraw->addRect(area, SWEEP_AREA_COLOR);
+
+    AABB hitShape;
+    for (int y = startTileY; y <= endTileY; y++)
+    {
+        for (int x = startTileX; x <= endTileX; x++)
+        {
+            CollisionCell cell = grid.getCell(x, y);
+            if (cell == CELL_EMPTY) continue;
+
+            float originX = x * tileWidth;
+            float originY = y * tileHeight;
+
+            const TileShape *shapes = &fullTile;
+            int shapeCount = 1;
+            if (cell == CELL_SHAPED) shapeCount = grid.getShapes(x, y, &shapes);
+
+            for (int i = 0; i < shapeCount; i++)
+            {
+                if (debugDraw) debugDraw->addRect(shapeBounds(shapes[i], originX, originY), TESTED_TILE_COLOR);
+                if (sweepShape(box, dx, dy, shapes[i], originX, originY, result))
+                {
+                    hitShape = shapeBounds(shapes[i], originX, originY);
+                }
+            }
+        }
+    }
+
+    if (debugDraw && result.hit) debugDraw->addFilledRect(hitShape, HIT_TILE_COLOR);
+    return result;
+}
 
-// TODO DOES NOT WORK
+/**
+    The scale doesnt change anything here since the player and the tiles would get
+    scaled the same, everything is done in world units
+**/
 bool Collision::collidesWithMapLayer(TSDL_TileMap *tileMap, float scale)
 {
     if (!tileMap || tileMap->layers.empty()) return false;
+    return overlapsGrid(tileMap->collisionGrid, this->getBounds(), this->showCollision ? &this->debugDraw : nullptr);
+}
 
-    // Get Player Bounds - scaled to match render position
-    float playerLeft = (this->getPlayer()->getX() * scale) + (this->getXOffset() * scale);
-    float playerRight = playerLeft + (this->getWidth() * scale);  // Use collision width instead of tile width
-    float playerTop = (this->getPlayer()->getY() * scale) + (this->getYOffset() * scale);
-    float playerBottom = playerTop + (this->getHeight() * scale);  // Use collision height instead of tile height
+bool Collision::overlapsGrid(const CollisionGrid &grid, const AABB &box, DebugDraw *debugDraw)
+{
+    if (grid.isEmpty()) return false;
 
-    // Convert to tile coordinates
-    int startTileX = static_cast<int>(playerLeft / (tileMap->tileWidth * scale));
-    int endTileX = static_cast<int>(playerRight / (tileMap->tileWidth * scale));
-    int startTileY = static_cast<int>(playerTop / (tileMap->tileHeight * scale));
-    int endTileY = static_cast<int>(playerBottom / (tileMap->tileHeight * scale));
-
-    // Ensure we check at least one tile if we're exactly on a boundary
-    if (startTileX == endTileX) endTileX++;
-    if (startTileY == endTileY) endTileY++;
-
-    // Clamp to map bounds
-    startTileX = std::max(0, startTileX);
-    endTileX = std::min(tileMap->width - 1, endTileX);
-    startTileY = std::max(0, startTileY);
-    endTileY = std::min(tileMap->height - 1, endTileY);
-
-    // Debug visualization of collision boxes
-    if (this->getShowingCollision()) {
-        SDL_FRect debugRect = {
-            playerLeft,
-            playerTop,
-            this->getWidth() * scale,
-            this->getHeight() * scale
-        };
-        SDL_SetRenderDrawColor(this->getPlayer()->getRenderer(), 255, 0, 0, 128);
-        SDL_RenderDrawRectF(this->getPlayer()->getRenderer(), &debugRect);
-    }
+    const float tileWidth = (float)grid.getTileWidth();
+    const float tileHeight = (float)grid.getTileHeight();
+    const TileShape fullTile = TileShape::fromRect(0, 0, tileWidth, tileHeight);
 
-    // wanna check if the player is going out of bounds
-    if (playerLeft < 0 || playerRight > tileMap->width * tileMap->tileWidth * scale ||
-        playerTop < 0 || playerBottom > tileMap->height * tileMap->tileHeight * scale) {
+    // wanna check if the box is going out of bounds
+    if (box.minX < 0 || box.maxX > grid.getWidth() * tileWidth ||
+        box.minY < 0 || box.maxY > grid.getHeight() * tileHeight)
+    {
         return true;
     }
 
-    // Check collision layer
-    for (auto &layer : tileMap->layers) {
-        if (layer.name == "Collision") {
-            for (int y = startTileY; y <= endTileY; y++) {
-                for (int x = startTileX; x <= endTileX; x++) {
-                    int tileIndex = layer.data[x + y * layer.width];
-                    if (tileIndex > 0) {
-                        // Calculate tile bounds using the same scaling as drawMap
-                        float tileLeft = (x * tileMap->tileWidth) * scale;
-                        float tileRight = tileLeft + (tileMap->tileWidth * scale);
-                        float tileTop = y * tileMap->tileHeight * scale;
-                        float tileBottom = tileTop + (tileMap->tileHeight * scale);
-
-                        // Debug visualization of tile collision boxes
-                        if (this->getShowingCollision()) {
-                            SDL_FRect tileRect = {tileLeft, tileTop, tileMap->tileWidth * scale, tileMap->tileHeight * scale};
-                            SDL_SetRenderDrawColor(this->getPlayer()->getRenderer(), 0, 255, 0, 128);
-                            SDL_RenderDrawRectF(this->getPlayer()->getRenderer(), &tileRect);
-                        }
-
-                        // Check for overlap
-                        if (playerLeft < tileRight && playerRight > tileLeft &&
-                            playerTop < tileBottom && playerBottom > tileTop) {
-                            return true;
-                        }
-                    }
+    // Convert to tile coordinates
+    int startTileX = (int)(box.minX / tileWidth);
+    int endTileX = std::min(grid.getWidth() - 1, (int)(box.maxX / tileWidth));
+    int startTileY = (int)(box.minY / tileHeight);
+    int endTileY = std::min(grid.getHeight() - 1, (int)(box.maxY / tileHeight));
+
+    for (int y = startTileY; y <= endTileY; y++)
+    {
+        for (int x = startTileX; x <= endTileX; x++)
+        {
+            CollisionCell cell = grid.getCell(x, y);
+            if (cell == CELL_EMPTY) continue;
+
+            float originX = x * tileWidth;
+            float originY = y * tileHeight;
+
+            const TileShape *shapes = &fullTile;
+            int shapeCount = 1;
+            if (cell == CELL_SHAPED) shapeCount = grid.getShapes(x, y, &shapes);
+
+            for (int i = 0; i < shapeCount; i++)
+            {
+                AABB bounds = shapeBounds(shapes[i], originX, originY);
+                if (debugDraw) debugDraw->addRect(bounds, TESTED_TILE_COLOR);
+
+                if (overlapsShape(box, shapes[i], originX, originY))
+                {
+                    if (debugDraw) debugDraw->addFilledRect(bounds, HIT_TILE_COLOR);
+                    return true;
                 }
             }
         }
@@ -0,0 +1,66 @@
+#include "utils/collision_grid.h"
+#include <algorithm>
+#include <atomic>
+
+static uint32_t nextVersion()
+{
+    static std::atomic<uint32_t> counter{0};
+    return ++counter;
+}
+
+void CollisionGrid::build(int width, int height, int tileWidth, int tileHeight, const std::vector<int> &layerData, const TileShapeTable *shapes)
+{
+    this->width = width;
+    this->height = height;
+    this->tileWidth = tileWidth;
+    this->tileHeight = tileHeight;
+    this->version = nextVersion();
+
+    this->cells.assign(static_cast<size_t>(width) * height, CELL_EMPTY);
+    this->cellGids.clear();
+    this->shapes.clear();
+
+    bool hasShapes = shapes && !shapes->isEmpty();
+    if (hasShapes)
+    {
+        this->cellGids.assign(this->cells.size(), 0);
+        this->shapes = *shapes;
+    }
+
+    // The layer might be smaller than the map if it was cropped in Tiled
+    size_t count = std::min(this->cells.size(), layerData.size());
+    for (size_t i = 0; i < count; i++)
+    {
+        int gid = layerData[i];
+        if (gid <= 0) continue;
+
+        if (hasShapes && shapes->hasShapes(gid))
+        {
+            this->cells[i] = CELL_SHAPED;
+            this->cellGids[i] = gid;
+        }
+        else
+        {
+            this->cells[i] = CELL_SOLID;
+        }
+    }
+}
+
+void CollisionGrid::clear()
+{
+    this->width = 0;
+    this->height = 0;
+    this->version = nextVersion();
+    this->cells.clear();
+    this->cellGids.clear();
+    this->shapes.clear();
+}
+
+void CollisionGrid::setSolid(int x, int y, bool solid)
+{
+    if (!this->inBounds(x, y)) return;
+    uint8_t cell = solid ? CELL_SOLID : CELL_EMPTY;
+    if (this->cells[x + y * this->width] == cell) return;
+    this->cells[x + y * this->width] = cell;
+    this->version = nextVersion();
+}
@@ -0,0 +1,32 @@
+#include "utils/debug_draw.h"
+#include "utils/camera.h"
+#include <SDL2/SDL.h>
+
+void DebugDraw::render(SDL_Renderer *renderer, Camera *camera, float scale)
+{
+    if (!renderer)
+    {
+        this->clear();
+        return;
+    }
+
+    float cameraX = camera ? camera->getX() : 0.0f;
+    float cameraY = camera ? camera->getY() : 0.0f;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    for (auto &command : this->commands)
+    {
+        SDL_FRect rect = {
+            (command.box.minX - cameraX) * scale,
+            (command.box.minY - cameraY) * scale,
+            command.box.getWidth() * scale,
+            command.box.getHeight() * scale
+        };
+        SDL_SetRenderDrawColor(renderer, command.color.r, command.color.g, command.color.b, command.color.a);
+        if (command.filled)
+            SDL_RenderFillRectF(renderer, &rect);
+        else
+            SDL_RenderDrawRectF(renderer, &rect);
+    }
+    this->clear();
+}
@@ -0,0 +1,111 @@
+#include "utils/fixed.h"
+
+Fixed Fixed::operator/(Fixed other) const
+{
+    if (other.raw == 0)
+    {
+        return this->raw < 0 ? Fixed::min() : Fixed::max();
+    }
+    // Multiply instead of << so negative numbers arent undefined, then round towards
+    // -infinity to match the >> in operator*
+    int64_t numerator = (int64_t)this->raw * FIXED_ONE;
+    int64_t quotient = numerator / other.raw;
+    if ((numerator % other.raw != 0) && ((numerator < 0) != (other.raw < 0))) quotient--;
+    if (quotient > INT32_MAX) return Fixed::max();
+    if (quotient < INT32_MIN) return Fixed::min();
+    return Fixed::fromRaw((int32_t)quotient);
+}
+
+// Floor of the square root of a 64 bit number, bit by bit
+static uint64_t integerSqrt(uint64_t remainder)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > remainder) bit >>= 2;
+    while (bit != 0)
+    {
+        if (remainder >= root + bit)
+        {
+            remainder -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+Fixed Fixed::sqrt(Fixed value)
+{
+    if (value.raw <= 0) return Fixed();
+    // sqrt(raw / 2^16) * 2^16 = sqrt(raw * 2^16)
+    return Fixed::fromRaw((int32_t)integerSqrt((uint64_t)value.raw << FIXED_FRACTION_BITS));
+}
+
+Fixed Fixed::hypot(Fixed x, Fixed y)
+{
+    // x.raw^2 + y.raw^2 is Q32.32, its square root is already Q16.16
+    uint64_t squared = (uint64_t)((int64_t)x.raw * x.raw) + (uint64_t)((int64_t)y.raw * y.raw);
+    uint64_t root = integerSqrt(squared);
+    return Fixed::fromRaw(root > INT32_MAX ? INT32_MAX : (int32_t)root);
+}
+
+Fixed Fixed::log2(Fixed value)
+{
+    if (value.raw <= 0) return Fixed::min();
+
+    // Whole part is where the top bit is, then scale into [1, 2)
+    int top = 31;
+    while (!((uint32_t)value.raw & (1u << top))) top--;
+    int whole = top - FIXED_FRACTION_BITS;
+    uint64_t y = whole >= 0 ? (uint64_t)value.raw >> whole : (uint64_t)value.raw << -whole;
+
+    // Squaring y doubles its log, every time it goes past 2 thats the next bit of the fraction
+    int32_t result = whole * FIXED_ONE;
+    for (int32_t bit = FIXED_ONE >> 1; bit > 0; bit >>= 1)
+    {
+        y = (y * y) >> FIXED_FRACTION_BITS;
+        if (y >= (uint64_t)(2 * FIXED_ONE))
+        {
+            y >>= 1;
+            result += bit;
+        }
+    }
+    return Fixed::fromRaw(result);
+}
+
+// 2^(2^-k) for k = 1 .. 16 in Q2.30
+static const uint32_t EXP2_TABLE[16] = {
+    1518500250u, 1276901417u, 1170923762u, 1121280436u, 1097253708u, 1085434106u, 1079572136u, 1076653033u,
+    1075196443u, 1074468888u, 1074105294u, 1073923544u, 1073832680u, 1073787251u, 1073764537u, 1073753181u,
+};
+
+Fixed Fixed::exp2(Fixed value)
+{
+    int whole = value.floorToInt();
+    uint32_t fraction = (uint32_t)value.raw & (FIXED_ONE - 1);
+    if (whole >= 15) return Fixed::max();
+    if (whole < -FIXED_FRACTION_BITS - 1) return Fixed();
+
+    // 2^fraction = product of 2^(2^-k) over the set bits of fraction, done in Q2.30
+    uint64_t result = 1ull << 30;
+    for (int k = 1; k <= FIXED_FRACTION_BITS; k++)
+    {
+        if (fraction & (1u << (FIXED_FRACTION_BITS - k))) result = (result * EXP2_TABLE[k - 1]) >> 30;
+    }
+
+    // Q2.30 -> Q16.16 and times 2^whole in one shift
+    int shift = 30 - FIXED_FRACTION_BITS - whole;
+    return Fixed::fromRaw((int32_t)(shift >= 0 ? result >> shift : result << -shift));
+}
+
+Fixed Fixed::pow(Fixed base, Fixed exponent)
+{
+    if (base.raw <= 0) return Fixed();
+    if (exponent.raw == 0) return Fixed::fromInt(1);
+    if (exponent == Fixed::fromInt(1)) return base;
+    return Fixed::exp2(exponent * Fixed::log2(base));
+}
@@ -0,0 +1,161 @@
+#include "utils/fixed_collision.h"
+#include "utils/tile_shapes.h"
+#include <algorithm>
+
+// Same as the float version (0.01 world units), rounded onto the Fixed grid
+static const Fixed CONTACT_SLOP = Fixed::fromRaw(655);
+// Slower than one step along an axis counts as not moving on it, see MIN_AXIS_SPEED
+static const Fixed MIN_AXIS_SPEED = Fixed::fromRaw(1);
+
+// See sweepAxis in collision.cpp
+static bool sweepAxis(Fixed boxMin, Fixed boxMax, Fixed shapeMin, Fixed shapeMax, Fixed speed, Fixed &gap, Fixed &entry, Fixed &exit)
+{
+    if (Fixed::abs(speed) > MIN_AXIS_SPEED)
+    {
+        gap = speed.raw > 0 ? shapeMin - boxMax : boxMin - shapeMax;
+        Fixed far = speed.raw > 0 ? shapeMax - boxMin : boxMax - shapeMin;
+        // Saturates on tiny speeds, which is just "a long way off"
+        entry = gap / Fixed::abs(speed);
+        exit = far / Fixed::abs(speed);
+        return true;
+    }
+
+    if (boxMin >= shapeMax - CONTACT_SLOP || boxMax <= shapeMin + CONTACT_SLOP) return false;
+    gap = Fixed::min();
+    entry = Fixed::min();
+    exit = Fixed::max();
+    return true;
+}
+
+// See sweepShape in collision.cpp
+static bool sweepShape(const FixedAABB &box, Fixed dx, Fixed dy, const TileShape &shape, Fixed originX, Fixed originY, FixedSweepResult &result)
+{
+    Fixed entry, exit, gap;
+    Fixed axisEntry, axisExit, axisGap;
+    Fixed normalX, normalY;
+    const Fixed one = Fixed::fromInt(1);
+
+    // X Axis
+    if (!sweepAxis(box.minX, box.maxX, originX + Fixed::fromFloat(shape.bounds.minX), originX + Fixed::fromFloat(shape.bounds.maxX),
+                   dx, gap, entry, exit)) return false;
+    normalX = dx.raw > 0 ? -one : one;
+    normalY = Fixed();
+
+    // Y Axis
+    if (!sweepAxis(box.minY, box.maxY, originY + Fixed::fromFloat(shape.bounds.minY), originY + Fixed::fromFloat(shape.bounds.maxY),
+                   dy, axisGap, axisEntry, axisExit)) return false;
+    if (axisEntry > entry)
+    {
+        entry = axisEntry;
+        gap = axisGap;
+        normalX = Fixed();
+        normalY = dy.raw > 0 ? -one : one;
+    }
+    exit = Fixed::minOf(exit, axisExit);
+
+    // Edge normals of the shape
+    Fixed centerX = (box.minX + box.maxX) / 2;
+    Fixed centerY = (box.minY + box.maxY) / 2;
+    Fixed halfWidth = box.getWidth() / 2;
+    Fixed halfHeight = box.getHeight() / 2;
+    for (int i = 0; i < shape.axisCount; i++)
+    {
+        Fixed axisX = Fixed::fromFloat(shape.axes[i * 2]);
+        Fixed axisY = Fixed::fromFloat(shape.axes[i * 2 + 1]);
+        Fixed center = centerX * axisX + centerY * axisY;
+        Fixed radius = halfWidth * Fixed::abs(axisX) + halfHeight * Fixed::abs(axisY);
+        Fixed offset = originX * axisX + originY * axisY;
+        Fixed speed = dx * axisX + dy * axisY;
+
+        if (!sweepAxis(center - radius, center + radius, offset + Fixed::fromFloat(shape.axisMin[i]),
+                       offset + Fixed::fromFloat(shape.axisMax[i]), speed, axisGap, axisEntry, axisExit)) return false;
+        if (axisEntry > entry)
+        {
+            entry = axisEntry;
+            gap = axisGap;
+            normalX = speed.raw > 0 ? -axisX : axisX;
+            normalY = speed.raw > 0 ? -axisY : axisY;
+        }
+        exit = Fixed::minOf(exit, axisExit);
+    }
+
+    if (entry >= exit || entry >= result.time || exit.raw <= 0) return false;
+    if (gap < -CONTACT_SLOP) return false;
+
+    result.hit = true;
+    result.time = Fixed::maxOf(Fixed(), entry);
+    result.normalX = normalX;
+    result.normalY = normalY;
+    return true;
+}
+
+FixedSweepResult FixedCollision::sweepGrid(const CollisionGrid &grid, const FixedAABB &box, Fixed dx, Fixed dy)
+{
+    FixedSweepResult result;
+    if (grid.isEmpty() || (dx.raw == 0 && dy.raw == 0)) return result;
+
+    const int tileWidth = grid.getTileWidth();
+    const int tileHeight = grid.getTileHeight();
+    const TileShape fullTile = TileShape::fromRect(0, 0, (float)tileWidth, (float)tileHeight);
+
+    // Every tile the box could touch along the way, one past the map edge since outside is solid
+    FixedAABB area = box.swept(dx, dy);
+    int startTileX = std::max(-1, (area.minX / tileWidth).floorToInt());
+    int endTileX = std::min(grid.getWidth(), (area.maxX / tileWidth).floorToInt());
+    int startTileY = std::max(-1, (area.minY / tileHeight).floorToInt());
+    int endTileY = std::min(grid.getHeight(), (area.maxY / tileHeight).floorToInt());
+
+    for (int y = startTileY; y <= endTileY; y++)
+    {
+        for (int x = startTileX; x <= endTileX; x++)
+        {
+            CollisionCell cell = grid.getCell(x, y);
+            if (cell == CELL_EMPTY) continue;
+
+            Fixed originX = Fixed::fromInt(x * tileWidth);
+            Fixed originY = Fixed::fromInt(y * tileHeight);
+
+            const TileShape *shapes = &fullTile;
+            int shapeCount = 1;
+            if (cell == CELL_SHAPED) shapeCount = grid.getShapes(x, y, &shapes);
+
+            for (int i = 0; i < shapeCount; i++)
+            {
+                sweepShape(box, dx, dy, shapes[i], originX, originY, result);
+            }
+        }
+    }
+    return result;
+}
+
+// Same steps as the sweep loop in Player::update
+bool FixedCollision::moveAndSlide(const CollisionGrid *grid, const FixedAABB &collider, FixedVec2 &position, FixedVec2 &velocity,
+                                  Fixed dt, int maxIterations)
+{
+    bool isColliding = false;
+    FixedVec2 move = velocity * dt;
+    for (int i = 0; i < maxIterations; i++)
+    {
+        if (move.x.raw == 0 && move.y.raw == 0) break;
+        if (!grid)
+        {
+            position += move;
+            break;
+        }
+
+        FixedAABB box = FixedAABB::fromRect(position.x + collider.minX, position.y + collider.minY,
+                                            collider.getWidth(), collider.getHeight());
+        FixedSweepResult sweep = sweepGrid(*grid, box, move.x, move.y);
+        position += move * sweep.time;
+        if (!sweep.hit) break;
+
+        isColliding = true;
+        move = move * (Fixed::fromInt(1) - sweep.time);
+        FixedVec2 normal(sweep.normalX, sweep.normalY);
+        Fixed moveInto = move.dot(normal);
+        if (moveInto.raw < 0) move -= normal * moveInto;
+        Fixed velocityInto = velocity.dot(normal);
+        if (velocityInto.raw < 0) velocity -= normal * velocityInto;
+    }
+    return isColliding;
+}
@@ -0,0 +1,64 @@
+#include "utils/fixed_timestep.h"
+
+FixedTimestep::FixedTimestep(int tickRate, int maxStepsPerFrame)
+{
+    if (tickRate <= 0) tickRate = SIM_TICK_RATE;
+    if (maxStepsPerFrame <= 0) maxStepsPerFrame = 1;
+    this->tickRate = tickRate;
+    this->maxStepsPerFrame = maxStepsPerFrame;
+    this->stepSeconds = 1.0f / tickRate;
+}
+
+void FixedTimestep::reset(uint64_t counter, uint64_t frequency)
+{
+    if (frequency == 0) frequency = 1;
+    this->frequency = frequency;
+    // Whole clock ticks per step, the simulation uses stepSeconds so rounding here only
+    // moves when a step happens by less than a nanosecond on any real counter
+    this->stepTicks = (frequency + this->tickRate / 2) / this->tickRate;
+    if (this->stepTicks == 0) this->stepTicks = 1;
+    this->lastCounter = counter;
+    this->accumulator = 0;
+    this->started = true;
+}
+
+int FixedTimestep::advance(uint64_t counter)
+{
+    if (!this->started)
+    {
+        this->reset(counter, this->frequency);
+        this->lastFrameSteps = 0;
+        return 0;
+    }
+
+    // Counter going backwards would wrap to a huge number, treat it as no time passing
+    uint64_t elapsed = counter > this->lastCounter ? counter - this->lastCounter : 0;
+    this->lastCounter = counter;
+    this->accumulator += elapsed;
+
+    uint64_t owed = this->accumulator / this->stepTicks;
+    int steps = owed > (uint64_t)this->maxStepsPerFrame ? this->maxStepsPerFrame : (int)owed;
+    this->accumulator -= steps * this->stepTicks;
+
+    // Too far behind, keep less than a step so alpha still means something
+    if (this->accumulator >= this->stepTicks)
+    {
+        uint64_t keep = this->accumulator % this->stepTicks;
+        this->droppedTicks += this->accumulator - keep;
+        this->accumulator = keep;
+    }
+
+    this->totalSteps += steps;
+    this->lastFrameSteps = steps;
+    return steps;
+}
+
+float FixedTimestep::getAlpha() const
+{
+    return (float)((double)this->accumulator / (double)this->stepTicks);
+}
+
+double FixedTimestep::getDroppedSeconds() const
+{
+    return (double)this->droppedTicks / (double)this->frequency;
+}
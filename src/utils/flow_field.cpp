@@ -0,0 +1,388 @@
+#include "utils/flow_field.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#define BUCKET_COUNT (FLOW_DIAGONAL_COST + 1)
+
+// E, SE, S, SW, W, NW, N, NE, the odd ones are diagonals
+static const int DIRECTION_X[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int DIRECTION_Y[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const float DIAGONAL = 0.70710678f;
+static const float DIRECTION_UNIT_X[8] = {1.0f, DIAGONAL, 0.0f, -DIAGONAL, -1.0f, -DIAGONAL, 0.0f, DIAGONAL};
+static const float DIRECTION_UNIT_Y[8] = {0.0f, DIAGONAL, 1.0f, DIAGONAL, 0.0f, -DIAGONAL, -1.0f, -DIAGONAL};
+// Straight neighbours first so ties go straight instead of zig zagging
+static const int SEARCH_ORDER[8] = {0, 2, 4, 6, 1, 3, 5, 7};
+
+// ==========================================================================================
+// FlowField
+// ==========================================================================================
+
+bool FlowField::canStep(const CollisionGrid &grid, int x, int y, int dir) const
+{
+    int toX = x + DIRECTION_X[dir];
+    int toY = y + DIRECTION_Y[dir];
+    if (grid.isSolid(toX, toY)) return false;
+    // No squeezing diagonally past the corner of a wall
+    if (dir & 1)
+    {
+        if (grid.isSolid(toX, y) || grid.isSolid(x, toY)) return false;
+    }
+    return true;
+}
+
+void FlowField::buildStepMasks(const CollisionGrid &grid)
+{
+    for (int y = 0; y < this->height; y++)
+    {
+        for (int x = 0; x < this->width; x++)
+        {
+            uint8_t mask = 0;
+            if (!grid.isSolid(x, y))
+            {
+                for (int dir = 0; dir < 8; dir++)
+                {
+                    if (this->canStep(grid, x, y, dir)) mask |= (uint8_t)(1 << dir);
+                }
+            }
+            this->steps[x + y * this->width] = mask;
+        }
+    }
+}
+
+void FlowField::resize(const CollisionGrid &grid)
+{
+    this->width = grid.getWidth();
+    this->height = grid.getHeight();
+    this->tileWidth = grid.getTileWidth();
+    this->tileHeight = grid.getTileHeight();
+
+    size_t count = static_cast<size_t>(this->width) * this->height;
+    this->cost.assign(count, FLOW_UNREACHABLE);
+    this->direction.assign(count, FLOW_NO_DIRECTION);
+    this->dirty.assign(count, 0);
+    this->steps.resize(count);
+    this->buildStepMasks(grid);
+}
+
+void FlowField::clear()
+{
+    this->width = 0;
+    this->height = 0;
+    this->goalX = -1;
+    this->goalY = -1;
+    this->cost.clear();
+    this->direction.clear();
+    this->dirty.clear();
+    this->steps.clear();
+}
+
+/**
+    Dijkstra from whatever is sitting in the buckets
+
+    Every step costs FLOW_STRAIGHT_COST or FLOW_DIAGONAL_COST so anything we push is at most
+    FLOW_DIAGONAL_COST past the cost we are on, a ring of that many buckets is a priority
+    queue that never has to sort (Dial's algorithm). Tiles only ever get cheaper so a tile
+    can sit in a bucket more than once, the stale copies are skipped.
+**/
+void FlowField::propagate(bool trackChanges)
+{
+    int pending = 0;
+    uint32_t current = FLOW_UNREACHABLE;
+    for (auto &bucket : this->buckets)
+    {
+        pending += (int)bucket.size();
+        for (int index : bucket) current = std::min(current, this->cost[index]);
+    }
+
+    while (pending > 0)
+    {
+        std::vector<int> &bucket = this->buckets[current % BUCKET_COUNT];
+        for (size_t i = 0; i < bucket.size(); i++)
+        {
+            int index = bucket[i];
+            pending--;
+            if (this->cost[index] != current) continue;
+
+            uint8_t mask = this->steps[index];
+            for (int dir = 0; dir < 8; dir++)
+            {
+                if (!(mask & (1 << dir))) continue;
+
+                int next = index + DIRECTION_X[dir] + DIRECTION_Y[dir] * this->width;
+                uint32_t nextCost = current + ((dir & 1) ? FLOW_DIAGONAL_COST : FLOW_STRAIGHT_COST);
+                if (nextCost >= this->cost[next]) continue;
+
+                this->cost[next] = nextCost;
+                this->buckets[nextCost % BUCKET_COUNT].push_back(next);
+                pending++;
+                if (trackChanges && !this->dirty[next])
+                {
+                    this->dirty[next] = 1;
+                    this->changed.push_back(next);
+                }
+            }
+        }
+        bucket.clear();
+        current++;
+    }
+}
+
+void FlowField::updateDirection(int index)
+{
+    uint32_t best = this->cost[index];
+    int bestDir = FLOW_NO_DIRECTION;
+    if (best != FLOW_UNREACHABLE && best != this->costBase)
+    {
+        uint8_t mask = this->steps[index];
+        for (int dir : SEARCH_ORDER)
+        {
+            if (!(mask & (1 << dir))) continue;
+            uint32_t neighbour = this->cost[index + DIRECTION_X[dir] + DIRECTION_Y[dir] * this->width];
+            if (neighbour < best)
+            {
+                best = neighbour;
+                bestDir = dir;
+            }
+        }
+    }
+    this->direction[index] = (uint8_t)bestDir;
+}
+
+bool FlowField::build(const CollisionGrid &grid, int goalX, int goalY)
+{
+    this->resize(grid);
+    this->incremental = false;
+    this->changedCount = 0;
+    this->costBase = FLOW_COST_BASE;
+    this->goalX = goalX;
+    this->goalY = goalY;
+    if (grid.isSolid(goalX, goalY)) return false;
+
+    int goal = goalX + goalY * this->width;
+    this->cost[goal] = this->costBase;
+    this->buckets[this->costBase % BUCKET_COUNT].push_back(goal);
+    this->propagate(false);
+
+    for (int i = 0; i < (int)this->cost.size(); i++) this->updateDirection(i);
+    return true;
+}
+
+bool FlowField::moveGoal(const CollisionGrid &grid, int goalX, int goalY)
+{
+    int stepX = goalX - this->goalX;
+    int stepY = goalY - this->goalY;
+    bool isNeighbour = std::abs(stepX) <= 1 && std::abs(stepY) <= 1;
+    bool sameGrid = this->width == grid.getWidth() && this->height == grid.getHeight();
+    // costBase runs out after about 75 million moves, start over then
+    if (!sameGrid || this->isEmpty() || grid.isSolid(this->goalX, this->goalY) || !isNeighbour || this->costBase < FLOW_DIAGONAL_COST)
+    {
+        return this->build(grid, goalX, goalY);
+    }
+    if (stepX == 0 && stepY == 0) return true;
+
+    // Walking to the new goal has to be a legal step or the old distances mean nothing
+    int stepDir = 0;
+    while (DIRECTION_X[stepDir] != stepX || DIRECTION_Y[stepDir] != stepY) stepDir++;
+    if (!(this->steps[this->goalX + this->goalY * this->width] & (1 << stepDir)))
+    {
+        return this->build(grid, goalX, goalY);
+    }
+
+    // Going through the old goal is always an option so old + step is never too low,
+    // everything that is really closer than that gets found by spreading out from the new goal.
+    // Lowering the base adds the step to every tile at once
+    this->costBase -= (stepDir & 1) ? FLOW_DIAGONAL_COST : FLOW_STRAIGHT_COST;
+
+    this->incremental = true;
+    this->goalX = goalX;
+    this->goalY = goalY;
+    int goal = goalX + goalY * this->width;
+    this->cost[goal] = this->costBase;
+    this->buckets[this->costBase % BUCKET_COUNT].push_back(goal);
+    this->changed.clear();
+    this->changed.push_back(goal);
+    this->dirty[goal] = 1;
+    this->propagate(true);
+    this->changedCount = (int)this->changed.size();
+
+    // Past an eighth of the map going over every tile in order beats hopping around
+    // the neighbours of the changed ones
+    if (this->changed.size() > this->cost.size() / 8)
+    {
+        for (int index : this->changed) this->dirty[index] = 0;
+        for (int i = 0; i < (int)this->cost.size(); i++) this->updateDirection(i);
+        return true;
+    }
+
+    // Everything else went up by the same amount so only the tiles that got cheaper and
+    // the ones next to them can point somewhere new
+    this->touched.clear();
+    for (int index : this->changed)
+    {
+        int x = index % this->width;
+        int y = index / this->width;
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                int nx = x + dx;
+                int ny = y + dy;
+                if (nx < 0 || ny < 0 || nx >= this->width || ny >= this->height) continue;
+                int neighbour = nx + ny * this->width;
+                if (this->dirty[neighbour] == 2) continue;
+                this->dirty[neighbour] = 2;
+                this->touched.push_back(neighbour);
+            }
+        }
+    }
+    for (int index : this->touched)
+    {
+        this->updateDirection(index);
+        this->dirty[index] = 0;
+    }
+    return true;
+}
+
+bool FlowField::sample(float worldX, float worldY, float &dirX, float &dirY) const
+{
+    dirX = 0.0f;
+    dirY = 0.0f;
+    if (this->isEmpty()) return false;
+
+    int dir = this->getDirection((int)std::floor(worldX / this->tileWidth), (int)std::floor(worldY / this->tileHeight));
+    if (dir == FLOW_NO_DIRECTION) return false;
+
+    dirX = DIRECTION_UNIT_X[dir];
+    dirY = DIRECTION_UNIT_Y[dir];
+    return true;
+}
+
+// ==========================================================================================
+// FlowFieldService
+// ==========================================================================================
+
+FlowFieldService::~FlowFieldService()
+{
+    this->stop();
+}
+
+void FlowFieldService::start()
+{
+    if (this->running) return;
+    this->running = true;
+    this->worker = std::thread(&FlowFieldService::run, this);
+}
+
+void FlowFieldService::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->running) return;
+        this->running = false;
+    }
+    this->wake.notify_one();
+    if (this->worker.joinable()) this->worker.join();
+}
+
+void FlowFieldService::setGrid(const CollisionGrid &grid)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->pendingGrid = grid;
+        this->gridChanged = true;
+        // Rebuild for the current goal on the new grid
+        if (this->lastRequestX >= 0)
+        {
+            this->requestX = this->lastRequestX;
+            this->requestY = this->lastRequestY;
+            this->hasRequest = true;
+        }
+    }
+    this->wake.notify_one();
+}
+
+void FlowFieldService::requestGoal(int tileX, int tileY)
+{
+    if (tileX == this->lastRequestX && tileY == this->lastRequestY) return;
+    this->lastRequestX = tileX;
+    this->lastRequestY = tileY;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->requestX = tileX;
+        this->requestY = tileY;
+        this->hasRequest = true;
+    }
+    this->wake.notify_one();
+}
+
+bool FlowFieldService::update()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->hasResult) return false;
+    std::swap(this->front, this->ready);
+    this->hasResult = false;
+    return true;
+}
+
+void FlowFieldService::run()
+{
+    while (true)
+    {
+        int goalX, goalY;
+        bool fullBuild = false;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [this] { return !this->running || this->hasRequest; });
+            if (!this->running) return;
+
+            if (this->gridChanged)
+            {
+                std::swap(this->workerGrid, this->pendingGrid);
+                this->gridChanged = false;
+                fullBuild = true;
+            }
+            goalX = this->requestX;
+            goalY = this->requestY;
+            this->hasRequest = false;
+        }
+
+        // The actual build happens without the lock so the main thread never waits on it
+        auto start = std::chrono::steady_clock::now();
+        if (fullBuild)
+        {
+            this->working.build(this->workerGrid, goalX, goalY);
+        }
+        else
+        {
+            this->working.moveGoal(this->workerGrid, goalX, goalY);
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->ready = this->working;
+        this->hasResult = true;
+        this->lastBuildMilliseconds = milliseconds;
+        this->buildCount++;
+        if (this->working.wasIncremental()) this->incrementalCount++;
+    }
+}
+
+double FlowFieldService::getLastBuildMilliseconds()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->lastBuildMilliseconds;
+}
+
+int FlowFieldService::getBuildCount()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->buildCount;
+}
+
+int FlowFieldService::getIncrementalCount()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->incrementalCount;
+}
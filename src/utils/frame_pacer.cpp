@@ -0,0 +1,152 @@
+#include "utils/frame_pacer.h"
+
+FramePacer::FramePacer()
+{
+    this->frequency = SDL_GetPerformanceFrequency();
+    if (this->frequency == 0) this->frequency = 1;
+    this->frameStart = SDL_GetPerformanceCounter();
+    this->lastPresent = this->frameStart;
+    this->deadline = this->frameStart;
+    this->updateFrameTicks();
+}
+
+// Setters
+void FramePacer::setTargetFps(int fps)
+{
+    this->targetFps = fps < 0 ? FRAME_PACER_UNCAPPED : fps;
+    this->updateFrameTicks();
+}
+
+void FramePacer::setVsync(bool vsync, int refreshRate)
+{
+    this->vsync = vsync;
+    this->refreshRate = refreshRate;
+    this->updateFrameTicks();
+}
+
+void FramePacer::updateFrameTicks()
+{
+    bool vsyncPaces = this->vsync && (this->targetFps == FRAME_PACER_UNCAPPED ||
+        this->refreshRate <= 0 || this->targetFps >= this->refreshRate);
+
+    if (this->targetFps == FRAME_PACER_UNCAPPED || vsyncPaces)
+    {
+        this->frameTicks = 0;
+    }
+    else
+    {
+        this->frameTicks = this->frequency / this->targetFps;
+    }
+    // New rate, start the deadlines over from now
+    this->deadline = SDL_GetPerformanceCounter() + this->frameTicks;
+}
+
+// ==========================================================================================
+// Stats
+// ==========================================================================================
+void FramePacer::recordFrame(double milliseconds)
+{
+    if (this->historyCount == FRAME_PACER_HISTORY)
+    {
+        double old = this->history[this->historyNext];
+        this->historySum -= old;
+        this->historySumSquares -= old * old;
+    }
+    else
+    {
+        this->historyCount++;
+    }
+    this->history[this->historyNext] = milliseconds;
+    this->historySum += milliseconds;
+    this->historySumSquares += milliseconds * milliseconds;
+    this->historyNext = (this->historyNext + 1) % FRAME_PACER_HISTORY;
+}
+
+double FramePacer::getMeanFrameMs() const
+{
+    if (this->historyCount == 0) return 0.0;
+    return this->historySum / this->historyCount;
+}
+
+double FramePacer::getFrameVariance() const
+{
+    if (this->historyCount < 2) return 0.0;
+    double mean = this->historySum / this->historyCount;
+    double variance = this->historySumSquares / this->historyCount - mean * mean;
+    // Running sums can dip a hair under 0 from rounding
+    return variance > 0.0 ? variance : 0.0;
+}
+
+// ==========================================================================================
+// Waiting
+// ==========================================================================================
+void FramePacer::waitUntil(uint64_t target)
+{
+    const double toMs = 1000.0 / this->frequency;
+    const uint64_t spinTicks = (uint64_t)(FRAME_PACER_SPIN_MS / toMs);
+    uint64_t now = SDL_GetPerformanceCounter();
+
+    // Coarse sleep while we are far from the target
+    while (now + spinTicks < target)
+    {
+        Uint32 sleepMs = (Uint32)((target - now - spinTicks) * toMs);
+        // Under a millisecond left to sleep, SDL_Delay(1) could blow past the spin window
+        if (sleepMs == 0) break;
+        SDL_Delay(sleepMs);
+        now = SDL_GetPerformanceCounter();
+    }
+    // Spin the last bit
+    while (now < target)
+    {
+        now = SDL_GetPerformanceCounter();
+    }
+}
+
+void FramePacer::beginFrame()
+{
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (this->frameTicks != 0)
+    {
+        // Leave just enough time for the frame to be done by the deadline
+        uint64_t budget = this->workEstimate + (uint64_t)(FRAME_PACER_WORK_MARGIN_MS * this->frequency / 1000.0);
+        if (budget > this->frameTicks) budget = this->frameTicks;
+
+        if (now + budget > this->deadline)
+        {
+            // Already late, present as soon as we can and keep the cadence from there
+            this->deadline = now + budget;
+        }
+        else
+        {
+            this->waitUntil(this->deadline - budget);
+            now = SDL_GetPerformanceCounter();
+        }
+    }
+
+    this->lastWaitMs = (now - this->lastPresent) * 1000.0 / this->frequency;
+    this->frameStart = now;
+}
+
+void FramePacer::endFrame()
+{
+    const double toMs = 1000.0 / this->frequency;
+    uint64_t now = SDL_GetPerformanceCounter();
+    uint64_t work = now - this->frameStart;
+    this->lastWorkMs = work * toMs;
+
+    // Jumps straight up to a slow frame, creeps back down after it so one fast frame
+    // doesnt make the next wake up too late
+    uint64_t decayed = this->workEstimate - this->workEstimate / FRAME_PACER_WORK_DECAY;
+    this->workEstimate = work > decayed ? work : decayed;
+
+    this->lastFrameMs = (now - this->lastPresent) * toMs;
+    this->lastPresent = now;
+    this->recordFrame(this->lastFrameMs);
+
+    if (this->frameTicks != 0)
+    {
+        this->deadline += this->frameTicks;
+        // Missed it by more than a frame (hitch, loading), dont rush frames out to catch up
+        if (this->deadline < now) this->deadline = now + this->frameTicks;
+    }
+}
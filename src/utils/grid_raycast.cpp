@@ -0,0 +1,212 @@
+#include "utils/grid_raycast.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// Slower than this along an axis (world units over the whole ray) is parallel to it
+static const float PARALLEL_EPSILON = 0.00001f;
+
+/**
+    Clips the ray against one slab (lo <= axis . p <= hi), entry / exit are narrowed down
+    and the normal is updated if this slab is the one the ray enters last
+**/
+static bool clipSlab(float start, float speed, float lo, float hi, float axisX, float axisY,
+                     float &entry, float &exit, float &normalX, float &normalY)
+{
+    if (std::fabs(speed) < PARALLEL_EPSILON)
+    {
+        return start >= lo && start <= hi;
+    }
+
+    float tLo = (lo - start) / speed;
+    float tHi = (hi - start) / speed;
+    float slabEntry = speed > 0 ? tLo : tHi;
+    float slabExit = speed > 0 ? tHi : tLo;
+    if (slabEntry > entry)
+    {
+        entry = slabEntry;
+        normalX = speed > 0 ? -axisX : axisX;
+        normalY = speed > 0 ? -axisY : axisY;
+    }
+    exit = std::min(exit, slabExit);
+    return entry <= exit;
+}
+
+/**
+    A convex shape is exactly the overlap of its bounds and the slabs of its edge axes,
+    so clipping the ray against each of them (Cyrus-Beck) gives where it enters
+**/
+static bool clipShape(const TileShape &shape, float originX, float originY,
+                      float x1, float y1, float dx, float dy, float &fraction, float &normalX, float &normalY)
+{
+    float entry = 0.0f;
+    float exit = 1.0f;
+    float nx = 0.0f;
+    float ny = 0.0f;
+
+    if (!clipSlab(x1, dx, originX + shape.bounds.minX, originX + shape.bounds.maxX, 1.0f, 0.0f, entry, exit, nx, ny)) return false;
+    if (!clipSlab(y1, dy, originY + shape.bounds.minY, originY + shape.bounds.maxY, 0.0f, 1.0f, entry, exit, nx, ny)) return false;
+    for (int i = 0; i < shape.axisCount; i++)
+    {
+        float axisX = shape.axes[i * 2];
+        float axisY = shape.axes[i * 2 + 1];
+        float offset = originX * axisX + originY * axisY;
+        if (!clipSlab(x1 * axisX + y1 * axisY, dx * axisX + dy * axisY,
+                      offset + shape.axisMin[i], offset + shape.axisMax[i],
+                      axisX, axisY, entry, exit, nx, ny)) return false;
+    }
+
+    if (entry >= fraction) return false;
+    fraction = entry;
+    normalX = nx;
+    normalY = ny;
+    return true;
+}
+
+GridRayHit GridRaycast::cast(const CollisionGrid &grid, float x1, float y1, float x2, float y2)
+{
+    GridRayHit result;
+    result.x = x2;
+    result.y = y2;
+    if (grid.isEmpty()) return result;
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    const float tileWidth = (float)grid.getTileWidth();
+    const float tileHeight = (float)grid.getTileHeight();
+    const float dx = x2 - x1;
+    const float dy = y2 - y1;
+
+    int tileX = (int)std::floor(x1 / tileWidth);
+    int tileY = (int)std::floor(y1 / tileHeight);
+    const int endTileX = (int)std::floor(x2 / tileWidth);
+    const int endTileY = (int)std::floor(y2 / tileHeight);
+    const int stepX = dx > 0 ? 1 : (dx < 0 ? -1 : 0);
+    const int stepY = dy > 0 ? 1 : (dy < 0 ? -1 : 0);
+
+    // How far along the ray the next vertical / horizontal tile edge is, and how
+    // far apart those edges are
+    float tMaxX = infinity;
+    float tMaxY = infinity;
+    if (stepX > 0) tMaxX = ((tileX + 1) * tileWidth - x1) / dx;
+    if (stepX < 0) tMaxX = (tileX * tileWidth - x1) / dx;
+    if (stepY > 0) tMaxY = ((tileY + 1) * tileHeight - y1) / dy;
+    if (stepY < 0) tMaxY = (tileY * tileHeight - y1) / dy;
+    const float tDeltaX = stepX != 0 ? tileWidth / std::fabs(dx) : infinity;
+    const float tDeltaY = stepY != 0 ? tileHeight / std::fabs(dy) : infinity;
+
+    // Where we came into the current tile
+    float tEntry = 0.0f;
+    float entryNormalX = 0.0f;
+    float entryNormalY = 0.0f;
+
+    // Shapes can hang over the edge of their tile so a shape hit only ends the walk
+    // once the next tile starts after it
+    while (tEntry < result.fraction && tEntry <= 1.0f)
+    {
+        CollisionCell cell = grid.getCell(tileX, tileY);
+        if (cell == CELL_SOLID)
+        {
+            result.hit = true;
+            result.fraction = tEntry;
+            result.normalX = entryNormalX;
+            result.normalY = entryNormalY;
+            result.tileX = tileX;
+            result.tileY = tileY;
+            break;
+        }
+        if (cell == CELL_SHAPED)
+        {
+            const TileShape *shapes = nullptr;
+            int shapeCount = grid.getShapes(tileX, tileY, &shapes);
+            for (int i = 0; i < shapeCount; i++)
+            {
+                if (clipShape(shapes[i], tileX * tileWidth, tileY * tileHeight, x1, y1, dx, dy,
+                              result.fraction, result.normalX, result.normalY))
+                {
+                    result.hit = true;
+                    result.tileX = tileX;
+                    result.tileY = tileY;
+                }
+            }
+        }
+
+        if (tileX == endTileX && tileY == endTileY) break;
+
+        if (tMaxX < tMaxY)
+        {
+            tEntry = tMaxX;
+            tMaxX += tDeltaX;
+            tileX += stepX;
+            entryNormalX = (float)-stepX;
+            entryNormalY = 0.0f;
+        }
+        else if (tMaxY < tMaxX)
+        {
+            tEntry = tMaxY;
+            tMaxY += tDeltaY;
+            tileY += stepY;
+            entryNormalX = 0.0f;
+            entryNormalY = (float)-stepY;
+        }
+        else
+        {
+            // Exactly through a corner, a diagonal crack between two walls is not see through
+            tEntry = tMaxX;
+            if (tEntry >= result.fraction || tEntry > 1.0f) break;
+            bool solidX = grid.getCell(tileX + stepX, tileY) == CELL_SOLID;
+            bool solidY = grid.getCell(tileX, tileY + stepY) == CELL_SOLID;
+            if (solidX || solidY)
+            {
+                result.hit = true;
+                result.fraction = tEntry;
+                result.normalX = solidX ? (float)-stepX : 0.0f;
+                result.normalY = solidX ? 0.0f : (float)-stepY;
+                result.tileX = solidX ? tileX + stepX : tileX;
+                result.tileY = solidX ? tileY : tileY + stepY;
+                break;
+            }
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+            tileX += stepX;
+            tileY += stepY;
+            entryNormalX = (float)-stepX;
+            entryNormalY = 0.0f;
+        }
+    }
+
+    if (result.hit)
+    {
+        result.x = x1 + dx * result.fraction;
+        result.y = y1 + dy * result.fraction;
+    }
+    return result;
+}
+
+int GridRaycast::castBatch(const CollisionGrid &grid, const std::vector<GridRay> &rays, std::vector<GridRayHit> &hits)
+{
+    hits.resize(rays.size());
+    int hitCount = 0;
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        hits[i] = cast(grid, rays[i]);
+        if (hits[i].hit) hitCount++;
+    }
+    return hitCount;
+}
+
+int GridRaycast::lineOfSightBatch(const CollisionGrid &grid, const GridRay *rays, int count, uint32_t *visibleMask)
+{
+    std::memset(visibleMask, 0, sizeof(uint32_t) * ((count + 31) / 32));
+    int hitCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (cast(grid, rays[i]).hit)
+        {
+            hitCount++;
+            continue;
+        }
+        visibleMask[i >> 5] |= 1u << (i & 31);
+    }
+    return hitCount;
+}
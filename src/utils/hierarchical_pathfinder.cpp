@@ -0,0 +1,598 @@
+#include "utils/hierarchical_pathfinder.h"
+#include <algorithm>
+#include <cstdlib>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define HPA_STRAIGHT_COST 10
+#define HPA_DIAGONAL_COST 14
+#define HPA_UNREACHABLE 0xFFFFFFFFu
+#define HPA_BUCKET_COUNT (HPA_DIAGONAL_COST + 1)
+// Openings at least this long get an entrance at each end instead of one in the middle
+#define HPA_SPLIT_ENTRANCE_LENGTH 6
+
+static const int DIRECTION_X[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int DIRECTION_Y[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// Radix heap bucket for f, 0 when it is the last f popped, else 1 + the highest bit they differ in
+static int openBucketOf(uint32_t f, uint32_t last)
+{
+    uint32_t differ = f ^ last;
+    if (differ == 0) return 0;
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanReverse(&bit, differ);
+    return (int)bit + 1;
+#else
+    return 32 - __builtin_clz(differ);
+#endif
+}
+
+static uint32_t octile(int dx, int dy)
+{
+    dx = std::abs(dx);
+    dy = std::abs(dy);
+    int diagonal = std::min(dx, dy);
+    return (uint32_t)(diagonal * HPA_DIAGONAL_COST + (std::max(dx, dy) - diagonal) * HPA_STRAIGHT_COST);
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(int clusterSize)
+{
+    this->clusterSize = std::max(4, clusterSize);
+    this->slotsPerCluster = 2 * this->clusterSize + 4;
+}
+
+int HierarchicalPathfinder::getClusterOf(int tile) const
+{
+    int x = tile % this->width;
+    int y = tile / this->width;
+    return (x / this->clusterSize) + (y / this->clusterSize) * this->clustersX;
+}
+
+int HierarchicalPathfinder::getSlotOf(int tile) const
+{
+    int node = this->tileNode[tile];
+    return node == -1 ? -1 : this->getClusterOf(tile) * this->slotsPerCluster + node;
+}
+
+void HierarchicalPathfinder::getClusterBounds(int clusterIndex, int &minX, int &minY, int &maxX, int &maxY) const
+{
+    minX = (clusterIndex % this->clustersX) * this->clusterSize;
+    minY = (clusterIndex / this->clustersX) * this->clusterSize;
+    maxX = std::min(this->width, minX + this->clusterSize) - 1;
+    maxY = std::min(this->height, minY + this->clusterSize) - 1;
+}
+
+int HierarchicalPathfinder::getNodeCount() const
+{
+    int count = 0;
+    for (auto &cluster : this->clusters) count += (int)cluster.nodes.size();
+    return count;
+}
+
+// ==========================================================================================
+// Building
+// ==========================================================================================
+
+void HierarchicalPathfinder::build(const CollisionGrid &grid)
+{
+    this->width = grid.getWidth();
+    this->height = grid.getHeight();
+    this->clustersX = (this->width + this->clusterSize - 1) / this->clusterSize;
+    this->clustersY = (this->height + this->clusterSize - 1) / this->clusterSize;
+    this->gridVersion = grid.getVersion();
+
+    size_t count = static_cast<size_t>(this->width) * this->height;
+    this->walkable.resize(count);
+    for (int y = 0; y < this->height; y++)
+    {
+        for (int x = 0; x < this->width; x++)
+        {
+            this->walkable[x + y * this->width] = grid.isSolid(x, y) ? 0 : 1;
+        }
+    }
+
+    size_t clusterCount = static_cast<size_t>(this->clustersX) * this->clustersY;
+    this->clusters.assign(clusterCount, Cluster());
+    this->rightBorders.assign(clusterCount, {});
+    this->bottomBorders.assign(clusterCount, {});
+    this->tileNode.assign(count, -1);
+
+    size_t slotCount = clusterCount * this->slotsPerCluster + 2;
+    this->generation = 0;
+    this->visited.assign(slotCount, 0);
+    this->closed.assign(slotCount, 0);
+    this->cost.resize(slotCount);
+    this->parent.resize(slotCount);
+    this->localCost.resize(this->clusterSize * this->clusterSize);
+    this->localParent.resize(this->clusterSize * this->clusterSize);
+
+    for (int cy = 0; cy < this->clustersY; cy++)
+    {
+        for (int cx = 0; cx < this->clustersX; cx++) this->buildBorders(cx, cy);
+    }
+    for (int cy = 0; cy < this->clustersY; cy++)
+    {
+        for (int cx = 0; cx < this->clustersX; cx++) this->buildCluster(cx, cy);
+    }
+}
+
+int HierarchicalPathfinder::update(const CollisionGrid &grid)
+{
+    if (grid.getWidth() != this->width || grid.getHeight() != this->height || this->clusters.empty())
+    {
+        this->build(grid);
+        return (int)this->clusters.size();
+    }
+    if (grid.getVersion() == this->gridVersion) return 0;
+    this->gridVersion = grid.getVersion();
+
+    // Find the clusters with tiles that changed since we last looked
+    std::vector<uint8_t> dirty(this->clusters.size(), 0);
+    bool anyDirty = false;
+    for (int y = 0; y < this->height; y++)
+    {
+        for (int x = 0; x < this->width; x++)
+        {
+            uint8_t open = grid.isSolid(x, y) ? 0 : 1;
+            uint8_t &current = this->walkable[x + y * this->width];
+            if (current == open) continue;
+            current = open;
+            dirty[(x / this->clusterSize) + (y / this->clusterSize) * this->clustersX] = 1;
+            anyDirty = true;
+        }
+    }
+    if (!anyDirty) return 0;
+
+    // Entrances on all four sides of a dirty cluster can move, which changes
+    // the nodes of the clusters on the other side of them too
+    std::vector<uint8_t> rebuild(this->clusters.size(), 0);
+    for (int cy = 0; cy < this->clustersY; cy++)
+    {
+        for (int cx = 0; cx < this->clustersX; cx++)
+        {
+            if (!dirty[cx + cy * this->clustersX]) continue;
+
+            this->buildBorders(cx, cy);
+            if (cx > 0) this->buildBorders(cx - 1, cy);
+            if (cy > 0) this->buildBorders(cx, cy - 1);
+
+            rebuild[cx + cy * this->clustersX] = 1;
+            if (cx > 0) rebuild[(cx - 1) + cy * this->clustersX] = 1;
+            if (cy > 0) rebuild[cx + (cy - 1) * this->clustersX] = 1;
+            if (cx + 1 < this->clustersX) rebuild[(cx + 1) + cy * this->clustersX] = 1;
+            if (cy + 1 < this->clustersY) rebuild[cx + (cy + 1) * this->clustersX] = 1;
+        }
+    }
+
+    int rebuilt = 0;
+    for (int i = 0; i < (int)rebuild.size(); i++)
+    {
+        if (!rebuild[i]) continue;
+        this->buildCluster(i % this->clustersX, i / this->clustersX);
+        rebuilt++;
+    }
+    return rebuilt;
+}
+
+void HierarchicalPathfinder::addEntrances(std::vector<Entrance> &border, int startA, int startB, int step, int length)
+{
+    int runStart = -1;
+    for (int i = 0; i <= length; i++)
+    {
+        bool open = i < length && this->walkable[startA + i * step] && this->walkable[startB + i * step];
+        if (open)
+        {
+            if (runStart == -1) runStart = i;
+            continue;
+        }
+        if (runStart == -1) continue;
+
+        int runEnd = i - 1;
+        if (runEnd - runStart + 1 >= HPA_SPLIT_ENTRANCE_LENGTH)
+        {
+            border.push_back({startA + runStart * step, startB + runStart * step});
+            border.push_back({startA + runEnd * step, startB + runEnd * step});
+        }
+        else
+        {
+            int middle = (runStart + runEnd) / 2;
+            border.push_back({startA + middle * step, startB + middle * step});
+        }
+        runStart = -1;
+    }
+}
+
+void HierarchicalPathfinder::buildBorders(int clusterX, int clusterY)
+{
+    int index = clusterX + clusterY * this->clustersX;
+    int minX, minY, maxX, maxY;
+    this->getClusterBounds(index, minX, minY, maxX, maxY);
+
+    this->rightBorders[index].clear();
+    if (clusterX + 1 < this->clustersX)
+    {
+        int startA = maxX + minY * this->width;
+        this->addEntrances(this->rightBorders[index], startA, startA + 1, this->width, maxY - minY + 1);
+    }
+
+    this->bottomBorders[index].clear();
+    if (clusterY + 1 < this->clustersY)
+    {
+        int startA = minX + maxY * this->width;
+        this->addEntrances(this->bottomBorders[index], startA, startA + this->width, 1, maxX - minX + 1);
+    }
+}
+
+void HierarchicalPathfinder::buildCluster(int clusterX, int clusterY)
+{
+    int index = clusterX + clusterY * this->clustersX;
+    Cluster &cluster = this->clusters[index];
+    for (auto &node : cluster.nodes) this->tileNode[node.tile] = -1;
+    cluster.nodes.clear();
+
+    // A tile in the corner of a cluster can be part of an entrance on two sides
+    auto addNode = [&](int tile, int partner) {
+        int existing = this->tileNode[tile];
+        if (existing == -1)
+        {
+            existing = (int)cluster.nodes.size();
+            cluster.nodes.push_back({tile, tile % this->width, tile / this->width, {-1, -1}, 0});
+            this->tileNode[tile] = (int16_t)existing;
+        }
+        ClusterNode &node = cluster.nodes[existing];
+        if (node.partnerCount < 2) node.partners[node.partnerCount++] = partner;
+    };
+
+    for (auto &entrance : this->rightBorders[index]) addNode(entrance.tileA, entrance.tileB);
+    for (auto &entrance : this->bottomBorders[index]) addNode(entrance.tileA, entrance.tileB);
+    if (clusterX > 0)
+    {
+        for (auto &entrance : this->rightBorders[index - 1]) addNode(entrance.tileB, entrance.tileA);
+    }
+    if (clusterY > 0)
+    {
+        for (auto &entrance : this->bottomBorders[index - this->clustersX]) addNode(entrance.tileB, entrance.tileA);
+    }
+
+    // Step masks for searchCluster, a diagonal that stays inside has both corner tiles inside too
+    int minX, minY, maxX, maxY;
+    this->getClusterBounds(index, minX, minY, maxX, maxY);
+    cluster.steps.assign(this->clusterSize * this->clusterSize, 0);
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            uint8_t mask = 0;
+            if (this->walkable[x + y * this->width])
+            {
+                for (int dir = 0; dir < 8; dir++)
+                {
+                    int nx = x + DIRECTION_X[dir];
+                    int ny = y + DIRECTION_Y[dir];
+                    if (nx < minX || ny < minY || nx > maxX || ny > maxY) continue;
+                    if (!this->walkable[nx + ny * this->width]) continue;
+                    if ((dir & 1) && (!this->walkable[nx + y * this->width] || !this->walkable[x + ny * this->width])) continue;
+                    mask |= (uint8_t)(1 << dir);
+                }
+            }
+            cluster.steps[(x - minX) + (y - minY) * this->clusterSize] = mask;
+        }
+    }
+
+    // How far every node is from every other node without leaving the cluster
+    size_t nodeCount = cluster.nodes.size();
+    cluster.distances.assign(nodeCount * nodeCount, HPA_UNREACHABLE);
+    cluster.pathStart.assign(nodeCount * nodeCount, -1);
+    cluster.pathTiles.clear();
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        this->searchCluster(index, cluster.nodes[i].tile);
+        for (size_t j = 0; j < nodeCount; j++)
+        {
+            int tile = cluster.nodes[j].tile;
+            int local = (tile % this->width - minX) + (tile / this->width - minY) * this->clusterSize;
+            cluster.distances[i * nodeCount + j] = this->localCost[local];
+        }
+    }
+}
+
+/**
+    Dijkstra from startTile over the tiles of one cluster, fills localCost / localParent
+    (indexed by tile position inside the cluster)
+
+    Steps only ever cost 10 or 14 so a ring of buckets works as the priority queue
+    (same as the FlowField), this runs for every node of a cluster on a rebuild and
+    twice per query so it matters
+**/
+void HierarchicalPathfinder::searchCluster(int clusterIndex, int startTile)
+{
+    int minX, minY, maxX, maxY;
+    this->getClusterBounds(clusterIndex, minX, minY, maxX, maxY);
+    const int size = this->clusterSize;
+    const int width = this->width;
+    const uint8_t *steps = this->clusters[clusterIndex].steps.data();
+    int offsets[8];
+    for (int dir = 0; dir < 8; dir++) offsets[dir] = DIRECTION_X[dir] + DIRECTION_Y[dir] * size;
+    std::fill(this->localCost.begin(), this->localCost.end(), HPA_UNREACHABLE);
+
+    int start = (startTile % width - minX) + (startTile / width - minY) * size;
+    this->localCost[start] = 0;
+    this->localParent[start] = -1;
+    this->localBuckets[0].push_back(start);
+
+    int pending = 1;
+    for (uint32_t current = 0; pending > 0; current++)
+    {
+        std::vector<int> &bucket = this->localBuckets[current % HPA_BUCKET_COUNT];
+        for (size_t i = 0; i < bucket.size(); i++)
+        {
+            int local = bucket[i];
+            pending--;
+            if (this->localCost[local] != current) continue;
+
+            uint8_t mask = steps[local];
+            for (int dir = 0; dir < 8; dir++)
+            {
+                if (!(mask & (1 << dir))) continue;
+
+                int next = local + offsets[dir];
+                uint32_t g = current + ((dir & 1) ? HPA_DIAGONAL_COST : HPA_STRAIGHT_COST);
+                if (g >= this->localCost[next]) continue;
+                this->localCost[next] = g;
+                this->localParent[next] = local;
+                this->localBuckets[g % HPA_BUCKET_COUNT].push_back(next);
+                pending++;
+            }
+        }
+        bucket.clear();
+    }
+}
+
+// ==========================================================================================
+// Queries
+// ==========================================================================================
+
+void HierarchicalPathfinder::pushOpen(const OpenNode &node)
+{
+    this->openBuckets[openBucketOf(node.f, this->openLast)].push_back(node);
+}
+
+bool HierarchicalPathfinder::popOpen(OpenNode &node)
+{
+    if (this->openBuckets[0].empty())
+    {
+        int index = 1;
+        while (index < 33 && this->openBuckets[index].empty()) index++;
+        if (index == 33) return false;
+
+        // Everything in here lands in a lower bucket once openLast is its smallest f
+        std::vector<OpenNode> &bucket = this->openBuckets[index];
+        uint32_t smallest = bucket[0].f;
+        for (const OpenNode &open : bucket) smallest = std::min(smallest, open.f);
+        this->openLast = smallest;
+        for (const OpenNode &open : bucket) this->openBuckets[openBucketOf(open.f, smallest)].push_back(open);
+        bucket.clear();
+    }
+    node = this->openBuckets[0].back();
+    this->openBuckets[0].pop_back();
+    return true;
+}
+
+bool HierarchicalPathfinder::findPath(int startX, int startY, int goalX, int goalY, HierarchicalPath &path)
+{
+    path.waypoints.clear();
+    path.cost = 0;
+    this->expanded = 0;
+    if (startX < 0 || startY < 0 || startX >= this->width || startY >= this->height) return false;
+    if (goalX < 0 || goalY < 0 || goalX >= this->width || goalY >= this->height) return false;
+
+    const int start = startX + startY * this->width;
+    const int goal = goalX + goalY * this->width;
+    if (!this->walkable[start] || !this->walkable[goal]) return false;
+    if (start == goal)
+    {
+        path.waypoints.push_back({startX, startY});
+        return true;
+    }
+
+    if (++this->generation == 0)
+    {
+        std::fill(this->visited.begin(), this->visited.end(), 0);
+        std::fill(this->closed.begin(), this->closed.end(), 0);
+        this->generation = 1;
+    }
+
+    // ==========================================================================================
+    // Hook the goal up to the entrances of its cluster
+    // ==========================================================================================
+    const int startCluster = this->getClusterOf(start);
+    const int goalCluster = this->getClusterOf(goal);
+    int minX, minY, maxX, maxY;
+
+    this->getClusterBounds(goalCluster, minX, minY, maxX, maxY);
+    this->searchCluster(goalCluster, goal);
+    const std::vector<ClusterNode> &goalNodes = this->clusters[goalCluster].nodes;
+    this->goalCost.resize(goalNodes.size());
+    for (size_t i = 0; i < goalNodes.size(); i++)
+    {
+        int tile = goalNodes[i].tile;
+        this->goalCost[i] = this->localCost[(tile % this->width - minX) + (tile / this->width - minY) * this->clusterSize];
+    }
+    uint32_t directCost = HPA_UNREACHABLE;
+    if (startCluster == goalCluster)
+    {
+        directCost = this->localCost[(startX - minX) + (startY - minY) * this->clusterSize];
+    }
+
+    // The start and goal search as the node they are on, or get a slot of their own
+    const int firstExtraSlot = (int)this->clusters.size() * this->slotsPerCluster;
+    int startSlot = this->getSlotOf(start);
+    int goalSlot = this->getSlotOf(goal);
+    if (startSlot == -1) startSlot = firstExtraSlot;
+    if (goalSlot == -1) goalSlot = firstExtraSlot + 1;
+
+    auto relax = [&](int slot, int x, int y, uint32_t g, int from) {
+        if (this->closed[slot] == this->generation) return;
+        if (this->visited[slot] == this->generation && g >= this->cost[slot]) return;
+        this->visited[slot] = this->generation;
+        this->cost[slot] = g;
+        this->parent[slot] = from;
+        // Every edge is a real tile path so f cant drop below the last one popped, max()
+        // only keeps the heap sound if that ever stops being true
+        this->pushOpen({std::max(this->openLast, g + octile(x - goalX, y - goalY)), g, slot});
+    };
+
+    for (auto &bucket : this->openBuckets) bucket.clear();
+    this->openLast = 0;
+    relax(startSlot, startX, startY, 0, -1);
+
+    // ==========================================================================================
+    // A* over the entrance graph
+    // ==========================================================================================
+    bool found = false;
+    OpenNode node;
+    while (this->popOpen(node))
+    {
+        int slot = node.slot;
+        if (this->closed[slot] == this->generation || node.g != this->cost[slot]) continue;
+        this->closed[slot] = this->generation;
+        this->expanded++;
+
+        if (slot == goalSlot)
+        {
+            found = true;
+            break;
+        }
+
+        if (slot == startSlot)
+        {
+            // The start isnt in the graph, connect it to its cluster's entrances
+            const std::vector<ClusterNode> &startNodes = this->clusters[startCluster].nodes;
+            this->getClusterBounds(startCluster, minX, minY, maxX, maxY);
+            this->searchCluster(startCluster, start);
+            for (size_t j = 0; j < startNodes.size(); j++)
+            {
+                const ClusterNode &clusterNode = startNodes[j];
+                uint32_t distance = this->localCost[(clusterNode.x - minX) + (clusterNode.y - minY) * this->clusterSize];
+                if (distance != HPA_UNREACHABLE) relax(startCluster * this->slotsPerCluster + (int)j, clusterNode.x, clusterNode.y, distance, slot);
+            }
+            if (directCost != HPA_UNREACHABLE) relax(goalSlot, goalX, goalY, directCost, slot);
+        }
+        if (slot >= firstExtraSlot) continue;
+
+        const int clusterIndex = slot / this->slotsPerCluster;
+        const int nodeIndex = slot % this->slotsPerCluster;
+        const int firstSlot = clusterIndex * this->slotsPerCluster;
+        const Cluster &cluster = this->clusters[clusterIndex];
+        const ClusterNode &clusterNode = cluster.nodes[nodeIndex];
+        size_t nodeCount = cluster.nodes.size();
+        for (size_t j = 0; j < nodeCount; j++)
+        {
+            uint32_t distance = cluster.distances[nodeIndex * nodeCount + j];
+            if ((int)j == nodeIndex || distance == HPA_UNREACHABLE) continue;
+            relax(firstSlot + (int)j, cluster.nodes[j].x, cluster.nodes[j].y, node.g + distance, slot);
+        }
+        for (int p = 0; p < clusterNode.partnerCount; p++)
+        {
+            int partner = clusterNode.partners[p];
+            relax(this->getSlotOf(partner), partner % this->width, partner / this->width, node.g + HPA_STRAIGHT_COST, slot);
+        }
+        if (clusterIndex == goalCluster && this->goalCost[nodeIndex] != HPA_UNREACHABLE)
+        {
+            relax(goalSlot, goalX, goalY, node.g + this->goalCost[nodeIndex], slot);
+        }
+    }
+
+    if (!found) return false;
+
+    path.cost = this->cost[goalSlot];
+    for (int slot = goalSlot; slot != -1; slot = this->parent[slot])
+    {
+        if (slot == goalSlot) path.waypoints.push_back({goalX, goalY});
+        else if (slot == startSlot) path.waypoints.push_back({startX, startY});
+        else
+        {
+            const ClusterNode &clusterNode = this->clusters[slot / this->slotsPerCluster].nodes[slot % this->slotsPerCluster];
+            path.waypoints.push_back({clusterNode.x, clusterNode.y});
+        }
+    }
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+    return true;
+}
+
+/**
+    Node to node tile paths are the same every time until the cluster is rebuilt, one
+    search from the node gives the paths to all the others so they all go in the cache
+**/
+void HierarchicalPathfinder::cachePathsFrom(int clusterIndex, int node)
+{
+    Cluster &cluster = this->clusters[clusterIndex];
+    int minX, minY, maxX, maxY;
+    this->getClusterBounds(clusterIndex, minX, minY, maxX, maxY);
+    this->searchCluster(clusterIndex, cluster.nodes[node].tile);
+
+    size_t nodeCount = cluster.nodes.size();
+    for (size_t j = 0; j < nodeCount; j++)
+    {
+        size_t lengthAt = cluster.pathTiles.size();
+        cluster.pathStart[node * nodeCount + j] = (int)lengthAt;
+        cluster.pathTiles.push_back(0);
+
+        int local = (cluster.nodes[j].x - minX) + (cluster.nodes[j].y - minY) * this->clusterSize;
+        if (this->localCost[local] == HPA_UNREACHABLE) continue;
+        for (; local != -1; local = this->localParent[local]) cluster.pathTiles.push_back(local);
+        std::reverse(cluster.pathTiles.begin() + lengthAt + 1, cluster.pathTiles.end());
+        cluster.pathTiles[lengthAt] = (int)(cluster.pathTiles.size() - lengthAt - 1);
+    }
+}
+
+bool HierarchicalPathfinder::refineSegment(const HierarchicalPath &path, size_t segment, std::vector<PathPoint> &tiles)
+{
+    tiles.clear();
+    if (segment + 1 >= path.waypoints.size()) return false;
+
+    const PathPoint &from = path.waypoints[segment];
+    const PathPoint &to = path.waypoints[segment + 1];
+    int fromTile = from.x + from.y * this->width;
+    int toTile = to.x + to.y * this->width;
+
+    // Crossing an entrance is a single step
+    int clusterIndex = this->getClusterOf(fromTile);
+    if (clusterIndex != this->getClusterOf(toTile))
+    {
+        tiles.push_back(from);
+        tiles.push_back(to);
+        return true;
+    }
+
+    int minX, minY, maxX, maxY;
+    this->getClusterBounds(clusterIndex, minX, minY, maxX, maxY);
+    int fromNode = this->tileNode[fromTile];
+    int toNode = this->tileNode[toTile];
+    if (fromNode != -1 && toNode != -1)
+    {
+        Cluster &cluster = this->clusters[clusterIndex];
+        size_t pair = fromNode * cluster.nodes.size() + toNode;
+        if (cluster.pathStart[pair] == -1) this->cachePathsFrom(clusterIndex, fromNode);
+        const int *cached = cluster.pathTiles.data() + cluster.pathStart[pair];
+        for (int i = 1; i <= cached[0]; i++)
+        {
+            tiles.push_back({cached[i] % this->clusterSize + minX, cached[i] / this->clusterSize + minY});
+        }
+        return cached[0] > 0;
+    }
+
+    // The start and goal arent nodes, those still get searched
+    this->searchCluster(clusterIndex, fromTile);
+    int local = (to.x - minX) + (to.y - minY) * this->clusterSize;
+    if (this->localCost[local] == HPA_UNREACHABLE) return false;
+
+    for (; local != -1; local = this->localParent[local])
+    {
+        tiles.push_back({local % this->clusterSize + minX, local / this->clusterSize + minY});
+    }
+    std::reverse(tiles.begin(), tiles.end());
+    return true;
+}
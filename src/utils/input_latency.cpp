@@ -0,0 +1,54 @@
+#include "utils/input_latency.h"
+#include <SDL2/SDL.h>
+
+void InputLatency::History::add(float milliseconds)
+{
+    this->samples[this->next] = milliseconds;
+    this->next = (this->next + 1) % INPUT_LATENCY_HISTORY;
+    if (this->count < INPUT_LATENCY_HISTORY) this->count++;
+}
+
+float InputLatency::History::mean() const
+{
+    if (this->count == 0) return 0.0f;
+    float total = 0.0f;
+    for (int i = 0; i < this->count; i++) total += this->samples[i];
+    return total / this->count;
+}
+
+float InputLatency::History::max() const
+{
+    float worst = 0.0f;
+    for (int i = 0; i < this->count; i++)
+    {
+        if (this->samples[i] > worst) worst = this->samples[i];
+    }
+    return worst;
+}
+
+InputLatency::InputLatency()
+{
+    this->frequency = SDL_GetPerformanceFrequency();
+    if (this->frequency == 0) this->frequency = 1;
+}
+
+void InputLatency::markSampled(uint64_t counter, float eventAgeMs)
+{
+    this->sampledAt = counter;
+    this->oldestEventAgeMs = eventAgeMs;
+}
+
+void InputLatency::markPresented(uint64_t counter)
+{
+    if (this->sampledAt == 0 || counter < this->sampledAt) return;
+
+    this->lastSampleToPresentMs = (float)((counter - this->sampledAt) * 1000.0 / this->frequency);
+    this->sampleToPresent.add(this->lastSampleToPresentMs);
+
+    if (this->oldestEventAgeMs >= 0.0f)
+    {
+        this->lastInputToPresentMs = this->oldestEventAgeMs + this->lastSampleToPresentMs;
+        this->inputToPresent.add(this->lastInputToPresentMs);
+    }
+    this->sampledAt = 0;
+}
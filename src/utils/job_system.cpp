@@ -0,0 +1,215 @@
+#include "utils/job_system.h"
+#include <algorithm>
+
+// Which JobSystem / worker the current thread is, threads that arent workers count as 0
+static thread_local const JobSystem *threadSystem = nullptr;
+static thread_local int threadWorker = 0;
+
+JobSystem::JobSystem(int workerThreads) : workers(workerThreads < 0
+    ? std::max(1u, std::thread::hardware_concurrency())
+    : (unsigned)workerThreads + 1)
+{
+    this->stats.resize(this->workers.size());
+    this->lastSnapshot = std::chrono::steady_clock::now();
+    for (int i = 1; i < (int)this->workers.size(); i++)
+    {
+        this->threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->running = false;
+    }
+    this->wake.notify_all();
+    for (auto &thread : this->threads) thread.join();
+}
+
+int JobSystem::currentWorker() const
+{
+    return threadSystem == this ? threadWorker : 0;
+}
+
+int JobSystem::suggestGrain(int count) const
+{
+    // Around 4 ranges a worker, enough to even out uneven ranges without drowning in jobs
+    int ranges = this->getWorkerCount() * 4;
+    int grain = (count + ranges - 1) / ranges;
+    return grain < 64 ? 64 : grain;
+}
+
+// ==========================================================================================
+// Queueing
+// ==========================================================================================
+void JobSystem::push(int worker, const Job &job)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->workers[worker].mutex);
+        this->workers[worker].jobs.push_back(job);
+    }
+    this->queued.fetch_add(1, std::memory_order_release);
+}
+
+void JobSystem::wakeWorkers(int count)
+{
+    if (this->threads.empty()) return;
+    // Taking the lock means a worker between checking queued and going to sleep cant miss this
+    { std::lock_guard<std::mutex> lock(this->sleepMutex); }
+    if (count > 1) this->wake.notify_all();
+    else this->wake.notify_one();
+}
+
+void JobSystem::run(Job job, JobCounter *counter, JobCounter *after)
+{
+    job.counter = counter;
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (after)
+    {
+        // Only pending here, once it hits 0 the continuations are (being) taken and
+        // anything added now would never run
+        std::lock_guard<std::mutex> lock(after->mutex);
+        if (after->pending.load(std::memory_order_acquire) != 0)
+        {
+            after->continuations.push_back(job);
+            return;
+        }
+    }
+
+    this->push(this->currentWorker(), job);
+    this->wakeWorkers(1);
+}
+
+// ==========================================================================================
+// Running
+// ==========================================================================================
+bool JobSystem::findJob(int worker, Job &job)
+{
+    if (this->queued.load(std::memory_order_acquire) == 0) return false;
+
+    // Own deque first, newest job
+    {
+        Worker &own = this->workers[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            this->queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of someone else, start somewhere different each time so
+    // thieves dont all pile onto worker 1
+    const int count = (int)this->workers.size();
+    int start = (int)(this->nextVictim.fetch_add(1, std::memory_order_relaxed) % count);
+    for (int i = 0; i < count; i++)
+    {
+        int victim = (start + i) % count;
+        if (victim == worker) continue;
+        Worker &other = this->workers[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.jobs.empty())
+        {
+            job = other.jobs.front();
+            other.jobs.pop_front();
+            this->queued.fetch_sub(1, std::memory_order_relaxed);
+            this->workers[worker].steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(int worker, const Job &job)
+{
+    auto start = std::chrono::steady_clock::now();
+    job.function(job.data, job.begin, job.end);
+    auto end = std::chrono::steady_clock::now();
+
+    Worker &self = this->workers[worker];
+    self.jobsRun.fetch_add(1, std::memory_order_relaxed);
+    self.busyNanoseconds.fetch_add(
+        (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+        std::memory_order_relaxed);
+
+    JobCounter *counter = job.counter;
+    if (!counter) return;
+
+    counter->finishing.fetch_add(1, std::memory_order_acq_rel);
+    std::vector<Job> released;
+    if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // Last one out releases whatever was waiting on this counter
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        released.swap(counter->continuations);
+    }
+    // Last touch of the counter, after this whoever is waiting on it can let it go
+    counter->finishing.fetch_sub(1, std::memory_order_acq_rel);
+
+    for (const Job &next : released) this->push(worker, next);
+    if (!released.empty()) this->wakeWorkers((int)released.size());
+}
+
+void JobSystem::workerLoop(int worker)
+{
+    threadSystem = this;
+    threadWorker = worker;
+
+    Job job;
+    while (true)
+    {
+        if (this->findJob(worker, job))
+        {
+            this->execute(worker, job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->sleepMutex);
+        this->wake.wait(lock, [this]() {
+            return !this->running || this->queued.load(std::memory_order_acquire) > 0;
+        });
+        if (!this->running) return;
+    }
+}
+
+void JobSystem::wait(JobCounter &counter)
+{
+    const int worker = this->currentWorker();
+    Job job;
+    while (!counter.isDone())
+    {
+        if (this->findJob(worker, job))
+        {
+            this->execute(worker, job);
+        }
+        else
+        {
+            // Whats left is running on other workers
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ==========================================================================================
+// Stats
+// ==========================================================================================
+void JobSystem::snapshotStats()
+{
+    auto now = std::chrono::steady_clock::now();
+    double wallMilliseconds = std::chrono::duration<double, std::milli>(now - this->lastSnapshot).count();
+    this->lastSnapshot = now;
+
+    for (size_t i = 0; i < this->workers.size(); i++)
+    {
+        Worker &worker = this->workers[i];
+        WorkerStats &out = this->stats[i];
+        out.jobs = worker.jobsRun.exchange(0, std::memory_order_relaxed);
+        out.steals = worker.steals.exchange(0, std::memory_order_relaxed);
+        out.busyMilliseconds = worker.busyNanoseconds.exchange(0, std::memory_order_relaxed) / 1e6;
+        out.utilisation = wallMilliseconds > 0.0 ? out.busyMilliseconds / wallMilliseconds : 0.0;
+    }
+}
@@ -0,0 +1,258 @@
+#include "utils/jump_point_search.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Same tenth of a tile costs as the flow field so the two agree on path lengths
+#define JPS_STRAIGHT_COST 10
+#define JPS_DIAGONAL_COST 14
+
+// Open list is a min heap on f, ties go to the deeper node (bigger g) so we head for the goal
+static bool openGreater(const uint32_t fa, const uint32_t ga, const uint32_t fb, const uint32_t gb)
+{
+    return fa > fb || (fa == fb && ga < gb);
+}
+
+static uint32_t octile(int dx, int dy)
+{
+    dx = std::abs(dx);
+    dy = std::abs(dy);
+    int diagonal = std::min(dx, dy);
+    return (uint32_t)(diagonal * JPS_DIAGONAL_COST + (std::max(dx, dy) - diagonal) * JPS_STRAIGHT_COST);
+}
+
+static int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+void JumpPointSearch::build(const CollisionGrid &grid)
+{
+    this->width = grid.getWidth();
+    this->height = grid.getHeight();
+    this->stride = this->width + 2;
+    this->gridVersion = grid.getVersion();
+
+    size_t count = static_cast<size_t>(this->stride) * (this->height + 2);
+    this->walkable.assign(count, 0);
+    for (int y = 0; y < this->height; y++)
+    {
+        for (int x = 0; x < this->width; x++)
+        {
+            this->walkable[(x + 1) + (y + 1) * this->stride] = grid.isSolid(x, y) ? 0 : 1;
+        }
+    }
+
+    // Sizes changed so the old stamps mean nothing
+    this->visited.assign(count, 0);
+    this->closed.assign(count, 0);
+    this->cost.resize(count);
+    this->parent.resize(count);
+    this->generation = 0;
+}
+
+uint32_t JumpPointSearch::heuristic(int index) const
+{
+    return octile(index % this->stride - this->goalX, index / this->stride - this->goalY);
+}
+
+/**
+    Runs from index (having just stepped in direction dx, dy) until it finds a tile worth
+    putting in the open list, returns -1 if it runs into a wall first
+
+    Without corner cutting a tile is a jump point when moving straight past a wall that
+    ends, the tile beside us is open but the one beside where we came from was blocked
+    so the only good way into that opening is through here. Moving diagonally we stop
+    whenever one of the two straight jumps from the tile finds something.
+**/
+int JumpPointSearch::jump(int index, int dx, int dy) const
+{
+    const int step = dx + dy * this->stride;
+    const uint8_t *tiles = this->walkable.data();
+    while (true)
+    {
+        if (!tiles[index]) return -1;
+        if (index == this->goal) return index;
+
+        if (dx != 0 && dy != 0)
+        {
+            if (this->jump(index + dx, dx, 0) != -1 || this->jump(index + dy * this->stride, 0, dy) != -1)
+            {
+                return index;
+            }
+            // Carrying on diagonally needs both sides open
+            if (!tiles[index + dx] || !tiles[index + dy * this->stride]) return -1;
+        }
+        else if (dx != 0)
+        {
+            if ((tiles[index - this->stride] && !tiles[index - dx - this->stride]) ||
+                (tiles[index + this->stride] && !tiles[index - dx + this->stride]))
+            {
+                return index;
+            }
+        }
+        else
+        {
+            int back = dy * this->stride;
+            if ((tiles[index - 1] && !tiles[index - 1 - back]) ||
+                (tiles[index + 1] && !tiles[index + 1 - back]))
+            {
+                return index;
+            }
+        }
+        index += step;
+    }
+}
+
+void JumpPointSearch::pushJumpPoint(int from, int to)
+{
+    if (this->closed[to] == this->generation) return;
+
+    int dx = to % this->stride - from % this->stride;
+    int dy = to / this->stride - from / this->stride;
+    uint32_t g = this->cost[from] + octile(dx, dy);
+    if (this->visited[to] == this->generation && g >= this->cost[to]) return;
+
+    this->visited[to] = this->generation;
+    this->cost[to] = g;
+    this->parent[to] = from;
+
+    // Already in the open list with a worse cost is fine, the stale copy gets skipped
+    this->open.push_back({g + this->heuristic(to), g, to});
+    std::push_heap(this->open.begin(), this->open.end(), [](const OpenNode &a, const OpenNode &b) {
+        return openGreater(a.f, a.g, b.f, b.g);
+    });
+}
+
+bool JumpPointSearch::findPath(int startX, int startY, int goalX, int goalY, std::vector<PathPoint> &path)
+{
+    path.clear();
+    this->expanded = 0;
+    if (startX < 0 || startY < 0 || startX >= this->width || startY >= this->height) return false;
+    if (goalX < 0 || goalY < 0 || goalX >= this->width || goalY >= this->height) return false;
+
+    int start = (startX + 1) + (startY + 1) * this->stride;
+    this->goal = (goalX + 1) + (goalY + 1) * this->stride;
+    this->goalX = goalX + 1;
+    this->goalY = goalY + 1;
+    if (!this->walkable[start] || !this->walkable[this->goal]) return false;
+
+    // Stamps wrapped around, old ones could look like this generation
+    if (++this->generation == 0)
+    {
+        std::fill(this->visited.begin(), this->visited.end(), 0);
+        std::fill(this->closed.begin(), this->closed.end(), 0);
+        this->generation = 1;
+    }
+
+    auto compare = [](const OpenNode &a, const OpenNode &b) { return openGreater(a.f, a.g, b.f, b.g); };
+    const uint8_t *tiles = this->walkable.data();
+    const int stride = this->stride;
+
+    this->open.clear();
+    this->visited[start] = this->generation;
+    this->cost[start] = 0;
+    this->parent[start] = -1;
+    this->open.push_back({this->heuristic(start), 0, start});
+
+    bool found = false;
+    while (!this->open.empty())
+    {
+        std::pop_heap(this->open.begin(), this->open.end(), compare);
+        OpenNode node = this->open.back();
+        this->open.pop_back();
+
+        int index = node.index;
+        if (this->closed[index] == this->generation || node.g != this->cost[index]) continue;
+        this->closed[index] = this->generation;
+        this->expanded++;
+
+        if (index == this->goal)
+        {
+            found = true;
+            break;
+        }
+
+        // ==========================================================================================
+        // Which directions are worth jumping in from here
+        // ==========================================================================================
+        int from = this->parent[index];
+        if (from == -1)
+        {
+            // Start tile, everything
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (dx == 0 && dy == 0) continue;
+                    if (dx != 0 && dy != 0 && (!tiles[index + dx] || !tiles[index + dy * stride])) continue;
+                    int to = this->jump(index + dx + dy * stride, dx, dy);
+                    if (to != -1) this->pushJumpPoint(index, to);
+                }
+            }
+            continue;
+        }
+
+        int dx = sign(index % stride - from % stride);
+        int dy = sign(index / stride - from / stride);
+        int successors[5][2];
+        int successorCount = 0;
+        auto addSuccessor = [&](int sx, int sy) {
+            successors[successorCount][0] = sx;
+            successors[successorCount][1] = sy;
+            successorCount++;
+        };
+        if (dx != 0 && dy != 0)
+        {
+            bool openX = tiles[index + dx];
+            bool openY = tiles[index + dy * stride];
+            if (openY) addSuccessor(0, dy);
+            if (openX) addSuccessor(dx, 0);
+            if (openX && openY) addSuccessor(dx, dy);
+        }
+        else if (dx != 0)
+        {
+            bool openNext = tiles[index + dx];
+            bool openUp = tiles[index - stride];
+            bool openDown = tiles[index + stride];
+            if (openNext)
+            {
+                addSuccessor(dx, 0);
+                if (openUp) addSuccessor(dx, -1);
+                if (openDown) addSuccessor(dx, 1);
+            }
+            if (openUp) addSuccessor(0, -1);
+            if (openDown) addSuccessor(0, 1);
+        }
+        else
+        {
+            bool openNext = tiles[index + dy * stride];
+            bool openLeft = tiles[index - 1];
+            bool openRight = tiles[index + 1];
+            if (openNext)
+            {
+                addSuccessor(0, dy);
+                if (openLeft) addSuccessor(-1, dy);
+                if (openRight) addSuccessor(1, dy);
+            }
+            if (openLeft) addSuccessor(-1, 0);
+            if (openRight) addSuccessor(1, 0);
+        }
+
+        for (int i = 0; i < successorCount; i++)
+        {
+            int sx = successors[i][0];
+            int sy = successors[i][1];
+            int to = this->jump(index + sx + sy * stride, sx, sy);
+            if (to != -1) this->pushJumpPoint(index, to);
+        }
+    }
+
+    if (!found) return false;
+
+    for (int index = this->goal; index != -1; index = this->parent[index])
+    {
+        path.push_back({index % stride - 1, index / stride - 1});
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
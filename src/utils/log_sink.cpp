@@ -0,0 +1,24 @@
+#include "utils/log_sink.h"
+#include <cstdio>
+
+LogSinkFunction LogSink::sink = nullptr;
+
+void LogSink::print(const std::string &log, ErrorCode code)
+{
+    std::printf("[%s] %s\n", errorCodeToString(code).c_str(), log.c_str());
+}
+
+void LogSink::set(LogSinkFunction sink)
+{
+    LogSink::sink = sink;
+}
+
+void LogSink::write(const std::string &log, ErrorCode code)
+{
+    if (LogSink::sink)
+    {
+        LogSink::sink(log, code);
+        return;
+    }
+    LogSink::print(log, code);
+}
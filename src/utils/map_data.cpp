@@ -0,0 +1,290 @@
+#include "utils/map_data.h"
+#include "utils/log_sink.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+using json = nlohmann::json;
+
+/**
+Load the map and store it inside the TSDL_TileMap Struct, no textures
+**/
+bool MapData::load(TSDL_TileMap *tileMap, const std::string &jsonPath, const std::string &tsxPath)
+{
+    std::ifstream file(jsonPath);
+    // Open the file
+    if (!file.is_open())
+    {
+        LogSink::write("Error: Could not open the file: (" + jsonPath + ")", ErrorCode::FILE_ERROR);
+        return false;
+    }
+
+    // Read the file
+    json j;
+    file >> j;
+    // Close the File
+    file.close();
+
+    // Load Basic Information
+    tileMap->width = j.at("width");
+    tileMap->height = j.at("height");
+    tileMap->tileWidth = j.at("tilewidth");
+    tileMap->tileHeight = j.at("tileheight");
+
+    // Load Tilesets
+
+    for (auto &tileset : j.at("tilesets"))
+    {
+        // Create a Tileset Object
+        TSDL_Tileset t;
+
+        // Load Basic Information
+        t.source = tileset.at("source");
+        t.firstGid = tileset.at("firstgid");
+
+        tileMap->tilesets.push_back(t);
+    }
+
+    // Load Layers
+    for (auto &layer : j.at("layers"))
+    {
+        // Create a Layer Object
+        TSDL_Layer l;
+
+        // Load Basic Information
+        l.name = layer.at("name");
+
+        // Only assign width and height if it's a tile layer
+        if (layer.contains("width") && layer.contains("height"))
+        {
+            l.width = layer.at("width");
+            l.height = layer.at("height");
+        }
+        else
+        {
+            // If it's an object layer, set width/height to 0 or handle differently
+            l.width = 0;
+            l.height = 0;
+        }
+
+        // Only parse "data" if it's present (Tile layers have data, object layers do not)
+        if (layer.contains("data"))
+        {
+            l.data = layer.at("data").get<std::vector<int>>();
+        }
+
+        tileMap->layers.push_back(l);
+    }
+
+    // We Will load the tsx files right now
+    // this will be whaterver ......assets/......
+    // we wanna remove everything after the last /
+    std::string path = tsxPath;
+    size_t lastSlash = path.find_last_of("/\\");
+    if (lastSlash != std::string::npos)
+    {
+        path = path.substr(0, lastSlash + 1);
+    }
+    else
+    {
+        path = "";
+    }
+    if (!loadTsx(tileMap, path))
+    {
+        LogSink::write("Error: Could not load the tsx file: (" + path + ")", ErrorCode::MAP_ERROR);
+        return false;
+    }
+
+    // Needs the tile shapes from the tsx files
+    buildCollisionGrid(tileMap);
+
+    LogSink::write("Succesfully Loaded Json Into Map Struct", ErrorCode::SUCCESS);
+    /*std::cout << "Path: " << path << std::endl;*/
+    LogSink::write("Sources: " + std::to_string(tileMap->tilesets.size()), ErrorCode::SUCCESS);
+    for (int i = 0; i < tileMap->tilesets.size(); i++)
+    {
+        TSDL_Tileset tile = tileMap->tilesets[i];
+        TSDL_TilesetSource tileSource = tileMap->tilesetSources[i];
+        // End GID will be the firstGid + tileCount
+        int endGid = tile.firstGid + tileSource.tileCount;
+        tileMap->maxTileCount = endGid;
+
+        LogSink::write("Source:\t" + tile.source + " | " + std::to_string(tile.firstGid) + " -> " + std::to_string(endGid), ErrorCode::SUCCESS);
+    }
+    LogSink::write("Max Size: " + std::to_string(tileMap->maxTileCount), ErrorCode::NONE);
+    std::cout << "======================================" << std::endl;
+
+    return true;
+}
+
+/**
+Load the Tileset Source from the .tsx file
+**/
+bool MapData::loadTsx(TSDL_TileMap *tileMap, const std::string &path)
+{
+    tileMap->tileShapes.clear();
+
+    // Tsx is a xml file there could be many inside tilesets so we need to parse it
+    for (auto &t : tileMap->tilesets)
+    {
+        std::string tempPath = path;
+        // Create a Tileset Source Object
+        pugi::xml_document doc;
+
+        // Load the file
+        if (!doc.load_file(std::string(tempPath + t.source).c_str()))
+        {
+            std::cerr << "❌ Error: Could not load the file: (" << tempPath + t.source << ")" << std::endl;
+            return false;
+        }
+
+        // find the tileset node
+        pugi::xml_node tilesetNode = doc.child("tileset");
+        if (!tilesetNode)
+        {
+            std::cerr << "❌ Error: Could not find the <tileset> node in (" << tempPath + t.source << ")" << std::endl;
+            return false;
+        }
+
+        TSDL_TilesetSource ts;
+        // Store The Values
+        ts.name = tilesetNode.attribute("name").as_string();
+        ts.tileWidth = tilesetNode.attribute("tilewidth").as_int();
+        ts.tileHeight = tilesetNode.attribute("tileheight").as_int();
+        ts.tileCount = tilesetNode.attribute("tilecount").as_int();
+        ts.columns = tilesetNode.attribute("columns").as_int();
+
+        // Getting Image Path
+        pugi::xml_node imageNode = tilesetNode.child("image");
+        if (!imageNode)
+        {
+            std::cerr << "❌ Error: Could not find the <image> node in tileset " << ts.name << std::endl;
+            return false;
+        }
+
+        ts.imagePath = imageNode.attribute("source").as_string();
+        ts.imageWidth = imageNode.attribute("width").as_int();
+        ts.imageHeight = imageNode.attribute("height").as_int();
+
+        loadTileShapes(tileMap, tilesetNode, t.firstGid, ts);
+
+        // Add to the vector
+        tileMap->tilesetSources.push_back(ts);
+        LogSink::write("Succesfully Loaded Tsx: " + ts.name, ErrorCode::SUCCESS);
+    }
+    return true;
+}
+
+/**
+Collision shapes drawn in Tiled's collision editor end up as an <objectgroup> on the <tile>,
+rectangles are plain <object>s and polygons have a <polygon points="x,y x,y ..."> relative
+to the object. Only convex polygons work with SAT so anything else gets its bounding box
+(same for ellipses) and a warning in the log.
+**/
+void MapData::loadTileShapes(TSDL_TileMap *tileMap, pugi::xml_node tilesetNode, int firstGid, const TSDL_TilesetSource &ts)
+{
+    // Shapes are in tileset pixels, collision is done in map tile units
+    float scaleX = ts.tileWidth > 0 ? (float)tileMap->tileWidth / ts.tileWidth : 1.0f;
+    float scaleY = ts.tileHeight > 0 ? (float)tileMap->tileHeight / ts.tileHeight : 1.0f;
+
+    for (pugi::xml_node tileNode : tilesetNode.children("tile"))
+    {
+        pugi::xml_node groupNode = tileNode.child("objectgroup");
+        if (!groupNode) continue;
+
+        int gid = firstGid + tileNode.attribute("id").as_int();
+        std::vector<TileShape> shapes;
+
+        for (pugi::xml_node objectNode : groupNode.children("object"))
+        {
+            float x = objectNode.attribute("x").as_float();
+            float y = objectNode.attribute("y").as_float();
+            float width = objectNode.attribute("width").as_float();
+            float height = objectNode.attribute("height").as_float();
+            // Rotation is clockwise in degrees around the object position
+            float rotation = objectNode.attribute("rotation").as_float() * (float)M_PI / 180.0f;
+
+            std::vector<float> points;
+            pugi::xml_node polygonNode = objectNode.child("polygon");
+            if (polygonNode)
+            {
+                std::stringstream stream(polygonNode.attribute("points").as_string());
+                std::string point;
+                while (stream >> point)
+                {
+                    size_t comma = point.find(',');
+                    if (comma == std::string::npos) continue;
+                    points.push_back(std::strtof(point.c_str(), nullptr));
+                    points.push_back(std::strtof(point.c_str() + comma + 1, nullptr));
+                }
+            }
+            else if (objectNode.child("polyline") || objectNode.child("point"))
+            {
+                // Lines and points dont have an inside
+                continue;
+            }
+            else
+            {
+                if (width <= 0 || height <= 0) continue;
+                points = {0, 0, width, 0, width, height, 0, height};
+            }
+
+            float cosR = std::cos(rotation);
+            float sinR = std::sin(rotation);
+            for (size_t i = 0; i + 1 < points.size(); i += 2)
+            {
+                float px = points[i];
+                float py = points[i + 1];
+                points[i] = (x + px * cosR - py * sinR) * scaleX;
+                points[i + 1] = (y + px * sinR + py * cosR) * scaleY;
+            }
+
+            TileShape shape;
+            int count = (int)points.size() / 2;
+            bool isEllipse = (bool)objectNode.child("ellipse");
+            if (isEllipse || !TileShape::fromPolygon(points.data(), count, shape))
+            {
+                if (count == 0) continue;
+
+                AABB bounds = {points[0], points[1], points[0], points[1]};
+                for (int i = 1; i < count; i++)
+                {
+                    bounds.minX = std::min(bounds.minX, points[i * 2]);
+                    bounds.minY = std::min(bounds.minY, points[i * 2 + 1]);
+                    bounds.maxX = std::max(bounds.maxX, points[i * 2]);
+                    bounds.maxY = std::max(bounds.maxY, points[i * 2 + 1]);
+                }
+                if (!isEllipse)
+                {
+                    LogSink::write("Warning: Tile " + std::to_string(gid) + " in " + ts.name + " has a concave collision polygon, using its bounding box", ErrorCode::MAP_ERROR);
+                }
+                shape = TileShape::fromRect(bounds.minX, bounds.minY, bounds.getWidth(), bounds.getHeight());
+            }
+            shapes.push_back(shape);
+        }
+
+        if (!shapes.empty()) tileMap->tileShapes.setShapes(gid, shapes);
+    }
+}
+
+/**
+Flatten the "Collision" layer into the tileMap's collisionGrid
+**/
+void MapData::buildCollisionGrid(TSDL_TileMap *tileMap)
+{
+    tileMap->collisionGrid.clear();
+    for (auto &layer : tileMap->layers)
+    {
+        if (layer.name == "Collision")
+        {
+            tileMap->collisionGrid.build(tileMap->width, tileMap->height, tileMap->tileWidth, tileMap->tileHeight, layer.data, &tileMap->tileShapes);
+            return;
+        }
+    }
+    // No collision layer, everything inside the map is walkable
+    tileMap->collisionGrid.build(tileMap->width, tileMap->height, tileMap->tileWidth, tileMap->tileHeight, {});
+}
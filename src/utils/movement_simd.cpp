@@ -0,0 +1,181 @@
+#include "utils/movement_simd.h"
+
+// COMFY_NO_SIMD forces the plain loop (handy for checking the SIMD paths against it)
+#if defined(COMFY_NO_SIMD)
+    #define MOVEMENT_SIMD_LANES 1
+#elif defined(__AVX__)
+    #include <immintrin.h>
+    #define MOVEMENT_SIMD_AVX 1
+    #define MOVEMENT_SIMD_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define MOVEMENT_SIMD_SSE2 1
+    #define MOVEMENT_SIMD_LANES 4
+#elif defined(__aarch64__)
+    #include <arm_neon.h>
+    #define MOVEMENT_SIMD_NEON 1
+    #define MOVEMENT_SIMD_LANES 4
+#else
+    #define MOVEMENT_SIMD_LANES 1
+#endif
+
+MovementParams MovementParams::make(float dt, float acceleration, float friction)
+{
+    MovementParams params;
+    params.dt = dt;
+    params.accelerationStep = acceleration * dt;
+    params.frictionFactor = (float)std::pow(friction, dt * 60.0f);
+    return params;
+}
+
+FixedMovementParams FixedMovementParams::make(int tickRate, Fixed acceleration, Fixed friction)
+{
+    FixedMovementParams params;
+    params.dt = Fixed::fromInt(1) / tickRate;
+    // acceleration / tickRate rounds once, acceleration * dt would round twice
+    params.accelerationStep = acceleration / tickRate;
+    params.frictionFactor = Fixed::pow(friction, Fixed::fromInt(60) / tickRate);
+    return params;
+}
+
+void MovementKernels::stepVelocityFixed(const FixedMovementParams &params, const FixedVec2 &direction, Fixed maxSpeed, FixedVec2 &velocity)
+{
+    velocity += direction * params.accelerationStep;
+
+    if (velocity.lengthSquaredRaw() > (int64_t)maxSpeed.raw * maxSpeed.raw)
+    {
+        Fixed scale = maxSpeed / velocity.length();
+        velocity = velocity * scale;
+    }
+
+    if (direction.x.raw == 0) velocity.x *= params.frictionFactor;
+    if (direction.y.raw == 0) velocity.y *= params.frictionFactor;
+}
+
+const char *MovementKernels::getInstructionSet()
+{
+#if defined(MOVEMENT_SIMD_AVX)
+    return "AVX (8 wide)";
+#elif defined(MOVEMENT_SIMD_SSE2)
+    return "SSE2 (4 wide)";
+#elif defined(MOVEMENT_SIMD_NEON)
+    return "NEON (4 wide)";
+#else
+    return "Scalar";
+#endif
+}
+
+void MovementKernels::integrateScalar(const MovementParams &params, const MovementArrays &arrays, int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        float velocityX = arrays.velocityX[i];
+        float velocityY = arrays.velocityY[i];
+        stepVelocity(params, arrays.directionX[i], arrays.directionY[i], arrays.maxSpeed[i], velocityX, velocityY);
+        arrays.velocityX[i] = velocityX;
+        arrays.velocityY[i] = velocityY;
+        arrays.x[i] += velocityX * params.dt;
+        arrays.y[i] += velocityY * params.dt;
+    }
+}
+
+/**
+    Same steps as stepVelocity, a lane at a time. The clamp scale gets worked out for
+    every lane and only kept where the lane was over its max speed, lanes sitting still
+    divide by 0 there but that result gets thrown away. Friction multiplies by 1 on axes
+    with input, which is exact, so it matches the scalar branch
+**/
+void MovementKernels::integrate(const MovementParams &params, const MovementArrays &arrays, int begin, int end)
+{
+    int i = begin;
+#if defined(MOVEMENT_SIMD_AVX)
+    const __m256 accelerationStep = _mm256_set1_ps(params.accelerationStep);
+    const __m256 friction = _mm256_set1_ps(params.frictionFactor);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 dt = _mm256_set1_ps(params.dt);
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 directionX = _mm256_loadu_ps(arrays.directionX + i);
+        __m256 directionY = _mm256_loadu_ps(arrays.directionY + i);
+        __m256 maxSpeed = _mm256_loadu_ps(arrays.maxSpeed + i);
+        __m256 velocityX = _mm256_add_ps(_mm256_loadu_ps(arrays.velocityX + i), _mm256_mul_ps(directionX, accelerationStep));
+        __m256 velocityY = _mm256_add_ps(_mm256_loadu_ps(arrays.velocityY + i), _mm256_mul_ps(directionY, accelerationStep));
+
+        __m256 lengthSquared = _mm256_add_ps(_mm256_mul_ps(velocityX, velocityX), _mm256_mul_ps(velocityY, velocityY));
+        __m256 over = _mm256_cmp_ps(lengthSquared, _mm256_mul_ps(maxSpeed, maxSpeed), _CMP_GT_OQ);
+        __m256 scale = _mm256_div_ps(maxSpeed, _mm256_sqrt_ps(lengthSquared));
+        velocityX = _mm256_blendv_ps(velocityX, _mm256_mul_ps(velocityX, scale), over);
+        velocityY = _mm256_blendv_ps(velocityY, _mm256_mul_ps(velocityY, scale), over);
+
+        velocityX = _mm256_mul_ps(velocityX, _mm256_blendv_ps(one, friction, _mm256_cmp_ps(directionX, zero, _CMP_EQ_OQ)));
+        velocityY = _mm256_mul_ps(velocityY, _mm256_blendv_ps(one, friction, _mm256_cmp_ps(directionY, zero, _CMP_EQ_OQ)));
+
+        _mm256_storeu_ps(arrays.velocityX + i, velocityX);
+        _mm256_storeu_ps(arrays.velocityY + i, velocityY);
+        _mm256_storeu_ps(arrays.x + i, _mm256_add_ps(_mm256_loadu_ps(arrays.x + i), _mm256_mul_ps(velocityX, dt)));
+        _mm256_storeu_ps(arrays.y + i, _mm256_add_ps(_mm256_loadu_ps(arrays.y + i), _mm256_mul_ps(velocityY, dt)));
+    }
+#elif defined(MOVEMENT_SIMD_SSE2)
+    // No blendv before SSE4.1, select with and / andnot / or
+    auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+    const __m128 accelerationStep = _mm_set1_ps(params.accelerationStep);
+    const __m128 friction = _mm_set1_ps(params.frictionFactor);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 dt = _mm_set1_ps(params.dt);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 directionX = _mm_loadu_ps(arrays.directionX + i);
+        __m128 directionY = _mm_loadu_ps(arrays.directionY + i);
+        __m128 maxSpeed = _mm_loadu_ps(arrays.maxSpeed + i);
+        __m128 velocityX = _mm_add_ps(_mm_loadu_ps(arrays.velocityX + i), _mm_mul_ps(directionX, accelerationStep));
+        __m128 velocityY = _mm_add_ps(_mm_loadu_ps(arrays.velocityY + i), _mm_mul_ps(directionY, accelerationStep));
+
+        __m128 lengthSquared = _mm_add_ps(_mm_mul_ps(velocityX, velocityX), _mm_mul_ps(velocityY, velocityY));
+        __m128 over = _mm_cmpgt_ps(lengthSquared, _mm_mul_ps(maxSpeed, maxSpeed));
+        __m128 scale = _mm_div_ps(maxSpeed, _mm_sqrt_ps(lengthSquared));
+        velocityX = select(over, _mm_mul_ps(velocityX, scale), velocityX);
+        velocityY = select(over, _mm_mul_ps(velocityY, scale), velocityY);
+
+        velocityX = _mm_mul_ps(velocityX, select(_mm_cmpeq_ps(directionX, zero), friction, one));
+        velocityY = _mm_mul_ps(velocityY, select(_mm_cmpeq_ps(directionY, zero), friction, one));
+
+        _mm_storeu_ps(arrays.velocityX + i, velocityX);
+        _mm_storeu_ps(arrays.velocityY + i, velocityY);
+        _mm_storeu_ps(arrays.x + i, _mm_add_ps(_mm_loadu_ps(arrays.x + i), _mm_mul_ps(velocityX, dt)));
+        _mm_storeu_ps(arrays.y + i, _mm_add_ps(_mm_loadu_ps(arrays.y + i), _mm_mul_ps(velocityY, dt)));
+    }
+#elif defined(MOVEMENT_SIMD_NEON)
+    // vmulq / vaddq on purpose, vmlaq can fuse and then we wouldnt match the scalar step
+    const float32x4_t accelerationStep = vdupq_n_f32(params.accelerationStep);
+    const float32x4_t friction = vdupq_n_f32(params.frictionFactor);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t dt = vdupq_n_f32(params.dt);
+    for (; i + 4 <= end; i += 4)
+    {
+        float32x4_t directionX = vld1q_f32(arrays.directionX + i);
+        float32x4_t directionY = vld1q_f32(arrays.directionY + i);
+        float32x4_t maxSpeed = vld1q_f32(arrays.maxSpeed + i);
+        float32x4_t velocityX = vaddq_f32(vld1q_f32(arrays.velocityX + i), vmulq_f32(directionX, accelerationStep));
+        float32x4_t velocityY = vaddq_f32(vld1q_f32(arrays.velocityY + i), vmulq_f32(directionY, accelerationStep));
+
+        float32x4_t lengthSquared = vaddq_f32(vmulq_f32(velocityX, velocityX), vmulq_f32(velocityY, velocityY));
+        uint32x4_t over = vcgtq_f32(lengthSquared, vmulq_f32(maxSpeed, maxSpeed));
+        float32x4_t scale = vdivq_f32(maxSpeed, vsqrtq_f32(lengthSquared));
+        velocityX = vbslq_f32(over, vmulq_f32(velocityX, scale), velocityX);
+        velocityY = vbslq_f32(over, vmulq_f32(velocityY, scale), velocityY);
+
+        velocityX = vmulq_f32(velocityX, vbslq_f32(vceqq_f32(directionX, zero), friction, one));
+        velocityY = vmulq_f32(velocityY, vbslq_f32(vceqq_f32(directionY, zero), friction, one));
+
+        vst1q_f32(arrays.velocityX + i, velocityX);
+        vst1q_f32(arrays.velocityY + i, velocityY);
+        vst1q_f32(arrays.x + i, vaddq_f32(vld1q_f32(arrays.x + i), vmulq_f32(velocityX, dt)));
+        vst1q_f32(arrays.y + i, vaddq_f32(vld1q_f32(arrays.y + i), vmulq_f32(velocityY, dt)));
+    }
+#endif
+    // Whatever doesnt fill a whole register
+    integrateScalar(params, arrays, i, end);
+}
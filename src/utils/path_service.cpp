@@ -0,0 +1,57 @@
+#include "utils/path_service.h"
+
+PathService::PathService(size_t capacity)
+{
+    this->capacity = capacity > 0 ? capacity : 1;
+    this->lookup.reserve(this->capacity);
+}
+
+void PathService::invalidate()
+{
+    this->recent.clear();
+    this->lookup.clear();
+}
+
+bool PathService::findPath(const CollisionGrid &grid, int startX, int startY, int goalX, int goalY, std::vector<PathPoint> &path)
+{
+    if (this->grid != &grid || this->gridVersion != grid.getVersion())
+    {
+        this->invalidate();
+        this->search.build(grid);
+        this->grid = &grid;
+        this->gridVersion = grid.getVersion();
+    }
+
+    // 16 bits per coordinate is a 65536 tile wide map, plenty
+    uint64_t key = ((uint64_t)(uint16_t)startX << 48) | ((uint64_t)(uint16_t)startY << 32) |
+                   ((uint64_t)(uint16_t)goalX << 16) | (uint64_t)(uint16_t)goalY;
+
+    auto cached = this->lookup.find(key);
+    if (cached != this->lookup.end())
+    {
+        this->hits++;
+        this->recent.splice(this->recent.begin(), this->recent, cached->second);
+        path = cached->second->path;
+        return cached->second->found;
+    }
+
+    this->misses++;
+    bool found = this->search.findPath(startX, startY, goalX, goalY, path);
+
+    // Reuse the oldest entry when full so a full cache doesnt allocate list nodes
+    if (this->recent.size() >= this->capacity)
+    {
+        this->lookup.erase(this->recent.back().key);
+        this->recent.splice(this->recent.begin(), this->recent, std::prev(this->recent.end()));
+    }
+    else
+    {
+        this->recent.emplace_front();
+    }
+    CachedPath &entry = this->recent.front();
+    entry.key = key;
+    entry.found = found;
+    entry.path = path;
+    this->lookup[key] = this->recent.begin();
+    return found;
+}
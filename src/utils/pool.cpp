@@ -0,0 +1,44 @@
+#include "utils/pool.h"
+
+PoolHandle HandleTable::allocate()
+{
+    uint32_t index;
+    if (!this->freeIndices.empty())
+    {
+        index = this->freeIndices.back();
+        this->freeIndices.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)this->generations.size();
+        this->generations.push_back(0);
+    }
+    // Even -> odd, the slot is live
+    this->generations[index]++;
+    this->liveCount++;
+    return PoolHandle{index, this->generations[index]};
+}
+
+bool HandleTable::release(PoolHandle handle)
+{
+    if (!this->isAlive(handle)) return false;
+    // Odd -> even, every handle to it is stale now
+    this->generations[handle.index]++;
+    this->freeIndices.push_back(handle.index);
+    this->liveCount--;
+    return true;
+}
+
+void HandleTable::clear()
+{
+    for (uint32_t index = 0; index < this->generations.size(); index++)
+    {
+        if (this->generations[index] & 1) this->release(this->handleAt(index));
+    }
+}
+
+void HandleTable::reserve(int count)
+{
+    this->generations.reserve(count);
+    this->freeIndices.reserve(count);
+}
@@ -0,0 +1,166 @@
+#include "utils/spatial_hash.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(int tileWidth, int tileHeight, int tilesPerCell)
+{
+    this->setCellSize(tileWidth, tileHeight, tilesPerCell);
+}
+
+void SpatialHash::setCellSize(int tileWidth, int tileHeight, int tilesPerCell)
+{
+    if (tileWidth <= 0) tileWidth = 16;
+    if (tileHeight <= 0) tileHeight = 16;
+    if (tilesPerCell <= 0) tilesPerCell = 1;
+    this->cellWidth = (float)(tileWidth * tilesPerCell);
+    this->cellHeight = (float)(tileHeight * tilesPerCell);
+}
+
+uint32_t SpatialHash::hashCell(int cellX, int cellY) const
+{
+    // Large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+    uint32_t h = ((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u);
+    return h & this->bucketMask;
+}
+
+void SpatialHash::cellRange(const AABB &box, int &startX, int &startY, int &endX, int &endY) const
+{
+    startX = (int)std::floor(box.minX / this->cellWidth);
+    startY = (int)std::floor(box.minY / this->cellHeight);
+    endX = (int)std::floor(box.maxX / this->cellWidth);
+    endY = (int)std::floor(box.maxY / this->cellHeight);
+}
+
+/**
+    Counting sort into the buckets, first pass counts how many entries land in each
+    bucket, then a prefix sum gives where each bucket starts and the second pass
+    drops the entries into place
+**/
+void SpatialHash::rebuild(const AABB *newBoxes, int count)
+{
+    this->boxes.assign(newBoxes, newBoxes + count);
+
+    // Keep the table at least twice the number of proxies so buckets stay short
+    uint32_t tableSize = 64;
+    while (tableSize < (uint32_t)count * 2) tableSize <<= 1;
+    this->bucketMask = tableSize - 1;
+    this->bucketStart.assign(tableSize + 1, 0);
+
+    // ==========================================================================================
+    // Count
+    // ==========================================================================================
+    size_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int startX, startY, endX, endY;
+        this->cellRange(this->boxes[i], startX, startY, endX, endY);
+        for (int y = startY; y <= endY; y++)
+        {
+            for (int x = startX; x <= endX; x++)
+            {
+                this->bucketStart[this->hashCell(x, y) + 1]++;
+                total++;
+            }
+        }
+    }
+
+    // ==========================================================================================
+    // Prefix Sum
+    // ==========================================================================================
+    for (uint32_t b = 0; b < tableSize; b++)
+    {
+        this->bucketStart[b + 1] += this->bucketStart[b];
+    }
+
+    // ==========================================================================================
+    // Fill, using the start of each bucket as a write cursor and then shifting back
+    // ==========================================================================================
+    this->entries.resize(total);
+    for (int i = 0; i < count; i++)
+    {
+        int startX, startY, endX, endY;
+        this->cellRange(this->boxes[i], startX, startY, endX, endY);
+        for (int y = startY; y <= endY; y++)
+        {
+            for (int x = startX; x <= endX; x++)
+            {
+                uint32_t bucket = this->hashCell(x, y);
+                this->entries[this->bucketStart[bucket]++] = {i, this->cellKey(x, y)};
+            }
+        }
+    }
+    for (uint32_t b = tableSize; b > 0; b--)
+    {
+        this->bucketStart[b] = this->bucketStart[b - 1];
+    }
+    this->bucketStart[0] = 0;
+}
+
+/**
+    Two boxes that span a few cells will meet in every one of those cells, so a pair
+    is only reported from the cell holding the top left corner of where they overlap
+**/
+void SpatialHash::findPairs(std::vector<BroadphasePair> &pairs) const
+{
+    pairs.clear();
+    if (this->bucketStart.empty()) return;
+
+    uint32_t tableSize = this->bucketMask + 1;
+    for (uint32_t bucket = 0; bucket < tableSize; bucket++)
+    {
+        uint32_t begin = this->bucketStart[bucket];
+        uint32_t end = this->bucketStart[bucket + 1];
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const Entry &first = this->entries[i];
+            const AABB &a = this->boxes[first.proxy];
+            for (uint32_t j = i + 1; j < end; j++)
+            {
+                const Entry &second = this->entries[j];
+                // Different cells that just happen to hash to the same bucket
+                if (second.cellKey != first.cellKey) continue;
+
+                const AABB &b = this->boxes[second.proxy];
+                if (!a.overlaps(b)) continue;
+
+                int cornerX = (int)std::floor(std::max(a.minX, b.minX) / this->cellWidth);
+                int cornerY = (int)std::floor(std::max(a.minY, b.minY) / this->cellHeight);
+                if (this->cellKey(cornerX, cornerY) != first.cellKey) continue;
+
+                pairs.push_back({std::min(first.proxy, second.proxy), std::max(first.proxy, second.proxy)});
+            }
+        }
+    }
+}
+
+void SpatialHash::query(const AABB &box, std::vector<int> &results) const
+{
+    results.clear();
+    if (this->bucketStart.empty()) return;
+
+    int startX, startY, endX, endY;
+    this->cellRange(box, startX, startY, endX, endY);
+    for (int y = startY; y <= endY; y++)
+    {
+        for (int x = startX; x <= endX; x++)
+        {
+            uint32_t bucket = this->hashCell(x, y);
+            int64_t key = this->cellKey(x, y);
+            for (uint32_t i = this->bucketStart[bucket]; i < this->bucketStart[bucket + 1]; i++)
+            {
+                const Entry &entry = this->entries[i];
+                if (entry.cellKey != key) continue;
+
+                const AABB &other = this->boxes[entry.proxy];
+                if (!box.overlaps(other)) continue;
+
+                // Same trick as findPairs so a proxy spanning cells only shows up once
+                int cornerX = (int)std::floor(std::max(box.minX, other.minX) / this->cellWidth);
+                int cornerY = (int)std::floor(std::max(box.minY, other.minY) / this->cellHeight);
+                if (cornerX != x || cornerY != y) continue;
+
+                results.push_back(entry.proxy);
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include "utils/tile_shapes.h"
+#include <algorithm>
+#include <cmath>
+
+// Normals closer than this to X or Y are already covered by the bounds
+static const float AXIS_EPSILON = 0.0001f;
+
+TileShape TileShape::fromRect(float x, float y, float width, float height)
+{
+    TileShape shape;
+    shape.bounds = AABB::fromRect(x, y, width, height);
+    shape.vertexCount = 4;
+    float points[8] = {x, y, x + width, y, x + width, y + height, x, y + height};
+    std::copy(points, points + 8, shape.vertices);
+    return shape;
+}
+
+bool TileShape::fromPolygon(const float *points, int count, TileShape &out)
+{
+    if (count < 3 || count > MAX_SHAPE_VERTICES) return false;
+
+    // Convex means every corner turns the same way (straight corners are fine)
+    int turn = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const float *a = &points[i * 2];
+        const float *b = &points[((i + 1) % count) * 2];
+        const float *c = &points[((i + 2) % count) * 2];
+        float cross = (b[0] - a[0]) * (c[1] - b[1]) - (b[1] - a[1]) * (c[0] - b[0]);
+        if (cross == 0.0f) continue;
+
+        int sign = cross > 0 ? 1 : -1;
+        if (turn != 0 && sign != turn) return false;
+        turn = sign;
+    }
+    // Every point on one line
+    if (turn == 0) return false;
+
+    TileShape shape;
+    shape.vertexCount = count;
+    shape.bounds = AABB{points[0], points[1], points[0], points[1]};
+    for (int i = 0; i < count; i++)
+    {
+        float x = points[i * 2];
+        float y = points[i * 2 + 1];
+        shape.vertices[i * 2] = x;
+        shape.vertices[i * 2 + 1] = y;
+        shape.bounds.minX = std::min(shape.bounds.minX, x);
+        shape.bounds.minY = std::min(shape.bounds.minY, y);
+        shape.bounds.maxX = std::max(shape.bounds.maxX, x);
+        shape.bounds.maxY = std::max(shape.bounds.maxY, y);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const float *a = &points[i * 2];
+        const float *b = &points[((i + 1) % count) * 2];
+        float nx = -(b[1] - a[1]);
+        float ny = b[0] - a[0];
+        float length = std::sqrt(nx * nx + ny * ny);
+        if (length == 0.0f) continue;
+        nx /= length;
+        ny /= length;
+
+        if (std::fabs(nx) < AXIS_EPSILON || std::fabs(ny) < AXIS_EPSILON) continue;
+
+        // Opposite edges of a parallelogram give the same axis
+        bool duplicate = false;
+        for (int j = 0; j < shape.axisCount; j++)
+        {
+            float dot = nx * shape.axes[j * 2] + ny * shape.axes[j * 2 + 1];
+            if (std::fabs(dot) > 1.0f - AXIS_EPSILON)
+            {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) continue;
+
+        int axis = shape.axisCount++;
+        shape.axes[axis * 2] = nx;
+        shape.axes[axis * 2 + 1] = ny;
+        shape.axisMin[axis] = shape.axisMax[axis] = points[0] * nx + points[1] * ny;
+        for (int v = 1; v < count; v++)
+        {
+            float projection = points[v * 2] * nx + points[v * 2 + 1] * ny;
+            shape.axisMin[axis] = std::min(shape.axisMin[axis], projection);
+            shape.axisMax[axis] = std::max(shape.axisMax[axis], projection);
+        }
+    }
+
+    out = shape;
+    return true;
+}
+
+void TileShapeTable::setShapes(int gid, const std::vector<TileShape> &tileShapes)
+{
+    if (gid < 0) return;
+    if (gid >= (int)this->shapeCount.size())
+    {
+        this->firstShape.resize(gid + 1, 0);
+        this->shapeCount.resize(gid + 1, 0);
+    }
+
+    // Always appended, a gid only gets its shapes once per load so nothing is wasted
+    size_t count = std::min<size_t>(tileShapes.size(), 255);
+    this->firstShape[gid] = (uint32_t)this->shapes.size();
+    this->shapeCount[gid] = (uint8_t)count;
+    this->shapes.insert(this->shapes.end(), tileShapes.begin(), tileShapes.begin() + count);
+}
+
+void TileShapeTable::clear()
+{
+    this->shapes.clear();
+    this->firstShape.clear();
+    this->shapeCount.clear();
+}